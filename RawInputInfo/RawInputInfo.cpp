@@ -8,28 +8,58 @@
 #include <RawInputDeviceHid.h>
 #include <RawInputDeviceKeyboard.h>
 #include <RawInputDeviceMouse.h>
+#include <HidDescriptorDisassembler.h>
+#include <utils_hiddescriptor.h>
 
 #include <fmt/format.h>
 #include <algorithm>
+#include <cstring>
+
+// What DumpDeviceInfo() prints besides the device properties.
+struct DumpOptions
+{
+    bool hex = true;                // raw USB descriptors
+    uint32_t disassemble = HidDescriptorDisassembler::Items | HidDescriptorDisassembler::Layout;
+};
+
+DumpOptions g_Options;
+
+// Reused for every device, so its buffer is allocated once.
+HidDescriptorDisassembler g_Disassembler;
 
 void HexDump(const uint8_t* src, size_t len) {
     if (!len)
-        printf("Empty ");
+    {
+        fmt::print("Empty (0 bytes)\n");
+        return;
+    }
+
+    // 16 bytes per line, formatted into one buffer and written at once.
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(len * 3 + (len / 16 + 1) * 8 + 16);
 
     for (size_t i = 0; i < len; i++) {
-        if (i % 8 == 0) {
-            //printf("%04x ", uint32_t(i));
+        if (i % 16 == 0) {
+            text += fmt::format("    {:04x}:", i);
         }
 
-        printf("%02x ", src[i]);
+        text += ' ';
+        text += kHex[src[i] >> 4];
+        text += kHex[src[i] & 0xf];
 
-        if ((i + 1) % 8 == 0)
-        {
-            //printf("\n");
-        }
+        if ((i + 1) % 16 == 0 || i + 1 == len)
+            text += '\n';
     }
-    //printf("\n");
-    printf("(%d bytes)\n", (int)len);
+    text += fmt::format("    ({} bytes)\n", len);
+
+    fwrite(text.data(), 1, text.size(), stdout);
+}
+
+void DisassembleDescriptor(std::span<const uint8_t> descriptor)
+{
+    const std::string_view text = g_Disassembler.Disassemble(descriptor, g_Options.disassemble);
+    fwrite(text.data(), 1, text.size(), stdout);
 }
 
 std::string BCDVersionToString(uint16_t bcd)
@@ -64,6 +94,12 @@ void DumpDeviceInfo(const RawInputDevice* device)
 
     fmt::print("New {} device: {}\n", deviceType, device->GetInterfacePath());
 
+    const DevicePathInfo& pathInfo = device->GetInterfacePathInfo();
+    fmt::print("  ->Path: Bus:{},MI:{},COL:{},Instance:{}\n", pathInfo.bus,
+        pathInfo.interfaceNumber ? fmt::format("{:02X}", *pathInfo.interfaceNumber) : "-",
+        pathInfo.collection ? fmt::format("{:02X}", *pathInfo.collection) : "-",
+        pathInfo.instance);
+
     fmt::print("  ->VID:{:04X},PID:{:04X},VER:{}\n", device->GetVendorId(), device->GetProductId(), BCDVersionToString(device->GetVersionNumber()));
     fmt::print("  ->Manufacturer: {}\n", device->GetManufacturerString());
     fmt::print("  ->Product: {}\n", device->GetProductString());
@@ -95,25 +131,93 @@ void DumpDeviceInfo(const RawInputDevice* device)
     {
         fmt::print("It have USB Device Interface: {}\n", device->GetUsbInterfacePath());
 
-        const std::vector<uint8_t>& configurationDesc = device->GetUsbConfigurationDescriptor();
+        const std::span<const uint8_t> configurationDesc = device->GetUsbConfigurationDescriptor();
 
-        fmt::print("  ->USB Configuration Descriptor Dump: \n");
-        HexDump(configurationDesc.data(), configurationDesc.size());
+        if (g_Options.hex)
+        {
+            fmt::print("  ->USB Configuration Descriptor Dump: \n");
+            HexDump(configurationDesc.data(), configurationDesc.size());
+        }
 
         if (device->IsHidDevice())
         {
-            const std::vector<uint8_t>& hidDesc = device->GetUsbHidReportDescriptor();
+            const std::span<const uint8_t> hidDesc = device->GetUsbHidReportDescriptor();
 
-            fmt::print("  ->HID Report Descriptor Dump: \n");
-            HexDump(hidDesc.data(), hidDesc.size());
+            if (g_Options.hex)
+            {
+                fmt::print("  ->HID Report Descriptor Dump: \n");
+                HexDump(hidDesc.data(), hidDesc.size());
+            }
+
+            if (g_Options.disassemble && !hidDesc.empty())
+            {
+                fmt::print("  ->HID Report Descriptor: \n");
+                DisassembleDescriptor(hidDesc);
+            }
+        }
+    }
+    else if (hidDevice && g_Options.disassemble)
+    {
+        // Bluetooth and other non-USB devices: only the preparsed data is
+        // available, so show the descriptor rebuilt from it.
+        const PHIDP_PREPARSED_DATA preparsedData = hidDevice->GetModel()->GetPreparsedData();
+        std::vector<UCHAR> hidDesc;
+        if (preparsedData && ReconstructDescriptor(preparsedData, hidDesc))
+        {
+            fmt::print("  ->HID Report Descriptor (reconstructed from preparsed data): \n");
+            DisassembleDescriptor(hidDesc);
         }
     }
 
+    fmt::print("  ->Metadata: {} bytes in {} block(s)\n", device->GetMetadataBytes(), device->GetMetadataBlockCount());
+
     fmt::print("--------------------------\n");
 }
 
-int main()
+void PrintUsage()
+{
+    fmt::print(
+        "Usage: RawInputInfo [--hex] [--items] [--layout] [--bytes]\n"
+        "  --hex     hex dumps of the USB configuration and HID report descriptors\n"
+        "  --items   HID report descriptor items, with usage names\n"
+        "  --layout  bit layout of every report, per Report ID\n"
+        "  --bytes   --items with the offset and bytes of each item\n"
+        "Without options: --hex --items --layout\n");
+}
+
+bool ParseOptions(int argc, char** argv)
+{
+    if (argc <= 1)
+        return true;
+
+    g_Options.hex = false;
+    g_Options.disassemble = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--hex"))
+            g_Options.hex = true;
+        else if (!strcmp(argv[i], "--items"))
+            g_Options.disassemble |= HidDescriptorDisassembler::Items;
+        else if (!strcmp(argv[i], "--layout"))
+            g_Options.disassemble |= HidDescriptorDisassembler::Layout;
+        else if (!strcmp(argv[i], "--bytes"))
+            g_Options.disassemble |= HidDescriptorDisassembler::Items | HidDescriptorDisassembler::Bytes;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
 {
+    if (!ParseOptions(argc, argv))
+    {
+        PrintUsage();
+        return 1;
+    }
+
     RawInputDeviceManager rawDeviceManager;
 
     std::cout << "RawInputDeviceManager is working!\n";
@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "framework.h"
+
+#include "CfgMgr32Wrapper.h"
+
+namespace
+{
+    std::string GetDevNodeInstanceId(DEVINST devInst)
+    {
+        WCHAR buffer[MAX_DEVICE_ID_LEN + 1] = {};
+        if (::CM_Get_Device_IDW(devInst, buffer, static_cast<ULONG>(std::size(buffer)), 0) != CR_SUCCESS)
+            return {};
+
+        return utf8::narrow(buffer);
+    }
+
+    class CfgMgrDeviceTreeSource final : public DeviceTreeSource
+    {
+    public:
+        // Depth-first over the live devnode tree; a node is visited before
+        // its children are pushed.
+        void EnumerateNodes(const NodeVisitor& visit) override
+        {
+            DEVINST root;
+            if (::CM_Locate_DevNodeW(&root, nullptr, CM_LOCATE_DEVNODE_NORMAL) != CR_SUCCESS)
+                return;
+
+            struct Pending
+            {
+                DEVINST     devInst;
+                std::string parentInstanceId;
+            };
+
+            std::vector<Pending> stack{ { root, {} } };
+            while (!stack.empty())
+            {
+                Pending pending = std::move(stack.back());
+                stack.pop_back();
+
+                std::string instanceId = GetDevNodeInstanceId(pending.devInst);
+                if (instanceId.empty())
+                    continue;
+
+                visit(instanceId, pending.parentInstanceId);
+
+                DEVINST child;
+                if (::CM_Get_Child(&child, pending.devInst, 0) != CR_SUCCESS)
+                    continue;
+
+                do
+                {
+                    stack.push_back({ child, instanceId });
+                } while (::CM_Get_Sibling(&child, child, 0) == CR_SUCCESS);
+            }
+        }
+
+        void EnumerateInterfaces(const DeviceGuid& interfaceClass, const InterfaceVisitor& visit) override
+        {
+            GUID guid;
+            std::memcpy(&guid, &interfaceClass, sizeof(guid));
+
+            for (const std::string& interfacePath : GetDeviceInterfaces(&guid))
+                visit(interfacePath, GetDeviceFromInterface(interfacePath));
+        }
+
+        std::vector<uint8_t> GetProperty(std::string_view instanceId, const DevicePropertyKey& key, uint32_t type) override
+        {
+            DEVPROPKEY propertyKey;
+            std::memcpy(&propertyKey.fmtid, &key.fmtid, sizeof(propertyKey.fmtid));
+            propertyKey.pid = key.pid;
+
+            return GetDevNodeProperty(OpenDevNode(instanceId), &propertyKey, type);
+        }
+    };
+}
+
+std::shared_ptr<DeviceTreeSource> CreateSystemDeviceTreeSource()
+{
+    return std::make_shared<CfgMgrDeviceTreeSource>();
+}
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "DeviceTree.h"
+
 #include <Cfgmgr32.h>
 #include <initguid.h>
 #include <Devpkey.h>
 
-inline std::vector<uint8_t> GetDeviceInterfaceProperty(const std::string& deviceInterfaceName, const DEVPROPKEY* propertyKey, DEVPROPTYPE expectedPropertyType)
+inline std::vector<uint8_t> GetDeviceInterfaceProperty(std::string_view deviceInterfaceName, const DEVPROPKEY* propertyKey, DEVPROPTYPE expectedPropertyType)
 {
     std::wstring devInterface = utf8::widen(deviceInterfaceName);
     DEVPROPTYPE propertyType = DEVPROP_TYPE_EMPTY;
@@ -26,7 +28,7 @@ inline std::vector<uint8_t> GetDeviceInterfaceProperty(const std::string& device
     return propertyData;
 }
 
-inline DEVINST OpenDevNode(const std::string& deviceInstanceId)
+inline DEVINST OpenDevNode(std::string_view deviceInstanceId)
 {
     std::wstring devInstance = utf8::widen(deviceInstanceId);
     DEVINST devNodeHandle;
@@ -58,26 +60,31 @@ inline std::vector<uint8_t> GetDevNodeProperty(DEVINST devInst, const DEVPROPKEY
     return propertyData;
 }
 
-template<typename T> T PropertyDataCast(const std::vector<uint8_t>& propertyData)
+// Property bytes may come unaligned out of a DeviceTree cache, so values are
+// copied out rather than read in place.
+template<typename T> T PropertyDataCast(std::span<const uint8_t> propertyData)
 {
-    if (propertyData.empty())
+    if (propertyData.size() < sizeof(T))
         return {};
 
-    return *const_cast<T*>(reinterpret_cast<const T*>(propertyData.data()));
+    T value;
+    std::memcpy(&value, propertyData.data(), sizeof(T));
+    return value;
 }
 
-template<> inline std::wstring PropertyDataCast(const std::vector<uint8_t>& propertyData)
+template<> inline std::wstring PropertyDataCast(std::span<const uint8_t> propertyData)
 {
     if (propertyData.empty())
         return {};
 
     const size_t len = propertyData.size() / sizeof(std::wstring::value_type) - 1;
-    std::wstring wstr(reinterpret_cast<const std::wstring::value_type*>(propertyData.data()), len);
+    std::wstring wstr(len, L'\0');
+    std::memcpy(wstr.data(), propertyData.data(), len * sizeof(std::wstring::value_type));
 
-    return std::move(wstr);
+    return wstr;
 }
 
-template<> inline std::string PropertyDataCast(const std::vector<uint8_t>& propertyData)
+template<> inline std::string PropertyDataCast(std::span<const uint8_t> propertyData)
 {
     if (propertyData.empty())
         return {};
@@ -87,7 +94,7 @@ template<> inline std::string PropertyDataCast(const std::vector<uint8_t>& prope
     return utf8::narrow(wstr.data(), wstr.size());
 }
 
-template<> inline std::vector<std::string> PropertyDataCast(const std::vector<uint8_t>& propertyData)
+template<> inline std::vector<std::string> PropertyDataCast(std::span<const uint8_t> propertyData)
 {
     std::string strList(PropertyDataCast<std::string>(propertyData));
 
@@ -102,63 +109,65 @@ template<> inline std::vector<std::string> PropertyDataCast(const std::vector<ui
     return std::move(outList);
 }
 
-inline std::string GetDeviceInterface(const std::string& deviceInstanceId, LPCGUID intefaceGuid)
+// Present interfaces of a class, of one device or of all devices if
+// `deviceInstanceId` is empty.
+inline std::vector<std::string> GetDeviceInterfaces(LPCGUID intefaceGuid, std::string_view deviceInstanceId = {})
 {
     std::wstring deviceID = utf8::widen(deviceInstanceId);
-    ULONG listSize;
-    CONFIGRET cr = CM_Get_Device_Interface_List_SizeW(&listSize, const_cast<LPGUID>(intefaceGuid), deviceID.data(), CM_GET_DEVICE_INTERFACE_LIST_PRESENT);
-
-    DCHECK(cr == CR_SUCCESS);
+    DEVINSTID_W filter = deviceID.empty() ? nullptr : deviceID.data();
 
-    std::vector<uint8_t> listData(listSize * sizeof(WCHAR), 0);
-    cr = ::CM_Get_Device_Interface_ListW(const_cast<LPGUID>(intefaceGuid), deviceID.data(), reinterpret_cast<PZZWSTR>(listData.data()), listSize, CM_GET_DEVICE_INTERFACE_LIST_PRESENT);
+    std::vector<uint8_t> listData;
+    CONFIGRET cr;
+    do
+    {
+        // The list of all devices may grow between the two calls.
+        ULONG listSize = 0;
+        cr = ::CM_Get_Device_Interface_List_SizeW(&listSize, const_cast<LPGUID>(intefaceGuid), filter, CM_GET_DEVICE_INTERFACE_LIST_PRESENT);
 
-    DCHECK(cr == CR_SUCCESS);
+        DCHECK(cr == CR_SUCCESS);
 
-    auto interfaces = PropertyDataCast<std::vector<std::string>>(listData);
+        listData.assign(listSize * sizeof(WCHAR), 0);
+        cr = ::CM_Get_Device_Interface_ListW(const_cast<LPGUID>(intefaceGuid), filter, reinterpret_cast<PZZWSTR>(listData.data()), listSize, CM_GET_DEVICE_INTERFACE_LIST_PRESENT);
+    } while (cr == CR_BUFFER_SMALL);
 
-    if (interfaces.empty())
-        return {};
+    DCHECK(cr == CR_SUCCESS);
 
-    return interfaces.front();
+    return PropertyDataCast<std::vector<std::string>>(listData);
 }
 
-inline std::string GetParentDevice(const std::string& deviceInstanceId)
+inline std::string GetDeviceFromInterface(std::string_view deviceInterfaceName)
 {
-    DEVINST devNodeHandle = OpenDevNode(deviceInstanceId);
-
-    return PropertyDataCast<std::string>(GetDevNodeProperty(devNodeHandle, &DEVPKEY_Device_Parent, DEVPROP_TYPE_STRING));
+    return PropertyDataCast<std::string>(
+        GetDeviceInterfaceProperty(
+            deviceInterfaceName,
+            &DEVPKEY_Device_InstanceId,
+            DEVPROP_TYPE_STRING));
 }
 
-inline std::string SearchParentDeviceInterface(const std::string& deviceInstanceId, LPCGUID intefaceGuid)
+inline DeviceGuid ToDeviceGuid(const GUID& guid)
 {
-    if (deviceInstanceId.empty())
-        return {};
-
-    std::string interfacePath = GetDeviceInterface(deviceInstanceId, intefaceGuid);
-
-    if (interfacePath.empty())
-    {
-        std::string parentDeviceInstanceId = GetParentDevice(deviceInstanceId);
-        while (!parentDeviceInstanceId.empty())
-        {
-            interfacePath = GetDeviceInterface(parentDeviceInstanceId, intefaceGuid);
-
-            if (!interfacePath.empty())
-                break;
+    static_assert(sizeof(DeviceGuid) == sizeof(GUID));
+    DeviceGuid result;
+    std::memcpy(&result, &guid, sizeof(result));
+    return result;
+}
 
-            parentDeviceInstanceId = GetParentDevice(parentDeviceInstanceId);
-        }
-    }
+inline DevicePropertyKey ToDevicePropertyKey(const DEVPROPKEY& key)
+{
+    return { ToDeviceGuid(key.fmtid), key.pid };
+}
 
-    return interfacePath;
+// DeviceTree counterparts of the functions above: answered from the snapshot
+// and its caches instead of new CfgMgr32 calls.
+inline std::span<const uint8_t> GetDevNodeProperty(const DeviceTree& tree, DeviceTree::NodeId node, const DEVPROPKEY* propertyKey, DEVPROPTYPE expectedPropertyType)
+{
+    return tree.GetProperty(node, ToDevicePropertyKey(*propertyKey), expectedPropertyType);
 }
 
-inline std::string GetDeviceFromInterface(const std::string& deviceInterfaceName)
+inline std::string_view SearchParentDeviceInterface(const DeviceTree& tree, DeviceTree::NodeId node, LPCGUID intefaceGuid, DeviceTree::NodeId* owner = nullptr)
 {
-    return PropertyDataCast<std::string>(
-        GetDeviceInterfaceProperty(
-            deviceInterfaceName,
-            &DEVPKEY_Device_InstanceId,
-            DEVPROP_TYPE_STRING));
+    return tree.SearchParentInterface(node, ToDeviceGuid(*intefaceGuid), owner);
 }
+
+// DeviceTreeSource backed by CfgMgr32.
+std::shared_ptr<DeviceTreeSource> CreateSystemDeviceTreeSource();
@@ -0,0 +1,434 @@
+#include "DescriptorStore.h"
+
+#include "utils_simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+namespace
+{
+    constexpr char     kMagic[8] = { 'H', 'I', 'D', 'D', 'S', 'T', 'O', 'R' };
+    constexpr uint32_t kVersion = 1;
+
+    // Bucket table size grows with the entry count up to 2^kMaxBucketBits
+    // buckets (256 KiB), about one entry per bucket.
+    constexpr uint32_t kMaxBucketBits = 16;
+
+    // wDescriptorLength is 16 bits.
+    constexpr size_t kMaxDescriptorSize = 0xFFFF;
+
+    struct Header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t vidPidCount;
+        uint32_t bucketBits;
+        uint64_t entriesOffset;
+        uint64_t bucketsOffset;
+        uint64_t vidPidsOffset;
+        uint64_t blobsOffset;
+        uint64_t blobsSize;
+    };
+
+    static_assert(sizeof(Header) == 64);
+    static_assert(sizeof(DescriptorStore::Entry) == 24);
+    static_assert(sizeof(DescriptorStore::VidPid) == 8);
+
+    size_t Align8(size_t size)
+    {
+        return (size + 7) & ~size_t(7);
+    }
+
+    uint32_t GetBucket(uint64_t hash, uint32_t bucketBits)
+    {
+        return bucketBits ? static_cast<uint32_t>(hash >> (64 - bucketBits)) : 0;
+    }
+
+    // A span of `count` T at `offset`, or nullopt if it is out of bounds or
+    // misaligned.
+    template<typename T>
+    std::optional<std::span<const T>> GetArray(std::span<const uint8_t> file, uint64_t offset, uint64_t count)
+    {
+        if (offset % alignof(T) || offset > file.size() || count > (file.size() - offset) / sizeof(T))
+            return std::nullopt;
+
+        return std::span<const T>(reinterpret_cast<const T*>(file.data() + offset), static_cast<size_t>(count));
+    }
+
+    bool LessEntry(const DescriptorStore::Entry& a, uint64_t hash) { return a.hash < hash; }
+}
+
+// ---------------------------------------------------------------------------
+// DescriptorStore
+// ---------------------------------------------------------------------------
+
+std::optional<DescriptorStore> DescriptorStore::Open(const std::string& path)
+{
+    std::optional<MappedFile> file = MappedFile::Open(path);
+    if (!file)
+        return std::nullopt;
+
+    const std::span<const uint8_t> data = file->GetData();
+    if (data.size() < sizeof(Header))
+        return std::nullopt;
+
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.bucketBits > kMaxBucketBits)
+        return std::nullopt;
+
+    DescriptorStore store(std::move(*file));
+
+    const auto entries = GetArray<Entry>(data, header.entriesOffset, header.entryCount);
+    const auto buckets = GetArray<uint32_t>(data, header.bucketsOffset, (uint64_t(1) << header.bucketBits) + 1);
+    const auto vidPids = GetArray<VidPid>(data, header.vidPidsOffset, header.vidPidCount);
+    const auto blobs = GetArray<uint8_t>(data, header.blobsOffset, header.blobsSize);
+    if (!entries || !buckets || !vidPids || !blobs)
+        return std::nullopt;
+
+    // Find() binary-searches within a bucket and FindByVidPid() over the
+    // whole table, so both orders are checked along with the bounds.
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        const Entry& entry = (*entries)[i];
+        if (entry.offset > blobs->size() || entry.size > blobs->size() - entry.offset)
+            return std::nullopt;
+
+        if (i && entry.hash < (*entries)[i - 1].hash)
+            return std::nullopt;
+    }
+
+    if (buckets->front() != 0 || buckets->back() != header.entryCount)
+        return std::nullopt;
+
+    for (size_t bucket = 0; bucket + 1 < buckets->size(); ++bucket)
+    {
+        const uint32_t first = (*buckets)[bucket];
+        const uint32_t last = (*buckets)[bucket + 1];
+        if (last < first || last > header.entryCount)
+            return std::nullopt;
+
+        for (uint32_t i = first; i < last; ++i)
+        {
+            if (GetBucket((*entries)[i].hash, header.bucketBits) != bucket)
+                return std::nullopt;
+        }
+    }
+
+    for (size_t i = 0; i < vidPids->size(); ++i)
+    {
+        if ((*vidPids)[i].entry >= header.entryCount || (i && (*vidPids)[i].vidPid < (*vidPids)[i - 1].vidPid))
+            return std::nullopt;
+    }
+
+    store.m_Entries = *entries;
+    store.m_Buckets = *buckets;
+    store.m_BucketBits = header.bucketBits;
+    store.m_VidPids = *vidPids;
+    store.m_Blobs = *blobs;
+    return store;
+}
+
+uint64_t DescriptorStore::Hash(std::span<const uint8_t> descriptor)
+{
+    return simd::HashBytes(descriptor.data(), descriptor.size());
+}
+
+std::span<const DescriptorStore::Entry> DescriptorStore::Find(uint64_t hash) const
+{
+    if (m_Entries.empty())
+        return {};
+
+    // The bucket narrows the search to a handful of entries.
+    const uint32_t bucket = GetBucket(hash, m_BucketBits);
+    const auto first = m_Entries.begin() + m_Buckets[bucket];
+    const auto last = m_Entries.begin() + m_Buckets[bucket + 1];
+
+    const auto begin = std::lower_bound(first, last, hash, LessEntry);
+    auto end = begin;
+    while (end != last && end->hash == hash)
+        ++end;
+
+    return { begin, end };
+}
+
+const DescriptorStore::Entry* DescriptorStore::Find(std::span<const uint8_t> descriptor) const
+{
+    for (const Entry& entry : Find(Hash(descriptor)))
+    {
+        const std::span<const uint8_t> stored = GetDescriptor(entry);
+        if (std::equal(stored.begin(), stored.end(), descriptor.begin(), descriptor.end()))
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+std::span<const DescriptorStore::VidPid> DescriptorStore::FindByVidPid(uint16_t vendorId, uint16_t productId) const
+{
+    const uint32_t key = (uint32_t(vendorId) << 16) | productId;
+    const auto [begin, end] = std::equal_range(m_VidPids.begin(), m_VidPids.end(), VidPid{ key, 0 },
+        [](const VidPid& a, const VidPid& b) { return a.vidPid < b.vidPid; });
+
+    return { begin, end };
+}
+
+// ---------------------------------------------------------------------------
+// DescriptorStoreBuilder
+// ---------------------------------------------------------------------------
+
+size_t DescriptorStoreBuilder::AddEntry(std::span<const uint8_t> descriptor, uint32_t copies)
+{
+    const uint64_t hash = DescriptorStore::Hash(descriptor);
+
+    auto [it, end] = m_ByHash.equal_range(hash);
+    for (; it != end; ++it)
+    {
+        Entry& entry = m_Entries[it->second];
+        const uint8_t* stored = m_Blobs.data() + entry.offset;
+        if (std::equal(stored, stored + entry.size, descriptor.begin(), descriptor.end()))
+        {
+            entry.copies += copies;
+            return it->second;
+        }
+    }
+
+    Entry entry;
+    entry.hash = hash;
+    entry.offset = m_Blobs.size();
+    entry.size = static_cast<uint32_t>(descriptor.size());
+    entry.copies = copies;
+    m_Blobs.insert(m_Blobs.end(), descriptor.begin(), descriptor.end());
+
+    m_Entries.push_back(entry);
+    m_ByHash.emplace(hash, m_Entries.size() - 1);
+    return m_Entries.size() - 1;
+}
+
+uint64_t DescriptorStoreBuilder::Add(std::span<const uint8_t> descriptor)
+{
+    return m_Entries[AddEntry(descriptor, 1)].hash;
+}
+
+uint64_t DescriptorStoreBuilder::Add(std::span<const uint8_t> descriptor, uint16_t vendorId, uint16_t productId)
+{
+    const size_t index = AddEntry(descriptor, 1);
+    m_VidPids.push_back(DescriptorStore::VidPid{ (uint32_t(vendorId) << 16) | productId, static_cast<uint32_t>(index) });
+    return m_Entries[index].hash;
+}
+
+void DescriptorStoreBuilder::Merge(const DescriptorStore& store)
+{
+    std::vector<uint32_t> indices;
+    indices.reserve(store.GetEntries().size());
+    for (const DescriptorStore::Entry& entry : store.GetEntries())
+        indices.push_back(static_cast<uint32_t>(AddEntry(store.GetDescriptor(entry), entry.copies)));
+
+    for (const DescriptorStore::VidPid& vidPid : store.GetVidPids())
+        m_VidPids.push_back(DescriptorStore::VidPid{ vidPid.vidPid, indices[vidPid.entry] });
+}
+
+bool DescriptorStoreBuilder::Write(const std::string& path) const
+{
+    // Entry order: by hash, ties broken by content so the file only depends
+    // on what was added, not in which order.
+    std::vector<uint32_t> order(m_Entries.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+        {
+            const Entry& x = m_Entries[a];
+            const Entry& y = m_Entries[b];
+            if (x.hash != y.hash)
+                return x.hash < y.hash;
+            return std::lexicographical_compare(m_Blobs.begin() + x.offset, m_Blobs.begin() + x.offset + x.size,
+                m_Blobs.begin() + y.offset, m_Blobs.begin() + y.offset + y.size);
+        });
+
+    std::vector<uint32_t> newIndex(m_Entries.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+        newIndex[order[i]] = i;
+
+    std::vector<DescriptorStore::Entry> entries(m_Entries.size());
+    uint64_t blobsSize = 0;
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        const Entry& entry = m_Entries[order[i]];
+        entries[i] = DescriptorStore::Entry{ entry.hash, blobsSize, entry.size, entry.copies };
+        blobsSize += Align8(entry.size);
+    }
+
+    const uint32_t bucketBits = std::min<uint32_t>(kMaxBucketBits, static_cast<uint32_t>(std::bit_width(entries.size())));
+    std::vector<uint32_t> buckets((size_t(1) << bucketBits) + 1);
+    for (size_t bucket = 0, entry = 0; bucket < buckets.size(); ++bucket)
+    {
+        while (entry < entries.size() && GetBucket(entries[entry].hash, bucketBits) < bucket)
+            ++entry;
+        buckets[bucket] = static_cast<uint32_t>(entry);
+    }
+
+    std::vector<DescriptorStore::VidPid> vidPids;
+    vidPids.reserve(m_VidPids.size());
+    for (const DescriptorStore::VidPid& vidPid : m_VidPids)
+        vidPids.push_back(DescriptorStore::VidPid{ vidPid.vidPid, newIndex[vidPid.entry] });
+    std::sort(vidPids.begin(), vidPids.end(), [](const auto& a, const auto& b) { return a.vidPid != b.vidPid ? a.vidPid < b.vidPid : a.entry < b.entry; });
+    vidPids.erase(std::unique(vidPids.begin(), vidPids.end(), [](const auto& a, const auto& b) { return a.vidPid == b.vidPid && a.entry == b.entry; }), vidPids.end());
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.vidPidCount = static_cast<uint32_t>(vidPids.size());
+    header.bucketBits = bucketBits;
+    header.entriesOffset = sizeof(Header);
+    header.bucketsOffset = header.entriesOffset + entries.size() * sizeof(DescriptorStore::Entry);
+    header.vidPidsOffset = Align8(header.bucketsOffset + buckets.size() * sizeof(uint32_t));
+    header.blobsOffset = header.vidPidsOffset + vidPids.size() * sizeof(DescriptorStore::VidPid);
+    header.blobsSize = blobsSize;
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        const char padding[8] = {};
+        auto write = [&out](const void* data, size_t size) { out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)); };
+
+        write(&header, sizeof(header));
+        write(entries.data(), entries.size() * sizeof(DescriptorStore::Entry));
+        write(buckets.data(), buckets.size() * sizeof(uint32_t));
+        write(padding, header.vidPidsOffset - (header.bucketsOffset + buckets.size() * sizeof(uint32_t)));
+        write(vidPids.data(), vidPids.size() * sizeof(DescriptorStore::VidPid));
+
+        for (uint32_t index : order)
+        {
+            const Entry& entry = m_Entries[index];
+            write(m_Blobs.data() + entry.offset, entry.size);
+            write(padding, Align8(entry.size) - entry.size);
+        }
+
+        if (!out.flush())
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+// ---------------------------------------------------------------------------
+// Ingest
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    // Read to EOF: sysfs reports a size of 4096 for report_descriptor
+    // whatever the descriptor's length, and procfs-like files report 0.
+    std::optional<std::vector<uint8_t>> ReadDump(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return std::nullopt;
+
+        std::vector<uint8_t> bytes;
+        for (std::istreambuf_iterator<char> it(in), end; it != end; ++it)
+        {
+            if (bytes.size() == kMaxDescriptorSize)
+                return std::nullopt;
+            bytes.push_back(static_cast<uint8_t>(*it));
+        }
+
+        if (bytes.empty())
+            return std::nullopt;
+
+        return bytes;
+    }
+
+    // HID_ID=0003:0000045E:000002EA in a sysfs uevent.
+    bool ReadUeventIds(const std::filesystem::path& path, uint16_t& vendorId, uint16_t& productId)
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            unsigned bus = 0, vendor = 0, product = 0;
+            if (line.rfind("HID_ID=", 0) == 0 && std::sscanf(line.c_str() + 7, "%x:%x:%x", &bus, &vendor, &product) == 3)
+            {
+                vendorId = static_cast<uint16_t>(vendor);
+                productId = static_cast<uint16_t>(product);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // VID_045E ... PID_02EA anywhere in a path, in either case.
+    bool ParsePathIds(std::string path, uint16_t& vendorId, uint16_t& productId)
+    {
+        std::transform(path.begin(), path.end(), path.begin(), [](char c) { return (c >= 'a' && c <= 'z') ? char(c - 'a' + 'A') : c; });
+
+        const size_t vid = path.rfind("VID_");
+        const size_t pid = path.rfind("PID_");
+        unsigned vendor = 0, product = 0;
+        if (vid == std::string::npos || pid == std::string::npos
+            || std::sscanf(path.c_str() + vid + 4, "%4x", &vendor) != 1
+            || std::sscanf(path.c_str() + pid + 4, "%4x", &product) != 1)
+            return false;
+
+        vendorId = static_cast<uint16_t>(vendor);
+        productId = static_cast<uint16_t>(product);
+        return true;
+    }
+}
+
+DescriptorIngestStats IngestDescriptorDumps(DescriptorStoreBuilder& builder, const std::filesystem::path& root)
+{
+    DescriptorIngestStats stats;
+
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, std::filesystem::directory_options::skip_permission_denied, error);
+        !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+        if (!it->is_regular_file(error))
+            continue;
+
+        const std::filesystem::path& path = it->path();
+        uint16_t vendorId = 0, productId = 0;
+        bool hasIds;
+        if (path.filename() == "report_descriptor")
+            hasIds = ReadUeventIds(path.parent_path() / "uevent", vendorId, productId);
+        else if (path.filename() == "uevent")
+            continue;
+        else if (!(hasIds = ParsePathIds(path.generic_string(), vendorId, productId)))
+            continue;
+
+        ++stats.files;
+
+        const std::optional<std::vector<uint8_t>> descriptor = ReadDump(path);
+        if (!descriptor)
+        {
+            ++stats.skipped;
+            continue;
+        }
+
+        const size_t before = builder.GetCount();
+        if (hasIds)
+            builder.Add(*descriptor, vendorId, productId);
+        else
+            builder.Add(*descriptor);
+
+        if (builder.GetCount() > before)
+            ++stats.added;
+        else
+            ++stats.duplicates;
+    }
+
+    return stats;
+}
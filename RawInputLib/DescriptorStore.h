@@ -0,0 +1,122 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A corpus of HID report descriptors in one file, stored once per distinct
+// content and addressed by its hash (simd::HashBytes).
+//
+// Layout, all little-endian and 8-byte aligned:
+//
+//   Header
+//   Entry[entryCount]           sorted by (hash, bytes)
+//   uint32_t[buckets + 1]       first entry of each top-`bucketBits` hash prefix
+//   VidPid[vidPidCount]         sorted by (vidPid, entry)
+//   descriptor bytes            in entry order, each padded to 8 bytes
+//
+// The store is memory-mapped and read in place. Descriptors are laid out in
+// entry order, so walking GetEntries() reads the file front to back.
+class DescriptorStore
+{
+public:
+    struct Entry
+    {
+        uint64_t hash = 0;
+        uint64_t offset = 0; // from the start of the descriptor bytes
+        uint32_t size = 0;
+        uint32_t copies = 0; // times it was ingested
+    };
+
+    struct VidPid
+    {
+        uint32_t vidPid = 0; // vendor << 16 | product
+        uint32_t entry = 0;  // index into GetEntries()
+    };
+
+    // nullopt if the file cannot be mapped or is not a valid store. Every
+    // offset and the order of the tables are checked here, so lookups never
+    // read out of bounds or miss an entry.
+    static std::optional<DescriptorStore> Open(const std::string& path);
+
+    static uint64_t Hash(std::span<const uint8_t> descriptor);
+
+    std::span<const Entry> GetEntries() const { return m_Entries; }
+    std::span<const uint8_t> GetDescriptor(const Entry& entry) const { return m_Blobs.subspan(entry.offset, entry.size); }
+
+    // Entries with this hash; almost always zero or one.
+    std::span<const Entry> Find(uint64_t hash) const;
+    const Entry* Find(std::span<const uint8_t> descriptor) const;
+
+    // Descriptors seen on devices with this VID/PID.
+    std::span<const VidPid> FindByVidPid(uint16_t vendorId, uint16_t productId) const;
+    std::span<const VidPid> GetVidPids() const { return m_VidPids; }
+
+private:
+    DescriptorStore(MappedFile file) : m_File(std::move(file)) {}
+
+    MappedFile               m_File;
+    std::span<const Entry>   m_Entries;
+    std::span<const uint32_t> m_Buckets;
+    uint32_t                 m_BucketBits = 0;
+    std::span<const VidPid>  m_VidPids;
+    std::span<const uint8_t> m_Blobs;
+};
+
+// Collects descriptors in memory and writes them out as a DescriptorStore.
+class DescriptorStoreBuilder
+{
+public:
+    // Returns the descriptor's hash. A descriptor already added only has
+    // its copy count raised and the VID/PID recorded.
+    uint64_t Add(std::span<const uint8_t> descriptor);
+    uint64_t Add(std::span<const uint8_t> descriptor, uint16_t vendorId, uint16_t productId);
+
+    // Adds everything in `store`, so a corpus can be grown and rewritten.
+    void Merge(const DescriptorStore& store);
+
+    size_t GetCount() const { return m_Entries.size(); }
+
+    // Writes to `path` through a temporary file, so readers of an older
+    // store at `path` never see a partial one.
+    bool Write(const std::string& path) const;
+
+private:
+    struct Entry
+    {
+        uint64_t hash = 0;
+        size_t   offset = 0; // into m_Blobs
+        uint32_t size = 0;
+        uint32_t copies = 0;
+    };
+
+    size_t AddEntry(std::span<const uint8_t> descriptor, uint32_t copies);
+
+    std::vector<uint8_t>                        m_Blobs;
+    std::vector<Entry>                          m_Entries;
+    std::unordered_multimap<uint64_t, size_t>   m_ByHash; // hash → m_Entries index
+    std::vector<DescriptorStore::VidPid>        m_VidPids; // may hold duplicates until Write
+};
+
+struct DescriptorIngestStats
+{
+    size_t files = 0;
+    size_t added = 0;      // new to the builder
+    size_t duplicates = 0; // already in it
+    size_t skipped = 0;    // unreadable, empty or too large
+};
+
+// Walks `root` recursively and adds every descriptor dump found:
+//   report_descriptor  a sysfs dump (/sys/class/hidraw/*/device); the IDs
+//                      come from HID_ID in the `uevent` next to it
+//   any other file     with VID_xxxx and PID_xxxx in its path, a raw dump
+//                      such as one of GetUsbHidReportDescriptor(); the IDs
+//                      come from the path
+DescriptorIngestStats IngestDescriptorDumps(DescriptorStoreBuilder& builder, const std::filesystem::path& root);
@@ -0,0 +1,223 @@
+#include "DevicePath.h"
+
+#include "utils_arena.h"
+#include "utils_simd.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+    char ToLowerAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    int HexDigitValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        c = ToLowerAscii(c);
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    bool StartsWithNoCase(std::string_view s, std::string_view prefix)
+    {
+        if (s.size() < prefix.size())
+            return false;
+        for (size_t i = 0; i < prefix.size(); ++i)
+            if (ToLowerAscii(s[i]) != ToLowerAscii(prefix[i]))
+                return false;
+        return true;
+    }
+
+    // Fields of a device ID are joined by '&'; Bluetooth IDs also use '_'.
+    bool IsFieldBoundary(char c)
+    {
+        return c == '&' || c == '_';
+    }
+
+    // Matches `key` followed by 1..maxDigits hex digits that run up to a field
+    // boundary. Returns the number of characters consumed, 0 if no match.
+    template<typename T>
+    size_t ParseHexField(std::string_view field, std::string_view key, size_t maxDigits, std::optional<T>& out)
+    {
+        if (!StartsWithNoCase(field, key))
+            return 0;
+
+        uint32_t value = 0;
+        size_t pos = key.size();
+        for (; pos < field.size() && pos - key.size() < maxDigits; ++pos)
+        {
+            const int digit = HexDigitValue(field[pos]);
+            if (digit < 0)
+                break;
+            value = (value << 4) | static_cast<uint32_t>(digit);
+        }
+
+        if (pos == key.size() || (pos < field.size() && !IsFieldBoundary(field[pos])))
+            return 0;
+
+        // Truncation keeps the low bits: the vendor ID without its source.
+        out = static_cast<T>(value);
+        return pos;
+    }
+
+    size_t ParseDeviceIdField(std::string_view field, DevicePathInfo& info)
+    {
+        if (size_t n = ParseHexField(field, "VID_", 4, info.vendorId)) return n;
+        if (size_t n = ParseHexField(field, "VID&", 8, info.vendorId)) return n; // source + vendor ID
+        if (size_t n = ParseHexField(field, "PID_", 4, info.productId)) return n;
+        if (size_t n = ParseHexField(field, "PID&", 4, info.productId)) return n;
+        if (size_t n = ParseHexField(field, "REV_", 4, info.revision)) return n;
+        if (size_t n = ParseHexField(field, "REV&", 4, info.revision)) return n;
+        if (size_t n = ParseHexField(field, "MI_", 2, info.interfaceNumber)) return n;
+        if (size_t n = ParseHexField(field, "Col", 2, info.collection)) return n;
+        return 0;
+    }
+
+    void ParseDeviceId(std::string_view id, DevicePathInfo& info)
+    {
+        size_t pos = 0;
+        while (pos < id.size())
+        {
+            pos += ParseDeviceIdField(id.substr(pos), info);
+            while (pos < id.size() && !IsFieldBoundary(id[pos]))
+                ++pos;
+            ++pos;
+        }
+    }
+
+    // "{guid}\reference" or "{guid}"
+    void ParseInterfaceClass(std::string_view segment, DevicePathInfo& info)
+    {
+        if (segment.empty() || segment.front() != '{')
+            return;
+
+        const size_t close = segment.find('}');
+        if (close == std::string_view::npos)
+            return;
+
+        info.interfaceGuid = segment.substr(0, close + 1);
+        if (close + 1 < segment.size() && segment[close + 1] == '\\')
+            info.reference = segment.substr(close + 2);
+    }
+
+    struct NoCaseHash
+    {
+        size_t operator()(std::string_view s) const
+        {
+            return static_cast<size_t>(simd::HashNoCase(s.data(), s.size()));
+        }
+    };
+
+    struct NoCaseEqual
+    {
+        bool operator()(std::string_view a, std::string_view b) const
+        {
+            return a.size() == b.size() && simd::CompareNoCase(a.data(), b.data(), a.size()) == 0;
+        }
+    };
+
+    // Entries and their strings live in the arena; the map only indexes them.
+    struct DevicePathPool
+    {
+        std::shared_mutex mutex;
+        ChunkedArena      arena{ 16 * 1024 };
+        std::unordered_map<std::string_view, const void*, NoCaseHash, NoCaseEqual> entries;
+    };
+
+    DevicePathPool& GetDevicePathPool()
+    {
+        static DevicePathPool pool;
+        return pool;
+    }
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Parser
+// ---------------------------------------------------------------------------
+
+DevicePathInfo ParseDevicePath(std::string_view path)
+{
+    DevicePathInfo info;
+
+    // Interface paths separate their parts with '#', IDs with '\'.
+    char separator = '\\';
+    if (path.size() >= 4 && path[0] == '\\' && (path[1] == '\\' || path[1] == '?') && path[2] == '?' && path[3] == '\\')
+    {
+        path.remove_prefix(4);
+        separator = '#';
+    }
+
+    // bus, device ID, instance, interface class; the last one takes the rest.
+    std::string_view segments[4];
+    size_t count = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= path.size(); ++i)
+    {
+        if (i == path.size() || (path[i] == separator && count + 1 < std::size(segments)))
+        {
+            segments[count++] = path.substr(start, i - start);
+            start = i + 1;
+        }
+    }
+
+    info.bus = segments[0];
+    info.deviceId = segments[1];
+    info.instance = segments[2];
+
+    ParseDeviceId(info.deviceId, info);
+    if (separator == '#')
+        ParseInterfaceClass(segments[3], info);
+
+    return info;
+}
+
+// ---------------------------------------------------------------------------
+// Intern pool
+// ---------------------------------------------------------------------------
+
+DevicePath::DevicePath()
+{
+    static const Entry empty{ "", {}, 0 };
+    m_Entry = &empty;
+}
+
+// static
+DevicePath DevicePath::Intern(std::string_view path)
+{
+    if (path.empty())
+        return DevicePath();
+
+    DevicePathPool& pool = GetDevicePathPool();
+
+    {
+        std::shared_lock lock(pool.mutex);
+        auto it = pool.entries.find(path);
+        if (it != pool.entries.end())
+            return DevicePath(static_cast<const Entry*>(it->second));
+    }
+
+    std::unique_lock lock(pool.mutex);
+    auto it = pool.entries.find(path);
+    if (it != pool.entries.end())
+        return DevicePath(static_cast<const Entry*>(it->second));
+
+    Entry& entry = pool.arena.Allocate<Entry>(1)[0];
+    entry.path = pool.arena.CopyString(path);
+    entry.info = ParseDevicePath(entry.path);
+    entry.id = static_cast<uint32_t>(pool.entries.size() + 1);
+
+    pool.entries.emplace(entry.path, &entry);
+    return DevicePath(&entry);
+}
+
+// static
+size_t DevicePath::GetInternedCount()
+{
+    DevicePathPool& pool = GetDevicePathPool();
+    std::shared_lock lock(pool.mutex);
+    return pool.entries.size();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// Parts of a PnP device path. Accepts interface paths as well as the device
+// instance and hardware IDs they are derived from:
+//
+//   \\?\HID#VID_203A&PID_FFFC&MI_01&Col02#7&2de99099&0&0000#{378de44c-56ef-11d1-bc8c-00a0c91405dd}\KBD
+//   HID\VID_203A&PID_FFFC&MI_01&Col02\7&2de99099&0&0000
+//   HID\VID_203A&PID_FFFC&REV_0100&MI_01&Col02
+//
+// Bluetooth spellings (`VID&0002054c_PID&09cc`, `_Dev_VID&02045e_PID&0b13`)
+// carry the vendor ID source in front of the vendor ID; only the low 16 bits
+// are kept.
+//
+// The views point into the parsed string.
+struct DevicePathInfo
+{
+    std::string_view bus;           // "HID", "USB", "BTHLEDEVICE", ...
+    std::string_view deviceId;      // "VID_203A&PID_FFFC&MI_01&Col02"
+    std::string_view instance;      // "7&2de99099&0&0000"
+    std::string_view interfaceGuid; // "{378de44c-...}", interface paths only
+    std::string_view reference;     // "KBD", text after the interface GUID
+
+    std::optional<uint16_t> vendorId;
+    std::optional<uint16_t> productId;
+    std::optional<uint16_t> revision;
+    std::optional<uint8_t>  interfaceNumber; // MI_xx
+    std::optional<uint8_t>  collection;      // Colxx
+
+    bool IsInterfacePath() const { return !interfaceGuid.empty(); }
+};
+
+// Splits `path` in one pass. Never fails: fields that are not present, or do
+// not parse, are left empty.
+DevicePathInfo ParseDevicePath(std::string_view path);
+
+// Process-wide interned device path.
+//
+// Interning the same path twice (compared case-insensitively, as Windows does)
+// yields the same entry, so handles compare by pointer and the string and its
+// parsed parts are computed once. Entries are never released: the set of
+// device paths a process sees is small and bounded by the hardware plugged in.
+// Copying a handle and reading through it take no locks.
+class DevicePath
+{
+public:
+    // Empty path.
+    DevicePath();
+
+    static DevicePath Intern(std::string_view path);
+
+    // NUL-terminated, valid for the lifetime of the process.
+    std::string_view GetString() const { return m_Entry->path; }
+    const DevicePathInfo& GetInfo() const { return m_Entry->info; }
+
+    // Dense, starting at 1 in interning order; 0 for the empty path.
+    uint32_t GetId() const { return m_Entry->id; }
+
+    bool IsEmpty() const { return m_Entry->path.empty(); }
+
+    bool operator==(const DevicePath& other) const { return m_Entry == other.m_Entry; }
+    bool operator!=(const DevicePath& other) const { return m_Entry != other.m_Entry; }
+
+    // Number of distinct paths interned so far.
+    static size_t GetInternedCount();
+
+private:
+    struct Entry
+    {
+        std::string_view path;
+        DevicePathInfo   info;
+        uint32_t         id = 0;
+    };
+
+    explicit DevicePath(const Entry* entry) : m_Entry(entry) {}
+
+    const Entry* m_Entry;
+};
@@ -0,0 +1,254 @@
+#include "DeviceTree.h"
+
+#include "utils_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+// ---------------------------------------------------------------------------
+// DeviceTree
+// ---------------------------------------------------------------------------
+
+size_t DeviceTree::NoCaseHash::operator()(std::string_view s) const
+{
+    return static_cast<size_t>(simd::HashNoCase(s.data(), s.size()));
+}
+
+bool DeviceTree::NoCaseEqual::operator()(std::string_view a, std::string_view b) const
+{
+    return a.size() == b.size() && simd::CompareNoCase(a.data(), b.data(), a.size()) == 0;
+}
+
+size_t DeviceTree::PropertyIdHash::operator()(const PropertyId& id) const
+{
+    uint64_t words[3];
+    std::memcpy(words, &id.key.fmtid, sizeof(DeviceGuid));
+    words[2] = (uint64_t(id.node) << 32) | id.key.pid;
+
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (uint64_t w : words)
+    {
+        h ^= w;
+        h *= 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+    return static_cast<size_t>(h);
+}
+
+DeviceTree::DeviceTree(std::shared_ptr<DeviceTreeSource> source)
+    : m_Source(std::move(source))
+{}
+
+// static
+std::shared_ptr<const DeviceTree> DeviceTree::Snapshot(std::shared_ptr<DeviceTreeSource> source)
+{
+    std::shared_ptr<DeviceTree> tree(new DeviceTree(std::move(source)));
+    tree->Build();
+    return tree;
+}
+
+void DeviceTree::Build()
+{
+    m_Source->EnumerateNodes([this](std::string_view instanceId, std::string_view parentInstanceId)
+        {
+            if (m_NodeIndex.count(instanceId))
+                return;
+
+            Node node;
+            node.instanceId = m_InstanceIds.CopyString(instanceId);
+            node.parent = parentInstanceId.empty() ? kNoNode : FindNode(parentInstanceId);
+
+            const NodeId id = static_cast<NodeId>(m_Nodes.size());
+            m_Nodes.push_back(node);
+            m_NodeIndex.emplace(node.instanceId, id);
+        });
+
+    // Children as one array, each node owning a contiguous range of it.
+    for (const Node& node : m_Nodes)
+        if (node.parent != kNoNode)
+            ++m_Nodes[node.parent].childCount;
+
+    uint32_t offset = 0;
+    for (Node& node : m_Nodes)
+    {
+        node.firstChild = offset;
+        offset += node.childCount;
+        node.childCount = 0;
+    }
+
+    m_Children.resize(offset);
+    for (NodeId id = 0; id < m_Nodes.size(); ++id)
+    {
+        const NodeId parent = m_Nodes[id].parent;
+        if (parent != kNoNode)
+        {
+            Node& p = m_Nodes[parent];
+            m_Children[p.firstChild + p.childCount++] = id;
+        }
+    }
+}
+
+DeviceTree::NodeId DeviceTree::FindNode(std::string_view instanceId) const
+{
+    auto it = m_NodeIndex.find(instanceId);
+    return it != m_NodeIndex.end() ? it->second : kNoNode;
+}
+
+const DeviceTree::InterfaceClass& DeviceTree::GetInterfaceClass(const DeviceGuid& interfaceClass) const
+{
+    for (const auto& loaded : m_InterfaceClasses)
+        if (loaded->guid == interfaceClass)
+            return *loaded;
+
+    auto loaded = std::make_unique<InterfaceClass>();
+    loaded->guid = interfaceClass;
+
+    m_Source->EnumerateInterfaces(interfaceClass, [&](std::string_view interfacePath, std::string_view instanceId)
+        {
+            const NodeId node = FindNode(instanceId);
+            if (node == kNoNode || loaded->byNode.count(node))
+                return;
+
+            loaded->byNode.emplace(node, m_Cache.CopyString(interfacePath));
+        });
+
+    m_InterfaceClasses.push_back(std::move(loaded));
+    return *m_InterfaceClasses.back();
+}
+
+std::string_view DeviceTree::GetInterface(NodeId node, const DeviceGuid& interfaceClass) const
+{
+    if (node == kNoNode)
+        return "";
+
+    std::lock_guard lock(m_Mutex);
+    const InterfaceClass& loaded = GetInterfaceClass(interfaceClass);
+
+    auto it = loaded.byNode.find(node);
+    return it != loaded.byNode.end() ? it->second : "";
+}
+
+std::string_view DeviceTree::SearchParentInterface(NodeId node, const DeviceGuid& interfaceClass, NodeId* owner) const
+{
+    std::lock_guard lock(m_Mutex);
+    const InterfaceClass& loaded = GetInterfaceClass(interfaceClass);
+
+    for (; node != kNoNode; node = m_Nodes[node].parent)
+    {
+        auto it = loaded.byNode.find(node);
+        if (it != loaded.byNode.end())
+        {
+            if (owner)
+                *owner = node;
+            return it->second;
+        }
+    }
+
+    if (owner)
+        *owner = kNoNode;
+    return "";
+}
+
+std::span<const uint8_t> DeviceTree::GetProperty(NodeId node, const DevicePropertyKey& key, uint32_t type) const
+{
+    if (node == kNoNode)
+        return {};
+
+    std::lock_guard lock(m_Mutex);
+
+    const PropertyId id{ node, key };
+    auto it = m_Properties.find(id);
+    if (it != m_Properties.end())
+        return it->second;
+
+    const std::vector<uint8_t> value = m_Source->GetProperty(m_Nodes[node].instanceId, key, type);
+    const std::span<const uint8_t> cached = m_Cache.CopyBytes(value);
+    m_Properties.emplace(id, cached);
+    return cached;
+}
+
+// ---------------------------------------------------------------------------
+// LazyDeviceTree
+// ---------------------------------------------------------------------------
+
+const std::shared_ptr<const DeviceTree>& LazyDeviceTree::Get() const
+{
+    std::call_once(m_Once, [this] { m_Tree = DeviceTree::Snapshot(m_Source); });
+    return m_Tree;
+}
+
+// ---------------------------------------------------------------------------
+// FakeDeviceTreeSource
+// ---------------------------------------------------------------------------
+
+void FakeDeviceTreeSource::AddNode(std::string_view instanceId, std::string_view parentInstanceId)
+{
+    m_Nodes.push_back({ std::string(instanceId), std::string(parentInstanceId) });
+}
+
+void FakeDeviceTreeSource::RemoveNode(std::string_view instanceId)
+{
+    TakeSubtree(instanceId);
+}
+
+void FakeDeviceTreeSource::MoveNode(std::string_view instanceId, std::string_view newParentInstanceId)
+{
+    // Appended again, so the new parent is still listed first.
+    std::vector<FakeNode> subtree = TakeSubtree(instanceId);
+    if (subtree.empty())
+        return;
+
+    subtree.front().parent = newParentInstanceId;
+    m_Nodes.insert(m_Nodes.end(), std::make_move_iterator(subtree.begin()), std::make_move_iterator(subtree.end()));
+}
+
+std::vector<FakeDeviceTreeSource::FakeNode> FakeDeviceTreeSource::TakeSubtree(std::string_view instanceId)
+{
+    // Descendants always follow their ancestors, so one pass collects them.
+    std::vector<FakeNode> subtree;
+    std::vector<FakeNode> kept;
+    for (FakeNode& node : m_Nodes)
+    {
+        const bool inSubtree = subtree.empty()
+            ? node.instanceId == instanceId
+            : std::any_of(subtree.begin(), subtree.end(), [&](const FakeNode& taken) { return taken.instanceId == node.parent; });
+        (inSubtree ? subtree : kept).push_back(std::move(node));
+    }
+    m_Nodes = std::move(kept);
+    return subtree;
+}
+
+void FakeDeviceTreeSource::AddInterface(const DeviceGuid& interfaceClass, std::string_view interfacePath, std::string_view instanceId)
+{
+    m_Interfaces.push_back({ interfaceClass, std::string(interfacePath), std::string(instanceId) });
+}
+
+void FakeDeviceTreeSource::SetProperty(std::string_view instanceId, const DevicePropertyKey& key, std::span<const uint8_t> value)
+{
+    m_Properties.push_back({ std::string(instanceId), key, { value.begin(), value.end() } });
+}
+
+void FakeDeviceTreeSource::EnumerateNodes(const NodeVisitor& visit)
+{
+    for (const FakeNode& node : m_Nodes)
+        visit(node.instanceId, node.parent);
+}
+
+void FakeDeviceTreeSource::EnumerateInterfaces(const DeviceGuid& interfaceClass, const InterfaceVisitor& visit)
+{
+    ++m_InterfaceQueries;
+    for (const FakeInterface& entry : m_Interfaces)
+        if (entry.interfaceClass == interfaceClass)
+            visit(entry.path, entry.instanceId);
+}
+
+std::vector<uint8_t> FakeDeviceTreeSource::GetProperty(std::string_view instanceId, const DevicePropertyKey& key, uint32_t)
+{
+    ++m_PropertyQueries;
+    for (const FakeProperty& property : m_Properties)
+        if (property.key == key && property.instanceId.size() == instanceId.size()
+            && simd::CompareNoCase(property.instanceId.data(), instanceId.data(), instanceId.size()) == 0)
+            return property.value;
+    return {};
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "utils_arena.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Same layout as the Windows GUID / DEVPROPKEY, so the Win32 code can
+// memcpy between them.
+struct DeviceGuid
+{
+    uint32_t data1 = 0;
+    uint16_t data2 = 0;
+    uint16_t data3 = 0;
+    uint8_t  data4[8] = {};
+
+    bool operator==(const DeviceGuid&) const = default;
+};
+
+struct DevicePropertyKey
+{
+    DeviceGuid fmtid;
+    uint32_t   pid = 0;
+
+    bool operator==(const DevicePropertyKey&) const = default;
+};
+
+// Where a DeviceTree takes its data from: the system (CfgMgr32 on Windows)
+// or a FakeDeviceTreeSource.
+class DeviceTreeSource
+{
+public:
+    using NodeVisitor = std::function<void(std::string_view instanceId, std::string_view parentInstanceId)>;
+    using InterfaceVisitor = std::function<void(std::string_view interfacePath, std::string_view instanceId)>;
+
+    virtual ~DeviceTreeSource() = default;
+
+    // Every present device node, parents before their children. The root
+    // has an empty parent.
+    virtual void EnumerateNodes(const NodeVisitor& visit) = 0;
+
+    // Every present interface of one class with the node exposing it.
+    virtual void EnumerateInterfaces(const DeviceGuid& interfaceClass, const InterfaceVisitor& visit) = 0;
+
+    // Raw property bytes, empty if the node has no such property. `type` is
+    // the expected DEVPROPTYPE.
+    virtual std::vector<uint8_t> GetProperty(std::string_view instanceId, const DevicePropertyKey& key, uint32_t type) = 0;
+};
+
+// Snapshot of the device tree, indexed for the ancestry queries done while
+// devices initialise ("nearest ancestor exposing a USB device interface").
+//
+// The node hierarchy is read once when the snapshot is taken and is then
+// immutable. Interfaces are listed one class at a time the first time that
+// class is asked for, and properties are read on first access; both are
+// cached for the lifetime of the snapshot. All queries are thread-safe and
+// returned views stay valid as long as the snapshot.
+class DeviceTree
+{
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId kNoNode = UINT32_MAX;
+
+    static std::shared_ptr<const DeviceTree> Snapshot(std::shared_ptr<DeviceTreeSource> source);
+
+    DeviceTree(const DeviceTree&) = delete;
+    void operator=(const DeviceTree&) = delete;
+
+    size_t GetNodeCount() const { return m_Nodes.size(); }
+
+    // Case-insensitive. kNoNode if the node was not present at snapshot time.
+    NodeId FindNode(std::string_view instanceId) const;
+
+    NodeId GetParent(NodeId node) const { return m_Nodes[node].parent; }
+    std::string_view GetInstanceId(NodeId node) const { return m_Nodes[node].instanceId; }
+    std::span<const NodeId> GetChildren(NodeId node) const
+    {
+        return { m_Children.data() + m_Nodes[node].firstChild, m_Nodes[node].childCount };
+    }
+
+    // First interface of the class exposed by `node`, or "".
+    std::string_view GetInterface(NodeId node, const DeviceGuid& interfaceClass) const;
+
+    // First interface of the class exposed by `node` or its nearest ancestor
+    // that has one, or "". `owner` receives the node exposing it.
+    std::string_view SearchParentInterface(NodeId node, const DeviceGuid& interfaceClass, NodeId* owner = nullptr) const;
+
+    // Empty if the node has no such property.
+    std::span<const uint8_t> GetProperty(NodeId node, const DevicePropertyKey& key, uint32_t type) const;
+
+private:
+    explicit DeviceTree(std::shared_ptr<DeviceTreeSource> source);
+
+    struct Node
+    {
+        std::string_view instanceId;
+        NodeId           parent = kNoNode;
+        uint32_t         firstChild = 0;
+        uint32_t         childCount = 0;
+    };
+
+    struct NoCaseHash  { size_t operator()(std::string_view s) const; };
+    struct NoCaseEqual { bool operator()(std::string_view a, std::string_view b) const; };
+
+    struct InterfaceClass
+    {
+        DeviceGuid                                   guid;
+        std::unordered_map<NodeId, std::string_view> byNode;
+    };
+
+    struct PropertyId
+    {
+        NodeId            node;
+        DevicePropertyKey key;
+
+        bool operator==(const PropertyId&) const = default;
+    };
+
+    struct PropertyIdHash { size_t operator()(const PropertyId& id) const; };
+
+    void Build();
+    const InterfaceClass& GetInterfaceClass(const DeviceGuid& interfaceClass) const; // m_Mutex held
+
+    std::shared_ptr<DeviceTreeSource> m_Source;
+
+    // Immutable once built.
+    std::vector<Node>   m_Nodes;
+    std::vector<NodeId> m_Children;
+    std::unordered_map<std::string_view, NodeId, NoCaseHash, NoCaseEqual> m_NodeIndex;
+    ChunkedArena        m_InstanceIds{ 64 * 1024 };
+
+    // Filled on demand.
+    mutable std::mutex                                   m_Mutex;
+    mutable ChunkedArena                                 m_Cache{ 16 * 1024 };
+    mutable std::vector<std::unique_ptr<InterfaceClass>> m_InterfaceClasses;
+    mutable std::unordered_map<PropertyId, std::span<const uint8_t>, PropertyIdHash> m_Properties;
+};
+
+// The snapshot a device resolves its facets against, taken the first time
+// any of them asks. Devices created between two refreshes share one, so a
+// burst of arrivals costs one snapshot and arrivals that are never inspected
+// cost none. Get() is thread-safe.
+class LazyDeviceTree
+{
+public:
+    explicit LazyDeviceTree(std::shared_ptr<DeviceTreeSource> source) : m_Source(std::move(source)) {}
+
+    const std::shared_ptr<const DeviceTree>& Get() const;
+
+private:
+    std::shared_ptr<DeviceTreeSource>         m_Source;
+    mutable std::once_flag                    m_Once;
+    mutable std::shared_ptr<const DeviceTree> m_Tree;
+};
+
+// In-memory DeviceTreeSource for tests and benchmarks. Counts the queries
+// made against it, so callers can check what a snapshot re-reads.
+class FakeDeviceTreeSource : public DeviceTreeSource
+{
+public:
+    // Nodes must be added after their parent; the root has an empty parent.
+    void AddNode(std::string_view instanceId, std::string_view parentInstanceId);
+    // Removes the node and everything below it, as unplugging a hub does.
+    void RemoveNode(std::string_view instanceId);
+    // Moves the node and everything below it under another parent, as a
+    // device re-enumerated behind a different port.
+    void MoveNode(std::string_view instanceId, std::string_view newParentInstanceId);
+    void AddInterface(const DeviceGuid& interfaceClass, std::string_view interfacePath, std::string_view instanceId);
+    void SetProperty(std::string_view instanceId, const DevicePropertyKey& key, std::span<const uint8_t> value);
+
+    void EnumerateNodes(const NodeVisitor& visit) override;
+    void EnumerateInterfaces(const DeviceGuid& interfaceClass, const InterfaceVisitor& visit) override;
+    std::vector<uint8_t> GetProperty(std::string_view instanceId, const DevicePropertyKey& key, uint32_t type) override;
+
+    size_t GetInterfaceQueryCount() const { return m_InterfaceQueries; }
+    size_t GetPropertyQueryCount()  const { return m_PropertyQueries; }
+
+private:
+    struct FakeNode      { std::string instanceId; std::string parent; };
+    struct FakeInterface { DeviceGuid interfaceClass; std::string path; std::string instanceId; };
+    struct FakeProperty  { std::string instanceId; DevicePropertyKey key; std::vector<uint8_t> value; };
+
+    // The node and its descendants, taken out of m_Nodes in order.
+    std::vector<FakeNode> TakeSubtree(std::string_view instanceId);
+
+    std::vector<FakeNode>      m_Nodes;
+    std::vector<FakeInterface> m_Interfaces;
+    std::vector<FakeProperty>  m_Properties;
+
+    size_t m_InterfaceQueries = 0;
+    size_t m_PropertyQueries = 0;
+};
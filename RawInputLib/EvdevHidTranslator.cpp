@@ -0,0 +1,223 @@
+#include "EvdevHidTranslator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    // https://www.kernel.org/doc/html/latest/input/event-codes.html
+    constexpr uint16_t kEvSyn = 0x00;
+    constexpr uint16_t kEvKey = 0x01;
+    constexpr uint16_t kEvRel = 0x02;
+    constexpr uint16_t kSynReport = 0x00;
+    constexpr uint16_t kRelX = 0x00;
+    constexpr uint16_t kRelY = 0x01;
+    constexpr uint16_t kRelHWheel = 0x06;
+    constexpr uint16_t kRelWheel = 0x08;
+    constexpr uint16_t kBtnMouse = 0x110; // BTN_LEFT; BTN_TASK is kBtnMouse + 7
+
+    constexpr uint8_t kKeyboardDescriptor[] = {
+        0x05, 0x01,        // Usage Page (Generic Desktop)
+        0x09, 0x06,        // Usage (Keyboard)
+        0xA1, 0x01,        // Collection (Application)
+        0x05, 0x07,        //   Usage Page (Keyboard/Keypad)
+        0x19, 0x00,        //   Usage Minimum (0)
+        0x29, 0xE7,        //   Usage Maximum (Right GUI)
+        0x15, 0x00,        //   Logical Minimum (0)
+        0x25, 0x01,        //   Logical Maximum (1)
+        0x75, 0x01,        //   Report Size (1)
+        0x95, 0xE8,        //   Report Count (232)
+        0x81, 0x02,        //   Input (Data,Var,Abs)
+        0xC0,              // End Collection
+    };
+
+    constexpr uint8_t kMouseDescriptor[] = {
+        0x05, 0x01,        // Usage Page (Generic Desktop)
+        0x09, 0x02,        // Usage (Mouse)
+        0xA1, 0x01,        // Collection (Application)
+        0x09, 0x01,        //   Usage (Pointer)
+        0xA1, 0x00,        //   Collection (Physical)
+        0x05, 0x09,        //     Usage Page (Button)
+        0x19, 0x01,        //     Usage Minimum (1)
+        0x29, 0x08,        //     Usage Maximum (8)
+        0x15, 0x00,        //     Logical Minimum (0)
+        0x25, 0x01,        //     Logical Maximum (1)
+        0x75, 0x01,        //     Report Size (1)
+        0x95, 0x08,        //     Report Count (8)
+        0x81, 0x02,        //     Input (Data,Var,Abs)
+        0x05, 0x01,        //     Usage Page (Generic Desktop)
+        0x09, 0x30,        //     Usage (X)
+        0x09, 0x31,        //     Usage (Y)
+        0x09, 0x38,        //     Usage (Wheel)
+        0x16, 0x01, 0x80,  //     Logical Minimum (-32767)
+        0x26, 0xFF, 0x7F,  //     Logical Maximum (32767)
+        0x75, 0x10,        //     Report Size (16)
+        0x95, 0x03,        //     Report Count (3)
+        0x81, 0x06,        //     Input (Data,Var,Rel)
+        0x05, 0x0C,        //     Usage Page (Consumer)
+        0x0A, 0x38, 0x02,  //     Usage (AC Pan)
+        0x95, 0x01,        //     Report Count (1)
+        0x81, 0x06,        //     Input (Data,Var,Rel)
+        0xC0,              //   End Collection
+        0xC0,              // End Collection
+    };
+
+    // Keyboard/Keypad usage → evdev key code, as hid_keyboard[] in the
+    // kernel's drivers/hid/hid-input.c; 0 where there is none.
+    constexpr uint8_t kUsageToKey[EvdevHidTranslator::kKeyboardUsages] = {
+          0,  0,  0,  0, 30, 48, 46, 32, 18, 33, 34, 35, 23, 36, 37, 38,
+         50, 49, 24, 25, 16, 19, 31, 20, 22, 47, 17, 45, 21, 44,  2,  3,
+          4,  5,  6,  7,  8,  9, 10, 11, 28,  1, 14, 15, 57, 12, 13, 26,
+         27, 43, 43, 39, 40, 41, 51, 52, 53, 58, 59, 60, 61, 62, 63, 64,
+         65, 66, 67, 68, 87, 88, 99, 70,119,110,102,104,111,107,109,106,
+        105,108,103, 69, 98, 55, 74, 78, 96, 79, 80, 81, 75, 76, 77, 71,
+         72, 73, 82, 83, 86,127,116,117,183,184,185,186,187,188,189,190,
+        191,192,193,194,134,138,130,132,128,129,131,137,133,135,136,113,
+        115,114,  0,  0,  0,121,  0, 89, 93,124, 92, 94, 95,  0,  0,  0,
+        122,123, 90, 91, 85,  0,  0,  0,  0,  0,  0,  0,111,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,179,180,  0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,111,  0,  0,  0,  0,  0,  0,  0,
+         29, 42, 56,125, 97, 54,100,126,
+    };
+
+    // The reverse; where several usages give the same key, the first one.
+    constexpr std::array<uint8_t, 256> kKeyToUsage = []
+    {
+        std::array<uint8_t, 256> table{};
+        for (size_t usage = 0; usage < std::size(kUsageToKey); ++usage)
+        {
+            const uint8_t key = kUsageToKey[usage];
+            if (key != 0 && table[key] == 0)
+                table[key] = static_cast<uint8_t>(usage);
+        }
+        return table;
+    }();
+
+    struct Event
+    {
+        uint16_t type;
+        uint16_t code;
+        int32_t  value;
+    };
+
+    // The fields after struct timeval.
+    Event ReadEvent(const uint8_t* record)
+    {
+        constexpr size_t kTimeBytes = EvdevHidTranslator::kEventSize - 8;
+
+        Event event;
+        std::memcpy(&event.type, record + kTimeBytes, sizeof(event.type));
+        std::memcpy(&event.code, record + kTimeBytes + 2, sizeof(event.code));
+        std::memcpy(&event.value, record + kTimeBytes + 4, sizeof(event.value));
+        return event;
+    }
+
+    void StoreDelta(uint8_t* dst, int32_t delta)
+    {
+        const int16_t v = static_cast<int16_t>(std::clamp<int32_t>(delta, -std::numeric_limits<int16_t>::max(), std::numeric_limits<int16_t>::max()));
+        dst[0] = static_cast<uint8_t>(v);
+        dst[1] = static_cast<uint8_t>(static_cast<uint16_t>(v) >> 8);
+    }
+}
+
+// static
+std::span<const uint8_t> EvdevHidTranslator::GetReportDescriptor(InputBackend::DeviceType type)
+{
+    switch (type)
+    {
+    case InputBackend::DeviceType::Keyboard:
+        return kKeyboardDescriptor;
+    case InputBackend::DeviceType::Mouse:
+        return kMouseDescriptor;
+    default:
+        return {};
+    }
+}
+
+EvdevHidTranslator::EvdevHidTranslator(InputBackend::DeviceType type)
+    : m_Type(type)
+{
+}
+
+std::span<const uint8_t> EvdevHidTranslator::Translate(std::span<const uint8_t> frame)
+{
+    switch (m_Type)
+    {
+    case InputBackend::DeviceType::Keyboard:
+        return TranslateKeyboard(frame);
+    case InputBackend::DeviceType::Mouse:
+        return TranslateMouse(frame);
+    default:
+        return {};
+    }
+}
+
+std::span<const uint8_t> EvdevHidTranslator::TranslateKeyboard(std::span<const uint8_t> frame)
+{
+    bool changed = false;
+    for (size_t offset = 0; offset + kEventSize <= frame.size(); offset += kEventSize)
+    {
+        const Event event = ReadEvent(frame.data() + offset);
+        if (event.type != kEvKey || event.code >= kKeyToUsage.size())
+            continue;
+
+        const uint8_t usage = kKeyToUsage[event.code];
+        if (usage == 0)
+            continue;
+
+        // 1 press, 2 autorepeat, 0 release.
+        const uint8_t bit = static_cast<uint8_t>(1u << (usage % 8));
+        if (event.value != 0)
+            m_Keys[usage / 8] |= bit;
+        else
+            m_Keys[usage / 8] &= static_cast<uint8_t>(~bit);
+        changed = true;
+    }
+
+    return changed ? std::span<const uint8_t>(m_Keys) : std::span<const uint8_t>();
+}
+
+std::span<const uint8_t> EvdevHidTranslator::TranslateMouse(std::span<const uint8_t> frame)
+{
+    bool changed = false;
+    int32_t x = 0, y = 0, wheel = 0, hwheel = 0;
+    for (size_t offset = 0; offset + kEventSize <= frame.size(); offset += kEventSize)
+    {
+        const Event event = ReadEvent(frame.data() + offset);
+        if (event.type == kEvKey && event.code >= kBtnMouse && event.code < kBtnMouse + kMouseButtons)
+        {
+            const uint8_t bit = static_cast<uint8_t>(1u << (event.code - kBtnMouse));
+            m_MouseButtons = static_cast<uint8_t>(event.value != 0 ? (m_MouseButtons | bit) : (m_MouseButtons & ~bit));
+            changed = true;
+        }
+        else if (event.type == kEvRel)
+        {
+            switch (event.code)
+            {
+            case kRelX:      x += event.value; break;
+            case kRelY:      y += event.value; break;
+            case kRelWheel:  wheel += event.value; break;
+            case kRelHWheel: hwheel += event.value; break;
+            default:         continue;
+            }
+            changed = true;
+        }
+        else if (event.type == kEvSyn && event.code == kSynReport)
+        {
+            break;
+        }
+    }
+
+    if (!changed)
+        return {};
+
+    m_MouseReport[0] = m_MouseButtons;
+    StoreDelta(&m_MouseReport[1], x);
+    StoreDelta(&m_MouseReport[3], y);
+    StoreDelta(&m_MouseReport[5], wheel);
+    StoreDelta(&m_MouseReport[7], hwheel);
+    return m_MouseReport;
+}
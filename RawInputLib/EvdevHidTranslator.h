@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InputBackend.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Turns the evdev frames of a Linux keyboard or mouse into HID reports of a
+// fixed descriptor, so that they are decoded by HidReportDecoder like every
+// other device.
+//
+//   Keyboard  one button per Keyboard/Keypad usage 0x00..0xE7, slot == usage;
+//             evdev key codes are mapped as the kernel's hid-input does in
+//             reverse. Autorepeat keeps a key down.
+//   Mouse     buttons 1..8 (BTN_LEFT..BTN_TASK), then relative X, Y, wheel
+//             and horizontal wheel (AC Pan). Deltas of one frame add up and
+//             are clamped to 16 bits.
+//
+// evdev sends changes only, so the keyboard report is the state after every
+// frame seen so far. Absolute axes and other event types are ignored.
+//
+// Platform-independent: frames are the struct input_event layout of the
+// machine's Linux ABI (see kEventSize), also when replayed elsewhere.
+class EvdevHidTranslator
+{
+public:
+    // struct input_event: struct timeval (two longs), type, code, value.
+    static constexpr size_t kEventSize = 2 * sizeof(long) + 8;
+
+    static constexpr size_t kKeyboardUsages = 0xE8;
+    static constexpr size_t kMouseButtons = 8;
+
+    // Empty for device types other than Keyboard and Mouse.
+    static std::span<const uint8_t> GetReportDescriptor(InputBackend::DeviceType type);
+
+    explicit EvdevHidTranslator(InputBackend::DeviceType type);
+
+    // Translates one frame, up to and including its SYN_REPORT. Returns the
+    // report, without Report ID byte, valid until the next call; empty if
+    // the frame carried nothing this device reports.
+    std::span<const uint8_t> Translate(std::span<const uint8_t> frame);
+
+private:
+    static constexpr size_t kKeyboardReportSize = kKeyboardUsages / 8;
+    static constexpr size_t kMouseReportSize = 1 + 4 * sizeof(int16_t);
+
+    std::span<const uint8_t> TranslateKeyboard(std::span<const uint8_t> frame);
+    std::span<const uint8_t> TranslateMouse(std::span<const uint8_t> frame);
+
+    InputBackend::DeviceType m_Type;
+
+    std::array<uint8_t, kKeyboardReportSize> m_Keys{};    // keyboard: key bitmap, kept across frames
+    uint8_t                                  m_MouseButtons = 0;
+    std::array<uint8_t, kMouseReportSize>    m_MouseReport{};
+};
@@ -0,0 +1,79 @@
+#include "HidControlRegistry.h"
+
+#include <algorithm>
+#include <bit>
+
+void HidControlRegistry::Build(std::vector<Entry> entries)
+{
+    m_Entries = std::move(entries);
+
+    std::stable_sort(m_Entries.begin(), m_Entries.end(),
+        [](const Entry& a, const Entry& b) { return PackKey(a) < PackKey(b); });
+
+    // At most two keys per entry (exact + wildcard); keep load factor <= 0.5.
+    const size_t capacity = std::bit_ceil(std::max<size_t>(m_Entries.size() * 4, 8));
+    m_Slots.assign(capacity, Slot{});
+    m_HashShift = 64 - static_cast<uint32_t>(std::countr_zero(capacity));
+
+    for (uint32_t i = 0; i < m_Entries.size(); ++i)
+    {
+        const Entry& e = m_Entries[i];
+
+        // Sorted order guarantees that the first entry wins for duplicates.
+        Insert(PackKey(e), i);
+        Insert(PackKey(e.usagePage, e.usage, kAnyCollection), i);
+    }
+}
+
+void HidControlRegistry::Clear()
+{
+    m_Entries.clear();
+    m_Slots.clear();
+    m_HashShift = 64;
+}
+
+void HidControlRegistry::Insert(uint64_t key, uint32_t entryIndex)
+{
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t s = HashSlot(key); ; s = (s + 1) & mask)
+    {
+        Slot& slot = m_Slots[s];
+        if (slot.entry == kEmptySlot)
+        {
+            slot = { key, entryIndex };
+            return;
+        }
+        if (slot.key == key)
+            return; // keep the first (lowest sorted) entry
+    }
+}
+
+const HidControlRegistry::Entry* HidControlRegistry::Find(uint16_t usagePage, uint16_t usage, uint16_t linkCollection) const
+{
+    if (m_Slots.empty())
+        return nullptr;
+
+    const uint64_t key = PackKey(usagePage, usage, linkCollection);
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t s = HashSlot(key); ; s = (s + 1) & mask)
+    {
+        const Slot& slot = m_Slots[s];
+        if (slot.entry == kEmptySlot)
+            return nullptr;
+        if (slot.key == key)
+            return &m_Entries[slot.entry];
+    }
+}
+
+std::span<const HidControlRegistry::Entry> HidControlRegistry::FindUsagePage(uint16_t usagePage) const
+{
+    const uint64_t lo = PackKey(usagePage, 0, 0);
+    const uint64_t hi = PackKey(usagePage, 0xFFFF, 0xFFFF);
+
+    auto first = std::lower_bound(m_Entries.begin(), m_Entries.end(), lo,
+        [](const Entry& e, uint64_t k) { return PackKey(e) < k; });
+    auto last = std::upper_bound(first, m_Entries.end(), hi,
+        [](uint64_t k, const Entry& e) { return k < PackKey(e); });
+
+    return { first, last };
+}
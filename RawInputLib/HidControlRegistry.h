@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Flat, read-only index of every input control of a HID device, keyed by
+// (UsagePage, Usage, LinkCollection).
+//
+// Entries are stored sorted by key, so all controls of one usage page are
+// adjacent and can be returned as a single span. Exact lookups go through an
+// open-addressing hash table built over the sorted array, so they are O(1)
+// regardless of how many controls the descriptor declares.
+//
+// The registry is built once after the capability scan and never mutated on
+// the input path. It does not depend on Windows headers.
+class HidControlRegistry
+{
+public:
+    enum class Kind : uint8_t { Button, Axis, Switch };
+
+    // Matches a control in any link collection.
+    static constexpr uint16_t kAnyCollection = 0xFFFF;
+
+    struct Entry
+    {
+        uint16_t usagePage = 0;
+        uint16_t usage = 0;
+        uint16_t linkCollection = 0;
+        uint8_t  reportId = 0;
+        Kind     kind = Kind::Button;
+
+        // First slot in the device's button / axis / switch storage.
+        uint32_t index = 0;
+        // Number of consecutive slots (> 1 for button and value arrays
+        // declared with a single usage).
+        uint32_t count = 1;
+    };
+
+    HidControlRegistry() = default;
+
+    // Takes ownership of the entries, sorts them and builds the hash index.
+    // Entries with identical keys are kept; lookups return the first one.
+    void Build(std::vector<Entry> entries);
+    void Clear();
+
+    // Returns nullptr if the device has no such control.
+    // With linkCollection == kAnyCollection the first control with this usage
+    // in any collection is returned.
+    const Entry* Find(uint16_t usagePage, uint16_t usage, uint16_t linkCollection = kAnyCollection) const;
+
+    // All controls of one usage page, sorted by usage and link collection.
+    std::span<const Entry> FindUsagePage(uint16_t usagePage) const;
+
+    std::span<const Entry> GetEntries() const { return m_Entries; }
+    size_t GetCount() const { return m_Entries.size(); }
+    bool IsEmpty() const { return m_Entries.empty(); }
+
+private:
+    static uint64_t PackKey(uint16_t usagePage, uint16_t usage, uint16_t linkCollection)
+    {
+        return (uint64_t(usagePage) << 32) | (uint64_t(usage) << 16) | linkCollection;
+    }
+
+    static uint64_t PackKey(const Entry& e) { return PackKey(e.usagePage, e.usage, e.linkCollection); }
+
+    size_t HashSlot(uint64_t key) const
+    {
+        // Fibonacci hashing; table size is a power of two.
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> m_HashShift);
+    }
+
+    void Insert(uint64_t key, uint32_t entryIndex);
+
+    std::vector<Entry> m_Entries; // sorted by PackKey()
+
+    // Open-addressing table with linear probing. Holds both exact keys and
+    // (page, usage, kAnyCollection) wildcard keys; values are indices into m_Entries.
+    struct Slot
+    {
+        uint64_t key = 0;
+        uint32_t entry = kEmptySlot;
+    };
+    static constexpr uint32_t kEmptySlot = 0xFFFFFFFF;
+
+    std::vector<Slot> m_Slots;
+    uint32_t          m_HashShift = 64;
+};
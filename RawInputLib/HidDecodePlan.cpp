@@ -0,0 +1,69 @@
+#include "HidDecodePlan.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint32_t ReadReportBits(const uint8_t* report, size_t size, uint32_t bitOffset, uint32_t bitSize)
+{
+    const size_t byteOffset = bitOffset / 8;
+    const uint32_t bitShift = bitOffset % 8;
+
+    if (byteOffset >= size || bitSize == 0)
+        return 0;
+
+    // Up to 32 bits at any shift span at most 5 bytes.
+    uint64_t raw = 0;
+    std::memcpy(&raw, report + byteOffset, std::min<size_t>(8, size - byteOffset));
+
+    raw >>= bitShift;
+    raw &= (bitSize < 32) ? ((uint64_t(1) << bitSize) - 1u) : 0xFFFFFFFFull;
+    return static_cast<uint32_t>(raw);
+}
+
+void HidDecodePlan::AddOp(const Op& op)
+{
+    m_Ops.push_back(op);
+}
+
+uint32_t HidDecodePlan::AddSelectorTable(std::span<const uint16_t> slots)
+{
+    const uint32_t base = static_cast<uint32_t>(m_SelectorSlots.size());
+    m_SelectorSlots.insert(m_SelectorSlots.end(), slots.begin(), slots.end());
+    return base;
+}
+
+void HidDecodePlan::MarkRelative(uint8_t reportId)
+{
+    m_Reports[reportId].hasRelative = true;
+}
+
+void HidDecodePlan::Finalize()
+{
+    std::stable_sort(m_Ops.begin(), m_Ops.end(), [](const Op& a, const Op& b)
+        {
+            if (a.reportId != b.reportId)
+                return a.reportId < b.reportId;
+            return a.bitOffset < b.bitOffset;
+        });
+
+    for (ReportRange& r : m_Reports)
+    {
+        r.first = 0;
+        r.count = 0;
+    }
+
+    for (uint32_t i = 0; i < m_Ops.size(); ++i)
+    {
+        ReportRange& r = m_Reports[m_Ops[i].reportId];
+        if (r.count == 0)
+            r.first = i;
+        ++r.count;
+    }
+}
+
+void HidDecodePlan::Clear()
+{
+    m_Ops.clear();
+    m_SelectorSlots.clear();
+    m_Reports.fill({});
+}
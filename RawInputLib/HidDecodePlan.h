@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Reads `bitSize` (<= 32) bits starting at `bitOffset` of a little-endian
+// HID report. Bits past `size` read as zero.
+uint32_t ReadReportBits(const uint8_t* report, size_t size, uint32_t bitOffset, uint32_t bitSize);
+
+// Precomputed recipe for decoding input reports straight from their bytes.
+//
+// Each op reads one field (or, for selector arrays, one group of fields) at a
+// fixed bit offset and stores it into a button / axis / switch slot of the
+// owning device. Ops are grouped by Report ID and sorted by bit offset, so the
+// ops overlapping a changed byte range can be re-run without decoding the
+// whole report.
+//
+// The plan only describes the layout; it does not depend on Windows headers
+// and holds no per-report state.
+class HidDecodePlan
+{
+public:
+    enum class OpKind : uint8_t
+    {
+        Button,   // variable field, non-zero → button `slot` pressed
+        Axis,     // value field → axis `slot`
+        Switch,   // value field → switch `slot`
+        Selector, // `fieldCount` array fields holding usage indices → buttons via the selector table
+    };
+
+    static constexpr uint16_t kNoSlot = 0xFFFF;
+
+    struct Op
+    {
+        uint32_t bitOffset = 0;    // from the start of the report, Report ID byte included
+        uint16_t bitSize = 0;      // bits per field
+        uint16_t slot = 0;         // target slot; unused for Selector
+        OpKind   kind = OpKind::Button;
+        uint8_t  reportId = 0;
+        uint16_t fieldCount = 1;   // Selector: number of array fields
+
+        uint32_t selectorBase = 0; // Selector: first entry in the selector table
+        uint16_t selectorSize = 0; // Selector: number of selectable usages
+        int32_t  logicalMin = 0;   // Selector: field value of the first usage
+
+        uint32_t GetFirstByte() const { return bitOffset / 8; }
+        uint32_t GetEndByte()   const { return (bitOffset + uint32_t(bitSize) * fieldCount + 7) / 8; }
+    };
+
+    HidDecodePlan() = default;
+
+    void AddOp(const Op& op);
+
+    // Appends a selector table mapping (field value - logicalMin) to a button
+    // slot or kNoSlot. Returns the base to store in Op::selectorBase.
+    uint32_t AddSelectorTable(std::span<const uint16_t> slots);
+
+    // Marks a report that carries relative data: identical consecutive
+    // reports still mean motion and must not be skipped.
+    void MarkRelative(uint8_t reportId);
+
+    // Sorts ops by (Report ID, bit offset) and builds the per-report index.
+    // Call once after the last AddOp().
+    void Finalize();
+    void Clear();
+
+    bool IsEmpty() const { return m_Ops.empty(); }
+    size_t GetOpCount() const { return m_Ops.size(); }
+
+    std::span<const Op> GetOps(uint8_t reportId) const
+    {
+        const ReportRange& r = m_Reports[reportId];
+        return { m_Ops.data() + r.first, r.count };
+    }
+
+    bool HasRelative(uint8_t reportId) const { return m_Reports[reportId].hasRelative; }
+
+    std::span<const uint16_t> GetSelectorSlots(const Op& op) const
+    {
+        return { m_SelectorSlots.data() + op.selectorBase, op.selectorSize };
+    }
+
+private:
+    struct ReportRange
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+        bool     hasRelative = false;
+    };
+
+    std::vector<Op>                  m_Ops;
+    std::vector<uint16_t>            m_SelectorSlots;
+    std::array<ReportRange, 256>     m_Reports{};
+};
@@ -0,0 +1,197 @@
+#include "HidDescriptorCanonical.h"
+
+#include "HidDescriptorItems.h"
+#include "utils_simd.h"
+
+namespace
+{
+    // Items that only apply to the next Main item.
+    enum class Pending
+    {
+        Usage,         // Usage, Usage Min/Max and Delimiter
+        Designator,
+        String,
+        UnknownGlobal,
+        Other,
+    };
+
+    Pending Classify(const HidItem& item)
+    {
+        switch (item.GetTag())
+        {
+        case HID_USAGE:
+        case HID_USAGE_MIN:
+        case HID_USAGE_MAX:
+        case HID_DELIMITER:
+            return Pending::Usage;
+        case HID_DESIGNATOR_INDEX:
+        case HID_DESIGNATOR_MIN:
+        case HID_DESIGNATOR_MAX:
+            return Pending::Designator;
+        case HID_STRING_INDEX:
+        case HID_STRING_MIN:
+        case HID_STRING_MAX:
+            return Pending::String;
+        default:
+            // Known globals are tags 0-11, up to POP.
+            return item.GetType() == HID_TYPE_GLOBAL && item.GetTag() > HID_POP ? Pending::UnknownGlobal : Pending::Other;
+        }
+    }
+
+    // Writes the items of one kind found in `pending`, the bytes between the
+    // previous Main item and the current one. Re-reading them there saves
+    // collecting them on the way.
+    //
+    // Extended (4-byte) usages carry their own page and keep their width;
+    // other local items are re-encoded minimally. Unknown globals are copied
+    // verbatim: the Windows parser records them per channel, and
+    // ReconstructDescriptor() re-emits them before each Main item too.
+    void EmitPending(DescriptorWriter& w, std::span<const uint8_t> pending, Pending kind)
+    {
+        HidItemReader reader(pending);
+        while (std::optional<HidItem> item = reader.Next())
+        {
+            if (item->IsLong() || Classify(*item) != kind)
+                continue;
+
+            if (kind == Pending::UnknownGlobal)
+                w.raw(pending.data() + item->offset, 1 + item->size);
+            else
+                w.itemU(item->GetTag(), item->data, item->size == 4 ? 4 : 0);
+        }
+    }
+
+    // Usage of a collection: its first Usage item, on the current page
+    // unless extended.
+    uint32_t GetCollectionUsage(std::span<const uint8_t> pending, uint16_t usagePage)
+    {
+        HidItemReader reader(pending);
+        while (std::optional<HidItem> item = reader.Next())
+        {
+            if (!item->IsLong() && item->GetTag() == HID_USAGE)
+                return item->size == 4 ? item->data : (uint32_t(usagePage) << 16) | item->data;
+        }
+        return uint32_t(usagePage) << 16;
+    }
+
+    bool EmitCanonical(DescriptorWriter& w, std::span<const uint8_t> descriptor)
+    {
+        HidItemReader reader(descriptor);
+        GlobalState g;        // parser state
+        GlobalState emitted;  // nothing emitted yet; forces emission of all globals
+        std::vector<GlobalState> stack;
+        size_t pendingBegin = 0; // first item after the last Main item
+        uint32_t pendingKinds = 0; // bit per Pending kind seen since then
+        size_t depth = 0;
+
+        while (std::optional<HidItem> item = reader.Next())
+        {
+            if (item->IsLong())
+                continue;
+
+            const std::span<const uint8_t> pending = descriptor.subspan(pendingBegin, item->offset - pendingBegin);
+
+            switch (item->GetTag())
+            {
+            // Global items
+            case HID_USAGE_PAGE:   g.UsagePage = static_cast<uint16_t>(item->data); break;
+            case HID_LOG_MIN:      g.LogMin = item->GetSigned(); break;
+            case HID_LOG_MAX:      g.LogMax = item->GetSigned(); break;
+            case HID_PHY_MIN:      g.PhyMin = item->GetSigned(); break;
+            case HID_PHY_MAX:      g.PhyMax = item->GetSigned(); break;
+            case HID_UNIT_EXP:     g.UnitExp = item->data; break;
+            case HID_UNIT:         g.Unit = item->data; break;
+            case HID_REPORT_SIZE:  g.ReportSize = static_cast<uint16_t>(item->data); break;
+            case HID_REPORT_ID:    g.ReportID = static_cast<uint8_t>(item->data); break;
+            case HID_REPORT_COUNT: g.ReportCount = static_cast<uint16_t>(item->data); break;
+            case HID_PUSH:
+                stack.push_back(g);
+                break;
+            case HID_POP:
+                if (stack.empty())
+                    return false;
+                g = stack.back();
+                stack.pop_back();
+                break;
+
+            // Main items
+            case HID_INPUT:
+            case HID_OUTPUT:
+            case HID_FEATURE:
+            {
+                // Only usages are common; the other kinds are re-read only
+                // when present.
+                auto emitPending = [&](Pending kind)
+                    {
+                        if (pendingKinds & (1u << static_cast<uint32_t>(kind)))
+                            EmitPending(w, pending, kind);
+                    };
+                emitPending(Pending::UnknownGlobal);
+                emitChangedGlobals(w, emitted, g);
+                emitPending(Pending::Usage);
+                emitPending(Pending::Designator);
+                emitPending(Pending::String);
+                w.itemU(item->GetTag(), item->data);
+                pendingBegin = reader.GetOffset();
+                pendingKinds = 0;
+                break;
+            }
+
+            case HID_COLLECTION:
+            {
+                // Same opening as ReconstructDescriptor: the page of the
+                // collection usage, always written, then the usage.
+                const uint32_t usage = GetCollectionUsage(pending, g.UsagePage);
+                const uint16_t page = static_cast<uint16_t>(usage >> 16);
+                w.itemU(HID_USAGE_PAGE, page, page > 0xFF ? 2 : 1);
+                emitted.UsagePage = page;
+                emitted.UsagePageEmitted = true;
+                w.itemU(HID_USAGE, usage & 0xFFFF, (usage & 0xFFFF) > 0xFF ? 2 : 1);
+                w.itemU(HID_COLLECTION, item->data, 1);
+                pendingBegin = reader.GetOffset();
+                pendingKinds = 0;
+                ++depth;
+                break;
+            }
+
+            case HID_END_COLLECTION:
+                if (depth == 0)
+                    return false;
+                w.raw(HID_END_COLLECTION);
+                pendingBegin = reader.GetOffset();
+                pendingKinds = 0;
+                --depth;
+                break;
+
+            // Local items wait in `pending` for their Main item; unknown
+            // local and Main items are dropped.
+            default:
+                pendingKinds |= 1u << static_cast<uint32_t>(Classify(*item));
+                break;
+            }
+        }
+
+        return !reader.IsTruncated() && depth == 0 && stack.empty() && w.size() != 0;
+    }
+}
+
+bool CanonicalizeDescriptor(std::span<const uint8_t> descriptor, std::vector<uint8_t>& outDesc)
+{
+    DescriptorWriter w;
+    if (!EmitCanonical(w, descriptor))
+        return false;
+
+    outDesc = w.bytes();
+    return true;
+}
+
+bool FingerprintDescriptor(std::span<const uint8_t> descriptor, uint64_t& outFingerprint)
+{
+    simd::ByteHasher hasher;
+    DescriptorWriter w(hasher);
+    if (!EmitCanonical(w, descriptor))
+        return false;
+
+    outFingerprint = hasher.Finish();
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Canonical form of a raw report descriptor, so descriptors that only differ
+// in encoding compare and hash equal. It is emitted through the same
+// DescriptorWriter rules as ReconstructDescriptor():
+//
+//   - globals are written at their minimal width, in a fixed order, just
+//     before the Main item they apply to and only when their value changed;
+//     PUSH/POP are resolved away
+//   - local items are grouped: usages (with their delimiter sets) in
+//     declaration order, then designators, then strings
+//   - every collection opens with Usage Page, Usage, Collection
+//   - long items and unknown local or Main items are dropped, as the
+//     Windows parser rejects them anyway
+//
+// Returns false if the descriptor is truncated, empty, or its collections or
+// PUSH/POP do not balance.
+bool CanonicalizeDescriptor(std::span<const uint8_t> descriptor, std::vector<uint8_t>& outDesc);
+
+// simd::HashBytes of the canonical form, computed without building it.
+bool FingerprintDescriptor(std::span<const uint8_t> descriptor, uint64_t& outFingerprint);
@@ -0,0 +1,1148 @@
+#include "HidDescriptorDisassembler.h"
+
+#include "HidDescriptorItems.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+    // Longest line any item or layout field renders to, with margin. Every
+    // line gets this much room before it is written.
+    constexpr size_t kMaxLine = 512;
+
+    // Deeper collections are still tracked, just not indented further.
+    constexpr size_t kMaxIndent = 32;
+
+    // PUSH nesting kept; deeper PUSH items are noted and ignored.
+    constexpr size_t kMaxPush = 32;
+
+    struct Name
+    {
+        uint16_t         id;
+        std::string_view name;
+    };
+
+    // ---------------------------------------------------------------------------
+    // HID Usage Tables 1.5 (names as listed there); every table is sorted by id
+    // ---------------------------------------------------------------------------
+
+    constexpr Name kGenericDesktop[] =
+    {
+        { 0x01, "Pointer" }, { 0x02, "Mouse" }, { 0x04, "Joystick" }, { 0x05, "Gamepad" },
+        { 0x06, "Keyboard" }, { 0x07, "Keypad" }, { 0x08, "Multi-axis Controller" },
+        { 0x09, "Tablet PC System Controls" }, { 0x0A, "Water Cooling Device" },
+        { 0x0B, "Computer Chassis Device" }, { 0x0C, "Wireless Radio Controls" },
+        { 0x0D, "Portable Device Control" }, { 0x0E, "System Multi-Axis Controller" },
+        { 0x0F, "Spatial Controller" }, { 0x10, "Assistive Control" }, { 0x11, "Device Dock" },
+        { 0x12, "Dockable Device" }, { 0x13, "Call State Management Control" },
+        { 0x30, "X" }, { 0x31, "Y" }, { 0x32, "Z" }, { 0x33, "Rx" }, { 0x34, "Ry" }, { 0x35, "Rz" },
+        { 0x36, "Slider" }, { 0x37, "Dial" }, { 0x38, "Wheel" }, { 0x39, "Hat Switch" },
+        { 0x3A, "Counted Buffer" }, { 0x3B, "Byte Count" }, { 0x3C, "Motion Wakeup" },
+        { 0x3D, "Start" }, { 0x3E, "Select" }, { 0x40, "Vx" }, { 0x41, "Vy" }, { 0x42, "Vz" },
+        { 0x43, "Vbrx" }, { 0x44, "Vbry" }, { 0x45, "Vbrz" }, { 0x46, "Vno" },
+        { 0x47, "Feature Notification" }, { 0x48, "Resolution Multiplier" },
+        { 0x49, "Qx" }, { 0x4A, "Qy" }, { 0x4B, "Qz" }, { 0x4C, "Qw" },
+        { 0x80, "System Control" }, { 0x81, "System Power Down" }, { 0x82, "System Sleep" },
+        { 0x83, "System Wake Up" }, { 0x84, "System Context Menu" }, { 0x85, "System Main Menu" },
+        { 0x86, "System App Menu" }, { 0x87, "System Menu Help" }, { 0x88, "System Menu Exit" },
+        { 0x89, "System Menu Select" }, { 0x8A, "System Menu Right" }, { 0x8B, "System Menu Left" },
+        { 0x8C, "System Menu Up" }, { 0x8D, "System Menu Down" }, { 0x8E, "System Cold Restart" },
+        { 0x8F, "System Warm Restart" }, { 0x90, "D-pad Up" }, { 0x91, "D-pad Down" },
+        { 0x92, "D-pad Right" }, { 0x93, "D-pad Left" }, { 0x94, "Index Trigger" },
+        { 0x95, "Palm Trigger" }, { 0x96, "Thumbstick" }, { 0x97, "System Function Shift" },
+        { 0x98, "System Function Shift Lock" }, { 0x99, "System Function Shift Lock Indicator" },
+        { 0x9A, "System Dismiss Notification" }, { 0x9B, "System Do Not Disturb" },
+        { 0xA0, "System Dock" }, { 0xA1, "System Undock" }, { 0xA2, "System Setup" },
+        { 0xA3, "System Break" }, { 0xA4, "System Debugger Break" }, { 0xA5, "Application Break" },
+        { 0xA6, "Application Debugger Break" }, { 0xA7, "System Speaker Mute" },
+        { 0xA8, "System Hibernate" }, { 0xB0, "System Display Invert" },
+        { 0xB1, "System Display Internal" }, { 0xB2, "System Display External" },
+        { 0xB3, "System Display Both" }, { 0xB4, "System Display Dual" },
+        { 0xB5, "System Display Toggle Int/Ext Mode" }, { 0xB6, "System Display Swap Primary/Secondary" },
+        { 0xB7, "System Display Toggle LCD Autoscale" }, { 0xC0, "Sensor Zone" }, { 0xC1, "RPM" },
+        { 0xC2, "Coolant Level" }, { 0xC3, "Coolant Critical Level" }, { 0xC4, "Coolant Pump" },
+        { 0xC5, "Chassis Enclosure" }, { 0xC6, "Wireless Radio Button" },
+        { 0xC7, "Wireless Radio LED" }, { 0xC8, "Wireless Radio Slider Switch" },
+        { 0xC9, "System Display Rotation Lock Button" },
+        { 0xCA, "System Display Rotation Lock Slider Switch" }, { 0xCB, "Control Enable" },
+    };
+
+    constexpr Name kSimulationControls[] =
+    {
+        { 0x01, "Flight Simulation Device" }, { 0x02, "Automobile Simulation Device" },
+        { 0x03, "Tank Simulation Device" }, { 0x04, "Spaceship Simulation Device" },
+        { 0x05, "Submarine Simulation Device" }, { 0x06, "Sailing Simulation Device" },
+        { 0x07, "Motorcycle Simulation Device" }, { 0x08, "Sports Simulation Device" },
+        { 0x09, "Airplane Simulation Device" }, { 0x0A, "Helicopter Simulation Device" },
+        { 0x0B, "Magic Carpet Simulation Device" }, { 0x0C, "Bicycle Simulation Device" },
+        { 0x20, "Flight Control Stick" }, { 0x21, "Flight Stick" }, { 0x22, "Cyclic Control" },
+        { 0x23, "Cyclic Trim" }, { 0x24, "Flight Yoke" }, { 0x25, "Track Control" },
+        { 0xB0, "Aileron" }, { 0xB1, "Aileron Trim" }, { 0xB2, "Anti-Torque Control" },
+        { 0xB3, "Autopilot Enable" }, { 0xB4, "Chaff Release" }, { 0xB5, "Collective Control" },
+        { 0xB6, "Dive Brake" }, { 0xB7, "Electronic Countermeasures" }, { 0xB8, "Elevator" },
+        { 0xB9, "Elevator Trim" }, { 0xBA, "Rudder" }, { 0xBB, "Throttle" },
+        { 0xBC, "Flight Communications" }, { 0xBD, "Flare Release" }, { 0xBE, "Landing Gear" },
+        { 0xBF, "Toe Brake" }, { 0xC0, "Trigger" }, { 0xC1, "Weapons Arm" },
+        { 0xC2, "Weapons Select" }, { 0xC3, "Wing Flaps" }, { 0xC4, "Accelerator" },
+        { 0xC5, "Brake" }, { 0xC6, "Clutch" }, { 0xC7, "Shifter" }, { 0xC8, "Steering" },
+        { 0xC9, "Turret Direction" }, { 0xCA, "Barrel Elevation" }, { 0xCB, "Dive Plane" },
+        { 0xCC, "Ballast" }, { 0xCD, "Bicycle Crank" }, { 0xCE, "Handle Bars" },
+        { 0xCF, "Front Brake" }, { 0xD0, "Rear Brake" },
+    };
+
+    constexpr Name kGameControls[] =
+    {
+        { 0x01, "3D Game Controller" }, { 0x02, "Pinball Device" }, { 0x03, "Gun Device" },
+        { 0x20, "Point of View" }, { 0x21, "Turn Right/Left" }, { 0x22, "Pitch Forward/Backward" },
+        { 0x23, "Roll Right/Left" }, { 0x24, "Move Right/Left" }, { 0x25, "Move Forward/Backward" },
+        { 0x26, "Move Up/Down" }, { 0x27, "Lean Right/Left" }, { 0x28, "Lean Forward/Backward" },
+        { 0x29, "Height of POV" }, { 0x2A, "Flipper" }, { 0x2B, "Secondary Flipper" },
+        { 0x2C, "Bump" }, { 0x2D, "New Game" }, { 0x2E, "Shoot Ball" }, { 0x2F, "Player" },
+        { 0x30, "Gun Bolt" }, { 0x31, "Gun Clip" }, { 0x32, "Gun Selector" },
+        { 0x33, "Gun Single Shot" }, { 0x34, "Gun Burst" }, { 0x35, "Gun Automatic" },
+        { 0x36, "Gun Safety" }, { 0x37, "Gamepad Fire/Jump" }, { 0x39, "Gamepad Trigger" },
+        { 0x3A, "Form-fitting Gamepad" },
+    };
+
+    constexpr Name kGenericDeviceControls[] =
+    {
+        { 0x01, "Background/Nonuser Controls" }, { 0x20, "Battery Strength" },
+        { 0x21, "Wireless Channel" }, { 0x22, "Wireless ID" },
+        { 0x23, "Discover Wireless Communication Channel" },
+        { 0x24, "Security Code Character Entered" }, { 0x25, "Security Code Character Erased" },
+        { 0x26, "Security Code Cleared" }, { 0x27, "Sequence ID" }, { 0x28, "Sequence ID Reset" },
+        { 0x29, "RF Signal Strength" }, { 0x2A, "Software Version" }, { 0x2B, "Protocol Version" },
+        { 0x2C, "Hardware Version" }, { 0x2D, "Major" }, { 0x2E, "Minor" }, { 0x2F, "Revision" },
+        { 0x30, "Handedness" }, { 0x31, "Either Hand" }, { 0x32, "Left Hand" },
+        { 0x33, "Right Hand" }, { 0x34, "Both Hands" }, { 0x40, "Grip Pose Offset" },
+        { 0x41, "Pointer Pose Offset" },
+    };
+
+    // Letters, digits, F-keys and keypad digits are computed in PutUsage().
+    constexpr Name kKeyboard[] =
+    {
+        { 0x01, "ErrorRollOver" }, { 0x02, "POSTFail" }, { 0x03, "ErrorUndefined" },
+        { 0x28, "Keyboard Return (ENTER)" }, { 0x29, "Keyboard ESCAPE" },
+        { 0x2A, "Keyboard DELETE (Backspace)" }, { 0x2B, "Keyboard Tab" }, { 0x2C, "Keyboard Spacebar" },
+        { 0x2D, "Keyboard - and _" }, { 0x2E, "Keyboard = and +" }, { 0x2F, "Keyboard [ and {" },
+        { 0x30, "Keyboard ] and }" }, { 0x31, "Keyboard \\ and |" }, { 0x32, "Keyboard Non-US # and ~" },
+        { 0x33, "Keyboard ; and :" }, { 0x34, "Keyboard ' and \"" }, { 0x35, "Keyboard Grave Accent and Tilde" },
+        { 0x36, "Keyboard , and <" }, { 0x37, "Keyboard . and >" }, { 0x38, "Keyboard / and ?" },
+        { 0x39, "Keyboard Caps Lock" }, { 0x46, "Keyboard PrintScreen" }, { 0x47, "Keyboard Scroll Lock" },
+        { 0x48, "Keyboard Pause" }, { 0x49, "Keyboard Insert" }, { 0x4A, "Keyboard Home" },
+        { 0x4B, "Keyboard PageUp" }, { 0x4C, "Keyboard Delete Forward" }, { 0x4D, "Keyboard End" },
+        { 0x4E, "Keyboard PageDown" }, { 0x4F, "Keyboard RightArrow" }, { 0x50, "Keyboard LeftArrow" },
+        { 0x51, "Keyboard DownArrow" }, { 0x52, "Keyboard UpArrow" }, { 0x53, "Keypad Num Lock and Clear" },
+        { 0x54, "Keypad /" }, { 0x55, "Keypad *" }, { 0x56, "Keypad -" }, { 0x57, "Keypad +" },
+        { 0x58, "Keypad ENTER" }, { 0x63, "Keypad . and Delete" }, { 0x64, "Keyboard Non-US \\ and |" },
+        { 0x65, "Keyboard Application" }, { 0x66, "Keyboard Power" }, { 0x67, "Keypad =" },
+        { 0x74, "Keyboard Execute" }, { 0x75, "Keyboard Help" }, { 0x76, "Keyboard Menu" },
+        { 0x77, "Keyboard Select" }, { 0x78, "Keyboard Stop" }, { 0x79, "Keyboard Again" },
+        { 0x7A, "Keyboard Undo" }, { 0x7B, "Keyboard Cut" }, { 0x7C, "Keyboard Copy" },
+        { 0x7D, "Keyboard Paste" }, { 0x7E, "Keyboard Find" }, { 0x7F, "Keyboard Mute" },
+        { 0x80, "Keyboard Volume Up" }, { 0x81, "Keyboard Volume Down" },
+        { 0x82, "Keyboard Locking Caps Lock" }, { 0x83, "Keyboard Locking Num Lock" },
+        { 0x84, "Keyboard Locking Scroll Lock" }, { 0x85, "Keypad Comma" },
+        { 0x86, "Keypad Equal Sign" }, { 0x87, "Keyboard International1" },
+        { 0x88, "Keyboard International2" }, { 0x89, "Keyboard International3" },
+        { 0x8A, "Keyboard International4" }, { 0x8B, "Keyboard International5" },
+        { 0x8C, "Keyboard International6" }, { 0x8D, "Keyboard International7" },
+        { 0x8E, "Keyboard International8" }, { 0x8F, "Keyboard International9" },
+        { 0x90, "Keyboard LANG1" }, { 0x91, "Keyboard LANG2" }, { 0x92, "Keyboard LANG3" },
+        { 0x93, "Keyboard LANG4" }, { 0x94, "Keyboard LANG5" }, { 0x95, "Keyboard LANG6" },
+        { 0x96, "Keyboard LANG7" }, { 0x97, "Keyboard LANG8" }, { 0x98, "Keyboard LANG9" },
+        { 0x99, "Keyboard Alternate Erase" }, { 0x9A, "Keyboard SysReq/Attention" },
+        { 0x9B, "Keyboard Cancel" }, { 0x9C, "Keyboard Clear" }, { 0x9D, "Keyboard Prior" },
+        { 0x9E, "Keyboard Return" }, { 0x9F, "Keyboard Separator" }, { 0xA0, "Keyboard Out" },
+        { 0xA1, "Keyboard Oper" }, { 0xA2, "Keyboard Clear/Again" }, { 0xA3, "Keyboard CrSel/Props" },
+        { 0xA4, "Keyboard ExSel" },
+        { 0xE0, "Keyboard LeftControl" }, { 0xE1, "Keyboard LeftShift" }, { 0xE2, "Keyboard LeftAlt" },
+        { 0xE3, "Keyboard Left GUI" }, { 0xE4, "Keyboard RightControl" }, { 0xE5, "Keyboard RightShift" },
+        { 0xE6, "Keyboard RightAlt" }, { 0xE7, "Keyboard Right GUI" },
+    };
+
+    constexpr Name kLed[] =
+    {
+        { 0x01, "Num Lock" }, { 0x02, "Caps Lock" }, { 0x03, "Scroll Lock" }, { 0x04, "Compose" },
+        { 0x05, "Kana" }, { 0x06, "Power" }, { 0x07, "Shift" }, { 0x08, "Do Not Disturb" },
+        { 0x09, "Mute" }, { 0x0A, "Tone Enable" }, { 0x0B, "High Cut Filter" },
+        { 0x0C, "Low Cut Filter" }, { 0x0D, "Equalizer Enable" }, { 0x0E, "Sound Field On" },
+        { 0x0F, "Surround On" }, { 0x10, "Repeat" }, { 0x11, "Stereo" },
+        { 0x12, "Sampling Rate Detect" }, { 0x13, "Spinning" }, { 0x14, "CAV" }, { 0x15, "CLV" },
+        { 0x16, "Recording Format Detect" }, { 0x17, "Off-Hook" }, { 0x18, "Ring" },
+        { 0x19, "Message Waiting" }, { 0x1A, "Data Mode" }, { 0x1B, "Battery Operation" },
+        { 0x1C, "Battery OK" }, { 0x1D, "Battery Low" }, { 0x1E, "Speaker" }, { 0x1F, "Headset" },
+        { 0x20, "Hold" }, { 0x21, "Microphone" }, { 0x22, "Coverage" }, { 0x23, "Night Mode" },
+        { 0x24, "Send Calls" }, { 0x25, "Call Pickup" }, { 0x26, "Conference" },
+        { 0x27, "Stand-by" }, { 0x28, "Camera On" }, { 0x29, "Camera Off" }, { 0x2A, "On-Line" },
+        { 0x2B, "Off-Line" }, { 0x2C, "Busy" }, { 0x2D, "Ready" }, { 0x2E, "Paper-Out" },
+        { 0x2F, "Paper-Jam" }, { 0x30, "Remote" }, { 0x31, "Forward" }, { 0x32, "Reverse" },
+        { 0x33, "Stop" }, { 0x34, "Rewind" }, { 0x35, "Fast Forward" }, { 0x36, "Play" },
+        { 0x37, "Pause" }, { 0x38, "Record" }, { 0x39, "Error" }, { 0x3A, "Usage Selected Indicator" },
+        { 0x3B, "Usage In Use Indicator" }, { 0x3C, "Usage Multi Mode Indicator" },
+        { 0x3D, "Indicator On" }, { 0x3E, "Indicator Flash" }, { 0x3F, "Indicator Slow Blink" },
+        { 0x40, "Indicator Fast Blink" }, { 0x41, "Indicator Off" }, { 0x42, "Flash On Time" },
+        { 0x43, "Slow Blink On Time" }, { 0x44, "Slow Blink Off Time" }, { 0x45, "Fast Blink On Time" },
+        { 0x46, "Fast Blink Off Time" }, { 0x47, "Usage Indicator Color" }, { 0x48, "Indicator Red" },
+        { 0x49, "Indicator Green" }, { 0x4A, "Indicator Amber" }, { 0x4B, "Generic Indicator" },
+        { 0x4C, "System Suspend" }, { 0x4D, "External Power Connected" },
+        { 0x4E, "Indicator Blue" }, { 0x4F, "Indicator Orange" }, { 0x50, "Good Status" },
+        { 0x51, "Warning Status" }, { 0x52, "RGB LED" }, { 0x53, "Red LED Channel" },
+        { 0x54, "Blue LED Channel" }, { 0x55, "Green LED Channel" }, { 0x56, "LED Intensity" },
+        { 0x57, "System Microphone Mute" }, { 0x60, "Player Indicator" }, { 0x61, "Player 1" },
+        { 0x62, "Player 2" }, { 0x63, "Player 3" }, { 0x64, "Player 4" }, { 0x65, "Player 5" },
+        { 0x66, "Player 6" }, { 0x67, "Player 7" }, { 0x68, "Player 8" },
+    };
+
+    constexpr Name kConsumer[] =
+    {
+        { 0x001, "Consumer Control" }, { 0x002, "Numeric Key Pad" }, { 0x003, "Programmable Buttons" },
+        { 0x004, "Microphone" }, { 0x005, "Headphone" }, { 0x006, "Graphic Equalizer" },
+        { 0x020, "+10" }, { 0x021, "+100" }, { 0x022, "AM/PM" },
+        { 0x030, "Power" }, { 0x031, "Reset" }, { 0x032, "Sleep" }, { 0x033, "Sleep After" },
+        { 0x034, "Sleep Mode" }, { 0x035, "Illumination" }, { 0x036, "Function Buttons" },
+        { 0x040, "Menu" }, { 0x041, "Menu Pick" }, { 0x042, "Menu Up" }, { 0x043, "Menu Down" },
+        { 0x044, "Menu Left" }, { 0x045, "Menu Right" }, { 0x046, "Menu Escape" },
+        { 0x047, "Menu Value Increase" }, { 0x048, "Menu Value Decrease" },
+        { 0x060, "Data On Screen" }, { 0x061, "Closed Caption" }, { 0x062, "Closed Caption Select" },
+        { 0x063, "VCR/TV" }, { 0x064, "Broadcast Mode" }, { 0x065, "Snapshot" }, { 0x066, "Still" },
+        { 0x067, "Picture-in-Picture Toggle" }, { 0x068, "Picture-in-Picture Swap" },
+        { 0x069, "Red Menu Button" }, { 0x06A, "Green Menu Button" }, { 0x06B, "Blue Menu Button" },
+        { 0x06C, "Yellow Menu Button" }, { 0x06D, "Aspect" }, { 0x06E, "3D Mode Select" },
+        { 0x06F, "Display Brightness Increment" }, { 0x070, "Display Brightness Decrement" },
+        { 0x071, "Display Brightness" }, { 0x072, "Display Backlight Toggle" },
+        { 0x073, "Display Set Brightness to Minimum" }, { 0x074, "Display Set Brightness to Maximum" },
+        { 0x075, "Display Set Auto Brightness" }, { 0x076, "Camera Access Enabled" },
+        { 0x077, "Camera Access Disabled" }, { 0x078, "Camera Access Toggle" },
+        { 0x079, "Keyboard Brightness Increment" }, { 0x07A, "Keyboard Brightness Decrement" },
+        { 0x07B, "Keyboard Backlight Set Level" }, { 0x07C, "Keyboard Backlight OOC" },
+        { 0x07D, "Keyboard Backlight Set Minimum" }, { 0x07E, "Keyboard Backlight Set Maximum" },
+        { 0x07F, "Keyboard Backlight Auto" },
+        { 0x080, "Selection" }, { 0x081, "Assign Selection" }, { 0x082, "Mode Step" },
+        { 0x083, "Recall Last" }, { 0x084, "Enter Channel" }, { 0x085, "Order Movie" },
+        { 0x086, "Channel" }, { 0x087, "Media Selection" }, { 0x088, "Media Select Computer" },
+        { 0x089, "Media Select TV" }, { 0x08A, "Media Select WWW" }, { 0x08B, "Media Select DVD" },
+        { 0x08C, "Media Select Telephone" }, { 0x08D, "Media Select Program Guide" },
+        { 0x08E, "Media Select Video Phone" }, { 0x08F, "Media Select Games" },
+        { 0x090, "Media Select Messages" }, { 0x091, "Media Select CD" }, { 0x092, "Media Select VCR" },
+        { 0x093, "Media Select Tuner" }, { 0x094, "Quit" }, { 0x095, "Help" },
+        { 0x096, "Media Select Tape" }, { 0x097, "Media Select Cable" },
+        { 0x098, "Media Select Satellite" }, { 0x099, "Media Select Security" },
+        { 0x09A, "Media Select Home" }, { 0x09B, "Media Select Call" },
+        { 0x09C, "Channel Increment" }, { 0x09D, "Channel Decrement" }, { 0x09E, "Media Select SAP" },
+        { 0x0A0, "VCR Plus" }, { 0x0A1, "Once" }, { 0x0A2, "Daily" }, { 0x0A3, "Weekly" },
+        { 0x0A4, "Monthly" },
+        { 0x0B0, "Play" }, { 0x0B1, "Pause" }, { 0x0B2, "Record" }, { 0x0B3, "Fast Forward" },
+        { 0x0B4, "Rewind" }, { 0x0B5, "Scan Next Track" }, { 0x0B6, "Scan Previous Track" },
+        { 0x0B7, "Stop" }, { 0x0B8, "Eject" }, { 0x0B9, "Random Play" }, { 0x0BA, "Select Disc" },
+        { 0x0BB, "Enter Disc" }, { 0x0BC, "Repeat" }, { 0x0BD, "Tracking" },
+        { 0x0BE, "Track Normal" }, { 0x0BF, "Slow Tracking" }, { 0x0C0, "Frame Forward" },
+        { 0x0C1, "Frame Back" }, { 0x0C2, "Mark" }, { 0x0C3, "Clear Mark" },
+        { 0x0C4, "Repeat From Mark" }, { 0x0C5, "Return To Mark" }, { 0x0C6, "Search Mark Forward" },
+        { 0x0C7, "Search Mark Backwards" }, { 0x0C8, "Counter Reset" }, { 0x0C9, "Show Counter" },
+        { 0x0CA, "Tracking Increment" }, { 0x0CB, "Tracking Decrement" }, { 0x0CC, "Stop/Eject" },
+        { 0x0CD, "Play/Pause" }, { 0x0CE, "Play/Skip" }, { 0x0CF, "Voice Command" },
+        { 0x0D0, "Invoke Capture Interface" }, { 0x0D1, "Start or Stop Game Recording" },
+        { 0x0D2, "Historical Game Capture" }, { 0x0D3, "Capture Game Screenshot" },
+        { 0x0D4, "Show or Hide Recording Indicator" }, { 0x0D5, "Start or Stop Microphone Capture" },
+        { 0x0D6, "Start or Stop Camera Capture" }, { 0x0D7, "Start or Stop Game Broadcast" },
+        { 0x0D8, "Start or Stop Voice Dictation Session" }, { 0x0D9, "Invoke/Dismiss Emoji Picker" },
+        { 0x0E0, "Volume" }, { 0x0E1, "Balance" }, { 0x0E2, "Mute" }, { 0x0E3, "Bass" },
+        { 0x0E4, "Treble" }, { 0x0E5, "Bass Boost" }, { 0x0E6, "Surround Mode" },
+        { 0x0E7, "Loudness" }, { 0x0E8, "MPX" }, { 0x0E9, "Volume Increment" },
+        { 0x0EA, "Volume Decrement" },
+        { 0x0F0, "Speed Select" }, { 0x0F1, "Playback Speed" }, { 0x0F2, "Standard Play" },
+        { 0x0F3, "Long Play" }, { 0x0F4, "Extended Play" }, { 0x0F5, "Slow" },
+        { 0x100, "Fan Enable" }, { 0x101, "Fan Speed" }, { 0x102, "Light Enable" },
+        { 0x103, "Light Illumination Level" }, { 0x104, "Climate Control Enable" },
+        { 0x105, "Room Temperature" }, { 0x106, "Security Enable" }, { 0x107, "Fire Alarm" },
+        { 0x108, "Police Alarm" }, { 0x109, "Proximity" }, { 0x10A, "Motion" },
+        { 0x10B, "Duress Alarm" }, { 0x10C, "Holdup Alarm" }, { 0x10D, "Medical Alarm" },
+        { 0x150, "Balance Right" }, { 0x151, "Balance Left" }, { 0x152, "Bass Increment" },
+        { 0x153, "Bass Decrement" }, { 0x154, "Treble Increment" }, { 0x155, "Treble Decrement" },
+        { 0x160, "Speaker System" }, { 0x161, "Channel Left" }, { 0x162, "Channel Right" },
+        { 0x163, "Channel Center" }, { 0x164, "Channel Front" }, { 0x165, "Channel Center Front" },
+        { 0x166, "Channel Side" }, { 0x167, "Channel Surround" }, { 0x168, "Channel Low Frequency Enhancement" },
+        { 0x169, "Channel Top" }, { 0x16A, "Channel Unknown" },
+        { 0x170, "Sub-channel" }, { 0x171, "Sub-channel Increment" }, { 0x172, "Sub-channel Decrement" },
+        { 0x173, "Alternate Audio Increment" }, { 0x174, "Alternate Audio Decrement" },
+        { 0x180, "Application Launch Buttons" }, { 0x181, "AL Launch Button Configuration Tool" },
+        { 0x182, "AL Programmable Button Configuration" }, { 0x183, "AL Consumer Control Configuration" },
+        { 0x184, "AL Word Processor" }, { 0x185, "AL Text Editor" }, { 0x186, "AL Spreadsheet" },
+        { 0x187, "AL Graphics Editor" }, { 0x188, "AL Presentation App" }, { 0x189, "AL Database App" },
+        { 0x18A, "AL Email Reader" }, { 0x18B, "AL Newsreader" }, { 0x18C, "AL Voicemail" },
+        { 0x18D, "AL Contacts/Address Book" }, { 0x18E, "AL Calendar/Schedule" },
+        { 0x18F, "AL Task/Project Manager" }, { 0x190, "AL Log/Journal/Timecard" },
+        { 0x191, "AL Checkbook/Finance" }, { 0x192, "AL Calculator" }, { 0x193, "AL A/V Capture/Playback" },
+        { 0x194, "AL Local Machine Browser" }, { 0x195, "AL LAN/WAN Browser" },
+        { 0x196, "AL Internet Browser" }, { 0x197, "AL Remote Networking/ISP Connect" },
+        { 0x198, "AL Network Conference" }, { 0x199, "AL Network Chat" },
+        { 0x19A, "AL Telephony/Dialer" }, { 0x19B, "AL Logon" }, { 0x19C, "AL Logoff" },
+        { 0x19D, "AL Logon/Logoff" }, { 0x19E, "AL Terminal Lock/Screensaver" },
+        { 0x19F, "AL Control Panel" }, { 0x1A0, "AL Command Line Processor/Run" },
+        { 0x1A1, "AL Process/Task Manager" }, { 0x1A2, "AL Select Task/Application" },
+        { 0x1A3, "AL Next Task/Application" }, { 0x1A4, "AL Previous Task/Application" },
+        { 0x1A5, "AL Preemptive Halt Task/Application" }, { 0x1A6, "AL Integrated Help Center" },
+        { 0x1A7, "AL Documents" }, { 0x1A8, "AL Thesaurus" }, { 0x1A9, "AL Dictionary" },
+        { 0x1AA, "AL Desktop" }, { 0x1AB, "AL Spell Check" }, { 0x1AC, "AL Grammar Check" },
+        { 0x1AD, "AL Wireless Status" }, { 0x1AE, "AL Keyboard Layout" },
+        { 0x1AF, "AL Virus Protection" }, { 0x1B0, "AL Encryption" }, { 0x1B1, "AL Screen Saver" },
+        { 0x1B2, "AL Alarms" }, { 0x1B3, "AL Clock" }, { 0x1B4, "AL File Browser" },
+        { 0x1B5, "AL Power Status" }, { 0x1B6, "AL Image Browser" }, { 0x1B7, "AL Audio Browser" },
+        { 0x1B8, "AL Movie Browser" }, { 0x1B9, "AL Digital Rights Manager" },
+        { 0x1BA, "AL Digital Wallet" }, { 0x1BC, "AL Instant Messaging" },
+        { 0x1BD, "AL OEM Features/Tips/Tutorial Browser" }, { 0x1BE, "AL OEM Help" },
+        { 0x1BF, "AL Online Community" }, { 0x1C0, "AL Entertainment Content Browser" },
+        { 0x1C1, "AL Online Shopping Browser" }, { 0x1C2, "AL SmartCard Information/Help" },
+        { 0x1C3, "AL Market Monitor/Finance Browser" }, { 0x1C4, "AL Customized Corporate News Browser" },
+        { 0x1C5, "AL Online Activity Browser" }, { 0x1C6, "AL Research/Search Browser" },
+        { 0x1C7, "AL Audio Player" }, { 0x1C8, "AL Message Status" }, { 0x1C9, "AL Contact Sync" },
+        { 0x1CA, "AL Navigation" }, { 0x1CB, "AL Context-aware Desktop Assistant" },
+        { 0x200, "Generic GUI Application Controls" }, { 0x201, "AC New" }, { 0x202, "AC Open" },
+        { 0x203, "AC Close" }, { 0x204, "AC Exit" }, { 0x205, "AC Maximize" }, { 0x206, "AC Minimize" },
+        { 0x207, "AC Save" }, { 0x208, "AC Print" }, { 0x209, "AC Properties" },
+        { 0x21A, "AC Undo" }, { 0x21B, "AC Copy" }, { 0x21C, "AC Cut" }, { 0x21D, "AC Paste" },
+        { 0x21E, "AC Select All" }, { 0x21F, "AC Find" }, { 0x220, "AC Find and Replace" },
+        { 0x221, "AC Search" }, { 0x222, "AC Go To" }, { 0x223, "AC Home" }, { 0x224, "AC Back" },
+        { 0x225, "AC Forward" }, { 0x226, "AC Stop" }, { 0x227, "AC Refresh" },
+        { 0x228, "AC Previous Link" }, { 0x229, "AC Next Link" }, { 0x22A, "AC Bookmarks" },
+        { 0x22B, "AC History" }, { 0x22C, "AC Subscriptions" }, { 0x22D, "AC Zoom In" },
+        { 0x22E, "AC Zoom Out" }, { 0x22F, "AC Zoom" }, { 0x230, "AC Full Screen View" },
+        { 0x231, "AC Normal View" }, { 0x232, "AC View Toggle" }, { 0x233, "AC Scroll Up" },
+        { 0x234, "AC Scroll Down" }, { 0x235, "AC Scroll" }, { 0x236, "AC Pan Left" },
+        { 0x237, "AC Pan Right" }, { 0x238, "AC Pan" }, { 0x239, "AC New Window" },
+        { 0x23A, "AC Tile Horizontally" }, { 0x23B, "AC Tile Vertically" }, { 0x23C, "AC Format" },
+        { 0x23D, "AC Edit" }, { 0x23E, "AC Bold" }, { 0x23F, "AC Italics" }, { 0x240, "AC Underline" },
+        { 0x241, "AC Strikethrough" }, { 0x242, "AC Subscript" }, { 0x243, "AC Superscript" },
+        { 0x244, "AC All Caps" }, { 0x245, "AC Rotate" }, { 0x246, "AC Resize" },
+        { 0x247, "AC Flip Horizontal" }, { 0x248, "AC Flip Vertical" }, { 0x249, "AC Mirror Horizontal" },
+        { 0x24A, "AC Mirror Vertical" }, { 0x24B, "AC Font Select" }, { 0x24C, "AC Font Color" },
+        { 0x24D, "AC Font Size" }, { 0x24E, "AC Justify Left" }, { 0x24F, "AC Justify Center H" },
+        { 0x250, "AC Justify Right" }, { 0x251, "AC Justify Block H" }, { 0x252, "AC Justify Top" },
+        { 0x253, "AC Justify Center V" }, { 0x254, "AC Justify Bottom" }, { 0x255, "AC Justify Block V" },
+        { 0x256, "AC Indent Decrease" }, { 0x257, "AC Indent Increase" }, { 0x258, "AC Numbered List" },
+        { 0x259, "AC Restart Numbering" }, { 0x25A, "AC Bulleted List" }, { 0x25B, "AC Promote" },
+        { 0x25C, "AC Demote" }, { 0x25D, "AC Yes" }, { 0x25E, "AC No" }, { 0x25F, "AC Cancel" },
+        { 0x260, "AC Catalog" }, { 0x261, "AC Buy/Checkout" }, { 0x262, "AC Add to Cart" },
+        { 0x263, "AC Expand" }, { 0x264, "AC Expand All" }, { 0x265, "AC Collapse" },
+        { 0x266, "AC Collapse All" }, { 0x267, "AC Print Preview" }, { 0x268, "AC Paste Special" },
+        { 0x269, "AC Insert Mode" }, { 0x26A, "AC Delete" }, { 0x26B, "AC Lock" },
+        { 0x26C, "AC Unlock" }, { 0x26D, "AC Protect" }, { 0x26E, "AC Unprotect" },
+        { 0x26F, "AC Attach Comment" }, { 0x270, "AC Delete Comment" }, { 0x271, "AC View Comment" },
+        { 0x272, "AC Select Word" }, { 0x273, "AC Select Sentence" }, { 0x274, "AC Select Paragraph" },
+        { 0x275, "AC Select Column" }, { 0x276, "AC Select Row" }, { 0x277, "AC Select Table" },
+        { 0x278, "AC Select Object" }, { 0x279, "AC Redo/Repeat" }, { 0x27A, "AC Sort" },
+        { 0x27B, "AC Sort Ascending" }, { 0x27C, "AC Sort Descending" }, { 0x27D, "AC Filter" },
+        { 0x27E, "AC Set Clock" }, { 0x27F, "AC View Clock" }, { 0x280, "AC Select Time Zone" },
+        { 0x281, "AC Edit Time Zones" }, { 0x282, "AC Set Alarm" }, { 0x283, "AC Clear Alarm" },
+        { 0x284, "AC Snooze Alarm" }, { 0x285, "AC Reset Alarm" }, { 0x286, "AC Synchronize" },
+        { 0x287, "AC Send/Receive" }, { 0x288, "AC Send To" }, { 0x289, "AC Reply" },
+        { 0x28A, "AC Reply All" }, { 0x28B, "AC Forward Msg" }, { 0x28C, "AC Send" },
+        { 0x28D, "AC Attach File" }, { 0x28E, "AC Upload" }, { 0x28F, "AC Download (Save Target As)" },
+        { 0x290, "AC Set Borders" }, { 0x291, "AC Insert Row" }, { 0x292, "AC Insert Column" },
+        { 0x293, "AC Insert File" }, { 0x294, "AC Insert Picture" }, { 0x295, "AC Insert Object" },
+        { 0x296, "AC Insert Symbol" }, { 0x297, "AC Save and Close" }, { 0x298, "AC Rename" },
+        { 0x299, "AC Merge" }, { 0x29A, "AC Split" }, { 0x29B, "AC Distribute Horizontally" },
+        { 0x29C, "AC Distribute Vertically" }, { 0x29D, "AC Next Keyboard Layout Select" },
+        { 0x29E, "AC Navigation Guidance" }, { 0x29F, "AC Desktop Show All Windows" },
+        { 0x2A0, "AC Soft Key Left" }, { 0x2A1, "AC Soft Key Right" },
+        { 0x2A2, "AC Desktop Show All Applications" }, { 0x2B0, "AC Idle Keep Alive" },
+        { 0x2C0, "Extended Keyboard Attributes Collection" }, { 0x2C1, "Keyboard Form Factor" },
+        { 0x2C2, "Keyboard Key Type" }, { 0x2C3, "Keyboard Physical Layout" },
+        { 0x2C4, "Vendor-Specific Keyboard Physical Layout" }, { 0x2C5, "Keyboard IETF Language Tag Index" },
+        { 0x2C6, "Implemented Keyboard Input Assist Controls" },
+        { 0x2C7, "Keyboard Input Assist Previous" }, { 0x2C8, "Keyboard Input Assist Next" },
+        { 0x2C9, "Keyboard Input Assist Previous Group" }, { 0x2CA, "Keyboard Input Assist Next Group" },
+        { 0x2CB, "Keyboard Input Assist Accept" }, { 0x2CC, "Keyboard Input Assist Cancel" },
+        { 0x2D0, "Privacy Screen Toggle" }, { 0x2D1, "Privacy Screen Level Decrement" },
+        { 0x2D2, "Privacy Screen Level Increment" }, { 0x2D3, "Privacy Screen Level Minimum" },
+        { 0x2D4, "Privacy Screen Level Maximum" },
+        { 0x500, "Contact Edited" }, { 0x501, "Contact Added" }, { 0x502, "Contact Record Active" },
+        { 0x503, "Contact Index" }, { 0x504, "Contact Nickname" }, { 0x505, "Contact First Name" },
+        { 0x506, "Contact Last Name" }, { 0x507, "Contact Full Name" },
+        { 0x508, "Contact Phone Number Personal" }, { 0x509, "Contact Phone Number Business" },
+        { 0x50A, "Contact Phone Number Mobile" }, { 0x50B, "Contact Phone Number Pager" },
+        { 0x50C, "Contact Phone Number Fax" }, { 0x50D, "Contact Phone Number Other" },
+        { 0x50E, "Contact Email Personal" }, { 0x50F, "Contact Email Business" },
+        { 0x510, "Contact Email Other" }, { 0x511, "Contact Email Main" },
+        { 0x512, "Contact Speed Dial Number" }, { 0x513, "Contact Status Flag" },
+        { 0x514, "Contact Misc." },
+    };
+
+    constexpr Name kDigitizers[] =
+    {
+        { 0x01, "Digitizer" }, { 0x02, "Pen" }, { 0x03, "Light Pen" }, { 0x04, "Touch Screen" },
+        { 0x05, "Touch Pad" }, { 0x06, "Whiteboard" }, { 0x07, "Coordinate Measuring Machine" },
+        { 0x08, "3D Digitizer" }, { 0x09, "Stereo Plotter" }, { 0x0A, "Articulated Arm" },
+        { 0x0B, "Armature" }, { 0x0C, "Multiple Point Digitizer" }, { 0x0D, "Free Space Wand" },
+        { 0x0E, "Device Configuration" }, { 0x0F, "Capacitive Heat Map Digitizer" },
+        { 0x20, "Stylus" }, { 0x21, "Puck" }, { 0x22, "Finger" }, { 0x23, "Device Settings" },
+        { 0x24, "Character Gesture" },
+        { 0x30, "Tip Pressure" }, { 0x31, "Barrel Pressure" }, { 0x32, "In Range" },
+        { 0x33, "Touch" }, { 0x34, "Untouch" }, { 0x35, "Tap" }, { 0x36, "Quality" },
+        { 0x37, "Data Valid" }, { 0x38, "Transducer Index" }, { 0x39, "Tablet Function Keys" },
+        { 0x3A, "Program Change Keys" }, { 0x3B, "Battery Strength" }, { 0x3C, "Invert" },
+        { 0x3D, "X Tilt" }, { 0x3E, "Y Tilt" }, { 0x3F, "Azimuth" }, { 0x40, "Altitude" },
+        { 0x41, "Twist" }, { 0x42, "Tip Switch" }, { 0x43, "Secondary Tip Switch" },
+        { 0x44, "Barrel Switch" }, { 0x45, "Eraser" }, { 0x46, "Tablet Pick" },
+        { 0x47, "Touch Valid" }, { 0x48, "Width" }, { 0x49, "Height" },
+        { 0x51, "Contact Identifier" }, { 0x52, "Device Mode" }, { 0x53, "Device Identifier" },
+        { 0x54, "Contact Count" }, { 0x55, "Contact Count Maximum" }, { 0x56, "Scan Time" },
+        { 0x57, "Surface Switch" }, { 0x58, "Button Switch" }, { 0x59, "Pad Type" },
+        { 0x5A, "Secondary Barrel Switch" }, { 0x5B, "Transducer Serial Number" },
+        { 0x5C, "Preferred Color" }, { 0x5D, "Preferred Color is Locked" },
+        { 0x5E, "Preferred Line Width" }, { 0x5F, "Preferred Line Width is Locked" },
+        { 0x60, "Latency Mode" }, { 0x61, "Gesture Character Quality" },
+        { 0x62, "Character Gesture Data Length" }, { 0x63, "Character Gesture Data" },
+        { 0x64, "Gesture Character Encoding" }, { 0x65, "UTF8 Character Gesture Encoding" },
+        { 0x66, "UTF16 Little Endian Character Gesture Encoding" },
+        { 0x67, "UTF16 Big Endian Character Gesture Encoding" },
+        { 0x68, "UTF32 Little Endian Character Gesture Encoding" },
+        { 0x69, "UTF32 Big Endian Character Gesture Encoding" },
+        { 0x6A, "Capacitive Heat Map Protocol Vendor ID" },
+        { 0x6B, "Capacitive Heat Map Protocol Version" }, { 0x6C, "Capacitive Heat Map Frame Data" },
+        { 0x6D, "Gesture Character Enable" }, { 0x6E, "Transducer Serial Number Part 2" },
+        { 0x6F, "No Preferred Color" }, { 0x70, "Preferred Line Style" },
+        { 0x71, "Preferred Line Style is Locked" }, { 0x72, "Ink" }, { 0x73, "Pencil" },
+        { 0x74, "Highlighter" }, { 0x75, "Chisel Marker" }, { 0x76, "Brush" },
+        { 0x77, "No Preference" }, { 0x80, "Digitizer Diagnostic" },
+        { 0x81, "Digitizer Error" }, { 0x82, "Err Normal Status" },
+        { 0x83, "Err Transducers Exceeded" }, { 0x84, "Err Full Trans Features Unavailable" },
+        { 0x85, "Err Charge Low" }, { 0x90, "Transducer Software Info" },
+        { 0x91, "Transducer Vendor Id" }, { 0x92, "Transducer Product Id" },
+        { 0x93, "Device Supported Protocols" }, { 0x94, "Transducer Supported Protocols" },
+        { 0x95, "No Protocol" }, { 0x96, "Wacom AES Protocol" }, { 0x97, "USI Protocol" },
+        { 0x98, "Microsoft Pen Protocol" }, { 0xA0, "Supported Report Rates" },
+        { 0xA1, "Report Rate" }, { 0xA2, "Transducer Connected" }, { 0xA3, "Switch Disabled" },
+        { 0xA4, "Switch Unimplemented" }, { 0xA5, "Transducer Switches" },
+        { 0xA6, "Transducer Index Selector" }, { 0xB0, "Button Press Threshold" },
+    };
+
+    constexpr Name kPhysicalInputDevice[] =
+    {
+        { 0x01, "Physical Input Device" }, { 0x20, "Normal" }, { 0x21, "Set Effect Report" },
+        { 0x22, "Effect Parameter Block Index" }, { 0x23, "Parameter Block Offset" },
+        { 0x24, "ROM Flag" }, { 0x25, "Effect Type" }, { 0x26, "ET Constant-Force" },
+        { 0x27, "ET Ramp" }, { 0x28, "ET Custom-Force" }, { 0x30, "ET Square" }, { 0x31, "ET Sine" },
+        { 0x32, "ET Triangle" }, { 0x33, "ET Sawtooth Up" }, { 0x34, "ET Sawtooth Down" },
+        { 0x40, "ET Spring" }, { 0x41, "ET Damper" }, { 0x42, "ET Inertia" }, { 0x43, "ET Friction" },
+        { 0x50, "Duration" }, { 0x51, "Sample Period" }, { 0x52, "Gain" }, { 0x53, "Trigger Button" },
+        { 0x54, "Trigger Repeat Interval" }, { 0x55, "Axes Enable" }, { 0x56, "Direction Enable" },
+        { 0x57, "Direction" }, { 0x58, "Type Specific Block Offset" }, { 0x59, "Block Type" },
+        { 0x5A, "Set Envelope Report" }, { 0x5B, "Attack Level" }, { 0x5C, "Attack Time" },
+        { 0x5D, "Fade Level" }, { 0x5E, "Fade Time" }, { 0x5F, "Set Condition Report" },
+        { 0x60, "Center-Point Offset" }, { 0x61, "Positive Coefficient" },
+        { 0x62, "Negative Coefficient" }, { 0x63, "Positive Saturation" },
+        { 0x64, "Negative Saturation" }, { 0x65, "Dead Band" }, { 0x66, "Download Force Sample" },
+        { 0x67, "Isoch Custom-Force Enable" }, { 0x68, "Custom-Force Data Report" },
+        { 0x69, "Custom-Force Data" }, { 0x6A, "Custom-Force Vendor Defined Data" },
+        { 0x6B, "Set Custom-Force Report" }, { 0x6C, "Custom-Force Data Offset" },
+        { 0x6D, "Sample Count" }, { 0x6E, "Set Periodic Report" }, { 0x6F, "Offset" },
+        { 0x70, "Magnitude" }, { 0x71, "Phase" }, { 0x72, "Period" },
+        { 0x73, "Set Constant-Force Report" }, { 0x74, "Set Ramp-Force Report" },
+        { 0x75, "Ramp Start" }, { 0x76, "Ramp End" }, { 0x77, "Effect Operation Report" },
+        { 0x78, "Effect Operation" }, { 0x79, "Op Effect Start" }, { 0x7A, "Op Effect Start Solo" },
+        { 0x7B, "Op Effect Stop" }, { 0x7C, "Loop Count" }, { 0x7D, "Device Gain Report" },
+        { 0x7E, "Device Gain" }, { 0x7F, "Parameter Block Pools Report" },
+        { 0x80, "RAM Pool Size" }, { 0x81, "ROM Pool Size" }, { 0x82, "ROM Effect Block Count" },
+        { 0x83, "Simultaneous Effects Max" }, { 0x84, "Pool Alignment" },
+        { 0x85, "Parameter Block Move Report" }, { 0x86, "Move Source" },
+        { 0x87, "Move Destination" }, { 0x88, "Move Length" }, { 0x89, "Effect Parameter Block Load Report" },
+        { 0x8B, "Effect Parameter Block Load Status" }, { 0x8C, "Block Load Success" },
+        { 0x8D, "Block Load Full" }, { 0x8E, "Block Load Error" }, { 0x8F, "Block Handle" },
+        { 0x90, "Effect Parameter Block Free Report" }, { 0x91, "Type Specific Block Handle" },
+        { 0x92, "PID State Report" }, { 0x94, "Effect Playing" },
+        { 0x95, "PID Device Control Report" }, { 0x96, "PID Device Control" },
+        { 0x97, "DC Enable Actuators" }, { 0x98, "DC Disable Actuators" },
+        { 0x99, "DC Stop All Effects" }, { 0x9A, "DC Reset" }, { 0x9B, "DC Pause" },
+        { 0x9C, "DC Continue" }, { 0x9F, "Device Paused" }, { 0xA0, "Actuators Enabled" },
+        { 0xA4, "Safety Switch" }, { 0xA5, "Actuator Override Switch" }, { 0xA6, "Actuator Power" },
+        { 0xA7, "Start Delay" }, { 0xA8, "Parameter Block Size" },
+        { 0xA9, "Device-Managed Pool" }, { 0xAA, "Shared Parameter Blocks" },
+        { 0xAB, "Create New Effect Parameter Block Report" }, { 0xAC, "RAM Pool Available" },
+    };
+
+    // Pages without a usage table above are still named.
+    struct Page
+    {
+        uint16_t             id;
+        std::string_view     name;
+        std::span<const Name> usages;
+    };
+
+    constexpr Page kPages[] =
+    {
+        { 0x01, "Generic Desktop", kGenericDesktop },
+        { 0x02, "Simulation Controls", kSimulationControls },
+        { 0x03, "VR Controls", {} },
+        { 0x04, "Sport Controls", {} },
+        { 0x05, "Game Controls", kGameControls },
+        { 0x06, "Generic Device Controls", kGenericDeviceControls },
+        { 0x07, "Keyboard/Keypad", kKeyboard },
+        { 0x08, "LED", kLed },
+        { 0x09, "Button", {} },
+        { 0x0A, "Ordinal", {} },
+        { 0x0B, "Telephony Device", {} },
+        { 0x0C, "Consumer", kConsumer },
+        { 0x0D, "Digitizers", kDigitizers },
+        { 0x0E, "Haptics", {} },
+        { 0x0F, "Physical Input Device", kPhysicalInputDevice },
+        { 0x10, "Unicode", {} },
+        { 0x11, "SoC", {} },
+        { 0x12, "Eye and Head Trackers", {} },
+        { 0x14, "Auxiliary Display", {} },
+        { 0x20, "Sensors", {} },
+        { 0x40, "Medical Instrument", {} },
+        { 0x41, "Braille Display", {} },
+        { 0x59, "Lighting And Illumination", {} },
+        { 0x80, "Monitor", {} },
+        { 0x81, "Monitor Enumerated", {} },
+        { 0x82, "VESA Virtual Controls", {} },
+        { 0x84, "Power", {} },
+        { 0x85, "Battery System", {} },
+        { 0x8C, "Barcode Scanner", {} },
+        { 0x8D, "Scales", {} },
+        { 0x8E, "Magnetic Stripe Reader", {} },
+        { 0x90, "Camera Control", {} },
+        { 0x91, "Arcade", {} },
+        { 0x92, "Gaming Device", {} },
+        { 0xF1D0, "FIDO Alliance", {} },
+    };
+
+    template<typename T>
+    const T* FindById(std::span<const T> table, uint16_t id)
+    {
+        auto it = std::lower_bound(table.begin(), table.end(), id,
+            [](const T& entry, uint16_t value) { return entry.id < value; });
+        return it != table.end() && it->id == id ? &*it : nullptr;
+    }
+
+    constexpr std::string_view kReportTypes[] = { "Input", "Output", "Feature" };
+
+    // Unit system names and the unit of each dimension (nibbles 1-6) per
+    // system, HID 1.11 section 6.2.2.7.
+    constexpr std::string_view kUnitSystems[] = { "None", "SI Linear", "SI Rotation", "English Linear", "English Rotation" };
+    constexpr std::string_view kUnitNames[4][6] =
+    {
+        { "cm", "g", "s", "K", "A", "cd" },
+        { "rad", "g", "s", "K", "A", "cd" },
+        { "in", "slug", "s", "F", "A", "cd" },
+        { "deg", "slug", "s", "F", "A", "cd" },
+    };
+
+    // Sign-extends a unit or unit exponent nibble.
+    int32_t Nibble(uint32_t value)
+    {
+        return static_cast<int32_t>(value & 0x7) - static_cast<int32_t>(value & 0x8);
+    }
+
+    // Local items collected for the next Main item's field.
+    struct Locals
+    {
+        uint32_t usages[4] = {};
+        uint8_t  count = 0;
+        bool     more = false;
+        uint32_t usageMin = 0;
+        uint32_t usageMax = 0;
+        bool     hasMin = false;
+        bool     hasMax = false;
+    };
+
+    // Usage as page << 16 | id; extended (4-byte) usages carry their own page.
+    uint32_t ExtendUsage(const HidItem& item, uint16_t usagePage)
+    {
+        return item.size == 4 ? item.data : (uint32_t(usagePage) << 16) | (item.data & 0xFFFF);
+    }
+}
+
+HidDescriptorDisassembler::HidDescriptorDisassembler(size_t reserveBytes)
+{
+    m_Buffer.resize(std::max(reserveBytes, kMaxLine));
+    m_Fields.reserve(256);
+}
+
+std::string_view HidDescriptorDisassembler::Disassemble(std::span<const uint8_t> descriptor, uint32_t flags)
+{
+    m_Size = 0;
+    m_Fields.clear();
+    m_HasReportIds = false;
+
+    RenderItems(descriptor, flags);
+    if (flags & Layout)
+        RenderLayout();
+
+    return std::string_view(m_Buffer.data(), m_Size);
+}
+
+// ---------------------------------------------------------------------------
+// Items
+// ---------------------------------------------------------------------------
+
+void HidDescriptorDisassembler::RenderItems(std::span<const uint8_t> descriptor, uint32_t flags)
+{
+    const bool showBytes = flags & Bytes;
+    const int offsetDigits = descriptor.size() > 0xFFFF ? 8 : 4;
+
+    HidItemReader reader(descriptor);
+    GlobalState g;
+    std::array<GlobalState, kMaxPush> stack;
+    size_t stackSize = 0;
+    Locals locals;
+    std::array<uint64_t, 3 * 256> bitEnd{}; // next free bit per report type and Report ID
+    size_t depth = 0;
+    uint32_t order = 0;
+
+    while (std::optional<HidItem> item = reader.Next())
+    {
+        const uint8_t tag = item->GetTag();
+
+        const bool unbalanced = tag == HID_END_COLLECTION && !item->IsLong() && depth == 0;
+        if (tag == HID_END_COLLECTION && !item->IsLong() && !unbalanced)
+            --depth;
+
+        // Lines are always rendered and dropped again when only the layout
+        // is wanted; the state tracking below is shared either way.
+        const size_t lineStart = m_Size;
+        BeginLine();
+
+        if (showBytes)
+        {
+            PutHex(static_cast<uint32_t>(item->offset), offsetDigits);
+            Put(": ");
+            const size_t itemSize = reader.GetOffset() - item->offset;
+            for (size_t i = 0; i < 5; ++i)
+            {
+                if (i < itemSize && (i < 4 || itemSize == 5))
+                {
+                    PutHex(descriptor[item->offset + i], 2);
+                    Put(' ');
+                }
+                else if (i == 4 && itemSize > 5)
+                    Put(".. ");
+                else
+                    Put("   ");
+            }
+            Put(' ');
+        }
+
+        for (size_t i = 0; i < std::min(depth, kMaxIndent); ++i)
+            Put("  ");
+
+        if (item->IsLong())
+        {
+            Put("Long Item (tag 0x");
+            PutHex(descriptor[item->offset + 2], 2);
+            Put(", ");
+            PutDec(item->size);
+            Put(" bytes)\n");
+            if (!(flags & Items))
+                m_Size = lineStart;
+            continue;
+        }
+
+        switch (tag)
+        {
+        // Global items
+        case HID_USAGE_PAGE:
+            g.UsagePage = static_cast<uint16_t>(item->data);
+            Put("Usage Page (");
+            PutUsagePage(g.UsagePage);
+            Put(')');
+            break;
+        case HID_LOG_MIN:
+            g.LogMin = item->GetSigned();
+            Put("Logical Minimum (");
+            PutDec(g.LogMin);
+            Put(')');
+            break;
+        case HID_LOG_MAX:
+            g.LogMax = item->GetSigned();
+            Put("Logical Maximum (");
+            PutDec(g.LogMax);
+            Put(')');
+            break;
+        case HID_PHY_MIN:
+            g.PhyMin = item->GetSigned();
+            Put("Physical Minimum (");
+            PutDec(g.PhyMin);
+            Put(')');
+            break;
+        case HID_PHY_MAX:
+            g.PhyMax = item->GetSigned();
+            Put("Physical Maximum (");
+            PutDec(g.PhyMax);
+            Put(')');
+            break;
+        case HID_UNIT_EXP:
+            g.UnitExp = item->data;
+            Put("Unit Exponent (");
+            PutDec(item->data <= 0xF ? Nibble(item->data) : item->GetSigned());
+            Put(')');
+            break;
+        case HID_UNIT:
+            g.Unit = item->data;
+            Put("Unit (");
+            PutUnit(item->data);
+            Put(')');
+            break;
+        case HID_REPORT_SIZE:
+            g.ReportSize = static_cast<uint16_t>(item->data);
+            Put("Report Size (");
+            PutDec(item->data);
+            Put(')');
+            break;
+        case HID_REPORT_ID:
+            g.ReportID = static_cast<uint8_t>(item->data);
+            m_HasReportIds = true;
+            Put("Report ID (");
+            PutDec(item->data);
+            Put(')');
+            if (item->data == 0 || item->data > 0xFF)
+                Put(" ; invalid");
+            break;
+        case HID_REPORT_COUNT:
+            g.ReportCount = static_cast<uint16_t>(item->data);
+            Put("Report Count (");
+            PutDec(item->data);
+            Put(')');
+            break;
+        case HID_PUSH:
+            Put("Push");
+            if (stackSize < stack.size())
+                stack[stackSize++] = g;
+            else
+                Put(" ; nested too deep, ignored");
+            break;
+        case HID_POP:
+            Put("Pop");
+            if (stackSize > 0)
+                g = stack[--stackSize];
+            else
+                Put(" ; nothing pushed");
+            break;
+
+        // Local items
+        case HID_USAGE:
+        {
+            const uint32_t usage = ExtendUsage(*item, g.UsagePage);
+            if (locals.count < std::size(locals.usages))
+                locals.usages[locals.count++] = usage;
+            else
+                locals.more = true;
+            Put("Usage (");
+            if (item->size == 4)
+            {
+                PutUsagePage(static_cast<uint16_t>(usage >> 16));
+                Put(": ");
+            }
+            PutUsage(static_cast<uint16_t>(usage >> 16), static_cast<uint16_t>(usage));
+            Put(')');
+            break;
+        }
+        case HID_USAGE_MIN:
+        case HID_USAGE_MAX:
+        {
+            const uint32_t usage = ExtendUsage(*item, g.UsagePage);
+            if (tag == HID_USAGE_MIN)
+            {
+                locals.usageMin = usage;
+                locals.hasMin = true;
+                Put("Usage Minimum (");
+            }
+            else
+            {
+                locals.usageMax = usage;
+                locals.hasMax = true;
+                Put("Usage Maximum (");
+            }
+            if (item->size == 4)
+            {
+                PutUsagePage(static_cast<uint16_t>(usage >> 16));
+                Put(": ");
+            }
+            PutUsage(static_cast<uint16_t>(usage >> 16), static_cast<uint16_t>(usage));
+            Put(')');
+            break;
+        }
+        case HID_DESIGNATOR_INDEX:
+        case HID_DESIGNATOR_MIN:
+        case HID_DESIGNATOR_MAX:
+        case HID_STRING_INDEX:
+        case HID_STRING_MIN:
+        case HID_STRING_MAX:
+        {
+            static constexpr std::string_view kNames[] =
+            {
+                "Designator Index (", "Designator Minimum (", "Designator Maximum (", "",
+                "String Index (", "String Minimum (", "String Maximum (",
+            };
+            Put(kNames[(tag - HID_DESIGNATOR_INDEX) >> 4]);
+            PutDec(item->data);
+            Put(')');
+            break;
+        }
+        case HID_DELIMITER:
+            Put(item->data == 1 ? "Delimiter (Open)" : item->data == 0 ? "Delimiter (Close)" : "Delimiter (?)");
+            break;
+
+        // Main items
+        case HID_INPUT:
+        case HID_OUTPUT:
+        case HID_FEATURE:
+        {
+            const uint8_t type = tag == HID_INPUT ? 0 : tag == HID_OUTPUT ? 1 : 2;
+            Put(kReportTypes[type]);
+            Put(" (");
+            PutMainFlags(tag, item->data);
+            Put(')');
+
+            Field& field = m_Fields.emplace_back();
+            field.reportType = type;
+            field.reportId = g.ReportID;
+            field.order = order++;
+            field.reportSize = g.ReportSize;
+            field.reportCount = g.ReportCount;
+            field.flags = item->data;
+
+            uint64_t& end = bitEnd[type * 256 + g.ReportID];
+            field.bitOffset = end;
+            end += uint64_t(field.reportSize) * field.reportCount;
+
+            std::copy_n(locals.usages, locals.count, field.usages);
+            field.usageCount = locals.count;
+            field.moreUsages = locals.more;
+            if (locals.hasMin && locals.hasMax)
+            {
+                if (locals.count == 0)
+                {
+                    field.usages[0] = locals.usageMin;
+                    field.usages[1] = locals.usageMax;
+                    field.usageCount = 2;
+                    field.isRange = true;
+                }
+                else
+                    field.moreUsages = true;
+            }
+            locals = {};
+            break;
+        }
+        case HID_COLLECTION:
+        {
+            static constexpr std::string_view kTypes[] =
+            {
+                "Physical", "Application", "Logical", "Report", "Named Array", "Usage Switch", "Usage Modifier",
+            };
+            Put("Collection (");
+            if (item->data < std::size(kTypes))
+                Put(kTypes[item->data]);
+            else if (item->data >= 0x80 && item->data <= 0xFF)
+            {
+                Put("Vendor 0x");
+                PutHex(item->data, 2);
+            }
+            else
+            {
+                Put("Reserved 0x");
+                PutHex(item->data, 2);
+            }
+            Put(')');
+            ++depth;
+            locals = {};
+            break;
+        }
+        case HID_END_COLLECTION:
+            Put("End Collection");
+            if (unbalanced)
+                Put(" ; no collection open");
+            locals = {};
+            break;
+
+        default:
+            Put("Unknown (tag 0x");
+            PutHex(item->prefix, 2);
+            if (item->size)
+            {
+                Put(", data 0x");
+                PutHex(item->data, item->size * 2);
+            }
+            Put(')');
+            break;
+        }
+
+        Put('\n');
+        if (!(flags & Items))
+            m_Size = lineStart;
+    }
+
+    if (reader.IsTruncated())
+    {
+        BeginLine();
+        Put("*** descriptor ends inside an item (");
+        PutDec(descriptor.size());
+        Put(" bytes)\n");
+    }
+    if (depth != 0)
+    {
+        BeginLine();
+        Put("*** ");
+        PutDec(depth);
+        Put(depth == 1 ? " collection not closed\n" : " collections not closed\n");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Report layout
+// ---------------------------------------------------------------------------
+
+void HidDescriptorDisassembler::RenderLayout()
+{
+    std::sort(m_Fields.begin(), m_Fields.end(), [](const Field& a, const Field& b)
+        {
+            if (a.reportType != b.reportType)
+                return a.reportType < b.reportType;
+            if (a.reportId != b.reportId)
+                return a.reportId < b.reportId;
+            return a.order < b.order;
+        });
+
+    for (size_t begin = 0; begin < m_Fields.size();)
+    {
+        const Field& first = m_Fields[begin];
+        size_t end = begin;
+        uint64_t bits = 0;
+        while (end < m_Fields.size() && m_Fields[end].reportType == first.reportType && m_Fields[end].reportId == first.reportId)
+        {
+            const Field& field = m_Fields[end++];
+            bits = std::max<uint64_t>(bits, uint64_t(field.bitOffset) + uint64_t(field.reportSize) * field.reportCount);
+        }
+
+        BeginLine();
+        Put('\n');
+        Put(kReportTypes[first.reportType]);
+        Put(" report");
+        if (m_HasReportIds)
+        {
+            Put(' ');
+            PutDec(first.reportId);
+        }
+        Put(": ");
+        PutDec(static_cast<int64_t>((bits + 7) / 8 + (m_HasReportIds ? 1 : 0)));
+        Put(m_HasReportIds ? " bytes with Report ID\n" : " bytes\n");
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Field& field = m_Fields[i];
+
+            BeginLine();
+            Put("  bit ");
+            PutDec(static_cast<int64_t>(field.bitOffset), 5);
+            Put("  ");
+            PutDec(field.reportSize, 2);
+            Put(" x ");
+            PutDec(field.reportCount, -5);
+            Put(' ');
+            const size_t flagsStart = m_Size;
+            PutMainFlags(field.reportType == 0 ? HID_INPUT : HID_FEATURE, field.flags);
+            while (m_Size - flagsStart < 14)
+                Put(' ');
+            Put("  ");
+
+            if (field.usageCount == 0)
+                Put(field.flags & 0x01 ? "padding" : "no usage");
+
+            uint16_t lastPage = 0;
+            for (uint8_t u = 0; u < field.usageCount; ++u)
+            {
+                const uint16_t page = static_cast<uint16_t>(field.usages[u] >> 16);
+                if (u != 0)
+                    Put(field.isRange ? " .. " : ", ");
+                if (u == 0 || page != lastPage)
+                {
+                    PutUsagePage(page);
+                    Put(": ");
+                    lastPage = page;
+                }
+                PutUsage(page, static_cast<uint16_t>(field.usages[u]));
+            }
+            if (field.moreUsages)
+                Put(", ...");
+            Put('\n');
+        }
+
+        begin = end;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Writers
+// ---------------------------------------------------------------------------
+
+void HidDescriptorDisassembler::BeginLine()
+{
+    if (m_Buffer.size() - m_Size < kMaxLine)
+        m_Buffer.resize(std::max(m_Buffer.size() * 2, m_Size + kMaxLine));
+}
+
+void HidDescriptorDisassembler::Put(std::string_view text)
+{
+    assert(m_Size + text.size() <= m_Buffer.size() && "line longer than kMaxLine");
+    std::memcpy(m_Buffer.data() + m_Size, text.data(), text.size());
+    m_Size += text.size();
+}
+
+void HidDescriptorDisassembler::PutDec(int64_t value, int width)
+{
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do
+    {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        *--p = '-';
+
+    // Positive width pads on the left, negative on the right. The length
+    // comes straight from the pointers, so the compiler sees it is at most
+    // sizeof(digits).
+    const std::string_view text(p, static_cast<size_t>(end - p));
+    const int length = static_cast<int>(text.size());
+    for (int i = length; i < width; ++i)
+        Put(' ');
+    Put(text);
+    for (int i = length; i < -width; ++i)
+        Put(' ');
+}
+
+void HidDescriptorDisassembler::PutHex(uint32_t value, int digits)
+{
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    for (int i = digits - 1; i >= 0; --i)
+        Put(kHex[(value >> (4 * i)) & 0xF]);
+}
+
+void HidDescriptorDisassembler::PutUsagePage(uint16_t page)
+{
+    if (const Page* entry = FindById<Page>(kPages, page))
+    {
+        Put(entry->name);
+        return;
+    }
+
+    Put(page >= 0xFF00 ? "Vendor 0x" : "0x");
+    PutHex(page, 4);
+}
+
+void HidDescriptorDisassembler::PutUsage(uint16_t page, uint16_t usage)
+{
+    switch (page)
+    {
+    case 0x07: // Keyboard/Keypad
+        if (usage >= 0x04 && usage <= 0x1D)
+        {
+            Put("Keyboard ");
+            Put(static_cast<char>('A' + usage - 0x04));
+            return;
+        }
+        if (usage >= 0x1E && usage <= 0x27)
+        {
+            Put("Keyboard ");
+            Put(static_cast<char>(usage == 0x27 ? '0' : '1' + usage - 0x1E));
+            return;
+        }
+        if (usage >= 0x59 && usage <= 0x62)
+        {
+            Put("Keypad ");
+            Put(static_cast<char>(usage == 0x62 ? '0' : '1' + usage - 0x59));
+            return;
+        }
+        if ((usage >= 0x3A && usage <= 0x45) || (usage >= 0x68 && usage <= 0x73))
+        {
+            Put("Keyboard F");
+            PutDec(usage <= 0x45 ? usage - 0x3A + 1 : usage - 0x68 + 13);
+            return;
+        }
+        break;
+    case 0x09: // Button
+        if (usage == 0)
+        {
+            Put("No Button Pressed");
+            return;
+        }
+        Put("Button ");
+        PutDec(usage);
+        return;
+    case 0x0A: // Ordinal
+        Put("Instance ");
+        PutDec(usage);
+        return;
+    }
+
+    if (const Page* entry = FindById<Page>(kPages, page))
+    {
+        if (const Name* name = FindById<Name>(entry->usages, usage))
+        {
+            Put(name->name);
+            return;
+        }
+    }
+
+    Put("0x");
+    PutHex(usage, 4);
+}
+
+void HidDescriptorDisassembler::PutUnit(uint32_t unit)
+{
+    const uint32_t system = unit & 0xF;
+    if (system == 0 || system > 4)
+    {
+        // No system: the other nibbles carry no meaning.
+        Put(system == 0 ? "None" : "Vendor");
+        if (unit != system)
+        {
+            Put(" 0x");
+            PutHex(unit, 8);
+        }
+        return;
+    }
+
+    Put(kUnitSystems[system]);
+    for (int i = 0; i < 6; ++i)
+    {
+        const int32_t exponent = Nibble(unit >> (4 * (i + 1)));
+        if (exponent == 0)
+            continue;
+        Put(' ');
+        Put(kUnitNames[system - 1][i]);
+        if (exponent != 1)
+        {
+            Put('^');
+            PutDec(exponent);
+        }
+    }
+}
+
+void HidDescriptorDisassembler::PutMainFlags(uint8_t tag, uint32_t flags)
+{
+    Put(flags & 0x001 ? "Const" : "Data");
+    Put(flags & 0x002 ? ",Var" : ",Array");
+    Put(flags & 0x004 ? ",Rel" : ",Abs");
+    if (flags & 0x008)
+        Put(",Wrap");
+    if (flags & 0x010)
+        Put(",NonLinear");
+    if (flags & 0x020)
+        Put(",NoPreferred");
+    if (flags & 0x040)
+        Put(",Null");
+    if ((flags & 0x080) && tag != HID_INPUT)
+        Put(",Volatile");
+    if (flags & 0x100)
+        Put(",Buffered");
+}
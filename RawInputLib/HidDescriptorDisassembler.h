@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Renders a HID report descriptor as text: one line per item, indented by
+// collection and with names from the HID Usage Tables, and optionally the
+// report layout that follows from it, the bit offset of every field of every
+// report per Report ID.
+//
+// All text goes into one buffer owned by the disassembler and reused across
+// calls. It is sized up front and only grows if a descriptor needs more, so
+// a disassembler kept around allocates nothing in steady state.
+class HidDescriptorDisassembler
+{
+public:
+    enum Flags : uint32_t
+    {
+        Items = 1 << 0,  // one line per item
+        Bytes = 1 << 1,  // offset and raw bytes in front of each item
+        Layout = 1 << 2, // fields of every report, by report type and Report ID
+    };
+
+    explicit HidDescriptorDisassembler(size_t reserveBytes = 256 * 1024);
+
+    // Text for `descriptor`, valid until the next call. A malformed
+    // descriptor is rendered up to the bad item and followed by a note.
+    std::string_view Disassemble(std::span<const uint8_t> descriptor, uint32_t flags = Items | Layout);
+
+private:
+    // One Main item's worth of report bits.
+    struct Field
+    {
+        uint8_t  reportType = 0; // 0 Input, 1 Output, 2 Feature
+        uint8_t  reportId = 0;
+        uint32_t order = 0;      // position in the descriptor
+        uint64_t bitOffset = 0;  // from the first bit after the Report ID byte
+        uint32_t reportSize = 0;
+        uint32_t reportCount = 0;
+        uint32_t flags = 0;
+        uint32_t usages[4] = {}; // page << 16 | usage; [0]..[1] if isRange
+        uint8_t  usageCount = 0;
+        bool     isRange = false;
+        bool     moreUsages = false;
+    };
+
+    void RenderItems(std::span<const uint8_t> descriptor, uint32_t flags);
+    void RenderLayout();
+
+    // Writers. Each line starts with BeginLine(), which makes room for the
+    // longest possible line, so the rest write without checks.
+    void BeginLine();
+    void Put(std::string_view text);
+    void Put(char c) { m_Buffer[m_Size++] = c; }
+    void PutDec(int64_t value, int width = 0); // width < 0 pads on the right
+    void PutHex(uint32_t value, int digits);
+    void PutUsagePage(uint16_t page);
+    void PutUsage(uint16_t page, uint16_t usage);
+    void PutUnit(uint32_t unit);
+    void PutMainFlags(uint8_t tag, uint32_t flags);
+
+    std::vector<char>  m_Buffer;
+    size_t             m_Size = 0;
+    std::vector<Field> m_Fields;
+    bool               m_HasReportIds = false;
+};
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "utils_simd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// HID 1.11 report descriptor items (section 6.2.2): the tag constants, a
+// reader for raw descriptors and the writer every descriptor this library
+// emits goes through.
+
+// ---------------------------------------------------------------------------
+// HID 1.11 short-item tag constants (table 6.2.2)
+// Lower 2 bits encode data size: 0=0B 1=1B 2=2B 3=4B — we fill them at emit.
+// ---------------------------------------------------------------------------
+
+// Global items
+inline constexpr uint8_t HID_USAGE_PAGE = 0x04;
+inline constexpr uint8_t HID_LOG_MIN = 0x14;
+inline constexpr uint8_t HID_LOG_MAX = 0x24;
+inline constexpr uint8_t HID_PHY_MIN = 0x34;
+inline constexpr uint8_t HID_PHY_MAX = 0x44;
+inline constexpr uint8_t HID_UNIT_EXP = 0x54;
+inline constexpr uint8_t HID_UNIT = 0x64;
+inline constexpr uint8_t HID_REPORT_SIZE = 0x74;
+inline constexpr uint8_t HID_REPORT_ID = 0x84;
+inline constexpr uint8_t HID_REPORT_COUNT = 0x94;
+inline constexpr uint8_t HID_PUSH = 0xA4;
+inline constexpr uint8_t HID_POP = 0xB4;
+
+// Local items
+inline constexpr uint8_t HID_USAGE = 0x08;
+inline constexpr uint8_t HID_USAGE_MIN = 0x18;
+inline constexpr uint8_t HID_USAGE_MAX = 0x28;
+inline constexpr uint8_t HID_DESIGNATOR_INDEX = 0x38; // single designator
+inline constexpr uint8_t HID_DESIGNATOR_MIN = 0x48; // designator range start
+inline constexpr uint8_t HID_DESIGNATOR_MAX = 0x58; // designator range end
+inline constexpr uint8_t HID_STRING_INDEX = 0x78; // single string
+inline constexpr uint8_t HID_STRING_MIN = 0x88; // string range start
+inline constexpr uint8_t HID_STRING_MAX = 0x98; // string range end
+inline constexpr uint8_t HID_DELIMITER = 0xA8;
+
+// Main items
+inline constexpr uint8_t HID_INPUT = 0x80;
+inline constexpr uint8_t HID_OUTPUT = 0x90;
+inline constexpr uint8_t HID_FEATURE = 0xB0;
+inline constexpr uint8_t HID_COLLECTION = 0xA0;
+inline constexpr uint8_t HID_END_COLLECTION = 0xC0; // 0-byte item
+
+// Item type, bits 2-3 of the prefix.
+inline constexpr uint8_t HID_TYPE_MAIN = 0x00;
+inline constexpr uint8_t HID_TYPE_GLOBAL = 0x04;
+inline constexpr uint8_t HID_TYPE_LOCAL = 0x08;
+
+inline constexpr uint8_t HID_LONG_ITEM = 0xFE;
+
+// ---------------------------------------------------------------------------
+// Descriptor item reader
+// ---------------------------------------------------------------------------
+
+struct HidItem
+{
+    uint8_t  prefix = 0;  // tag | type | size; HID_LONG_ITEM for long items
+    uint8_t  size = 0;    // data bytes: 0, 1, 2 or 4 (long items: bDataSize)
+    uint32_t data = 0;    // zero-extended; long item data is not decoded
+    size_t   offset = 0;  // of the prefix byte
+
+    bool    IsLong() const { return prefix == HID_LONG_ITEM; }
+    uint8_t GetTag() const { return prefix & 0xFC; }   // tag and type, as the HID_* constants
+    uint8_t GetType() const { return prefix & 0x0C; }  // HID_TYPE_*
+
+    // Data as a signed value of its own width (Logical/Physical Min/Max).
+    int32_t GetSigned() const
+    {
+        switch (size)
+        {
+        case 1:  return static_cast<int8_t>(data);
+        case 2:  return static_cast<int16_t>(data);
+        default: return static_cast<int32_t>(data);
+        }
+    }
+};
+
+class HidItemReader
+{
+public:
+    explicit HidItemReader(std::span<const uint8_t> descriptor) : m_Descriptor(descriptor) {}
+
+    // The next item; nullopt at the end or at an item cut off by the end.
+    std::optional<HidItem> Next()
+    {
+        if (m_Offset >= m_Descriptor.size())
+            return std::nullopt;
+
+        HidItem item;
+        item.offset = m_Offset;
+        item.prefix = m_Descriptor[m_Offset];
+
+        size_t header = 1;
+        if (item.IsLong())
+        {
+            if (m_Descriptor.size() - m_Offset < 3)
+                return Truncate();
+            item.size = m_Descriptor[m_Offset + 1];
+            header = 3;
+        }
+        else
+        {
+            static constexpr uint8_t kSizes[4] = { 0, 1, 2, 4 };
+            item.size = kSizes[item.prefix & 0x03];
+        }
+
+        if (m_Descriptor.size() - m_Offset - header < item.size)
+            return Truncate();
+
+        if (!item.IsLong())
+        {
+            for (size_t i = 0; i < item.size; ++i)
+                item.data |= static_cast<uint32_t>(m_Descriptor[m_Offset + header + i]) << (8 * i);
+        }
+
+        m_Offset += header + item.size;
+        return item;
+    }
+
+    bool IsTruncated() const { return m_Truncated; }
+
+    // Bytes consumed so far.
+    size_t GetOffset() const { return m_Offset; }
+
+private:
+    std::optional<HidItem> Truncate()
+    {
+        m_Truncated = true;
+        m_Offset = m_Descriptor.size();
+        return std::nullopt;
+    }
+
+    std::span<const uint8_t> m_Descriptor;
+    size_t                   m_Offset = 0;
+    bool                     m_Truncated = false;
+};
+
+// ---------------------------------------------------------------------------
+// Descriptor byte-stream builder
+//
+// Either collects the bytes or streams them into a simd::ByteHasher, so a
+// descriptor can be fingerprinted without being materialised.
+// ---------------------------------------------------------------------------
+
+class DescriptorWriter {
+public:
+    DescriptorWriter() = default;
+    explicit DescriptorWriter(simd::ByteHasher& hasher) : hasher_(&hasher) {}
+
+    // Unsigned item — always emits at least 1 data byte (val=0 → one 0x00 byte).
+    // force_bytes: 0=minimal(≥1), 1/2/4=exact width.
+    void itemU(uint8_t tag, uint32_t val, int force_bytes = 0) {
+        int nb = (force_bytes > 0) ? force_bytes : minUnsignedBytes(val);
+        emitTagAndData(tag & 0xFC, val, nb);
+    }
+
+    // Signed item — sign-extended minimal encoding (0 → one 0x00 byte).
+    void itemS(uint8_t tag, int32_t val) {
+        emitTagAndData(tag & 0xFC, static_cast<uint32_t>(val), minSignedBytes(val));
+    }
+
+    // Raw bytes — for verbatim re-emission of unknown global tokens.
+    void raw(uint8_t b) { put(&b, 1); }
+    void raw(const void* p, size_t n) { put(static_cast<const uint8_t*>(p), n); }
+
+    // Empty when streaming into a hasher.
+    const std::vector<uint8_t>& bytes() const { return buf_; }
+    size_t size() const { return size_; }
+
+private:
+    std::vector<uint8_t> buf_;
+    simd::ByteHasher*    hasher_ = nullptr;
+    size_t               size_ = 0;
+
+    // Items are handed over whole: one call per item instead of per byte.
+    void put(const uint8_t* p, size_t n) {
+        size_ += n;
+        if (hasher_) hasher_->Update(p, n);
+        else buf_.insert(buf_.end(), p, p + n);
+    }
+
+    void emitTagAndData(uint8_t base, uint32_t val, int nb) {
+        // nb 0 is only valid for END_COLLECTION; every other item is written
+        // with ≥1 data byte. Size code 3 means 4 bytes.
+        const uint8_t sizeCode = static_cast<uint8_t>(nb > 2 ? 3 : nb);
+        const uint8_t item[5] = {
+            static_cast<uint8_t>(base | sizeCode),
+            static_cast<uint8_t>(val),
+            static_cast<uint8_t>(val >> 8),
+            static_cast<uint8_t>(val >> 16),
+            static_cast<uint8_t>(val >> 24),
+        };
+        put(item, nb > 2 ? 5 : 1 + static_cast<size_t>(nb));
+    }
+
+    // Minimum bytes to represent v unsigned (always ≥ 1).
+    static int minUnsignedBytes(uint32_t v) {
+        if (v <= 0xFF)   return 1;
+        if (v <= 0xFFFF) return 2;
+        return 4;
+    }
+
+    // Minimum bytes to represent v signed (always ≥ 1).
+    static int minSignedBytes(int32_t v) {
+        if (v >= -128 && v <= 127)   return 1;
+        if (v >= -32768 && v <= 32767) return 2;
+        return 4;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Global item state — tracks last-emitted values to suppress redundant items.
+// Initialised to "nothing ever emitted" so first channel forces all globals;
+// as parser state it starts at the HID 1.11 defaults, all zero.
+// ---------------------------------------------------------------------------
+
+struct GlobalState {
+    uint16_t UsagePage = 0;
+    uint16_t ReportSize = 0;
+    uint16_t ReportCount = 0;
+    uint8_t  ReportID = 0;
+    int32_t  LogMin = 0;
+    int32_t  LogMax = 0;
+    int32_t  PhyMin = 0;
+    int32_t  PhyMax = 0;
+    uint32_t UnitExp = 0;
+    uint32_t Unit = 0;
+
+    // Until a field has been written it is emitted whatever its value.
+    // Comparing against sentinel values instead drops a first value that
+    // equals the sentinel (a Logical Minimum of 1). Collection openings write
+    // the Usage Page themselves and set UsagePageEmitted.
+    bool     Emitted = false;
+    bool     UsagePageEmitted = false;
+};
+
+// Emit only globals that changed; update prev in-place.
+// Report_ID(0) is never emitted — value 0 is reserved (HID 1.11 §6.2.2.7)
+// and the Windows parser explicitly rejects it (descript.c:1430).
+inline void emitChangedGlobals(DescriptorWriter& w,
+    GlobalState& prev,
+    const GlobalState& cur)
+{
+    const bool all = !prev.Emitted;
+    prev.Emitted = true;
+
+    if (cur.ReportID != 0 && (all || cur.ReportID != prev.ReportID)) {
+        w.itemU(HID_REPORT_ID, cur.ReportID, 1);
+        prev.ReportID = cur.ReportID;
+    }
+    if (!prev.UsagePageEmitted || cur.UsagePage != prev.UsagePage) {
+        w.itemU(HID_USAGE_PAGE, cur.UsagePage, cur.UsagePage > 0xFF ? 2 : 1);
+        prev.UsagePage = cur.UsagePage;
+        prev.UsagePageEmitted = true;
+    }
+    if (all || cur.LogMin != prev.LogMin) {
+        w.itemS(HID_LOG_MIN, cur.LogMin);
+        prev.LogMin = cur.LogMin;
+    }
+    if (all || cur.LogMax != prev.LogMax) {
+        w.itemS(HID_LOG_MAX, cur.LogMax);
+        prev.LogMax = cur.LogMax;
+    }
+    if (all || cur.PhyMin != prev.PhyMin) {
+        w.itemS(HID_PHY_MIN, cur.PhyMin);
+        prev.PhyMin = cur.PhyMin;
+    }
+    if (all || cur.PhyMax != prev.PhyMax) {
+        w.itemS(HID_PHY_MAX, cur.PhyMax);
+        prev.PhyMax = cur.PhyMax;
+    }
+    if (all || cur.UnitExp != prev.UnitExp) {
+        w.itemU(HID_UNIT_EXP, cur.UnitExp);
+        prev.UnitExp = cur.UnitExp;
+    }
+    if (all || cur.Unit != prev.Unit) {
+        w.itemU(HID_UNIT, cur.Unit);
+        prev.Unit = cur.Unit;
+    }
+    if (all || cur.ReportSize != prev.ReportSize) {
+        w.itemU(HID_REPORT_SIZE, cur.ReportSize);
+        prev.ReportSize = cur.ReportSize;
+    }
+    if (all || cur.ReportCount != prev.ReportCount) {
+        w.itemU(HID_REPORT_COUNT, cur.ReportCount);
+        prev.ReportCount = cur.ReportCount;
+    }
+}
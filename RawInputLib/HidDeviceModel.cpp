@@ -0,0 +1,754 @@
+#include "HidDeviceModel.h"
+#include "HidDescriptorCanonical.h"
+#include "utils_bitset.h"
+#include "utils_simd.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    // HID Usage Tables 1.3; hidusage.h is Windows-only.
+    constexpr uint16_t kUsagePageGeneric = 0x01;
+    constexpr uint16_t kUsagePageGame = 0x05;
+    constexpr uint16_t kUsagePageButton = 0x09;
+    constexpr uint16_t kUsageGenericX = 0x30;
+    constexpr uint16_t kUsageGenericHatSwitch = 0x39;
+    constexpr uint16_t kUsageGamePov = 0x20;
+
+    bool IsPOV(const HidInputChannel& vc)
+    {
+        if (vc.isRange)
+            return false;
+        return (vc.usagePage == kUsagePageGeneric && vc.usageMin == kUsageGenericHatSwitch)
+            || (vc.usagePage == kUsagePageGame && vc.usageMin == kUsageGamePov);
+    }
+
+    struct ParsedRange { int32_t logicalMin, logicalMax; uint8_t bitSize; bool isSigned; };
+
+    ParsedRange ParseLogicalRange(const HidInputChannel& vc)
+    {
+        const uint8_t bitSize = static_cast<uint8_t>(std::min<uint16_t>(vc.reportSize, 0xFF));
+
+        // Invalid or unsupported bit size
+        if (bitSize == 0 || bitSize > 32)
+            return { 0, 1, 1, false };
+
+        const int32_t unsignedMax =
+            (bitSize == 32) ? INT32_MAX : ((1u << bitSize) - 1);
+
+        // Firmware sometimes leaves logical range unset
+        if (vc.logicalMin == 0 && vc.logicalMax == 0)
+        {
+            return { 0, unsignedMax, bitSize, false };
+        }
+
+        const int32_t min = std::max(vc.logicalMin, -unsignedMax);
+        const int32_t max = std::min(vc.logicalMax, unsignedMax);
+        const bool isSigned = (min < 0);
+
+        return { min, max, bitSize, isSigned };
+    }
+
+    // Live models by ModelKey::hash. Entries expire with their last device.
+    struct ModelCache
+    {
+        std::mutex mutex;
+        std::unordered_multimap<uint64_t, std::weak_ptr<const HidDeviceModel>> models;
+    };
+
+    ModelCache& GetModelCache()
+    {
+        static ModelCache cache;
+        return cache;
+    }
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Model cache
+// ---------------------------------------------------------------------------
+
+// Models are keyed by the canonical descriptor, so devices whose descriptors
+// only differ in encoding share one. The hash only picks candidates; a match
+// needs an identical key.
+
+// static
+std::shared_ptr<const HidDeviceModel> HidDeviceModel::Find(ModelKey& key, const KeyBytesBuilder& buildBytes)
+{
+    ModelCache& cache = GetModelCache();
+
+    // A new model is the common miss: it is told apart by the hash alone.
+    if (key.bytes.empty())
+    {
+        bool candidate = false;
+        {
+            std::lock_guard lock(cache.mutex);
+            auto [it, end] = cache.models.equal_range(key.hash);
+            while (it != end)
+            {
+                if (it->second.expired())
+                {
+                    it = cache.models.erase(it);
+                    continue;
+                }
+                candidate = true;
+                ++it;
+            }
+        }
+        if (!candidate || !buildBytes(key.bytes))
+            return nullptr;
+    }
+
+    std::lock_guard lock(cache.mutex);
+    auto [it, end] = cache.models.equal_range(key.hash);
+    for (; it != end; ++it)
+    {
+        std::shared_ptr<const HidDeviceModel> model = it->second.lock();
+        if (model && model->m_Key == key)
+            return model;
+    }
+    return nullptr;
+}
+
+// static
+std::shared_ptr<const HidDeviceModel> HidDeviceModel::Publish(std::shared_ptr<HidDeviceModel> built, ModelKey&& key)
+{
+    // Two devices racing on a new model both build it and the first one to
+    // publish wins.
+    ModelCache& cache = GetModelCache();
+    std::lock_guard lock(cache.mutex);
+
+    auto [it, end] = cache.models.equal_range(key.hash);
+    for (; it != end; ++it)
+    {
+        std::shared_ptr<const HidDeviceModel> model = it->second.lock();
+        if (model && model->m_Key == key)
+            return model;
+    }
+
+    built->m_Key = std::move(key);
+    cache.models.emplace(built->m_Key.hash, built);
+    return built;
+}
+
+// static
+std::shared_ptr<const HidDeviceModel> HidDeviceModel::AcquireFromDescriptor(std::span<const uint8_t> descriptor)
+{
+    // The layout is parsed from the canonical form, so models that share a
+    // key share a layout by construction. The report length follows from
+    // the bytes and is left out of the key.
+    ModelKey key;
+    key.source = KeySource::Descriptor;
+    if (!FingerprintDescriptor(descriptor, key.hash))
+        return nullptr;
+
+    const KeyBytesBuilder buildBytes = [descriptor](std::vector<uint8_t>& bytes)
+    {
+        return CanonicalizeDescriptor(descriptor, bytes);
+    };
+    if (std::shared_ptr<const HidDeviceModel> model = Find(key, buildBytes))
+        return model;
+
+    HidInputLayout layout;
+    if ((key.bytes.empty() && !buildBytes(key.bytes)) || !ParseInputLayout(key.bytes, layout))
+        return nullptr;
+
+    std::shared_ptr<HidDeviceModel> built(new HidDeviceModel());
+    built->BuildFromLayout(layout);
+    return Publish(std::move(built), std::move(key));
+}
+
+// static
+std::shared_ptr<const HidDeviceModel> HidDeviceModel::GetEmpty()
+{
+    static const std::shared_ptr<const HidDeviceModel> empty(new HidDeviceModel());
+    return empty;
+}
+
+// static
+size_t HidDeviceModel::GetLiveModelCount()
+{
+    ModelCache& cache = GetModelCache();
+    std::lock_guard lock(cache.mutex);
+
+    size_t count = 0;
+    for (const auto& [hash, model] : cache.models)
+        if (!model.expired())
+            ++count;
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Build
+// ---------------------------------------------------------------------------
+
+void HidDeviceModel::BuildFromLayout(const HidInputLayout& layout)
+{
+    m_UsagePage = layout.usagePage;
+    m_UsageId = layout.usageId;
+    m_HasReportIds = layout.hasReportIds;
+    m_InputReportSize = layout.inputReportSize;
+
+    // Capabilities, as HidP_GetButtonCaps / HidP_GetValueCaps list them.
+    std::vector<HidInputChannel> buttonCaps;
+    std::vector<HidInputChannel> valueCaps;
+    for (const HidInputChannel& ch : layout.channels)
+        (ch.isButton ? buttonCaps : valueCaps).push_back(ch);
+
+    BuildControls(buttonCaps, valueCaps, layout.dataIndexCount);
+
+    // Button arrays are decoded by the plan; there is no HidP to read them.
+    m_ButtonArrayElements = 0;
+
+    BuildDecodePlan(layout.channels);
+}
+
+void HidDeviceModel::BuildControls(std::span<const HidInputChannel> buttonCaps,
+                                   std::span<const HidInputChannel> valueCaps,
+                                   size_t dataIndexCount)
+{
+    m_DataIndexTable.assign(dataIndexCount, {});
+
+    const ControlCounts counts = CountControls(buttonCaps, valueCaps);
+    AllocateControls(counts);
+
+    if (!buttonCaps.empty())
+        QueryButtonCapabilities(buttonCaps, counts.buttonPageSlots);
+
+    if (!valueCaps.empty())
+        QueryAxisCapabilities(valueCaps, counts.axes - counts.axisArrayElements);
+
+    BuildControlRegistry();
+}
+
+// static
+HidDeviceModel::ControlCounts HidDeviceModel::CountControls(
+    std::span<const HidInputChannel> buttonCaps,
+    std::span<const HidInputChannel> valueCaps)
+{
+    ControlCounts counts;
+
+    // Mirrors the slot assignment in QueryButtonCapabilities: button page
+    // buttons occupy [0, highest button usage), everything else is appended.
+    size_t buttonPageSlots = 0;
+    size_t appendedButtons = 0;
+    std::array<bool, 256> reportHasButtons{};
+    for (const HidInputChannel& bc : buttonCaps)
+    {
+        if (!reportHasButtons[bc.reportId])
+        {
+            reportHasButtons[bc.reportId] = true;
+            ++counts.buttonReports;
+        }
+
+        if (!bc.isRange && bc.reportCount > 1)
+        {
+            appendedButtons += bc.reportCount;
+            continue;
+        }
+
+        if (bc.usagePage == kUsagePageButton)
+        {
+            if (bc.usageMin != 0 && bc.usageMax != 0)
+                buttonPageSlots = std::max<size_t>(buttonPageSlots, bc.usageMin + (bc.dataIndexMax - bc.dataIndexMin));
+        }
+        else
+        {
+            appendedButtons += static_cast<size_t>(bc.dataIndexMax - bc.dataIndexMin) + 1;
+        }
+    }
+    counts.buttonPageSlots = std::min(buttonPageSlots, kMaxControlSlots);
+    counts.buttons = std::min(buttonPageSlots + appendedButtons, kMaxControlSlots);
+
+    // Mirrors QueryAxisCapabilities: one slot per usage of a range.
+    for (const HidInputChannel& vc : valueCaps)
+    {
+        if (!vc.isRange && vc.reportCount > 1)
+            counts.axisArrayElements += vc.reportCount;
+        else if (IsPOV(vc))
+            ++counts.switches;
+        else
+            counts.axes += static_cast<size_t>(vc.dataIndexMax - vc.dataIndexMin) + 1;
+    }
+    counts.axes = std::min(counts.axes, kMaxControlSlots);
+    counts.axisArrayElements = std::min(counts.axisArrayElements, kMaxControlSlots - counts.axes);
+    counts.axes += counts.axisArrayElements;
+
+    return counts;
+}
+
+void HidDeviceModel::AllocateControls(const ControlCounts& counts)
+{
+    m_Buttons.assign(counts.buttons, {});
+    m_Axes.assign(counts.axes, {});
+    m_Switches.assign(counts.switches, {});
+
+    m_AxisTransform.scale.assign(counts.axes, 0.f);
+    m_AxisTransform.offset.assign(counts.axes, 0.f);
+    m_AxisTransform.lo.assign(counts.axes, 0.f);
+    m_AxisTransform.hi.assign(counts.axes, 0.f);
+    m_AxisTransform.signShift.assign(counts.axes, 0);
+    m_AxisTransform.relative.assign(counts.axes, 0);
+
+    m_ButtonMaskPool.assign(BitWordCount(counts.buttons) * counts.buttonReports, 0);
+    m_ButtonReportMasks.fill({});
+}
+
+// ---------------------------------------------------------------------------
+// QueryButtonCapabilities
+// ---------------------------------------------------------------------------
+
+void HidDeviceModel::QueryButtonCapabilities(std::span<const HidInputChannel> caps, size_t buttonPageSlots)
+{
+    const size_t buttonCount = m_Buttons.size();
+
+    // Register each button / button array in the dispatch table.
+    size_t maxButtonArrayCount = 0;
+
+    // Button page controls go first and keep slot == (Usage - 1), so GetButton(i)
+    // matches the HID button number. Button arrays and controls of every other
+    // usage page (consumer, keyboard, LED, vendor...) are appended after them.
+    size_t appendSlot = buttonPageSlots;
+
+    // Per-report masks are carved from m_ButtonMaskPool on first use.
+    const size_t buttonWords = BitWordCount(buttonCount);
+    std::array<std::span<uint64_t>, 256> reportMasks{};
+    size_t maskPoolUsed = 0;
+    auto maskForReport = [&](uint8_t reportId) -> std::span<uint64_t>
+        {
+            std::span<uint64_t>& mask = reportMasks[reportId];
+            if (mask.empty() && maskPoolUsed + buttonWords <= m_ButtonMaskPool.size())
+            {
+                mask = std::span<uint64_t>(m_ButtonMaskPool).subspan(maskPoolUsed, buttonWords);
+                maskPoolUsed += buttonWords;
+            }
+            return mask;
+        };
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        const bool buttonPagePass = (pass == 0);
+
+        for (const HidInputChannel& bc : caps)
+        {
+            if ((bc.usagePage == kUsagePageButton) != buttonPagePass)
+                continue;
+
+            // Button array: single Usage (not a range), ReportCount > 1.
+            // HidP assigns ONE DataIndex for the whole array.
+            // Individual element state requires HidP_GetButtonArray (Windows 11+).
+            if (!bc.isRange && bc.reportCount > 1)
+            {
+                const uint16_t di = bc.dataIndexMin;
+                const size_t   firstSlot = appendSlot;
+
+                for (uint16_t j = 0; j < bc.reportCount && appendSlot < buttonCount; ++j)
+                {
+                    ButtonState& btn = m_Buttons[appendSlot++];
+                    btn.usagePage = bc.usagePage;
+                    btn.usage = bc.usageMin;
+                    btn.linkCollection = bc.linkCollection;
+                    btn.reportId = bc.reportId;
+                    btn.reportCount = (j == 0) ? bc.reportCount : 0;
+                }
+
+                if (di < m_DataIndexTable.size() && firstSlot < buttonCount)
+                    m_DataIndexTable[di] = { Kind::ButtonArray,
+                                             static_cast<uint16_t>(firstSlot),
+                                             bc.reportId };
+
+
+                const std::span<uint64_t> mask = maskForReport(bc.reportId);
+                for (size_t j = 0; j < bc.reportCount && firstSlot + j < buttonCount; ++j)
+                    AssignBit(mask, firstSlot + j, true);
+
+                maxButtonArrayCount = std::max(maxButtonArrayCount, static_cast<size_t>(bc.reportCount));
+                continue;
+            }
+
+            // Regular buttons (range or single button).
+            const uint16_t uMin = bc.usageMin;
+            const uint16_t uMax = bc.usageMax;
+            const uint16_t diMin = bc.dataIndexMin;
+            const uint16_t diMax = bc.dataIndexMax;
+
+            // Button 0 means "no button pressed"; other pages may legitimately
+            // start a range at 0 (e.g. consumer selector arrays).
+            if (buttonPagePass && (uMin == 0 || uMax == 0))
+                continue;
+
+            for (uint16_t di = diMin; di <= diMax; ++di)
+            {
+                const uint16_t usage = static_cast<uint16_t>(uMin + (di - diMin));
+
+                const size_t slot = buttonPagePass
+                    ? static_cast<size_t>(usage - 1)
+                    : appendSlot++;
+
+                if (slot >= buttonCount || di >= m_DataIndexTable.size())
+                    continue;
+
+                ButtonState& btn = m_Buttons[slot];
+                btn.usagePage = bc.usagePage;
+                btn.usage = usage;
+                btn.linkCollection = bc.linkCollection;
+                btn.reportId = bc.reportId;
+
+                m_DataIndexTable[di] = { Kind::Button,
+                                         static_cast<uint16_t>(slot),
+                                         bc.reportId };
+
+                AssignBit(maskForReport(bc.reportId), slot, true);
+            }
+        }
+    }
+
+    for (size_t id = 0; id < reportMasks.size(); ++id)
+        m_ButtonReportMasks[id] = reportMasks[id];
+
+    // Build() keeps this only if HidP_GetButtonArray is available.
+    m_ButtonArrayElements = maxButtonArrayCount;
+}
+
+// ---------------------------------------------------------------------------
+// QueryAxisCapabilities
+// ---------------------------------------------------------------------------
+
+void HidDeviceModel::QueryAxisCapabilities(std::span<const HidInputChannel> caps, size_t regularAxisSlots)
+{
+    const size_t axisCount = m_Axes.size();
+
+    // Regular axes occupy [0, regularAxisSlots); value arrays are appended after them.
+    std::vector<bool> axisSlotUsed(axisCount, false);
+    size_t appendSlot = regularAxisSlots;
+    size_t nextFreeSwitch = 0;
+
+    // One usage of a value cap: ranged caps have one DataIndex and one slot
+    // per usage, like button ranges.
+    struct AxisUsage
+    {
+        const HidInputChannel* caps;
+        uint16_t               usage;
+        uint16_t               dataIndex;
+    };
+    std::vector<AxisUsage> unplacedAxes;
+
+    auto assignAxis = [this](const HidInputChannel& vc, size_t slot, uint16_t usage)
+        {
+            const auto [logicalMin, logicalMax, bitSize, isSigned] = ParseLogicalRange(vc);
+
+            AxisState& ax = m_Axes[slot];
+            ax.logicalMin = logicalMin;
+            ax.logicalMax = logicalMax;
+            ax.bitSize = bitSize;
+            ax.isSigned = isSigned;
+            ax.isAbsolute = vc.isAbsolute;
+            ax.usagePage = vc.usagePage;
+            ax.usage = usage;
+            ax.linkCollection = vc.linkCollection;
+            ax.reportId = vc.reportId;
+            ax.physicalMin = vc.physicalMin;
+            ax.physicalMax = vc.physicalMax;
+            ax.units = vc.units;
+            ax.unitsExp = static_cast<int16_t>(vc.unitsExp);
+            InitAxisTransform(slot);
+        };
+
+    auto placeAxis = [&](const AxisUsage& axis, size_t slot)
+        {
+            axisSlotUsed[slot] = true;
+            assignAxis(*axis.caps, slot, axis.usage);
+            if (axis.dataIndex < m_DataIndexTable.size())
+                m_DataIndexTable[axis.dataIndex] = { Kind::Axis,
+                                                     static_cast<uint16_t>(slot),
+                                                     axis.caps->reportId };
+        };
+
+    for (const HidInputChannel& vc : caps)
+    {
+        // Value array: single Usage (not a range), ReportCount > 1.
+        // HidP_GetData does not report individual elements — use HidP_GetUsageValueArray.
+        if (!vc.isRange && vc.reportCount > 1)
+        {
+            const uint16_t di = vc.dataIndexMin;
+            const size_t   firstSlot = appendSlot;
+
+            for (uint16_t j = 0; j < vc.reportCount && appendSlot < axisCount; ++j)
+            {
+                const size_t slot = appendSlot++;
+                axisSlotUsed[slot] = true;
+                assignAxis(vc, slot, vc.usageMin);
+                m_Axes[slot].reportCount = (j == 0) ? vc.reportCount : 0;
+            }
+
+            if (di < m_DataIndexTable.size() && firstSlot < axisCount)
+                m_DataIndexTable[di] = { Kind::ValueArray,
+                                         static_cast<uint16_t>(firstSlot),
+                                         vc.reportId };
+            continue;
+        }
+
+        // ---- Switch (POV) ----
+        if (IsPOV(vc))
+        {
+            const auto [logicalMin, logicalMax, bitSize, isSigned] = ParseLogicalRange(vc);
+            const size_t switchIdx = nextFreeSwitch++;
+
+            SwitchState& ss = m_Switches[switchIdx];
+            ss.usagePage = vc.usagePage;
+            ss.usage = vc.usageMin;
+            ss.linkCollection = vc.linkCollection;
+            ss.reportId = vc.reportId;
+            ss.logicalMin = logicalMin;
+            ss.logicalMax = logicalMax;
+
+            const int32_t lUnits = logicalMax - logicalMin + 1;
+            ss.granularity = (lUnits > 0)
+                ? static_cast<uint16_t>(36000u / static_cast<uint32_t>(lUnits))
+                : 0u;
+
+            const uint16_t di = vc.dataIndexMin;
+
+            if (di < m_DataIndexTable.size())
+                m_DataIndexTable[di] = { Kind::Switch,
+                                         static_cast<uint16_t>(switchIdx),
+                                         vc.reportId };
+            continue;
+        }
+
+        // ---- Regular axes, one per usage ----
+        const uint16_t usageMin = vc.usageMin;
+        const uint16_t usageMax = vc.usageMax;
+        const uint16_t diMin = vc.dataIndexMin;
+        const uint16_t diMax = vc.dataIndexMax;
+
+        for (uint16_t di = diMin; di <= diMax; ++di)
+        {
+            const AxisUsage axis{ &vc, static_cast<uint16_t>(std::min<uint32_t>(usageMin + (di - diMin), usageMax)), di };
+
+            // Prefer the slot that matches the HID generic desktop usage offset
+            // (X=0, Y=1, Z=2, Rx=3, Ry=4, Rz=5, Slider=6, Dial=7).
+            const size_t prefSlot = (axis.usage >= kUsageGenericX)
+                ? static_cast<size_t>(axis.usage - kUsageGenericX)
+                : regularAxisSlots;
+
+            if (prefSlot < regularAxisSlots && !axisSlotUsed[prefSlot])
+                placeAxis(axis, prefSlot);
+            else
+                unplacedAxes.push_back(axis);
+        }
+    }
+
+    // Remaining regular axes take the free slots in declaration order.
+    size_t freeSlot = 0;
+    for (const AxisUsage& axis : unplacedAxes)
+    {
+        while (freeSlot < regularAxisSlots && axisSlotUsed[freeSlot])
+            ++freeSlot;
+        if (freeSlot >= regularAxisSlots)
+            break;
+
+        placeAxis(axis, freeSlot);
+    }
+
+    // Value array buffer is sized for the largest array.
+    size_t maxArrayBytes = 0;
+    for (const AxisState& ax : m_Axes)
+        if (ax.reportCount > 1)
+            maxArrayBytes = std::max(maxArrayBytes, static_cast<size_t>((ax.bitSize * ax.reportCount + 7) / 8));
+
+    m_ValueArrayBytes = maxArrayBytes;
+}
+
+void HidDeviceModel::InitAxisTransform(size_t slot)
+{
+    const AxisState& ax = m_Axes[slot];
+    AxisTransform& t = m_AxisTransform;
+
+    t.signShift[slot] = (ax.isSigned && ax.bitSize < 32)
+        ? static_cast<uint8_t>(32 - ax.bitSize)
+        : 0;
+    t.relative[slot] = !ax.isAbsolute;
+
+    // Relative axes accumulate deltas; pass the sum through unclamped.
+    if (!ax.isAbsolute)
+    {
+        t.scale[slot] = 1.f;
+        t.offset[slot] = 0.f;
+        t.lo[slot] = -std::numeric_limits<float>::max();
+        t.hi[slot] = std::numeric_limits<float>::max();
+        return;
+    }
+
+    // Linear map [logicalMin, logicalMax] → [-1, +1], folded into one
+    // multiply-add so that the per-report path has no division:
+    //   2 * (lv - min) / range - 1  ==  lv * (2 / range) - (2 * min / range + 1)
+    const double min = static_cast<double>(ax.logicalMin);
+    const double range = static_cast<double>(ax.logicalMax) - min;
+
+    t.scale[slot] = (range != 0.0) ? static_cast<float>(2.0 / range) : 0.f;
+    t.offset[slot] = (range != 0.0) ? static_cast<float>(-(2.0 * min / range + 1.0)) : 0.f;
+    t.lo[slot] = -1.f;
+    t.hi[slot] = 1.f;
+}
+
+// ---------------------------------------------------------------------------
+// BuildControlRegistry
+// ---------------------------------------------------------------------------
+
+void HidDeviceModel::BuildControlRegistry()
+{
+    const size_t buttonCount = m_Buttons.size();
+    const size_t axisCount = m_Axes.size();
+
+    std::vector<HidControlRegistry::Entry> entries;
+    entries.reserve(buttonCount + axisCount + m_Switches.size());
+
+    // Array elements after the first (reportCount == 0) are covered by the
+    // first element's entry; unused slots have no usage page.
+    for (size_t i = 0; i < buttonCount; ++i)
+    {
+        const ButtonState& btn = m_Buttons[i];
+        if (btn.usagePage == 0 || btn.reportCount == 0)
+            continue;
+
+        const uint32_t n = static_cast<uint32_t>(std::min<size_t>(btn.reportCount, buttonCount - i));
+        entries.push_back({ btn.usagePage, btn.usage, btn.linkCollection, btn.reportId,
+                            HidControlRegistry::Kind::Button, static_cast<uint32_t>(i), n });
+    }
+
+    for (size_t i = 0; i < axisCount; ++i)
+    {
+        const AxisState& ax = m_Axes[i];
+        if (ax.usagePage == 0 || ax.reportCount == 0)
+            continue;
+
+        const uint32_t n = static_cast<uint32_t>(std::min<size_t>(ax.reportCount, axisCount - i));
+        entries.push_back({ ax.usagePage, ax.usage, ax.linkCollection, ax.reportId,
+                            HidControlRegistry::Kind::Axis, static_cast<uint32_t>(i), n });
+    }
+
+    for (size_t i = 0; i < m_Switches.size(); ++i)
+    {
+        const SwitchState& ss = m_Switches[i];
+        entries.push_back({ ss.usagePage, ss.usage, ss.linkCollection, ss.reportId,
+                            HidControlRegistry::Kind::Switch, static_cast<uint32_t>(i), 1 });
+    }
+
+    m_Controls.Build(std::move(entries));
+}
+
+// ---------------------------------------------------------------------------
+// BuildDecodePlan
+// ---------------------------------------------------------------------------
+
+void HidDeviceModel::BuildDecodePlan(std::span<const HidInputChannel> channels)
+{
+    m_DecodePlan.Clear();
+
+    auto entryOf = [this](uint32_t dataIndex) -> const DataIndexEntry*
+        {
+            return dataIndex < m_DataIndexTable.size() ? &m_DataIndexTable[dataIndex] : nullptr;
+        };
+
+    auto addFieldOp = [this](HidDecodePlan::OpKind kind, uint8_t reportId, uint32_t bitOffset, uint16_t bitSize, uint16_t slot)
+        {
+            HidDecodePlan::Op op;
+            op.kind = kind;
+            op.reportId = reportId;
+            op.bitOffset = bitOffset;
+            op.bitSize = bitSize;
+            op.slot = slot;
+            m_DecodePlan.AddOp(op);
+        };
+
+    for (size_t k = 0; k < channels.size(); ++k)
+    {
+        const HidInputChannel& ch = channels[k];
+
+        // Selector array: a MoreChannels chain shares one set of fields, each
+        // holding the index (from LogicalMin) of a usage that is on. Usages are
+        // numbered across the chain in channel order.
+        if (ch.isButton && !ch.isVariable)
+        {
+            size_t last = k;
+            while (last + 1 < channels.size() && channels[last].moreChannels)
+                ++last;
+
+            std::vector<uint16_t> slots;
+            for (size_t c = k; c <= last; ++c)
+            {
+                for (uint32_t di = channels[c].dataIndexMin; di <= channels[c].dataIndexMax; ++di)
+                {
+                    const DataIndexEntry* e = entryOf(di);
+                    const bool isButton = e && (e->kind == Kind::Button || e->kind == Kind::ButtonArray);
+                    slots.push_back(isButton ? e->index : HidDecodePlan::kNoSlot);
+                }
+            }
+
+            if (!ch.isConst && !slots.empty())
+            {
+                HidDecodePlan::Op op;
+                op.kind = HidDecodePlan::OpKind::Selector;
+                op.reportId = ch.reportId;
+                op.bitOffset = ch.bitOffset;
+                op.bitSize = ch.reportSize;
+                op.fieldCount = ch.reportCount;
+                op.selectorBase = m_DecodePlan.AddSelectorTable(slots);
+                op.selectorSize = static_cast<uint16_t>(slots.size());
+                op.logicalMin = ch.logicalMin;
+                m_DecodePlan.AddOp(op);
+            }
+
+            k = last;
+            continue;
+        }
+
+        // Aliases describe the same field as the channel that follows them.
+        if (ch.isConst || ch.isAlias)
+            continue;
+
+        if (!ch.isButton && !ch.isAbsolute)
+            m_DecodePlan.MarkRelative(ch.reportId);
+
+        const DataIndexEntry* first = entryOf(ch.dataIndexMin);
+        if (!first)
+            continue;
+
+        // Button / value array: one DataIndex, elements in consecutive slots.
+        if (first->kind == Kind::ButtonArray || first->kind == Kind::ValueArray)
+        {
+            const bool isButtons = (first->kind == Kind::ButtonArray);
+            const size_t slotCount = isButtons ? m_Buttons.size() : m_Axes.size();
+
+            for (uint16_t f = 0; f < ch.reportCount && first->index + f < slotCount; ++f)
+                addFieldOp(isButtons ? HidDecodePlan::OpKind::Button : HidDecodePlan::OpKind::Axis,
+                           ch.reportId, ch.bitOffset + uint32_t(f) * ch.reportSize, ch.reportSize,
+                           static_cast<uint16_t>(first->index + f));
+            continue;
+        }
+
+        // Variable fields: field f carries DataIndexMin + f; extra fields
+        // beyond the usage range repeat the last usage.
+        const uint32_t lastIndex = static_cast<uint32_t>(ch.dataIndexMax - ch.dataIndexMin);
+        for (uint32_t f = 0; f < ch.reportCount; ++f)
+        {
+            const DataIndexEntry* e = entryOf(ch.dataIndexMin + std::min(f, lastIndex));
+            if (!e)
+                continue;
+
+            const uint32_t bitOffset = ch.bitOffset + f * ch.reportSize;
+            switch (e->kind)
+            {
+            case Kind::Button: addFieldOp(HidDecodePlan::OpKind::Button, ch.reportId, bitOffset, ch.reportSize, e->index); break;
+            case Kind::Axis:   addFieldOp(HidDecodePlan::OpKind::Axis,   ch.reportId, bitOffset, ch.reportSize, e->index); break;
+            case Kind::Switch: addFieldOp(HidDecodePlan::OpKind::Switch, ch.reportId, bitOffset, ch.reportSize, e->index); break;
+            default: break;
+            }
+        }
+    }
+
+    m_DecodePlan.Finalize();
+}
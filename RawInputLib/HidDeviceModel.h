@@ -0,0 +1,261 @@
+#pragma once
+
+#include "HidControlRegistry.h"
+#include "HidDecodePlan.h"
+#include "HidInputLayout.h"
+
+#ifdef _WIN32
+#include <hidsdi.h>
+#include <hidpi.h>
+#endif
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Everything about a HID device that follows from its report descriptor:
+// preparsed data, control metadata and slot layout, the DataIndex dispatch
+// table, axis normalisation constants, the decode plan and the control
+// registry.
+//
+// Models are immutable and shared. Acquire() hash-conses them by the
+// canonical report descriptor, so identical devices (four
+// of the same controller, or the same one across firmware that only
+// re-encodes its descriptor) hold one model between them and only the first
+// device's capability scan is done. A model lives as long as a device
+// references it.
+//
+// On Windows models come from the preparsed data; elsewhere, or for reports
+// that do not come through Raw Input, AcquireFromDescriptor() builds them
+// from the raw report descriptor with the same slot rules. Both kinds decode
+// reports that start with the Report ID byte, as RAWHID::bRawData does.
+class HidDeviceModel
+{
+public:
+    // Slot indices are stored as uint16_t in the DataIndex dispatch table.
+    static constexpr size_t kMaxControlSlots = 0xFFFF;
+
+    struct ButtonState
+    {
+        uint16_t usagePage = 0;
+        uint16_t usage = 0;
+        uint16_t linkCollection = 0;
+        uint8_t  reportId = 0;
+
+        // If > 1, this button is the first element of a button array
+        // of reportCount elements occupying consecutive slots.
+        // HidP_GetButtonArray is needed to read individual elements (Windows 11+).
+        // For subsequent elements (slots 1..N-1) this field is 0.
+        uint16_t reportCount = 1;
+    };
+
+    struct AxisState
+    {
+        int32_t logicalMin = 0;
+        int32_t logicalMax = 0;
+        uint16_t bitSize = 0;
+        bool    isSigned = false;
+        bool    isAbsolute = true; // false → relative, accumulate delta
+
+        uint16_t usagePage = 0;
+        uint16_t usage = 0;
+        uint16_t linkCollection = 0;
+        uint8_t  reportId = 0;
+        int32_t  physicalMin = 0;
+        int32_t  physicalMax = 0;
+        uint32_t units = 0;
+        int16_t  unitsExp = 0;
+
+        // If > 1, this axis is the first element of a value array
+        // of reportCount elements occupying consecutive slots.
+        // HidP_GetData does not report these — parsed via HidP_GetUsageValueArray.
+        // For subsequent elements (slots 1..N-1) this field is 0.
+        uint16_t reportCount = 1;
+    };
+
+    struct SwitchState
+    {
+        uint16_t       usagePage = 0;
+        uint16_t       usage = 0;
+        uint16_t       linkCollection = 0;
+        uint8_t        reportId = 0;
+        int32_t        logicalMin = 0;
+        int32_t        logicalMax = 0;
+        uint16_t       granularity = 0; // 36000 / (logicalMax - logicalMin + 1)
+    };
+
+    // Dispatch table entry indexed by HIDP_DATA::DataIndex.
+    // Kind::ButtonArray → index is the first slot; individual buttons read via HidP_GetButtonArray.
+    // Kind::ValueArray  → index is the first slot; individual values read via HidP_GetUsageValueArray.
+    enum class Kind : uint8_t { None, Axis, Switch, Button, ButtonArray, ValueArray };
+    struct DataIndexEntry
+    {
+        Kind     kind = Kind::None;
+        uint16_t index = 0;   // index into the axis / switch / button slots
+        uint8_t  reportId = 0;
+    };
+
+    // Per-axis constants of the normalisation pass, one array per field:
+    //   value = clamp(raw * scale + offset, lo, hi)
+    // Absolute axes map [logicalMin, logicalMax] to [-1, +1]; relative axes
+    // accumulate deltas in raw and use scale 1, offset 0 and no clamp.
+    struct AxisTransform
+    {
+        std::vector<float>   scale;
+        std::vector<float>   offset;
+        std::vector<float>   lo;
+        std::vector<float>   hi;
+        std::vector<uint8_t> signShift; // 32 - bitSize for signed fields, else 0
+        std::vector<uint8_t> relative;
+    };
+
+    HidDeviceModel(const HidDeviceModel&) = delete;
+    void operator=(const HidDeviceModel&) = delete;
+
+#ifdef _WIN32
+    // Returns the model of a device with this preparsed data, building it on
+    // first use. Returns nullptr if the data is rejected by HidP.
+    static std::shared_ptr<const HidDeviceModel> Acquire(std::span<const uint8_t> preparsedData);
+#endif
+
+    // Returns the model of a device with this raw report descriptor, built
+    // by ParseInputLayout() on first use. Such models have no preparsed data
+    // and always decode through their plan. They are cached apart from
+    // preparsed data models: their data indices, and so the order of
+    // appended slots, can differ from HidP's. Returns nullptr if the
+    // descriptor is malformed.
+    static std::shared_ptr<const HidDeviceModel> AcquireFromDescriptor(std::span<const uint8_t> descriptor);
+
+    // Model of a device without usable capabilities: no controls, no plan.
+    static std::shared_ptr<const HidDeviceModel> GetEmpty();
+
+    // Number of distinct models currently alive.
+    static size_t GetLiveModelCount();
+
+#ifdef _WIN32
+    PHIDP_PREPARSED_DATA GetPreparsedData() const
+    {
+        return m_PreparsedData.empty() ? nullptr
+            : reinterpret_cast<PHIDP_PREPARSED_DATA>(const_cast<uint8_t*>(m_PreparsedData.data()));
+    }
+#endif
+    // simd::HashBytes of the canonical descriptor; of the preparsed data if
+    // its layout is not recognised. Models with equal hashes are only shared
+    // if their keys are byte-identical.
+    uint64_t GetHash() const { return m_Key.hash; }
+
+    uint16_t GetUsagePage() const { return m_UsagePage; }
+    uint16_t GetUsageId()   const { return m_UsageId; }
+    bool     HasReportIds() const { return m_HasReportIds; }
+    size_t   GetInputReportSize() const { return m_InputReportSize; }
+
+    std::span<const ButtonState> GetButtons()  const { return m_Buttons; }
+    std::span<const AxisState>   GetAxes()     const { return m_Axes; }
+    std::span<const SwitchState> GetSwitches() const { return m_Switches; }
+    const AxisTransform&         GetAxisTransform() const { return m_AxisTransform; }
+
+    std::span<const DataIndexEntry> GetDataIndexTable() const { return m_DataIndexTable; }
+
+    // Buttons carried by one Report ID; they are released when the report
+    // does not list them. Empty for reports without buttons.
+    std::span<const uint64_t> GetButtonReportMask(uint8_t reportId) const { return m_ButtonReportMasks[reportId]; }
+
+    // Scratch sizes for the HidP_GetData fallback; 0 for descriptor models.
+    size_t GetMaxDataListLength()    const { return m_MaxDataListLength; }
+    size_t GetValueArrayBytes()      const { return m_ValueArrayBytes; }
+    size_t GetButtonArrayElements()  const { return m_ButtonArrayElements; }
+
+    // Field layout read from the preparsed data or the descriptor. Empty if
+    // the preparsed data layout is not recognised; reports are then decoded
+    // with HidP_GetData.
+    const HidDecodePlan&      GetDecodePlan() const { return m_DecodePlan; }
+    const HidControlRegistry& GetControls()   const { return m_Controls; }
+
+private:
+    HidDeviceModel() = default;
+
+    struct ControlCounts
+    {
+        size_t buttons = 0;
+        size_t buttonPageSlots = 0;   // leading slots indexed by (Button usage - 1)
+        size_t buttonReports = 0;     // distinct Report IDs carrying buttons
+        size_t axes = 0;
+        size_t axisArrayElements = 0; // trailing slots taken by value arrays
+        size_t switches = 0;
+    };
+
+    // Cache identity. The input report length is part of it: with Report
+    // IDs, trailing padding is not in the descriptor. The hash is streamed
+    // from the source (FingerprintDescriptor()) and picks candidates; the
+    // bytes are only built to confirm a candidate or to publish a new model.
+    enum class KeySource : uint8_t
+    {
+        PreparsedData,  // bytes: the preparsed data, in a layout we cannot read
+        Reconstructed,  // bytes: ReconstructDescriptor() of the preparsed data
+        Descriptor,     // bytes: CanonicalizeDescriptor() of a raw descriptor
+    };
+    struct ModelKey
+    {
+        uint64_t             hash = 0;
+        KeySource            source = KeySource::PreparsedData;
+        std::vector<uint8_t> bytes;            // empty until built
+        size_t               inputReportSize = 0;
+
+        bool operator==(const ModelKey&) const = default;
+    };
+    using KeyBytesBuilder = std::function<bool(std::vector<uint8_t>&)>;
+
+    // Cache lookup, and insertion of a model built outside the cache lock;
+    // if another thread published an equal model first, that one is returned.
+    // Find() fills key.bytes through buildBytes only if a live model has the
+    // same hash.
+    static std::shared_ptr<const HidDeviceModel> Find(ModelKey& key, const KeyBytesBuilder& buildBytes);
+    static std::shared_ptr<const HidDeviceModel> Publish(std::shared_ptr<HidDeviceModel> built, ModelKey&& key);
+
+#ifdef _WIN32
+    static ModelKey GetModelKey(std::span<const uint8_t> preparsedData);
+    bool Build(std::span<const uint8_t> preparsedData);
+#endif
+    void BuildFromLayout(const HidInputLayout& layout);
+
+    // Slots, dispatch table and registry from the input button and value
+    // capabilities, given as channels.
+    void BuildControls(std::span<const HidInputChannel> buttonCaps, std::span<const HidInputChannel> valueCaps,
+                       size_t dataIndexCount);
+    static ControlCounts CountControls(std::span<const HidInputChannel> buttonCaps,
+                                       std::span<const HidInputChannel> valueCaps);
+    void AllocateControls(const ControlCounts& counts);
+    void QueryButtonCapabilities(std::span<const HidInputChannel> caps, size_t buttonPageSlots);
+    void QueryAxisCapabilities(std::span<const HidInputChannel> caps, size_t regularAxisSlots);
+    void InitAxisTransform(size_t slot);
+    void BuildControlRegistry();
+    void BuildDecodePlan(std::span<const HidInputChannel> channels);
+
+    std::vector<uint8_t> m_PreparsedData;
+    ModelKey             m_Key;
+
+    uint16_t m_UsagePage = 0;
+    uint16_t m_UsageId = 0;
+    bool     m_HasReportIds = false;
+    size_t   m_InputReportSize = 0;
+
+    std::vector<ButtonState>    m_Buttons;
+    std::vector<AxisState>      m_Axes;
+    std::vector<SwitchState>    m_Switches;
+    AxisTransform               m_AxisTransform;
+    std::vector<DataIndexEntry> m_DataIndexTable;
+
+    // Per-Report-ID views into m_ButtonMaskPool, indexed directly by Report ID.
+    std::array<std::span<const uint64_t>, 256> m_ButtonReportMasks{};
+    std::vector<uint64_t>       m_ButtonMaskPool;
+
+    size_t m_MaxDataListLength = 0;
+    size_t m_ValueArrayBytes = 0;
+    size_t m_ButtonArrayElements = 0; // 0 if HidP_GetButtonArray is unavailable
+
+    HidDecodePlan      m_DecodePlan;
+    HidControlRegistry m_Controls;
+};
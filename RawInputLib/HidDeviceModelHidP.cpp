@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "framework.h"
+
+#include "HidDeviceModel.h"
+#include "utils_hiddescriptor.h"
+#include "utils_simd.h"
+
+// Preparsed data side of HidDeviceModel: the capabilities come from HidP and
+// the field layout from the preparsed data internals.
+
+namespace
+{
+    HidInputChannel ToChannel(const HIDP_BUTTON_CAPS& bc)
+    {
+        HidInputChannel ch;
+        ch.reportId = bc.ReportID;
+        ch.isButton = true;
+        ch.isAbsolute = (bc.IsAbsolute != FALSE);
+        ch.isRange = (bc.IsRange != FALSE);
+        ch.reportSize = 1;
+        ch.reportCount = bc.ReportCount;
+        ch.usagePage = bc.UsagePage;
+        ch.usageMin = bc.IsRange ? bc.Range.UsageMin : bc.NotRange.Usage;
+        ch.usageMax = bc.IsRange ? bc.Range.UsageMax : bc.NotRange.Usage;
+        ch.dataIndexMin = bc.IsRange ? bc.Range.DataIndexMin : bc.NotRange.DataIndex;
+        ch.dataIndexMax = bc.IsRange ? bc.Range.DataIndexMax : bc.NotRange.DataIndex;
+        ch.linkCollection = bc.LinkCollection;
+        return ch;
+    }
+
+    HidInputChannel ToChannel(const HIDP_VALUE_CAPS& vc)
+    {
+        HidInputChannel ch;
+        ch.reportId = vc.ReportID;
+        ch.isVariable = true;
+        ch.isAbsolute = (vc.IsAbsolute != FALSE);
+        ch.isRange = (vc.IsRange != FALSE);
+        ch.reportSize = vc.BitSize;
+        ch.reportCount = vc.ReportCount;
+        ch.usagePage = vc.UsagePage;
+        ch.usageMin = vc.IsRange ? vc.Range.UsageMin : vc.NotRange.Usage;
+        ch.usageMax = vc.IsRange ? vc.Range.UsageMax : vc.NotRange.Usage;
+        ch.dataIndexMin = vc.IsRange ? vc.Range.DataIndexMin : vc.NotRange.DataIndex;
+        ch.dataIndexMax = vc.IsRange ? vc.Range.DataIndexMax : vc.NotRange.DataIndex;
+        ch.logicalMin = vc.LogicalMin;
+        ch.logicalMax = vc.LogicalMax;
+        ch.linkCollection = vc.LinkCollection;
+        ch.physicalMin = vc.PhysicalMin;
+        ch.physicalMax = vc.PhysicalMax;
+        ch.units = vc.Units;
+        ch.unitsExp = vc.UnitsExp;
+        return ch;
+    }
+} // namespace
+
+// static
+HidDeviceModel::ModelKey HidDeviceModel::GetModelKey(std::span<const uint8_t> preparsedData)
+{
+    const auto ppd = reinterpret_cast<PHIDP_PREPARSED_DATA>(const_cast<uint8_t*>(preparsedData.data()));
+
+    ModelKey key;
+    HIDP_CAPS caps;
+    if (FingerprintDescriptor(ppd, key.hash) && HidP_GetCaps(ppd, &caps) == HIDP_STATUS_SUCCESS)
+    {
+        key.source = KeySource::Reconstructed;
+        key.inputReportSize = caps.InputReportByteLength;
+    }
+    else
+    {
+        // Blobs in an unknown layout only match byte-identical data.
+        key.source = KeySource::PreparsedData;
+        key.hash = simd::HashBytes(preparsedData.data(), preparsedData.size());
+    }
+    return key;
+}
+
+// static
+std::shared_ptr<const HidDeviceModel> HidDeviceModel::Acquire(std::span<const uint8_t> preparsedData)
+{
+    if (preparsedData.empty())
+        return nullptr;
+
+    ModelKey key = GetModelKey(preparsedData);
+    const KeyBytesBuilder buildBytes = [&key, preparsedData](std::vector<uint8_t>& bytes)
+    {
+        if (key.source == KeySource::PreparsedData)
+        {
+            bytes.assign(preparsedData.begin(), preparsedData.end());
+            return true;
+        }
+        const auto ppd = reinterpret_cast<PHIDP_PREPARSED_DATA>(const_cast<uint8_t*>(preparsedData.data()));
+        return ReconstructDescriptor(ppd, bytes);
+    };
+    if (std::shared_ptr<const HidDeviceModel> model = Find(key, buildBytes))
+        return model;
+
+    if (key.bytes.empty() && !buildBytes(key.bytes))
+        return nullptr;
+
+    std::shared_ptr<HidDeviceModel> built(new HidDeviceModel());
+    if (!built->Build(preparsedData))
+        return nullptr;
+    return Publish(std::move(built), std::move(key));
+}
+
+bool HidDeviceModel::Build(std::span<const uint8_t> preparsedData)
+{
+    m_PreparsedData.assign(preparsedData.begin(), preparsedData.end());
+
+    const PHIDP_PREPARSED_DATA ppd = GetPreparsedData();
+
+    HIDP_CAPS caps;
+    if (HidP_GetCaps(ppd, &caps) != HIDP_STATUS_SUCCESS)
+        return false;
+
+    m_UsagePage = caps.UsagePage;
+    m_UsageId = caps.Usage;
+    m_InputReportSize = caps.InputReportByteLength;
+
+    std::vector<HidInputChannel> buttonCaps;
+    if (caps.NumberInputButtonCaps)
+    {
+        std::vector<HIDP_BUTTON_CAPS> hidpCaps(caps.NumberInputButtonCaps);
+        USHORT count = static_cast<USHORT>(hidpCaps.size());
+        DCHECK_EQ(HIDP_STATUS_SUCCESS,
+            HidP_GetButtonCaps(HidP_Input, hidpCaps.data(), &count, ppd));
+        hidpCaps.resize(count);
+        for (const HIDP_BUTTON_CAPS& bc : hidpCaps)
+            buttonCaps.push_back(ToChannel(bc));
+    }
+
+    std::vector<HidInputChannel> valueCaps;
+    if (caps.NumberInputValueCaps)
+    {
+        std::vector<HIDP_VALUE_CAPS> hidpCaps(caps.NumberInputValueCaps);
+        USHORT count = static_cast<USHORT>(hidpCaps.size());
+        DCHECK_EQ(HIDP_STATUS_SUCCESS,
+            HidP_GetValueCaps(HidP_Input, hidpCaps.data(), &count, ppd));
+        hidpCaps.resize(count);
+        for (const HIDP_VALUE_CAPS& vc : hidpCaps)
+            valueCaps.push_back(ToChannel(vc));
+    }
+
+    for (const HidInputChannel& ch : buttonCaps)
+        m_HasReportIds |= (ch.reportId != 0);
+    for (const HidInputChannel& ch : valueCaps)
+        m_HasReportIds |= (ch.reportId != 0);
+
+    BuildControls(buttonCaps, valueCaps, caps.NumberInputDataIndices);
+
+    // Button array elements are only readable through HidP_GetButtonArray
+    // (requires HidP version >= 2, i.e. Windows 11+).
+    if (m_ButtonArrayElements > 0)
+    {
+        ULONG hidpVersion = 0;
+        if (HidP_GetVersion(&hidpVersion) != HIDP_STATUS_SUCCESS || hidpVersion < 2)
+            m_ButtonArrayElements = 0;
+    }
+
+    m_MaxDataListLength = static_cast<size_t>(HidP_MaxDataListLength(HidP_Input, ppd));
+
+    std::vector<HidInputChannel> channels;
+    if (GetInputChannels(ppd, channels))
+        BuildDecodePlan(channels);
+    else
+        DBGPRINT("Unknown preparsed data layout, decoding with HidP_GetData.");
+
+    return true;
+}
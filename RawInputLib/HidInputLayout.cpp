@@ -0,0 +1,252 @@
+#include "HidInputLayout.h"
+
+#include "HidDescriptorItems.h"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    // hidraw's HID_MAX_BUFFER_SIZE; larger reports cannot be delivered anyway.
+    constexpr uint64_t kMaxReportBits = 16384 * 8;
+    constexpr uint32_t kMaxDataIndices = 0xFFFF;
+
+    // One Usage, or Usage Minimum/Maximum pair, waiting for its Main item.
+    struct LocalUsage
+    {
+        uint16_t page = 0;
+        uint16_t min = 0;
+        uint16_t max = 0;
+        bool     isRange = false;
+    };
+
+    class LayoutParser
+    {
+    public:
+        explicit LayoutParser(HidInputLayout& layout) : m_Layout(layout) {}
+
+        bool Parse(std::span<const uint8_t> descriptor)
+        {
+            m_ReportBits.fill(8); // the Report ID byte
+
+            HidItemReader reader(descriptor);
+            while (std::optional<HidItem> item = reader.Next())
+            {
+                if (!item->IsLong() && !OnItem(*item))
+                    return false;
+            }
+
+            if (reader.IsTruncated() || !m_Collections.empty() || !m_Stack.empty())
+                return false;
+
+            for (size_t id = 0; id < m_ReportBits.size(); ++id)
+                if (m_ReportUsed[id])
+                    m_Layout.inputReportSize = std::max<size_t>(m_Layout.inputReportSize, (m_ReportBits[id] + 7) / 8);
+            m_Layout.dataIndexCount = m_NextDataIndex;
+            return true;
+        }
+
+    private:
+        bool OnItem(const HidItem& item)
+        {
+            switch (item.GetTag())
+            {
+            // Global items
+            case HID_USAGE_PAGE:   m_Global.UsagePage = static_cast<uint16_t>(item.data); break;
+            case HID_LOG_MIN:      m_Global.LogMin = item.GetSigned(); break;
+            case HID_LOG_MAX:      m_Global.LogMax = item.GetSigned(); break;
+            case HID_PHY_MIN:      m_Global.PhyMin = item.GetSigned(); break;
+            case HID_PHY_MAX:      m_Global.PhyMax = item.GetSigned(); break;
+            case HID_UNIT_EXP:     m_Global.UnitExp = item.data; break;
+            case HID_UNIT:         m_Global.Unit = item.data; break;
+            case HID_REPORT_SIZE:  m_Global.ReportSize = static_cast<uint16_t>(std::min<uint32_t>(item.data, 0xFFFF)); break;
+            case HID_REPORT_COUNT: m_Global.ReportCount = static_cast<uint16_t>(std::min<uint32_t>(item.data, 0xFFFF)); break;
+            case HID_REPORT_ID:
+                if (item.data == 0 || item.data > 0xFF)
+                    return false;
+                m_Global.ReportID = static_cast<uint8_t>(item.data);
+                m_Layout.hasReportIds = true;
+                break;
+            case HID_PUSH:
+                m_Stack.push_back(m_Global);
+                break;
+            case HID_POP:
+                if (m_Stack.empty())
+                    return false;
+                m_Global = m_Stack.back();
+                m_Stack.pop_back();
+                break;
+
+            // Local items
+            case HID_USAGE:
+                m_Usages.push_back({ GetPage(item), static_cast<uint16_t>(item.data), static_cast<uint16_t>(item.data), false });
+                break;
+            case HID_USAGE_MIN:
+                m_UsageMin = item;
+                m_HasUsageMin = true;
+                break;
+            case HID_USAGE_MAX:
+                if (m_HasUsageMin)
+                {
+                    const uint16_t min = static_cast<uint16_t>(m_UsageMin.data);
+                    const uint16_t max = std::max(min, static_cast<uint16_t>(item.data));
+                    m_Usages.push_back({ GetPage(m_UsageMin), min, max, true });
+                    m_HasUsageMin = false;
+                }
+                break;
+
+            // Main items
+            case HID_INPUT:
+                if (!OnInput(item.data))
+                    return false;
+                ClearLocals();
+                break;
+            case HID_OUTPUT:
+            case HID_FEATURE:
+                ClearLocals();
+                break;
+            case HID_COLLECTION:
+                if (m_NextCollection == 0xFFFF)
+                    return false;
+                if (m_Collections.empty() && m_NextCollection == 0 && !m_Usages.empty())
+                {
+                    m_Layout.usagePage = m_Usages.front().page;
+                    m_Layout.usageId = m_Usages.front().min;
+                }
+                m_Collections.push_back(m_NextCollection++);
+                ClearLocals();
+                break;
+            case HID_END_COLLECTION:
+                if (m_Collections.empty())
+                    return false;
+                m_Collections.pop_back();
+                ClearLocals();
+                break;
+
+            default:
+                break;
+            }
+            return true;
+        }
+
+        bool OnInput(uint32_t flags)
+        {
+            const bool isConst = (flags & 0x01) != 0;
+            const bool isVariable = (flags & 0x02) != 0;
+            const bool isRelative = (flags & 0x04) != 0;
+
+            const uint8_t reportId = m_Global.ReportID;
+            const uint32_t reportSize = m_Global.ReportSize;
+            const uint32_t reportCount = m_Global.ReportCount;
+            const uint32_t bitOffset = m_ReportBits[reportId];
+
+            const uint64_t bits = uint64_t(bitOffset) + uint64_t(reportSize) * reportCount;
+            if (bits > kMaxReportBits)
+                return false;
+            m_ReportBits[reportId] = static_cast<uint32_t>(bits);
+            m_ReportUsed[reportId] = true;
+
+            if (isConst || m_Usages.empty() || reportSize == 0 || reportSize > 32 || reportCount == 0)
+                return true;
+
+            HidInputChannel ch;
+            ch.reportId = reportId;
+            ch.isVariable = isVariable;
+            ch.isAbsolute = !isRelative;
+            ch.reportSize = static_cast<uint16_t>(reportSize);
+            ch.logicalMin = m_Global.LogMin;
+            ch.logicalMax = m_Global.LogMax;
+            ch.linkCollection = m_Collections.empty() ? 0 : m_Collections.back();
+            ch.physicalMin = m_Global.PhyMin;
+            ch.physicalMax = m_Global.PhyMax;
+            ch.units = m_Global.Unit;
+            ch.unitsExp = m_Global.UnitExp;
+
+            // Array: every usage shares the same fields, which hold the index
+            // of the usage that is on.
+            if (!isVariable)
+            {
+                ch.isButton = true;
+                ch.bitOffset = bitOffset;
+                ch.reportCount = static_cast<uint16_t>(reportCount);
+                for (size_t u = 0; u < m_Usages.size(); ++u)
+                {
+                    ch.moreChannels = (u + 1 < m_Usages.size());
+                    if (!AddChannel(ch, m_Usages[u], m_Usages[u].max))
+                        return false;
+                }
+                return true;
+            }
+
+            // Variable: fields take the usages in order, a range one field per
+            // usage; the last usage takes the fields left over, which makes a
+            // single usage with several fields an array.
+            ch.isButton = (reportSize == 1);
+            uint32_t field = 0;
+            for (size_t u = 0; u < m_Usages.size() && field < reportCount; ++u)
+            {
+                const LocalUsage& usage = m_Usages[u];
+                const uint32_t usageCount = uint32_t(usage.max) - usage.min + 1;
+                const uint32_t left = reportCount - field;
+                const uint32_t fields = (u + 1 == m_Usages.size()) ? left : std::min(usageCount, left);
+
+                ch.bitOffset = bitOffset + field * reportSize;
+                ch.reportCount = static_cast<uint16_t>(fields);
+                const uint16_t usageMax = static_cast<uint16_t>(usage.min + std::min(usageCount, fields) - 1);
+                if (!AddChannel(ch, usage, usageMax))
+                    return false;
+                field += fields;
+            }
+            return true;
+        }
+
+        bool AddChannel(HidInputChannel ch, const LocalUsage& usage, uint16_t usageMax)
+        {
+            ch.isRange = usage.isRange;
+            ch.usagePage = usage.page;
+            ch.usageMin = usage.min;
+            ch.usageMax = usageMax;
+
+            const uint32_t dataIndexMax = m_NextDataIndex + (usageMax - usage.min);
+            if (dataIndexMax >= kMaxDataIndices)
+                return false;
+            ch.dataIndexMin = static_cast<uint16_t>(m_NextDataIndex);
+            ch.dataIndexMax = static_cast<uint16_t>(dataIndexMax);
+            m_NextDataIndex = dataIndexMax + 1;
+
+            m_Layout.channels.push_back(ch);
+            return true;
+        }
+
+        // Extended (4-byte) usages carry their own page.
+        uint16_t GetPage(const HidItem& item) const
+        {
+            return item.size == 4 ? static_cast<uint16_t>(item.data >> 16) : m_Global.UsagePage;
+        }
+
+        void ClearLocals()
+        {
+            m_Usages.clear();
+            m_HasUsageMin = false;
+        }
+
+        HidInputLayout&             m_Layout;
+        GlobalState                 m_Global;
+        std::vector<GlobalState>    m_Stack;
+        std::vector<LocalUsage>     m_Usages;
+        HidItem                     m_UsageMin;
+        bool                        m_HasUsageMin = false;
+        std::vector<uint16_t>       m_Collections; // link collection of each open collection
+        uint16_t                    m_NextCollection = 0;
+        uint32_t                    m_NextDataIndex = 0;
+        std::array<uint32_t, 256>   m_ReportBits{};
+        std::array<bool, 256>       m_ReportUsed{};
+    };
+}
+
+bool ParseInputLayout(std::span<const uint8_t> descriptor, HidInputLayout& outLayout)
+{
+    outLayout = {};
+    LayoutParser parser(outLayout);
+    return parser.Parse(descriptor);
+}
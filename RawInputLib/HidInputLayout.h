@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Bit layout of one input channel: one usage, or usage range, of an Input
+// main item, in the shape the Windows HID parser gives its channels. Array
+// channels chained with moreChannels describe one shared field.
+struct HidInputChannel
+{
+    uint8_t  reportId = 0;
+    bool     isButton = false;
+    bool     isVariable = false;
+    bool     isAbsolute = false;
+    bool     isRange = false;
+    bool     isConst = false;
+    bool     isAlias = false;
+    bool     moreChannels = false;
+
+    uint32_t bitOffset = 0;   // from the start of the report, Report ID byte included
+    uint16_t reportSize = 0;  // bits per field
+    uint16_t reportCount = 0; // number of fields
+
+    uint16_t usagePage = 0;
+    uint16_t usageMin = 0;
+    uint16_t usageMax = 0;
+    uint16_t dataIndexMin = 0;
+    uint16_t dataIndexMax = 0;
+
+    int32_t  logicalMin = 0;
+    int32_t  logicalMax = 0;
+
+    // Capability metadata; GetInputChannels() leaves these zero.
+    uint16_t linkCollection = 0;
+    int32_t  physicalMin = 0;
+    int32_t  physicalMax = 0;
+    uint32_t units = 0;
+    uint32_t unitsExp = 0;
+};
+
+// Input side of a report descriptor, as the Windows HID parser lays it out:
+// reports always start with the Report ID byte (0 if the descriptor declares
+// no Report IDs, as in RAWHID::bRawData), link collections are numbered in
+// declaration order from the top-level collection (0), and data indices are
+// handed out in channel order, one per usage.
+struct HidInputLayout
+{
+    uint16_t usagePage = 0;        // of the first top-level collection
+    uint16_t usageId = 0;
+    bool     hasReportIds = false;
+    size_t   inputReportSize = 0;  // longest input report, Report ID byte included
+    size_t   dataIndexCount = 0;
+
+    std::vector<HidInputChannel> channels;
+};
+
+// Parses the Input items of a raw report descriptor. Constant items, items
+// without usages and fields wider than 32 bits only take up report space.
+// Returns false if the descriptor is truncated, declares Report ID 0, its
+// collections or PUSH/POP do not balance, or a report or the data indices
+// overflow.
+bool ParseInputLayout(std::span<const uint8_t> descriptor, HidInputLayout& outLayout);
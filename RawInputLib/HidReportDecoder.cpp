@@ -0,0 +1,829 @@
+#include "HidReportDecoder.h"
+
+#include "utils_simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+HidReportDecoder::HidReportDecoder(std::shared_ptr<const HidDeviceModel> model)
+    : m_Model(model ? std::move(model) : HidDeviceModel::GetEmpty())
+{
+    AllocateControlStorage();
+    m_Calibration = BuildCalibrationTable(m_AxisCount, {}, {});
+    m_DecodeCalibration = m_Calibration.load();
+    BuildLastReportCache();
+    BuildPendingReports();
+}
+
+HidReportDecoder::~HidReportDecoder() = default;
+
+HidReportDecoder::Settings HidReportDecoder::SaveSettings() const
+{
+    std::lock_guard lock(m_Mutex);
+
+    Settings settings;
+    settings.model = m_Model;
+    settings.calibration = m_Calibration.load();
+    settings.batchMode = m_BatchMode;
+    settings.deferredDecode = m_DeferredDecode;
+    settings.rawReportRingCapacity = m_RawReports ? m_RawReports->GetCapacity() : 0;
+    return settings;
+}
+
+void HidReportDecoder::RestoreSettings(const Settings& settings)
+{
+    // Tables index axis slots of the model they were built for.
+    if (settings.calibration && settings.model == m_Model)
+    {
+        m_Calibration.store(settings.calibration);
+    }
+    else if (settings.calibration)
+    {
+        for (const AxisLut& lut : settings.calibration->luts)
+            SetAxisCalibration(lut.slot, lut.calibration);
+        for (const AxisCurve& curve : settings.calibration->curves)
+            SetAxisCalibration(curve.slot, curve.calibration);
+    }
+
+    SetBatchMode(settings.batchMode);
+    SetDeferredDecode(settings.deferredDecode);
+    EnableRawReportRing(settings.rawReportRingCapacity);
+}
+
+void HidReportDecoder::ReadSnapshot(Snapshot& out) const
+{
+    const auto lock = LockDecoded();
+
+    out.axes.assign(m_AxisHot.value.begin(), m_AxisHot.value.end());
+    out.switches.assign(m_SwitchValues.begin(), m_SwitchValues.end());
+    out.buttons.assign(m_ButtonWords.begin(), m_ButtonWords.end());
+    out.pressed.assign(m_ButtonPressed.begin(), m_ButtonPressed.end());
+    out.released.assign(m_ButtonReleased.begin(), m_ButtonReleased.end());
+    out.stats = m_DecodeStats;
+}
+
+// ---------------------------------------------------------------------------
+// Decode
+// ---------------------------------------------------------------------------
+
+void HidReportDecoder::Decode(const uint8_t* reports, size_t reportSize, size_t count, uint64_t timestamp)
+{
+    if (RawReportRing* ring = m_RawReportRing.load(std::memory_order_acquire))
+    {
+        for (size_t ri = 0; ri < count; ++ri)
+            ring->Push(reports + ri * reportSize, reportSize, timestamp);
+    }
+
+    if (GetDecodePlan().IsEmpty() && !HasDecodeFallback())
+        return;
+
+    std::lock_guard lock(m_Mutex);
+    RefreshCalibration();
+
+    if (m_DeferredDecode)
+    {
+        for (size_t ri = 0; ri < count; ++ri)
+            DeferReport(reports + ri * reportSize, reportSize);
+        return;
+    }
+
+    std::fill(m_ButtonPressed.begin(), m_ButtonPressed.end(), 0);
+    std::fill(m_ButtonReleased.begin(), m_ButtonReleased.end(), 0);
+
+    if (count > 1 && m_BatchMode == HidBatchMode::LatestOnly)
+    {
+        DecodeLatestOnly(reports, reportSize, count);
+        return;
+    }
+
+    if (m_BatchMode == HidBatchMode::History)
+    {
+        DecodeWithHistory(reports, reportSize, count);
+        return;
+    }
+
+    for (size_t ri = 0; ri < count; ++ri)
+        DecodeReport(reports + ri * reportSize, reportSize);
+}
+
+bool HidReportDecoder::DecodeFallback(const uint8_t* /*src*/, size_t /*len*/)
+{
+    return false;
+}
+
+void HidReportDecoder::EnableRawReportRing(size_t capacity)
+{
+    if (capacity == 0)
+        return;
+
+    std::lock_guard lock(m_Mutex);
+    if (m_RawReports)
+        return;
+
+    const size_t reportSize = m_Model->GetInputReportSize() ? m_Model->GetInputReportSize() : 64;
+    m_RawReports = std::make_unique<RawReportRing>(capacity, reportSize);
+    m_RawReportRing.store(m_RawReports.get(), std::memory_order_release);
+}
+
+// ---------------------------------------------------------------------------
+// Batched decode
+// ---------------------------------------------------------------------------
+
+// Decodes only the last report of every Report ID in the burst. Reports with
+// relative data are all decoded so that deltas add up.
+void HidReportDecoder::DecodeLatestOnly(const uint8_t* reports, size_t len, size_t count)
+{
+    constexpr uint32_t kNone = UINT32_MAX;
+    std::array<uint32_t, 256> lastOf;
+    lastOf.fill(kNone);
+
+    if (len == 0)
+        return;
+
+    for (size_t ri = 0; ri < count; ++ri)
+        lastOf[reports[ri * len]] = static_cast<uint32_t>(ri);
+
+    for (size_t ri = 0; ri < count; ++ri)
+    {
+        const uint8_t* src = reports + ri * len;
+        if (lastOf[src[0]] != ri && !GetDecodePlan().HasRelative(src[0]))
+        {
+            ++m_DecodeStats.reports;
+            ++m_DecodeStats.coalesced;
+            continue;
+        }
+        DecodeReport(src, len);
+    }
+}
+
+// Decodes every report of the burst and records per-report values. Runs of
+// reports with the same Report ID go through DecodeRun() in one pass over the
+// plan.
+void HidReportDecoder::DecodeWithHistory(const uint8_t* reports, size_t len, size_t count)
+{
+    m_History.Reset(m_AxisCount, m_ButtonWords.size(), m_SwitchCount, count);
+    if (count == 0 || len == 0)
+        return;
+
+    for (size_t begin = 0; begin < count; )
+    {
+        const uint8_t* first = reports + begin * len;
+
+        size_t end = begin + 1;
+        while (end < count && reports[end * len] == first[0])
+            ++end;
+
+        if (!GetDecodePlan().IsEmpty())
+        {
+            DecodeRun(first, len, end - begin, begin);
+        }
+        else
+        {
+            // No plan: decode report by report and record the result.
+            for (size_t r = begin; r < end; ++r)
+            {
+                DecodeReport(reports + r * len, len);
+
+                m_History.SetReportId(r, reports[r * len]);
+                std::copy(m_ButtonWords.begin(), m_ButtonWords.end(), m_History.ButtonRow(r).begin());
+                for (size_t a = 0; a < m_AxisCount; ++a)
+                {
+                    m_History.AxisRawColumn(a)[r] = m_AxisHot.raw[a];
+                    m_History.AxisColumn(a)[r] = m_AxisHot.value[a];
+                }
+                for (size_t sw = 0; sw < m_SwitchCount; ++sw)
+                    m_History.SwitchColumn(sw)[r] = static_cast<uint8_t>(m_SwitchValues[sw]);
+            }
+        }
+
+        begin = end;
+    }
+}
+
+// Decodes `count` reports of one Report ID (spaced `stride` bytes apart) into
+// history rows [row0, row0 + count): each op is applied to all reports before
+// moving to the next op. The device state ends up as after the last report.
+void HidReportDecoder::DecodeRun(const uint8_t* first, size_t stride, size_t count, size_t row0)
+{
+    const uint8_t reportId = first[0];
+    const size_t rowEnd = row0 + count;
+
+    m_DecodeStats.reports += count;
+
+    // Rows start from the state before the run; ops overwrite what this
+    // report carries.
+    for (size_t r = row0; r < rowEnd; ++r)
+    {
+        m_History.SetReportId(r, reportId);
+        std::copy(m_ButtonWords.begin(), m_ButtonWords.end(), m_History.ButtonRow(r).begin());
+    }
+    for (size_t a = 0; a < m_AxisCount; ++a)
+    {
+        const std::span<int32_t> column = m_History.AxisRawColumn(a);
+        std::fill(column.begin() + row0, column.begin() + rowEnd, m_AxisHot.raw[a]);
+    }
+    for (size_t sw = 0; sw < m_SwitchCount; ++sw)
+    {
+        const std::span<uint8_t> column = m_History.SwitchColumn(sw);
+        std::fill(column.begin() + row0, column.begin() + rowEnd, static_cast<uint8_t>(m_SwitchValues[sw]));
+    }
+
+    for (const HidDecodePlan::Op& op : GetDecodePlan().GetOps(reportId))
+    {
+        switch (op.kind)
+        {
+        case HidDecodePlan::OpKind::Button:
+        {
+            for (size_t r = 0; r < count; ++r)
+                AssignBit(m_History.ButtonRow(row0 + r), op.slot,
+                          ReadReportBits(first + r * stride, stride, op.bitOffset, op.bitSize) != 0);
+            break;
+        }
+        case HidDecodePlan::OpKind::Axis:
+        {
+            const std::span<int32_t> column = m_History.AxisRawColumn(op.slot);
+            const bool relative = m_AxisHot.relative[op.slot] != 0;
+            int32_t acc = m_AxisHot.raw[op.slot];
+            for (size_t r = 0; r < count; ++r)
+            {
+                const int32_t lv = SignExtendAxis(op.slot, ReadReportBits(first + r * stride, stride, op.bitOffset, op.bitSize));
+                acc = relative ? acc + lv : lv;
+                column[row0 + r] = acc;
+            }
+            break;
+        }
+        case HidDecodePlan::OpKind::Switch:
+        {
+            const std::span<uint8_t> column = m_History.SwitchColumn(op.slot);
+            const SwitchState& ss = m_Switches[op.slot];
+            for (size_t r = 0; r < count; ++r)
+            {
+                const int32_t lv = static_cast<int32_t>(ReadReportBits(first + r * stride, stride, op.bitOffset, op.bitSize));
+                column[row0 + r] = static_cast<uint8_t>(NormaliseSwitch(lv, ss));
+            }
+            break;
+        }
+        case HidDecodePlan::OpKind::Selector:
+        {
+            const std::span<const uint16_t> slots = GetDecodePlan().GetSelectorSlots(op);
+            for (size_t r = 0; r < count; ++r)
+            {
+                const std::span<uint64_t> row = m_History.ButtonRow(row0 + r);
+                const uint8_t* src = first + r * stride;
+
+                for (uint16_t slot : slots)
+                    if (slot != HidDecodePlan::kNoSlot)
+                        AssignBit(row, slot, false);
+
+                for (uint32_t f = 0; f < op.fieldCount; ++f)
+                {
+                    const uint32_t v = ReadReportBits(src, stride, op.bitOffset + f * op.bitSize, op.bitSize);
+                    const int64_t idx = static_cast<int64_t>(v) - op.logicalMin;
+                    if (idx >= 0 && idx < static_cast<int64_t>(slots.size()) && slots[static_cast<size_t>(idx)] != HidDecodePlan::kNoSlot)
+                        AssignBit(row, slots[static_cast<size_t>(idx)], true);
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    // Normalise whole columns, then carry the last report into the live state.
+    for (size_t a = 0; a < m_AxisCount; ++a)
+    {
+        const std::span<const int32_t> raw = m_History.AxisRawColumn(a).subspan(row0, count);
+        const std::span<float> values = m_History.AxisColumn(a).subspan(row0, count);
+        NormaliseAxisColumn(a, raw, values);
+
+        m_AxisHot.raw[a] = raw[count - 1];
+        m_AxisHot.value[a] = values[count - 1];
+    }
+
+    for (size_t sw = 0; sw < m_SwitchCount; ++sw)
+        m_SwitchValues[sw] = static_cast<SwitchPosition>(m_History.SwitchColumn(sw)[rowEnd - 1]);
+
+    // m_ButtonWords still holds the state before the run.
+    std::span<const uint64_t> previous = m_ButtonWords;
+    for (size_t r = row0; r < rowEnd; ++r)
+    {
+        const std::span<const uint64_t> row = m_History.ButtonRow(r);
+        AccumulateEdges(previous, row, m_ButtonPressed, m_ButtonReleased);
+        previous = row;
+    }
+    std::copy(previous.begin(), previous.end(), m_ButtonWords.begin());
+
+    // The last-report cache no longer matches; decode the next report in full.
+    const uint16_t cacheSlot = m_LastReports.slotOf[reportId];
+    if (cacheSlot != LastReportCache::kNoSlot)
+        m_LastReports.valid[cacheSlot] = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Deferred decode
+// ---------------------------------------------------------------------------
+
+void HidReportDecoder::SetDeferredDecode(bool deferred)
+{
+    std::lock_guard lock(m_Mutex);
+
+    if (m_DeferredDecode == deferred)
+        return;
+
+    FlushPendingReports();
+    m_DeferredDecode = deferred;
+    m_EdgesConsumed = false;
+}
+
+void HidReportDecoder::DeferReport(const uint8_t* src, size_t len)
+{
+    if (len == 0)
+        return;
+
+    PendingReports& pending = m_PendingReports;
+    const uint16_t slot = pending.slotOf[src[0]];
+
+    // Relative data or an unexpected size: decode right away.
+    if (slot == PendingReports::kNoSlot || len != pending.reportSize)
+    {
+        ClearConsumedEdges();
+        DecodeReport(src, len);
+        return;
+    }
+
+    if (pending.pending[slot])
+    {
+        ++m_DecodeStats.reports;
+        ++m_DecodeStats.coalesced;
+    }
+    else
+    {
+        pending.pending[slot] = 1;
+        ++pending.count;
+    }
+
+    std::memcpy(pending.bytes.data() + static_cast<size_t>(slot) * pending.reportSize, src, len);
+}
+
+void HidReportDecoder::FlushPendingReports()
+{
+    PendingReports& pending = m_PendingReports;
+
+    if (pending.count != 0)
+    {
+        ClearConsumedEdges();
+        RefreshCalibration();
+
+        for (size_t slot = 0; slot < pending.pending.size(); ++slot)
+        {
+            if (!pending.pending[slot])
+                continue;
+
+            pending.pending[slot] = 0;
+            DecodeReport(pending.bytes.data() + slot * pending.reportSize, pending.reportSize);
+        }
+        pending.count = 0;
+    }
+
+    m_EdgesConsumed = true;
+}
+
+void HidReportDecoder::ClearConsumedEdges()
+{
+    if (!m_EdgesConsumed)
+        return;
+
+    std::fill(m_ButtonPressed.begin(), m_ButtonPressed.end(), 0);
+    std::fill(m_ButtonReleased.begin(), m_ButtonReleased.end(), 0);
+    m_EdgesConsumed = false;
+}
+
+// One pending slot per Report ID that carries controls and no relative axes.
+void HidReportDecoder::BuildPendingReports()
+{
+    const size_t inputReportSize = m_Model->GetInputReportSize();
+    std::array<bool, 256> hasControls{};
+    std::array<bool, 256> hasRelative{};
+
+    for (size_t i = 0; i < m_ButtonCount; ++i)
+        hasControls[m_Buttons[i].reportId] = true;
+    for (size_t i = 0; i < m_SwitchCount; ++i)
+        hasControls[m_Switches[i].reportId] = true;
+    for (size_t i = 0; i < m_AxisCount; ++i)
+    {
+        hasControls[m_Axis[i].reportId] = true;
+        if (!m_Axis[i].isAbsolute)
+            hasRelative[m_Axis[i].reportId] = true;
+    }
+
+    PendingReports& pending = m_PendingReports;
+    pending = {};
+    pending.slotOf.fill(PendingReports::kNoSlot);
+
+    uint16_t slots = 0;
+    for (size_t id = 0; id < pending.slotOf.size(); ++id)
+        if (hasControls[id] && !hasRelative[id])
+            pending.slotOf[id] = slots++;
+
+    pending.reportSize = inputReportSize;
+    pending.bytes.assign(static_cast<size_t>(slots) * inputReportSize, 0);
+    pending.pending.assign(slots, 0);
+}
+
+void HidReportDecoder::DecodeReport(const uint8_t* src, size_t len)
+{
+    if (len == 0)
+        return;
+
+    ++m_DecodeStats.reports;
+
+    const ReportChange change = CompareWithLastReport(src, len);
+    if (change == ReportChange::None)
+    {
+        ++m_DecodeStats.skipped;
+        return;
+    }
+
+    std::copy(m_ButtonWords.begin(), m_ButtonWords.end(), m_ButtonSnapshot.begin());
+
+    bool axesTouched = false;
+    if (GetDecodePlan().IsEmpty())
+    {
+        axesTouched = DecodeFallback(src, len);
+    }
+    else if (change == ReportChange::Partial)
+    {
+        ++m_DecodeStats.partial;
+        axesTouched = DecodeReportPlan(src, len, m_LastReports.diffMask);
+    }
+    else
+    {
+        axesTouched = DecodeReportPlan(src, len, {});
+    }
+
+    if (axesTouched)
+        NormaliseAxes();
+
+    AccumulateEdges(m_ButtonSnapshot, m_ButtonWords, m_ButtonPressed, m_ButtonReleased);
+}
+
+HidReportDecoder::ReportChange HidReportDecoder::CompareWithLastReport(const uint8_t* src, size_t len)
+{
+    LastReportCache& cache = m_LastReports;
+
+    const uint8_t reportId = src[0]; // Report ID is always the first byte
+    const uint16_t cacheSlot = cache.slotOf[reportId];
+
+    // Unknown report, unexpected size, or relative data that must be
+    // accumulated even when repeated: decode in full, nothing to compare.
+    if (cacheSlot == LastReportCache::kNoSlot || len != cache.reportSize)
+        return ReportChange::Full;
+
+    uint8_t* last = cache.bytes.data() + static_cast<size_t>(cacheSlot) * cache.reportSize;
+    const bool hadLast = cache.valid[cacheSlot] != 0;
+
+    const bool changed = simd::DiffBytes(last, src, len, cache.diffMask.data());
+    if (hadLast && !changed)
+        return ReportChange::None;
+
+    std::memcpy(last, src, len);
+    cache.valid[cacheSlot] = 1;
+
+    return hadLast ? ReportChange::Partial : ReportChange::Full;
+}
+
+// Runs the ops of this report. With a non-empty diffMask only ops whose bytes
+// overlap a changed byte are run; the rest keep their previous result.
+bool HidReportDecoder::DecodeReportPlan(const uint8_t* src, size_t len, std::span<const uint64_t> diffMask)
+{
+    bool axesTouched = false;
+
+    for (const HidDecodePlan::Op& op : GetDecodePlan().GetOps(src[0]))
+    {
+        if (!diffMask.empty() && !AnyBitInRange(diffMask, op.GetFirstByte(), std::min<size_t>(op.GetEndByte(), len)))
+            continue;
+
+        switch (op.kind)
+        {
+        case HidDecodePlan::OpKind::Button:
+        {
+            AssignBit(m_ButtonWords, op.slot, ReadReportBits(src, len, op.bitOffset, op.bitSize) != 0);
+            break;
+        }
+        case HidDecodePlan::OpKind::Axis:
+        {
+            StoreAxis(op.slot, ReadReportBits(src, len, op.bitOffset, op.bitSize));
+            axesTouched = true;
+            break;
+        }
+        case HidDecodePlan::OpKind::Switch:
+        {
+            const int32_t lv = static_cast<int32_t>(ReadReportBits(src, len, op.bitOffset, op.bitSize));
+            m_SwitchValues[op.slot] = NormaliseSwitch(lv, m_Switches[op.slot]);
+            break;
+        }
+        case HidDecodePlan::OpKind::Selector:
+        {
+            // Array fields list the usages that are currently on; everything
+            // the array can select is off unless listed.
+            const std::span<const uint16_t> slots = GetDecodePlan().GetSelectorSlots(op);
+            for (uint16_t slot : slots)
+                if (slot != HidDecodePlan::kNoSlot)
+                    AssignBit(m_ButtonWords, slot, false);
+
+            for (uint32_t f = 0; f < op.fieldCount; ++f)
+            {
+                const uint32_t v = ReadReportBits(src, len, op.bitOffset + f * op.bitSize, op.bitSize);
+                const int64_t idx = static_cast<int64_t>(v) - op.logicalMin;
+                if (idx < 0 || idx >= static_cast<int64_t>(slots.size()))
+                    continue;
+                if (slots[static_cast<size_t>(idx)] != HidDecodePlan::kNoSlot)
+                    AssignBit(m_ButtonWords, slots[static_cast<size_t>(idx)], true);
+            }
+            break;
+        }
+        }
+    }
+
+    return axesTouched;
+}
+// ---------------------------------------------------------------------------
+// Control storage
+// ---------------------------------------------------------------------------
+
+// Only the per-device state lives here; metadata and axis constants are
+// viewed in place in the model.
+void HidReportDecoder::AllocateControlStorage()
+{
+    const HidDeviceModel& model = *m_Model;
+
+    m_Buttons = model.GetButtons();
+    m_Axis = model.GetAxes();
+    m_Switches = model.GetSwitches();
+
+    m_ButtonCount = m_Buttons.size();
+    m_AxisCount = m_Axis.size();
+    m_SwitchCount = m_Switches.size();
+
+    const size_t buttonWords = BitWordCount(m_ButtonCount);
+
+    ArenaLayout layout;
+    layout.Add<uint64_t>(buttonWords * 4)
+          .Add<int32_t>(m_AxisCount)
+          .Add<float>(m_AxisCount)
+          .Add<SwitchPosition>(m_SwitchCount);
+
+    // Single block: inline for typical gamepads, one heap allocation otherwise.
+    m_ControlStorage.Reserve(layout.GetBytes());
+
+    const std::span<uint64_t> words = m_ControlStorage.Allocate<uint64_t>(buttonWords * 4);
+    m_ButtonWords = words.subspan(0 * buttonWords, buttonWords);
+    m_ButtonSnapshot = words.subspan(1 * buttonWords, buttonWords);
+    m_ButtonPressed = words.subspan(2 * buttonWords, buttonWords);
+    m_ButtonReleased = words.subspan(3 * buttonWords, buttonWords);
+
+    const HidDeviceModel::AxisTransform& transform = model.GetAxisTransform();
+    m_AxisHot.raw = m_ControlStorage.Allocate<int32_t>(m_AxisCount);
+    m_AxisHot.value = m_ControlStorage.Allocate<float>(m_AxisCount);
+    m_AxisHot.scale = transform.scale;
+    m_AxisHot.offset = transform.offset;
+    m_AxisHot.lo = transform.lo;
+    m_AxisHot.hi = transform.hi;
+    m_AxisHot.signShift = transform.signShift;
+    m_AxisHot.relative = transform.relative;
+
+    m_SwitchValues = m_ControlStorage.Allocate<SwitchPosition>(m_SwitchCount);
+}
+
+// One cached copy per Report ID that has ops and no relative data.
+void HidReportDecoder::BuildLastReportCache()
+{
+    const HidDecodePlan& plan = GetDecodePlan();
+    const size_t inputReportSize = m_Model->GetInputReportSize();
+
+    LastReportCache& cache = m_LastReports;
+    cache = {};
+    cache.slotOf.fill(LastReportCache::kNoSlot);
+
+    uint16_t cached = 0;
+    for (size_t id = 0; id < cache.slotOf.size(); ++id)
+    {
+        const uint8_t reportId = static_cast<uint8_t>(id);
+        if (!plan.GetOps(reportId).empty() && !plan.HasRelative(reportId))
+            cache.slotOf[id] = cached++;
+    }
+
+    cache.reportSize = inputReportSize;
+    cache.bytes.assign(static_cast<size_t>(cached) * inputReportSize, 0);
+    cache.valid.assign(cached, 0);
+    cache.diffMask.assign(BitWordCount(inputReportSize), 0);
+}
+
+void HidReportDecoder::StoreAxis(size_t slot, uint32_t rawValue)
+{
+    // Sign-extend value based on bit size
+    const int32_t lv = SignExtendAxis(slot, rawValue);
+
+    // Relative axes accumulate deltas
+    if (m_AxisHot.relative[slot])
+        m_AxisHot.raw[slot] += lv;
+    else
+        m_AxisHot.raw[slot] = lv;
+}
+
+// Picks up a table published by SetAxisCalibration(). All axes are
+// normalised again right away: repeated reports are skipped and reports
+// without axes do not normalise, so a still stick would otherwise keep its
+// old value.
+void HidReportDecoder::RefreshCalibration()
+{
+    std::shared_ptr<const AxisCalibrationTable> calibration = m_Calibration.load();
+    if (calibration == m_DecodeCalibration)
+        return;
+
+    m_DecodeCalibration = std::move(calibration);
+    NormaliseAxes();
+}
+
+// Axes without a LUT go through the vector pass, one run of adjacent slots
+// at a time; LUT axes read their value from the raw one.
+void HidReportDecoder::NormaliseAxes()
+{
+    const AxisCalibrationTable& calibration = *m_DecodeCalibration;
+
+    for (const auto& [begin, end] : calibration.normaliseRuns)
+        simd::NormaliseAxes(m_AxisHot.raw.data() + begin,
+                            m_AxisHot.scale.data() + begin, m_AxisHot.offset.data() + begin,
+                            m_AxisHot.lo.data() + begin, m_AxisHot.hi.data() + begin,
+                            m_AxisHot.value.data() + begin, size_t(end - begin));
+
+    for (const AxisLut& lut : calibration.luts)
+    {
+        const int64_t idx = static_cast<int64_t>(m_AxisHot.raw[lut.slot]) - lut.base;
+        const size_t clamped = static_cast<size_t>(std::clamp<int64_t>(idx, 0, static_cast<int64_t>(lut.table.size()) - 1));
+        m_AxisHot.value[lut.slot] = lut.table[clamped];
+    }
+
+    for (const AxisCurve& curve : calibration.curves)
+        m_AxisHot.value[curve.slot] = Calibrate(m_AxisHot.value[curve.slot], curve.calibration);
+}
+
+void HidReportDecoder::NormaliseAxisColumn(size_t slot, std::span<const int32_t> raw, std::span<float> values) const
+{
+    const AxisCalibrationTable& calibration = *m_DecodeCalibration;
+
+    if (const uint16_t l = calibration.lutOf[slot]; l != AxisCalibrationTable::kNone)
+    {
+        const AxisLut& lut = calibration.luts[l];
+        const int64_t last = static_cast<int64_t>(lut.table.size()) - 1;
+        for (size_t r = 0; r < values.size(); ++r)
+            values[r] = lut.table[static_cast<size_t>(std::clamp<int64_t>(int64_t(raw[r]) - lut.base, 0, last))];
+        return;
+    }
+
+    simd::NormaliseAxisColumn(raw.data(), m_AxisHot.scale[slot], m_AxisHot.offset[slot],
+                              m_AxisHot.lo[slot], m_AxisHot.hi[slot], values.data(), values.size());
+
+    if (const uint16_t c = calibration.curveOf[slot]; c != AxisCalibrationTable::kNone)
+        for (float& v : values)
+            v = Calibrate(v, calibration.curves[c].calibration);
+}
+
+// static
+float HidReportDecoder::Calibrate(float v, const AxisCalibration& calibration)
+{
+    const float magnitude = std::abs(v);
+    if (magnitude <= calibration.deadzone)
+        return 0.f;
+
+    const float span = calibration.saturation - calibration.deadzone;
+    float t = (span > 0.f) ? std::min((magnitude - calibration.deadzone) / span, 1.f) : 1.f;
+    if (calibration.exponent != 1.f)
+        t = std::pow(t, calibration.exponent);
+
+    return std::copysign(t, v);
+}
+
+void HidReportDecoder::SetAxisCalibration(size_t i, const AxisCalibration& calibration)
+{
+    if (i >= m_AxisCount)
+        return;
+
+    const uint16_t slot = static_cast<uint16_t>(i);
+    const AxisState& ax = m_Axis[i];
+    const bool calibrated = ax.isAbsolute && !calibration.IsIdentity();
+    const int64_t entries = int64_t(ax.logicalMax) - ax.logicalMin + 1;
+    const bool useLut = calibrated && entries > 0 && entries <= static_cast<int64_t>(kMaxAxisLutEntries);
+
+    // Same float operations as the vector pass, so table and arithmetic agree.
+    AxisLut lut;
+    if (useLut)
+    {
+        lut.slot = slot;
+        lut.base = ax.logicalMin;
+        lut.calibration = calibration;
+        lut.table.resize(static_cast<size_t>(entries));
+        for (int64_t k = 0; k < entries; ++k)
+        {
+            const int32_t lv = static_cast<int32_t>(ax.logicalMin + k);
+            const float scaled = static_cast<float>(lv) * m_AxisHot.scale[i];
+            const float v = std::clamp(scaled + m_AxisHot.offset[i], m_AxisHot.lo[i], m_AxisHot.hi[i]);
+            lut.table[static_cast<size_t>(k)] = Calibrate(v, calibration);
+        }
+    }
+
+    // Concurrent setters each retry on top of the table the other published.
+    std::shared_ptr<const AxisCalibrationTable> current = m_Calibration.load();
+    std::shared_ptr<const AxisCalibrationTable> next;
+    do
+    {
+        std::vector<AxisLut> luts;
+        std::vector<AxisCurve> curves;
+        for (const AxisLut& other : current->luts)
+            if (other.slot != slot)
+                luts.push_back(other);
+        for (const AxisCurve& other : current->curves)
+            if (other.slot != slot)
+                curves.push_back(other);
+
+        if (useLut)
+            luts.push_back(lut);
+        else if (calibrated)
+            curves.push_back({ slot, calibration });
+
+        next = BuildCalibrationTable(m_AxisCount, std::move(luts), std::move(curves));
+    }
+    while (!m_Calibration.compare_exchange_weak(current, next));
+}
+
+AxisCalibration HidReportDecoder::GetAxisCalibration(size_t i) const
+{
+    if (i >= m_AxisCount)
+        return {};
+
+    const std::shared_ptr<const AxisCalibrationTable> calibration = m_Calibration.load();
+    if (const uint16_t l = calibration->lutOf[i]; l != AxisCalibrationTable::kNone)
+        return calibration->luts[l].calibration;
+    if (const uint16_t c = calibration->curveOf[i]; c != AxisCalibrationTable::kNone)
+        return calibration->curves[c].calibration;
+    return {};
+}
+
+// static
+std::shared_ptr<const HidReportDecoder::AxisCalibrationTable> HidReportDecoder::BuildCalibrationTable(
+    size_t axisCount, std::vector<AxisLut> luts, std::vector<AxisCurve> curves)
+{
+    auto table = std::make_shared<AxisCalibrationTable>();
+    table->luts = std::move(luts);
+    table->curves = std::move(curves);
+    table->lutOf.assign(axisCount, AxisCalibrationTable::kNone);
+    table->curveOf.assign(axisCount, AxisCalibrationTable::kNone);
+
+    for (size_t l = 0; l < table->luts.size(); ++l)
+        table->lutOf[table->luts[l].slot] = static_cast<uint16_t>(l);
+    for (size_t c = 0; c < table->curves.size(); ++c)
+        table->curveOf[table->curves[c].slot] = static_cast<uint16_t>(c);
+
+    for (size_t begin = 0; begin < axisCount; )
+    {
+        if (table->lutOf[begin] != AxisCalibrationTable::kNone)
+        {
+            ++begin;
+            continue;
+        }
+
+        size_t end = begin + 1;
+        while (end < axisCount && table->lutOf[end] == AxisCalibrationTable::kNone)
+            ++end;
+        table->normaliseRuns.emplace_back(static_cast<uint16_t>(begin), static_cast<uint16_t>(end));
+        begin = end;
+    }
+
+    return table;
+}
+
+SwitchPosition HidReportDecoder::NormaliseSwitch(int32_t lv, const SwitchState& ss)
+{
+    if (lv < ss.logicalMin || lv > ss.logicalMax)
+        return SwitchPosition::Center;
+
+    // Convert to hundredths of a degree
+    const int32_t angle = (lv - ss.logicalMin) * ss.granularity;
+
+    // 8 directions, each spanning 45° = 4500 hundredths
+    // Add half-step (2250) before dividing to get nearest direction
+    const int32_t index = ((angle + 2250) % 36000) / 4500;
+
+    // index 0..7 → Up, UpRight, Right, DownRight, Down, DownLeft, Left, UpLeft
+    static constexpr SwitchPosition kMap[8] = {
+        SwitchPosition::Up,
+        SwitchPosition::UpRight,
+        SwitchPosition::Right,
+        SwitchPosition::DownRight,
+        SwitchPosition::Down,
+        SwitchPosition::DownLeft,
+        SwitchPosition::Left,
+        SwitchPosition::UpLeft,
+    };
+    return kMap[index];
+}
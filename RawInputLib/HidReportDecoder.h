@@ -0,0 +1,368 @@
+#pragma once
+
+#include "HidControlRegistry.h"
+#include "HidDecodePlan.h"
+#include "HidDeviceModel.h"
+#include "HidReportHistory.h"
+#include "RawReportRing.h"
+#include "utils_arena.h"
+#include "utils_bitset.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+enum class SwitchPosition : uint8_t
+{
+    Center = 0,
+    Up = 1,
+    UpRight = 2,
+    Right = 3,
+    DownRight = 4,
+    Down = 5,
+    DownLeft = 6,
+    Left = 7,
+    UpLeft = 8,
+};
+
+// Per-axis response shaping applied on top of the [-1, +1] normalisation.
+// Works on the magnitude, so bipolar sticks stay symmetric around centre.
+struct AxisCalibration
+{
+    float deadzone = 0.f;   // |v| <= deadzone reads as 0
+    float saturation = 1.f; // |v| >= saturation reads as ±1
+    float exponent = 1.f;   // response curve, 1 = linear, > 1 = finer near centre
+
+    bool IsIdentity() const { return deadzone == 0.f && saturation == 1.f && exponent == 1.f; }
+};
+
+// Input report counters since the device was opened.
+struct HidDecodeStats
+{
+    uint64_t reports = 0; // reports received
+    uint64_t skipped = 0; // byte-identical to the previous report with the same ID, not decoded
+    uint64_t partial = 0; // only controls overlapping the changed bytes were decoded
+    uint64_t coalesced = 0; // deferred mode: replaced by a newer report before being decoded
+};
+
+// How reports arriving together in one Decode() call (RAWHID::dwCount > 1) are decoded.
+enum class HidBatchMode : uint8_t
+{
+    Sequential, // every report decoded in order; edges see short taps (default)
+    LatestOnly, // only the newest report per Report ID is decoded; relative data is still summed
+    History,    // every report decoded, per-report values kept, see CopyHistory()
+};
+
+// Control state of one HID device, decoded from its input reports.
+//
+// The decoder owns the per-device state (button words and edges, axis raw and
+// normalised values, switch positions, the last-report cache, deferred
+// reports, history and raw report ring); everything that follows from the
+// descriptor is in the shared HidDeviceModel. It does not depend on Windows:
+// RawInputDeviceHid feeds it RAWHID reports and adds a HidP_GetData fallback
+// for models without a decode plan, and InputPipeline feeds it the reports
+// of any other InputBackend.
+//
+// Decoded state is read through ReadSnapshot(): it copies every control
+// under one lock, and the Snapshot's getters then read the copy without
+// locking, so polling 128 buttons costs one lock round-trip, not 128.
+//
+// Threads: Decode() is called from one thread at a time, usually a
+// ParallelDecodePool worker. Everything else may be called from any thread.
+// Decode() and every accessor of decoded state or settings take the
+// decoder's lock, so a snapshot holds the state between two Decode() calls,
+// never the middle of one. Axis calibration is published as an immutable
+// table that Decode() picks up on its next call, so setting it never waits
+// for a decode. The raw report ring is read without the lock. Counts, the model and the control
+// registry never change and need no lock.
+class HidReportDecoder
+{
+public:
+    // Control state of typical gamepads, wheels and keyboards fits inline;
+    // larger descriptors get one exact-size heap block.
+    static constexpr size_t kInlineStorageBytes = 1024;
+    // Calibrated axes with at most this many logical values (12-bit) read
+    // their output from a precomputed table.
+    static constexpr size_t kMaxAxisLutEntries = 4096;
+
+    // A null model decodes nothing.
+    explicit HidReportDecoder(std::shared_ptr<const HidDeviceModel> model);
+    virtual ~HidReportDecoder();
+
+    HidReportDecoder(const HidReportDecoder&) = delete;
+    void operator=(const HidReportDecoder&) = delete;
+
+    // Never null; a decoder built without a model has the empty one.
+    const std::shared_ptr<const HidDeviceModel>& GetModel() const { return m_Model; }
+
+    // Decodes `count` reports of `reportSize` bytes each, stored back to
+    // back. Every report starts with its Report ID byte, 0 if the descriptor
+    // declares none (RAWHID::bRawData layout). `timestamp` is stored with the
+    // reports in the raw report ring.
+    void Decode(const uint8_t* reports, size_t reportSize, size_t count, uint64_t timestamp);
+
+    // Deferred mode: Decode() only keeps the newest report of every Report ID
+    // and the decode runs when state is first read, on the reading thread
+    // under the decoder's lock. Meant for devices that are registered but
+    // rarely looked at. Reports with relative data are still decoded on
+    // arrival, since dropping one would lose motion. Edge masks then cover
+    // everything since the previous read instead of the last Decode().
+    void SetDeferredDecode(bool deferred);
+    bool IsDeferredDecode() const { std::lock_guard lock(m_Mutex); return m_DeferredDecode; }
+
+    // Deadzone / response curve for absolute axis i; relative axes are not
+    // affected. Narrow axes bake normalisation and calibration into a lookup
+    // table that replaces the arithmetic for that axis. Takes effect from the
+    // next Decode() call, which normalises every axis again, also without
+    // new axis data.
+    void SetAxisCalibration(size_t i, const AxisCalibration& calibration);
+    AxisCalibration GetAxisCalibration(size_t i) const;
+
+    size_t GetAxisCount()    const { return m_AxisCount; }
+    size_t GetButtonCount() const { return m_ButtonCount; }
+    size_t GetSwitchCount()    const { return m_SwitchCount; }
+
+    // Control state at one point in time, consistent across controls.
+    struct Snapshot
+    {
+        std::vector<float>          axes;
+        std::vector<SwitchPosition> switches;
+        std::vector<uint64_t>       buttons;  // packed 64 per word: bit i == GetButton(i)
+        std::vector<uint64_t>       pressed;  // same layout, see WasButtonPressed()
+        std::vector<uint64_t>       released;
+        HidDecodeStats              stats;
+
+        // Normalised axis value: [-1, +1] for absolute, raw delta for relative.
+        float GetAxis(size_t i)   const { return i < axes.size() ? axes[i] : 0.f; }
+        bool  GetButton(size_t i) const { return i / 64 < buttons.size() && TestBit(buttons, i); }
+
+        // Switch / Hat / POV
+        SwitchPosition GetSwitch(size_t i) const { return i < switches.size() ? switches[i] : SwitchPosition::Center; }
+
+        // Whether button i went down / up during the last Decode() call. A
+        // press and release within one batch sets both.
+        bool WasButtonPressed(size_t i)  const { return i / 64 < pressed.size() && TestBit(pressed, i); }
+        bool WasButtonReleased(size_t i) const { return i / 64 < released.size() && TestBit(released, i); }
+    };
+
+    // Copies the whole control state under one lock. Reuses the capacity of
+    // `out`, so polling into the same snapshot does not allocate.
+    void ReadSnapshot(Snapshot& out) const;
+    Snapshot ReadSnapshot() const { Snapshot out; ReadSnapshot(out); return out; }
+
+    HidDecodeStats GetDecodeStats() const { const auto lock = LockDecoded(); return m_DecodeStats; }
+
+    void SetBatchMode(HidBatchMode mode) { std::lock_guard lock(m_Mutex); m_BatchMode = mode; }
+    HidBatchMode GetBatchMode() const { std::lock_guard lock(m_Mutex); return m_BatchMode; }
+
+    // HidBatchMode::History: one entry per report of the last Decode() call,
+    // copied into `out` (reusing its storage).
+    void CopyHistory(HidReportHistory& out) const { std::lock_guard lock(m_Mutex); out = m_History; }
+
+    // Keeps the last `capacity` raw reports, stamped with the Decode()
+    // timestamps, independent of the decode mode. May be called from any
+    // thread, also while input arrives: the next Decode() starts filling the
+    // ring. Only the first call creates it; later calls are ignored. The
+    // ring may be read from any thread and lives as long as the decoder.
+    void EnableRawReportRing(size_t capacity);
+    const RawReportRing* GetRawReportRing() const { return m_RawReportRing.load(std::memory_order_acquire); }
+
+    const HidControlRegistry& GetControls() const { return m_Model->GetControls(); }
+
+private:
+    // Calibrated narrow axis: value = table[raw - base].
+    struct AxisLut
+    {
+        uint16_t           slot = 0;
+        int32_t            base = 0;
+        AxisCalibration    calibration;
+        std::vector<float> table;
+    };
+
+    // Calibrated axis too wide for a table; calibrated arithmetically.
+    struct AxisCurve
+    {
+        uint16_t        slot = 0;
+        AxisCalibration calibration;
+    };
+
+    // Calibration of all axes, never modified once published; see
+    // SetAxisCalibration().
+    struct AxisCalibrationTable
+    {
+        static constexpr uint16_t kNone = 0xFFFF;
+
+        std::vector<AxisLut>   luts;
+        std::vector<AxisCurve> curves;
+        std::vector<uint16_t>  lutOf;   // axis slot → index into luts, or kNone
+        std::vector<uint16_t>  curveOf; // axis slot → index into curves, or kNone
+        // [begin, end) slot ranges without a LUT, normalised arithmetically.
+        std::vector<std::pair<uint16_t, uint16_t>> normaliseRuns;
+    };
+
+public:
+    // What carries over to a new decoder for the same device, e.g. after a
+    // reconnect. Holding the model keeps it in HidDeviceModel's cache; the
+    // calibration table is shared as it is if the model is the same.
+    struct Settings
+    {
+        std::shared_ptr<const HidDeviceModel>       model;
+        std::shared_ptr<const AxisCalibrationTable> calibration;
+        HidBatchMode                          batchMode = HidBatchMode::Sequential;
+        bool                                  deferredDecode = false;
+        size_t                                rawReportRingCapacity = 0;
+    };
+
+    Settings SaveSettings() const;
+    void RestoreSettings(const Settings& settings);
+
+protected:
+    using ButtonState = HidDeviceModel::ButtonState;
+    using AxisState = HidDeviceModel::AxisState;
+    using SwitchState = HidDeviceModel::SwitchState;
+
+    // Decodes a report for a model without a decode plan; returns whether
+    // any axis was stored. Runs between the button snapshot and the
+    // normalisation pass, so it only stores raw values through the helpers
+    // below.
+    virtual bool HasDecodeFallback() const { return false; }
+    virtual bool DecodeFallback(const uint8_t* src, size_t len);
+
+    void StoreAxis(size_t slot, uint32_t rawValue);
+    void SetButton(size_t slot, bool on) { AssignBit(m_ButtonWords, slot, on); }
+    void ClearButtons(std::span<const uint64_t> mask) { ClearBits(m_ButtonWords, mask); }
+    void SetSwitch(size_t slot, int32_t logicalValue) { m_SwitchValues[slot] = NormaliseSwitch(logicalValue, m_Switches[slot]); }
+    void CenterSwitches() { std::fill(m_SwitchValues.begin(), m_SwitchValues.end(), SwitchPosition::Center); }
+
+private:
+    enum class ReportChange : uint8_t { None, Partial, Full };
+
+    void AllocateControlStorage();
+    void BuildLastReportCache();
+    void BuildPendingReports();
+
+    void DecodeReport(const uint8_t* src, size_t len);
+    void DecodeLatestOnly(const uint8_t* reports, size_t len, size_t count);
+    void DecodeWithHistory(const uint8_t* reports, size_t len, size_t count);
+    void DecodeRun(const uint8_t* first, size_t stride, size_t count, size_t row0);
+    void DeferReport(const uint8_t* src, size_t len);
+    void FlushPendingReports();
+    void ClearConsumedEdges();
+
+    // Takes m_Mutex for a reader. In deferred mode the first read after new
+    // input runs the pending decode first, under the same lock Decode() takes,
+    // so it never overlaps a decode on another thread.
+    std::unique_lock<std::mutex> LockDecoded() const
+    {
+        std::unique_lock lock(m_Mutex);
+        if (m_DeferredDecode)
+            const_cast<HidReportDecoder*>(this)->FlushPendingReports(); // logically const
+        return lock;
+    }
+    ReportChange CompareWithLastReport(const uint8_t* src, size_t len);
+    bool DecodeReportPlan(const uint8_t* src, size_t len, std::span<const uint64_t> diffMask);
+
+    int32_t SignExtendAxis(size_t slot, uint32_t rawValue) const
+    {
+        const int shift = m_AxisHot.signShift[slot];
+        return static_cast<int32_t>(rawValue << shift) >> shift;
+    }
+    void NormaliseAxisColumn(size_t slot, std::span<const int32_t> raw, std::span<float> values) const;
+    void NormaliseAxes();
+    void RefreshCalibration();
+    static std::shared_ptr<const AxisCalibrationTable> BuildCalibrationTable(size_t axisCount, std::vector<AxisLut> luts, std::vector<AxisCurve> curves);
+    static float Calibrate(float v, const AxisCalibration& calibration);
+    static SwitchPosition NormaliseSwitch(int32_t lv, const SwitchState& ss);
+
+    const HidDecodePlan& GetDecodePlan() const { return m_Model->GetDecodePlan(); }
+
+    // Never null; decoders without usable capabilities get the empty model.
+    std::shared_ptr<const HidDeviceModel> m_Model;
+
+    // Held by Decode() and by every accessor of decoded state or settings.
+    mutable std::mutex m_Mutex;
+
+    // Per-axis values touched on every report, one array per field so that
+    // all axes are normalised in a single vector pass:
+    //   value = clamp(raw * scale + offset, lo, hi)
+    // raw and value are per device (m_ControlStorage); the constants are the
+    // model's HidDeviceModel::AxisTransform.
+    struct AxisHotBlock
+    {
+        std::span<int32_t>       raw;       // sign-extended logical value
+        std::span<const float>   scale;
+        std::span<const float>   offset;
+        std::span<const float>   lo;
+        std::span<const float>   hi;
+        std::span<float>         value;
+        std::span<const uint8_t> signShift; // 32 - bitSize for signed fields, else 0
+        std::span<const uint8_t> relative;
+    };
+
+    // Metadata views into the model; state views into m_ControlStorage.
+    size_t                     m_AxisCount = 0;
+    std::span<const AxisState> m_Axis;
+    AxisHotBlock               m_AxisHot;
+
+    // Never null. Replaced whole by SetAxisCalibration() from any thread;
+    // Decode() takes a reference for the duration of the call.
+    std::atomic<std::shared_ptr<const AxisCalibrationTable>> m_Calibration;
+    std::shared_ptr<const AxisCalibrationTable>              m_DecodeCalibration; // under m_Mutex
+
+    size_t                       m_ButtonCount = 0;
+    std::span<const ButtonState> m_Buttons;
+    std::span<uint64_t>          m_ButtonWords;     // current state
+    std::span<uint64_t>          m_ButtonSnapshot;  // state before the report being decoded
+    std::span<uint64_t>          m_ButtonPressed;
+    std::span<uint64_t>          m_ButtonReleased;
+
+    size_t                       m_SwitchCount = 0;
+    std::span<const SwitchState> m_Switches;
+    std::span<SwitchPosition>    m_SwitchValues;
+
+    MonotonicArena<kInlineStorageBytes> m_ControlStorage;
+
+    // Previous report bytes per Report ID, for skipping repeated reports and
+    // re-decoding only what changed. Reports with relative data are not cached.
+    struct LastReportCache
+    {
+        static constexpr uint16_t kNoSlot = 0xFFFF;
+
+        size_t                    reportSize = 0;
+        std::array<uint16_t, 256> slotOf{};  // Report ID → index into bytes / valid
+        std::vector<uint8_t>      bytes;     // one reportSize block per cached Report ID
+        std::vector<uint8_t>      valid;
+        std::vector<uint64_t>     diffMask;  // changed bytes of the last compare
+    };
+
+    LastReportCache             m_LastReports;
+    HidDecodeStats              m_DecodeStats;
+
+    // Deferred mode: newest undecoded report per Report ID.
+    struct PendingReports
+    {
+        static constexpr uint16_t kNoSlot = 0xFFFF;
+
+        size_t                    reportSize = 0;
+        std::array<uint16_t, 256> slotOf{};  // Report ID → index into bytes / pending
+        std::vector<uint8_t>      bytes;     // one reportSize block per Report ID
+        std::vector<uint8_t>      pending;
+        size_t                    count = 0; // number of set pending flags
+    };
+
+    HidBatchMode                m_BatchMode = HidBatchMode::Sequential;
+    HidReportHistory            m_History;
+    // Created once under m_Mutex, then published to Decode() and readers
+    // through the atomic pointer.
+    std::unique_ptr<RawReportRing> m_RawReports;
+    std::atomic<RawReportRing*>    m_RawReportRing = nullptr;
+
+    bool                        m_DeferredDecode = false;
+    bool                        m_EdgesConsumed = false; // deferred: edges were read, clear before next decode
+    PendingReports              m_PendingReports;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Per-report control state of the reports delivered by the last
+// HidReportDecoder::Decode() call, for consumers that need every intermediate
+// sample of a burst rather than just the newest state.
+//
+// Axes and switches are stored column by column: GetAxis(i) returns one value
+// per report, oldest first. Buttons are stored as one packed bit row per report
+// (same layout as HidReportDecoder::Snapshot::buttons).
+//
+// Storage grows to the largest burst seen and is then reused, so steady-state
+// decoding does not allocate.
+class HidReportHistory
+{
+public:
+    HidReportHistory() = default;
+
+    size_t GetReportCount() const { return m_Count; }
+    bool IsEmpty() const { return m_Count == 0; }
+
+    uint8_t GetReportId(size_t report) const { return m_ReportIds[report]; }
+
+    // Normalised axis values, one per report.
+    std::span<const float> GetAxis(size_t axis) const
+    {
+        return { m_AxisValues.data() + axis * m_Capacity, m_Count };
+    }
+
+    // SwitchPosition values, one per report.
+    std::span<const uint8_t> GetSwitch(size_t sw) const
+    {
+        return { m_Switches.data() + sw * m_Capacity, m_Count };
+    }
+
+    std::span<const uint64_t> GetButtonWords(size_t report) const
+    {
+        return { m_ButtonWords.data() + report * m_WordCount, m_WordCount };
+    }
+
+    // ---- writer side, used by the decoder ----
+
+    // Makes room for `count` reports and drops the previous contents.
+    void Reset(size_t axes, size_t buttonWords, size_t switches, size_t count)
+    {
+        m_AxisCount = axes;
+        m_WordCount = buttonWords;
+        m_SwitchCount = switches;
+        m_Count = count;
+
+        if (count > m_Capacity || m_AxisRaw.size() != axes * m_Capacity
+            || m_ButtonWords.size() != buttonWords * m_Capacity || m_Switches.size() != switches * m_Capacity)
+        {
+            m_Capacity = std::max(count, m_Capacity);
+            m_AxisRaw.assign(axes * m_Capacity, 0);
+            m_AxisValues.assign(axes * m_Capacity, 0.f);
+            m_Switches.assign(switches * m_Capacity, 0);
+            m_ButtonWords.assign(buttonWords * m_Capacity, 0);
+            m_ReportIds.assign(m_Capacity, 0);
+        }
+    }
+
+    std::span<int32_t>  AxisRawColumn(size_t axis) { return { m_AxisRaw.data() + axis * m_Capacity, m_Count }; }
+    std::span<float>    AxisColumn(size_t axis)    { return { m_AxisValues.data() + axis * m_Capacity, m_Count }; }
+    std::span<uint8_t>  SwitchColumn(size_t sw)    { return { m_Switches.data() + sw * m_Capacity, m_Count }; }
+    std::span<uint64_t> ButtonRow(size_t report)   { return { m_ButtonWords.data() + report * m_WordCount, m_WordCount }; }
+    void SetReportId(size_t report, uint8_t reportId) { m_ReportIds[report] = reportId; }
+
+private:
+    size_t m_Capacity = 0;
+    size_t m_Count = 0;
+    size_t m_AxisCount = 0;
+    size_t m_WordCount = 0;
+    size_t m_SwitchCount = 0;
+
+    std::vector<int32_t>  m_AxisRaw;     // sign-extended logical values, column-major
+    std::vector<float>    m_AxisValues;  // column-major
+    std::vector<uint8_t>  m_Switches;    // column-major
+    std::vector<uint64_t> m_ButtonWords; // row-major
+    std::vector<uint8_t>  m_ReportIds;
+};
@@ -0,0 +1,61 @@
+#include "HotplugCoalescer.h"
+
+#include <algorithm>
+
+HotplugCoalescer::HotplugCoalescer(Clock::duration quietPeriod, Clock::duration maxDelay)
+    : m_QuietPeriod(quietPeriod)
+    , m_MaxDelay(std::max(maxDelay, quietPeriod))
+{}
+
+void HotplugCoalescer::OnArrival(Key key, Clock::time_point now)
+{
+    Add(key, true, now);
+}
+
+void HotplugCoalescer::OnRemoval(Key key, Clock::time_point now)
+{
+    Add(key, false, now);
+}
+
+void HotplugCoalescer::Add(Key key, bool arrival, Clock::time_point now)
+{
+    if (m_Order.empty())
+        m_First = now;
+    m_Last = now;
+    ++m_Notifications;
+
+    auto [it, inserted] = m_Pending.try_emplace(key);
+    if (inserted)
+        m_Order.push_back(key);
+
+    Pending& pending = it->second;
+    if (!arrival)
+        pending.removed = true;
+    pending.present = arrival;
+}
+
+HotplugCoalescer::Clock::time_point HotplugCoalescer::GetDeadline() const
+{
+    return std::min(m_Last + m_QuietPeriod, m_First + m_MaxDelay);
+}
+
+HotplugCoalescer::Batch HotplugCoalescer::Take()
+{
+    Batch batch;
+    batch.notifications = m_Notifications;
+
+    for (Key key : m_Order)
+    {
+        const Pending& pending = m_Pending[key];
+        if (pending.removed)
+            batch.removed.push_back(key);
+        if (pending.present)
+            batch.arrived.push_back(key);
+    }
+
+    m_Order.clear();
+    m_Pending.clear();
+    m_Notifications = 0;
+
+    return batch;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Collects device arrival and removal notifications into batches.
+//
+// Docks and hubs announce dozens of interfaces within a few hundred
+// milliseconds. Notifications are held until none has come in for
+// `quietPeriod`, or until the oldest one has waited `maxDelay`, and are then
+// taken as one batch with at most one entry per device:
+//
+//   arrival                   → arrived
+//   removal                   → removed
+//   arrival ... removal       → removed (a no-op if the device never made it in)
+//   removal ... arrival       → removed and arrived (the handle was reused)
+//   repeated notifications    → collapsed
+//
+// Not thread-safe; the owner feeds and drains it from one thread.
+class HotplugCoalescer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Key = uint64_t;
+
+    struct Batch
+    {
+        std::vector<Key> removed; // in the order first seen
+        std::vector<Key> arrived; // in the order first seen
+        size_t           notifications = 0;
+    };
+
+    HotplugCoalescer(Clock::duration quietPeriod, Clock::duration maxDelay);
+
+    void OnArrival(Key key, Clock::time_point now);
+    void OnRemoval(Key key, Clock::time_point now);
+
+    bool IsEmpty() const { return m_Order.empty(); }
+
+    // When the pending batch is due; only meaningful if !IsEmpty().
+    Clock::time_point GetDeadline() const;
+    bool IsDue(Clock::time_point now) const { return !IsEmpty() && now >= GetDeadline(); }
+
+    // Hands over everything pending, due or not, and starts a new batch.
+    Batch Take();
+
+private:
+    struct Pending
+    {
+        bool removed = false; // a removal was seen
+        bool present = false; // the last notification was an arrival
+    };
+
+    void Add(Key key, bool arrival, Clock::time_point now);
+
+    Clock::duration m_QuietPeriod;
+    Clock::duration m_MaxDelay;
+
+    Clock::time_point m_First;
+    Clock::time_point m_Last;
+    size_t            m_Notifications = 0;
+
+    std::vector<Key>                  m_Order;
+    std::unordered_map<Key, Pending>  m_Pending;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Where devices and their input come from.
+//
+// A backend owns one thread. Everything it reports to its Listener, and
+// every task posted to it, runs on that thread in order, so the listener
+// needs no locking of its own. The manager is one listener; anything that
+// wants the raw stream (a benchmark, a recorder) can be another.
+//
+// Handles are opaque and only unique among devices present at the same time;
+// a removed device's handle may be reused.
+class InputBackend
+{
+public:
+    using DeviceHandle = uint64_t;
+    using Clock = std::chrono::steady_clock;
+
+    // Same values as RIM_TYPEMOUSE, RIM_TYPEKEYBOARD and RIM_TYPEHID.
+    enum class DeviceType : uint32_t
+    {
+        Mouse = 0,
+        Keyboard = 1,
+        Hid = 2,
+    };
+
+    // What a device's OnInput packets carry.
+    enum class PacketFormat : uint8_t
+    {
+        Native,     // the backend's own: RAWINPUT, or generated bytes
+        HidReport,  // a bare HID report, see GetReportDescriptor()
+        EvdevFrame, // Linux input_event records up to and including SYN_REPORT
+    };
+
+    struct DeviceInfo
+    {
+        DeviceType   type = DeviceType::Hid;
+        std::string  interfacePath;
+        PacketFormat format = PacketFormat::Native;
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        // First and last calls on the backend thread. Devices present at
+        // start are not announced; OnStarted enumerates them.
+        virtual void OnStarted() = 0;
+        virtual void OnStopping() = 0;
+
+        virtual void OnDeviceArrived(DeviceHandle handle) = 0;
+        virtual void OnDeviceRemoved(DeviceHandle handle) = 0;
+
+        // One input packet, in the device's DeviceInfo::format. Only valid
+        // for the duration of the call.
+        virtual void OnInput(DeviceHandle handle, DeviceType type, std::span<const uint8_t> packet) = 0;
+
+        // The wakeup requested by ScheduleWakeup() is due.
+        virtual void OnWakeup() = 0;
+    };
+
+    virtual ~InputBackend() = default;
+
+    // Starts the backend thread and returns once the listener's OnStarted()
+    // has returned. Start and Stop are called once each, from the same thread.
+    virtual void Start(Listener& listener) = 0;
+
+    // Calls the listener's OnStopping() and joins the backend thread.
+    virtual void Stop() = 0;
+
+    // Runs `task` on the backend thread. Callable from any thread while
+    // started; tasks posted after Stop() began are dropped.
+    virtual void Post(std::function<void()> task) = 0;
+
+    // The following are called on the backend thread only.
+
+    // Calls OnWakeup() once after `delay`. Replaces an earlier request.
+    virtual void ScheduleWakeup(Clock::duration delay) = 0;
+    virtual void CancelWakeup() = 0;
+
+    virtual std::vector<DeviceHandle> EnumerateDevices() = 0;
+
+    // nullopt if the device is gone.
+    virtual std::optional<DeviceInfo> GetDeviceInfo(DeviceHandle handle) = 0;
+
+    // The device's HID report descriptor, for backends whose packets are
+    // bare HID reports. Empty if unknown; valid until the device is removed.
+    virtual std::span<const uint8_t> GetReportDescriptor(DeviceHandle /*handle*/) const { return {}; }
+};
@@ -0,0 +1,185 @@
+#include "InputPipeline.h"
+
+#include <cstring>
+#include <future>
+
+namespace
+{
+    // Each pool frame starts with the arrival time.
+    constexpr size_t kTimestampBytes = sizeof(uint64_t);
+}
+
+InputPipeline::InputPipeline(std::unique_ptr<InputBackend> backend, size_t workerCount)
+    : m_Backend(std::move(backend))
+    , m_Pool(workerCount)
+{
+}
+
+InputPipeline::~InputPipeline()
+{
+    if (m_Started)
+        Stop();
+}
+
+void InputPipeline::Start()
+{
+    m_Started = true;
+    m_Backend->Start(*this);
+}
+
+void InputPipeline::Stop()
+{
+    m_Backend->Stop();
+    m_Started = false;
+}
+
+std::vector<InputPipeline::DeviceHandle> InputPipeline::GetDevices() const
+{
+    std::lock_guard lock(m_Mutex);
+
+    std::vector<DeviceHandle> handles;
+    handles.reserve(m_Devices.size());
+    for (const auto& [handle, device] : m_Devices)
+        handles.push_back(handle);
+    return handles;
+}
+
+std::shared_ptr<HidReportDecoder> InputPipeline::GetDecoder(DeviceHandle handle) const
+{
+    std::lock_guard lock(m_Mutex);
+
+    auto it = m_Devices.find(handle);
+    return it != m_Devices.end() ? it->second.decoder : nullptr;
+}
+
+void InputPipeline::Flush()
+{
+    // Tasks run after the packets delivered before them.
+    std::promise<void> delivered;
+    std::future<void>  deliveredFuture = delivered.get_future();
+    m_Backend->Post([&delivered]() { delivered.set_value(); });
+    deliveredFuture.wait();
+
+    m_Pool.WaitIdle();
+}
+
+// ---------------------------------------------------------------------------
+// InputBackend::Listener
+// ---------------------------------------------------------------------------
+
+void InputPipeline::OnStarted()
+{
+    for (DeviceHandle handle : m_Backend->EnumerateDevices())
+        AddDevice(handle);
+}
+
+void InputPipeline::OnStopping()
+{
+    std::vector<DeviceHandle> handles = GetDevices();
+    for (DeviceHandle handle : handles)
+        RemoveDevice(handle);
+}
+
+void InputPipeline::OnDeviceArrived(DeviceHandle handle)
+{
+    AddDevice(handle);
+}
+
+void InputPipeline::OnDeviceRemoved(DeviceHandle handle)
+{
+    RemoveDevice(handle);
+}
+
+void InputPipeline::OnInput(DeviceHandle handle, InputBackend::DeviceType /*type*/, std::span<const uint8_t> packet)
+{
+    // Only this thread writes m_Devices, so reading it needs no lock.
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return;
+
+    if (it->second.evdev)
+    {
+        packet = it->second.evdev->Translate(packet);
+        if (packet.empty())
+            return;
+    }
+
+    const bool addReportId = it->second.addReportId;
+    const uint64_t timestamp = static_cast<uint64_t>(InputBackend::Clock::now().time_since_epoch().count());
+    const size_t idBytes = addReportId ? 1 : 0;
+
+    m_Frame.resize(kTimestampBytes + idBytes + packet.size());
+    std::memcpy(m_Frame.data(), &timestamp, kTimestampBytes);
+    if (addReportId)
+        m_Frame[kTimestampBytes] = 0;
+    if (!packet.empty())
+        std::memcpy(m_Frame.data() + kTimestampBytes + idBytes, packet.data(), packet.size());
+
+    m_Pool.Submit(it->second.poolDevice, m_Frame.data(), m_Frame.size());
+}
+
+// ---------------------------------------------------------------------------
+// Devices
+// ---------------------------------------------------------------------------
+
+void InputPipeline::AddDevice(DeviceHandle handle)
+{
+    const std::optional<InputBackend::DeviceInfo> info = m_Backend->GetDeviceInfo(handle);
+    if (!info)
+        return;
+
+    std::span<const uint8_t> descriptor;
+    switch (info->format)
+    {
+    case InputBackend::PacketFormat::HidReport:
+        descriptor = m_Backend->GetReportDescriptor(handle);
+        break;
+    case InputBackend::PacketFormat::EvdevFrame:
+        descriptor = EvdevHidTranslator::GetReportDescriptor(info->type);
+        break;
+    case InputBackend::PacketFormat::Native:
+        return;
+    }
+
+    std::shared_ptr<const HidDeviceModel> model = descriptor.empty() ? nullptr : HidDeviceModel::AcquireFromDescriptor(descriptor);
+    if (!model)
+        return;
+
+    RemoveDevice(handle); // handles may be reused
+
+    Device device;
+    device.addReportId = !model->HasReportIds();
+    if (info->format == InputBackend::PacketFormat::EvdevFrame)
+        device.evdev = std::make_unique<EvdevHidTranslator>(info->type);
+    device.decoder = std::make_shared<HidReportDecoder>(std::move(model));
+    device.poolDevice = m_Pool.AddDevice([decoder = device.decoder](const uint8_t* data, size_t size)
+        {
+            if (size <= kTimestampBytes)
+                return;
+
+            uint64_t timestamp;
+            std::memcpy(&timestamp, data, kTimestampBytes);
+            decoder->Decode(data + kTimestampBytes, size - kTimestampBytes, 1, timestamp);
+        });
+
+    std::lock_guard lock(m_Mutex);
+    m_Devices[handle] = std::move(device);
+}
+
+void InputPipeline::RemoveDevice(DeviceHandle handle)
+{
+    Device device;
+    {
+        std::lock_guard lock(m_Mutex);
+
+        auto it = m_Devices.find(handle);
+        if (it == m_Devices.end())
+            return;
+
+        device = std::move(it->second);
+        m_Devices.erase(it);
+    }
+
+    // Waits for an in-flight decode; queued reports are dropped.
+    m_Pool.RemoveDevice(device.poolDevice);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "EvdevHidTranslator.h"
+#include "HidReportDecoder.h"
+#include "InputBackend.h"
+#include "ParallelDecodePool.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// HID decoding for backends whose packets are bare HID reports (hidraw,
+// replayed captures, synthetic devices) or evdev frames, without Windows.
+//
+// On arrival, a device's report descriptor (InputBackend::GetReportDescriptor)
+// gives its HidDeviceModel and a HidReportDecoder; devices without a usable
+// descriptor are ignored. evdev keyboards and mice get the descriptor of
+// EvdevHidTranslator, which turns their frames into reports on the backend
+// thread. The backend thread only copies each report, with its arrival time,
+// into a ParallelDecodePool queue; the decoders run on the pool's workers.
+// Reports carry the Report ID byte only if the descriptor declares Report
+// IDs; the pipeline adds the 0 byte HidReportDecoder expects otherwise.
+//
+// Raw Input devices, which deliver RAWINPUT, go through RawInputDeviceManager.
+class InputPipeline : public InputBackend::Listener
+{
+public:
+    using DeviceHandle = InputBackend::DeviceHandle;
+
+    // workerCount as for ParallelDecodePool.
+    explicit InputPipeline(std::unique_ptr<InputBackend> backend, size_t workerCount = 0);
+    ~InputPipeline() override;
+
+    InputPipeline(const InputPipeline&) = delete;
+    void operator=(const InputPipeline&) = delete;
+
+    // Start and Stop are called once each, from the same thread.
+    void Start();
+    void Stop();
+
+    InputBackend& GetBackend() { return *m_Backend; }
+
+    // Devices that have a decoder. Thread-safe.
+    std::vector<DeviceHandle> GetDevices() const;
+
+    // nullptr if the device is unknown, gone or has no usable descriptor.
+    // Thread-safe; a removed device's decoder stays valid for as long as the
+    // caller holds it. Decoder timestamps are steady_clock ticks.
+    std::shared_ptr<HidReportDecoder> GetDecoder(DeviceHandle handle) const;
+
+    // Blocks until every packet the backend delivered so far is decoded.
+    // Call while started, not from the backend thread.
+    void Flush();
+
+    // InputBackend::Listener, all on the backend thread.
+    void OnStarted() override;
+    void OnStopping() override;
+    void OnDeviceArrived(DeviceHandle handle) override;
+    void OnDeviceRemoved(DeviceHandle handle) override;
+    void OnInput(DeviceHandle handle, InputBackend::DeviceType type, std::span<const uint8_t> packet) override;
+    void OnWakeup() override {}
+
+private:
+    struct Device
+    {
+        std::shared_ptr<HidReportDecoder>   decoder;
+        ParallelDecodePool::DeviceId        poolDevice;
+        bool                                addReportId = false; // descriptor declares no Report IDs
+        std::unique_ptr<EvdevHidTranslator> evdev;               // PacketFormat::EvdevFrame devices
+    };
+
+    void AddDevice(DeviceHandle handle);
+    void RemoveDevice(DeviceHandle handle);
+
+    std::unique_ptr<InputBackend> m_Backend;
+    ParallelDecodePool            m_Pool;
+    bool                          m_Started = false;
+
+    // Written on the backend thread under the lock, read from anywhere.
+    mutable std::mutex                       m_Mutex;
+    std::unordered_map<DeviceHandle, Device> m_Devices;
+
+    // Backend thread only: timestamp, then the report as the decoder takes it.
+    std::vector<uint8_t> m_Frame;
+};
@@ -0,0 +1,507 @@
+#include "LinuxInputBackend.h"
+
+#include "EvdevHidTranslator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace
+{
+    // epoll keys of the backend's own descriptors; device handles start at 1.
+    constexpr uint64_t kTaskKey = 0;
+    constexpr uint64_t kTimerKey = UINT64_MAX;
+
+    constexpr size_t kEventSize = sizeof(input_event);
+    static_assert(kEventSize == EvdevHidTranslator::kEventSize);
+
+    bool AddToEpoll(int epoll, int fd, uint64_t key)
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = key;
+        return ::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    void Drain(int fd)
+    {
+        uint64_t value;
+        while (::read(fd, &value, sizeof(value)) == sizeof(value))
+            ;
+    }
+
+    // Whether a failed read means the source is gone rather than drained.
+    bool IsReadError(ssize_t result)
+    {
+        return result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+    }
+
+    // "0003:0000046D:0000C52B" → bus, vendor, product.
+    void ParseHidId(const std::string& value, LinuxInputBackend::HidrawSysfsInfo& info)
+    {
+        unsigned bus = 0, vendor = 0, product = 0;
+        if (std::sscanf(value.c_str(), "%x:%x:%x", &bus, &vendor, &product) == 3)
+        {
+            info.bus = static_cast<uint16_t>(bus);
+            info.vendorId = static_cast<uint16_t>(vendor);
+            info.productId = static_cast<uint16_t>(product);
+        }
+    }
+}
+
+LinuxInputBackend::~LinuxInputBackend()
+{
+    if (m_Thread.joinable())
+        Stop();
+
+    // Sources added but never started.
+    for (const Source& source : m_InitialSources)
+        ::close(source.fd);
+}
+
+void LinuxInputBackend::Start(Listener& listener)
+{
+    m_Listener = &listener;
+
+    m_Epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    m_TaskEvent = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_Timer = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    AddToEpoll(m_Epoll, m_TaskEvent, kTaskKey);
+    AddToEpoll(m_Epoll, m_Timer, kTimerKey);
+
+    std::promise<void> readyPromise;
+    std::future<void>  readyFuture = readyPromise.get_future();
+
+    m_Thread = std::thread(&LinuxInputBackend::ThreadRun, this, std::move(readyPromise));
+
+    readyFuture.get();
+}
+
+void LinuxInputBackend::Stop()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stopping = true;
+    }
+
+    const uint64_t one = 1;
+    ::write(m_TaskEvent, &one, sizeof(one));
+
+    m_Thread.join();
+
+    ::close(m_Timer);
+    ::close(m_TaskEvent);
+    ::close(m_Epoll);
+    m_Timer = m_TaskEvent = m_Epoll = -1;
+}
+
+void LinuxInputBackend::Post(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        if (m_Stopping)
+            return;
+
+        m_Tasks.push_back(std::move(task));
+    }
+
+    const uint64_t one = 1;
+    ::write(m_TaskEvent, &one, sizeof(one));
+}
+
+void LinuxInputBackend::RunPostedTasks()
+{
+    Drain(m_TaskEvent);
+
+    std::deque<std::function<void()>> tasks;
+    {
+        std::lock_guard lock(m_Mutex);
+        tasks.swap(m_Tasks);
+    }
+
+    for (auto& task : tasks)
+        task();
+}
+
+void LinuxInputBackend::ScheduleWakeup(Clock::duration delay)
+{
+    // A zero it_value disarms the timer; fire as soon as possible instead.
+    const auto ns = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
+
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    ::timerfd_settime(m_Timer, 0, &spec, nullptr);
+}
+
+void LinuxInputBackend::CancelWakeup()
+{
+    const itimerspec spec = {};
+    ::timerfd_settime(m_Timer, 0, &spec, nullptr);
+}
+
+std::vector<InputBackend::DeviceHandle> LinuxInputBackend::EnumerateDevices()
+{
+    return m_Order;
+}
+
+std::optional<InputBackend::DeviceInfo> LinuxInputBackend::GetDeviceInfo(DeviceHandle handle)
+{
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return std::nullopt;
+
+    const Source& source = it->second.source;
+    return DeviceInfo{ source.type, source.interfacePath,
+                       source.format == StreamFormat::Evdev ? PacketFormat::EvdevFrame : PacketFormat::HidReport };
+}
+
+std::span<const uint8_t> LinuxInputBackend::GetReportDescriptor(DeviceHandle handle) const
+{
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return {};
+
+    return it->second.source.reportDescriptor;
+}
+
+void LinuxInputBackend::AddSource(Source source)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        if (!m_Running)
+        {
+            m_InitialSources.push_back(std::move(source));
+            return;
+        }
+    }
+
+    Post([this, source = std::move(source)]() mutable
+        {
+            const DeviceHandle handle = AddDevice(std::move(source));
+            if (handle)
+                m_Listener->OnDeviceArrived(handle);
+        });
+}
+
+void LinuxInputBackend::ThreadRun(std::promise<void> readyPromise)
+{
+    std::vector<Source> sources;
+    {
+        std::lock_guard lock(m_Mutex);
+        sources.swap(m_InitialSources);
+        m_Running = true;
+    }
+
+    for (Source& source : sources)
+        AddDevice(std::move(source));
+
+    m_Listener->OnStarted();
+
+    readyPromise.set_value();
+
+    epoll_event events[kBatchSize];
+    for (;;)
+    {
+        const int count = ::epoll_wait(m_Epoll, events, static_cast<int>(std::size(events)), -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const uint64_t key = events[i].data.u64;
+            if (key == kTaskKey)
+            {
+                RunPostedTasks();
+            }
+            else if (key == kTimerKey)
+            {
+                Drain(m_Timer);
+                m_Listener->OnWakeup();
+            }
+            else
+            {
+                // Possibly removed by an earlier event or task of this round.
+                auto it = m_Devices.find(key);
+                if (it != m_Devices.end() && !ReadDevice(key, it->second))
+                {
+                    RemoveDevice(key);
+                    m_Listener->OnDeviceRemoved(key);
+                }
+            }
+        }
+
+        std::lock_guard lock(m_Mutex);
+        if (m_Stopping)
+            break;
+    }
+
+    m_Listener->OnStopping();
+
+    while (!m_Order.empty())
+        RemoveDevice(m_Order.back());
+}
+
+InputBackend::DeviceHandle LinuxInputBackend::AddDevice(Source source)
+{
+    const DeviceHandle handle = m_NextHandle++;
+    if (!AddToEpoll(m_Epoll, source.fd, handle))
+    {
+        ::close(source.fd);
+        return 0;
+    }
+
+    Device& device = m_Devices[handle];
+    device.source = std::move(source);
+
+    struct stat st;
+    device.socket = ::fstat(device.source.fd, &st) == 0 && S_ISSOCK(st.st_mode);
+
+    switch (device.source.format)
+    {
+    case StreamFormat::Packets:
+        device.buffer.resize(device.socket ? kBatchSize * device.source.maxPacket : device.source.maxPacket);
+        break;
+    case StreamFormat::FixedReports:
+        device.buffer.resize(kBatchSize * std::max<size_t>(device.source.reportSize, 1));
+        break;
+    case StreamFormat::Evdev:
+        device.buffer.resize(kBatchSize * kEventSize);
+        break;
+    }
+
+    m_Order.push_back(handle);
+    return handle;
+}
+
+void LinuxInputBackend::RemoveDevice(DeviceHandle handle)
+{
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return;
+
+    ::epoll_ctl(m_Epoll, EPOLL_CTL_DEL, it->second.source.fd, nullptr);
+    ::close(it->second.source.fd);
+
+    m_Devices.erase(it);
+    m_Order.erase(std::find(m_Order.begin(), m_Order.end(), handle));
+}
+
+bool LinuxInputBackend::ReadDevice(DeviceHandle handle, Device& device)
+{
+    switch (device.source.format)
+    {
+    case StreamFormat::Packets:
+        return device.socket ? ReadSocketPackets(handle, device) : ReadPackets(handle, device);
+    case StreamFormat::FixedReports:
+    case StreamFormat::Evdev:
+        return ReadStream(handle, device);
+    }
+
+    return false;
+}
+
+bool LinuxInputBackend::ReadPackets(DeviceHandle handle, Device& device)
+{
+    // Level-triggered, so a device that keeps reporting is picked up again
+    // on the next round instead of starving the others.
+    for (size_t i = 0; i < kBatchSize; ++i)
+    {
+        const ssize_t result = ::read(device.source.fd, device.buffer.data(), device.buffer.size());
+        if (result > 0)
+        {
+            m_Listener->OnInput(handle, device.source.type, std::span<const uint8_t>(device.buffer.data(), static_cast<size_t>(result)));
+            continue;
+        }
+
+        return !IsReadError(result);
+    }
+
+    return true;
+}
+
+bool LinuxInputBackend::ReadSocketPackets(DeviceHandle handle, Device& device)
+{
+    const size_t maxPacket = device.source.maxPacket;
+
+    iovec   iov[kBatchSize];
+    mmsghdr messages[kBatchSize] = {};
+    for (size_t i = 0; i < kBatchSize; ++i)
+    {
+        iov[i].iov_base = device.buffer.data() + i * maxPacket;
+        iov[i].iov_len = maxPacket;
+        messages[i].msg_hdr.msg_iov = &iov[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int result = ::recvmmsg(device.source.fd, messages, kBatchSize, MSG_DONTWAIT, nullptr);
+    if (result <= 0)
+        return !IsReadError(result);
+
+    for (int i = 0; i < result; ++i)
+    {
+        // A zero-length message is how a closed seqpacket peer reads.
+        if (messages[i].msg_len == 0)
+            return false;
+
+        m_Listener->OnInput(handle, device.source.type, std::span<const uint8_t>(device.buffer.data() + i * maxPacket, messages[i].msg_len));
+    }
+
+    return true;
+}
+
+bool LinuxInputBackend::ReadStream(DeviceHandle handle, Device& device)
+{
+    for (size_t i = 0; i < kBatchSize; ++i)
+    {
+        // A frame longer than the buffer; keep it whole.
+        if (device.buffered == device.buffer.size())
+            device.buffer.resize(device.buffer.size() * 2);
+
+        const ssize_t result = ::read(device.source.fd, device.buffer.data() + device.buffered, device.buffer.size() - device.buffered);
+        if (result <= 0)
+            return !IsReadError(result);
+
+        const size_t size = device.buffered + static_cast<size_t>(result);
+        const size_t used = device.source.format == StreamFormat::Evdev
+            ? DeliverEvdevFrames(handle, device, size)
+            : DeliverFixedReports(handle, device, size);
+
+        // Carry the incomplete tail over to the next read.
+        device.buffered = size - used;
+        std::memmove(device.buffer.data(), device.buffer.data() + used, device.buffered);
+    }
+
+    return true;
+}
+
+size_t LinuxInputBackend::DeliverFixedReports(DeviceHandle handle, Device& device, size_t size)
+{
+    const size_t reportSize = device.source.reportSize;
+    if (!reportSize)
+        return size;
+
+    size_t offset = 0;
+    for (; offset + reportSize <= size; offset += reportSize)
+        m_Listener->OnInput(handle, device.source.type, std::span<const uint8_t>(device.buffer.data() + offset, reportSize));
+
+    return offset;
+}
+
+size_t LinuxInputBackend::DeliverEvdevFrames(DeviceHandle handle, Device& device, size_t size)
+{
+    // https://www.kernel.org/doc/html/latest/input/event-codes.html
+    // Events come in frames closed by SYN_REPORT. SYN_DROPPED means the
+    // kernel buffer overran: everything up to the next SYN_REPORT is
+    // discarded, as the frame it belongs to is incomplete.
+    size_t frameStart = 0;
+    for (size_t offset = 0; offset + kEventSize <= size; offset += kEventSize)
+    {
+        input_event event;
+        std::memcpy(&event, device.buffer.data() + offset, kEventSize);
+        if (event.type != EV_SYN)
+            continue;
+
+        if (event.code == SYN_DROPPED)
+        {
+            device.dropping = true;
+        }
+        else if (event.code == SYN_REPORT)
+        {
+            const size_t frameEnd = offset + kEventSize;
+            if (!device.dropping)
+                m_Listener->OnInput(handle, device.source.type, std::span<const uint8_t>(device.buffer.data() + frameStart, frameEnd - frameStart));
+
+            device.dropping = false;
+            frameStart = frameEnd;
+        }
+    }
+
+    return frameStart;
+}
+
+std::optional<LinuxInputBackend::HidrawSysfsInfo> LinuxInputBackend::ReadHidrawSysfs(const std::string& deviceDir)
+{
+    std::ifstream descriptor(deviceDir + "/report_descriptor", std::ios::binary);
+    if (!descriptor)
+        return std::nullopt;
+
+    HidrawSysfsInfo info;
+    info.reportDescriptor.assign(std::istreambuf_iterator<char>(descriptor), std::istreambuf_iterator<char>());
+
+    // KEY=value lines.
+    std::ifstream uevent(deviceDir + "/uevent");
+    std::string line;
+    while (std::getline(uevent, line))
+    {
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            continue;
+
+        const std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        if (key == "HID_ID")
+            ParseHidId(value, info);
+        else if (key == "HID_NAME")
+            info.name = std::move(value);
+        else if (key == "HID_UNIQ")
+            info.uniq = std::move(value);
+    }
+
+    return info;
+}
+
+std::optional<LinuxInputBackend::Source> LinuxInputBackend::OpenHidraw(const std::string& devNode, std::string sysfsDeviceDir)
+{
+    if (sysfsDeviceDir.empty())
+    {
+        const size_t slash = devNode.rfind('/');
+        sysfsDeviceDir = "/sys/class/hidraw/" + devNode.substr(slash == std::string::npos ? 0 : slash + 1) + "/device";
+    }
+
+    std::optional<HidrawSysfsInfo> info = ReadHidrawSysfs(sysfsDeviceDir);
+    if (!info)
+        return std::nullopt;
+
+    const int fd = ::open(devNode.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return std::nullopt;
+
+    Source source;
+    source.fd = fd;
+    source.format = StreamFormat::Packets;
+    source.type = DeviceType::Hid;
+    source.interfacePath = devNode;
+    source.reportDescriptor = std::move(info->reportDescriptor);
+    return source;
+}
+
+std::optional<LinuxInputBackend::Source> LinuxInputBackend::OpenEvdev(const std::string& devNode, DeviceType type)
+{
+    const int fd = ::open(devNode.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return std::nullopt;
+
+    Source source;
+    source.fd = fd;
+    source.format = StreamFormat::Evdev;
+    source.type = type;
+    source.interfacePath = devNode;
+    return source;
+}
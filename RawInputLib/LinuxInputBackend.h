@@ -0,0 +1,144 @@
+#pragma once
+
+#include "InputBackend.h"
+
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Linux: hidraw and evdev nodes, or anything else that carries their streams
+// (pipes, socketpairs), read on one epoll thread.
+//
+// The backend does not look for devices itself. Callers open them (see
+// OpenHidraw and OpenEvdev) and hand over the file descriptors with
+// AddSource; a source is removed when its descriptor reports end of file,
+// hangup or ENODEV. Packets are bare HID reports (with the Report ID byte if
+// the device uses them) for hidraw sources, and the struct input_event
+// records of one frame, up to and including its SYN_REPORT, for evdev ones;
+// InputPipeline decodes both.
+//
+// Each wakeup reads every ready descriptor, at most kBatchSize reads (one
+// recvmmsg for sockets) per descriptor, so a busy device cannot starve the
+// others; epoll is level-triggered and returns a descriptor with data left on
+// the next round. Each read takes as many reports as are queued where the
+// stream allows it:
+//   Packets      one report per read on character devices; up to
+//                kBatchSize per recvmmsg on datagram and seqpacket sockets
+//   FixedReports a byte stream of `reportSize` reports, kBatchSize per read
+//   Evdev        kBatchSize input events per read, split at SYN_REPORT
+//
+// Linux only; not part of the Windows project.
+class LinuxInputBackend : public InputBackend
+{
+public:
+    static constexpr size_t kBatchSize = 64;
+
+    enum class StreamFormat
+    {
+        Packets,
+        FixedReports,
+        Evdev,
+    };
+
+    struct Source
+    {
+        int          fd = -1; // owned, must be non-blocking
+        StreamFormat format = StreamFormat::Packets;
+        DeviceType   type = DeviceType::Hid;
+        std::string  interfacePath;
+
+        size_t reportSize = 0; // FixedReports: bytes per report
+        size_t maxPacket = 4096; // Packets: largest report
+
+        // From sysfs, see ReadHidrawSysfs(). Empty for evdev.
+        std::vector<uint8_t> reportDescriptor;
+    };
+
+    // What sysfs knows about a hidraw node's HID device.
+    struct HidrawSysfsInfo
+    {
+        uint16_t             bus = 0;
+        uint16_t             vendorId = 0;
+        uint16_t             productId = 0;
+        std::string          name;   // HID_NAME
+        std::string          uniq;   // HID_UNIQ, the serial number or Bluetooth address
+        std::vector<uint8_t> reportDescriptor;
+    };
+
+    LinuxInputBackend() = default;
+    ~LinuxInputBackend() override;
+
+    LinuxInputBackend(const LinuxInputBackend&) = delete;
+    void operator=(const LinuxInputBackend&) = delete;
+
+    void Start(Listener& listener) override;
+    void Stop() override;
+    void Post(std::function<void()> task) override;
+
+    void ScheduleWakeup(Clock::duration delay) override;
+    void CancelWakeup() override;
+
+    std::vector<DeviceHandle> EnumerateDevices() override;
+    std::optional<DeviceInfo> GetDeviceInfo(DeviceHandle handle) override;
+
+    // Adds a device. Sources added before Start() are present at start;
+    // later ones are announced as arrivals. Callable from any thread.
+    void AddSource(Source source);
+
+    // Backend thread only. Empty if unknown or not a hidraw source.
+    std::span<const uint8_t> GetReportDescriptor(DeviceHandle handle) const override;
+
+    // Reads `uevent` and `report_descriptor` from `deviceDir`, the HID device
+    // directory of a hidraw node (/sys/class/hidraw/hidrawN/device) or a dump
+    // of those two files. nullopt if `report_descriptor` cannot be read.
+    static std::optional<HidrawSysfsInfo> ReadHidrawSysfs(const std::string& deviceDir);
+
+    // Open `devNode` non-blocking. OpenHidraw reads the descriptor through
+    // `sysfsDeviceDir`, by default the node's own sysfs directory.
+    static std::optional<Source> OpenHidraw(const std::string& devNode, std::string sysfsDeviceDir = {});
+    static std::optional<Source> OpenEvdev(const std::string& devNode, DeviceType type);
+
+private:
+    struct Device
+    {
+        Source               source;
+        bool                 socket = false;
+        std::vector<uint8_t> buffer;
+        size_t               buffered = 0;     // FixedReports, Evdev: bytes carried over to the next read
+        bool                 dropping = false; // Evdev: after SYN_DROPPED, until the next SYN_REPORT
+    };
+
+    void ThreadRun(std::promise<void> readyPromise);
+    void RunPostedTasks();
+
+    DeviceHandle AddDevice(Source source);
+    void RemoveDevice(DeviceHandle handle);
+
+    // false once the source is gone.
+    bool ReadDevice(DeviceHandle handle, Device& device);
+    bool ReadPackets(DeviceHandle handle, Device& device);
+    bool ReadSocketPackets(DeviceHandle handle, Device& device);
+    bool ReadStream(DeviceHandle handle, Device& device);
+    size_t DeliverFixedReports(DeviceHandle handle, Device& device, size_t size);
+    size_t DeliverEvdevFrames(DeviceHandle handle, Device& device, size_t size);
+
+    Listener*   m_Listener = nullptr;
+    std::thread m_Thread;
+
+    int m_Epoll = -1;
+    int m_TaskEvent = -1; // eventfd, signalled by Post
+    int m_Timer = -1;     // timerfd for ScheduleWakeup
+
+    // Backend thread only.
+    std::unordered_map<DeviceHandle, Device> m_Devices;
+    std::vector<DeviceHandle>                m_Order; // m_Devices in arrival order
+    DeviceHandle                             m_NextHandle = 1;
+
+    std::mutex                        m_Mutex;
+    std::deque<std::function<void()>> m_Tasks;
+    std::vector<Source>               m_InitialSources; // added before Start()
+    bool                              m_Running = false;
+    bool                              m_Stopping = false;
+};
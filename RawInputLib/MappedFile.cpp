@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::optional<MappedFile> MappedFile::Open(const std::string& path)
+{
+    MappedFile file;
+
+#ifdef _WIN32
+    std::wstring widePath(path.size(), L'\0');
+    widePath.resize(::MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), widePath.data(), static_cast<int>(widePath.size())));
+
+    const HANDLE handle = ::CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return std::nullopt;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(handle, &size))
+    {
+        ::CloseHandle(handle);
+        return std::nullopt;
+    }
+
+    if (size.QuadPart == 0)
+    {
+        ::CloseHandle(handle);
+        return file;
+    }
+
+    // The view keeps the section alive; neither handle is needed after this.
+    const HANDLE mapping = ::CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(handle);
+    if (!mapping)
+        return std::nullopt;
+
+    const void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if (!view)
+        return std::nullopt;
+
+    file.m_Data = static_cast<const uint8_t*>(view);
+    file.m_Size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return std::nullopt;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    if (st.st_size == 0)
+    {
+        ::close(fd);
+        return file;
+    }
+
+    // The mapping keeps the file open.
+    void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return std::nullopt;
+
+    file.m_Data = static_cast<const uint8_t*>(view);
+    file.m_Size = static_cast<size_t>(st.st_size);
+#endif
+
+    return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_Data(std::exchange(other.m_Data, nullptr))
+    , m_Size(std::exchange(other.m_Size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_Data = std::exchange(other.m_Data, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+void MappedFile::Close()
+{
+    if (!m_Data)
+        return;
+
+#ifdef _WIN32
+    ::UnmapViewOfFile(m_Data);
+#else
+    ::munmap(const_cast<uint8_t*>(m_Data), m_Size);
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+void MappedFile::AdviseSequential() const
+{
+    if (!m_Data)
+        return;
+
+#ifdef _WIN32
+    // No madvise for views; the memory manager reads ahead on its own.
+#else
+    ::madvise(const_cast<uint8_t*>(m_Data), m_Size, MADV_SEQUENTIAL);
+#endif
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+// A whole file mapped read-only into memory. Pages are read in as they are
+// touched, so captures and stores larger than RAM can be walked front to
+// back. Move-only; the mapping goes away with the object.
+class MappedFile
+{
+public:
+    // nullopt if the file cannot be opened or mapped. An empty file maps to
+    // an empty span.
+    static std::optional<MappedFile> Open(const std::string& path);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    void operator=(const MappedFile&) = delete;
+
+    std::span<const uint8_t> GetData() const { return { m_Data, m_Size }; }
+    size_t GetSize() const { return m_Size; }
+
+    // Tells the OS the file will be read front to back, once.
+    void AdviseSequential() const;
+
+private:
+    MappedFile() = default;
+    void Close();
+
+    const uint8_t* m_Data = nullptr;
+    size_t         m_Size = 0;
+};
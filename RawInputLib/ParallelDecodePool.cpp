@@ -0,0 +1,193 @@
+#include "ParallelDecodePool.h"
+
+#include <algorithm>
+#include <cstring>
+
+ParallelDecodePool::ParallelDecodePool(size_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        const size_t hw = std::thread::hardware_concurrency();
+        workerCount = std::max<size_t>(1, hw > 1 ? hw - 1 : 1);
+    }
+
+    m_Workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+        m_Workers.push_back(std::make_unique<Worker>());
+
+    // Start threads only after every deque exists, since workers steal.
+    for (size_t i = 0; i < workerCount; ++i)
+        m_Workers[i]->thread = std::thread(&ParallelDecodePool::WorkerRun, this, i);
+}
+
+ParallelDecodePool::~ParallelDecodePool()
+{
+    {
+        std::lock_guard lock(m_WakeMutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_all();
+
+    for (auto& worker : m_Workers)
+        worker->thread.join();
+}
+
+ParallelDecodePool::DeviceId ParallelDecodePool::AddDevice(DecodeFn decode)
+{
+    auto device = std::make_shared<Device>();
+    device->decode = std::move(decode);
+    device->homeWorker = m_NextHome.fetch_add(1, std::memory_order_relaxed) % m_Workers.size();
+    return device;
+}
+
+void ParallelDecodePool::RemoveDevice(const DeviceId& device)
+{
+    if (!device)
+        return;
+
+    std::unique_lock lock(device->mutex);
+    device->removed = true;
+    device->pending.clear();
+    device->idle.wait(lock, [&] { return !device->scheduled; });
+}
+
+void ParallelDecodePool::Submit(const DeviceId& device, const void* data, size_t size)
+{
+    bool schedule = false;
+    {
+        std::lock_guard lock(device->mutex);
+        if (device->removed)
+            return;
+
+        const uint32_t size32 = static_cast<uint32_t>(size);
+        const size_t padded = (size + kFrameAlign - 1) & ~(kFrameAlign - 1);
+        const size_t offset = device->pending.size();
+        device->pending.resize(offset + kFrameHeader + padded);
+        std::memcpy(device->pending.data() + offset, &size32, sizeof(size32));
+        std::memcpy(device->pending.data() + offset + kFrameHeader, data, size);
+
+        if (!device->scheduled)
+        {
+            device->scheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule)
+        Schedule(device);
+}
+
+void ParallelDecodePool::Schedule(const DeviceId& device)
+{
+    {
+        std::lock_guard lock(m_WakeMutex);
+        ++m_QueuedTasks;
+        ++m_ActiveTasks;
+    }
+
+    Worker& home = *m_Workers[device->homeWorker];
+    {
+        std::lock_guard lock(home.mutex);
+        home.tasks.push_back(device);
+    }
+
+    m_Wake.notify_one();
+}
+
+void ParallelDecodePool::WaitIdle()
+{
+    std::unique_lock lock(m_WakeMutex);
+    m_Idle.wait(lock, [&] { return m_ActiveTasks == 0; });
+}
+
+// Own deque first (LIFO, warm caches), then steal the oldest task of the others.
+bool ParallelDecodePool::PopTask(size_t index, DeviceId& task)
+{
+    {
+        Worker& self = *m_Workers[index];
+        std::lock_guard lock(self.mutex);
+        if (!self.tasks.empty())
+        {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t k = 1; k < m_Workers.size(); ++k)
+    {
+        Worker& victim = *m_Workers[(index + k) % m_Workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ParallelDecodePool::WorkerRun(size_t index)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock lock(m_WakeMutex);
+            m_Wake.wait(lock, [&] { return m_Stop || m_QueuedTasks > 0; });
+            if (m_Stop)
+                return;
+        }
+
+        DeviceId task;
+        if (!PopTask(index, task))
+            continue; // another worker took it
+
+        {
+            std::lock_guard lock(m_WakeMutex);
+            --m_QueuedTasks;
+        }
+
+        RunDevice(*task);
+
+        bool idle = false;
+        {
+            std::lock_guard lock(m_WakeMutex);
+            idle = (--m_ActiveTasks == 0);
+        }
+        if (idle)
+            m_Idle.notify_all();
+    }
+}
+
+// Drains the device until its queue stays empty. Only this worker touches
+// `processing` while `scheduled` is set.
+void ParallelDecodePool::RunDevice(Device& device)
+{
+    for (;;)
+    {
+        {
+            std::lock_guard lock(device.mutex);
+            if (device.removed || device.pending.empty())
+            {
+                device.scheduled = false;
+                device.idle.notify_all();
+                return;
+            }
+            device.processing.clear();
+            device.processing.swap(device.pending);
+        }
+
+        const uint8_t* p = device.processing.data();
+        const uint8_t* end = p + device.processing.size();
+        while (p < end)
+        {
+            uint32_t size = 0;
+            std::memcpy(&size, p, sizeof(size));
+            p += kFrameHeader;
+            device.decode(p, size);
+            p += (size + kFrameAlign - 1) & ~(kFrameAlign - 1);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Decodes input reports of many devices on a pool of worker threads.
+//
+// The receiving thread only copies each report into its device's queue
+// (Submit). A device with queued reports is scheduled as one task on a
+// worker; idle workers steal tasks from busy ones. A device is processed by
+// at most one worker at a time, so its reports are decoded in arrival order.
+//
+// Queues are double-buffered byte vectors that keep their capacity, so after
+// warm-up neither side allocates per report. Report copies are 8-byte aligned,
+// so structures such as RAWINPUT can be read in place.
+//
+// The pool is platform-independent; the decode callback decides what a
+// report is.
+class ParallelDecodePool
+{
+public:
+    // Called on a worker thread with one report; never concurrently for the
+    // same device.
+    using DecodeFn = std::function<void(const uint8_t* data, size_t size)>;
+
+    struct Device;
+    using DeviceId = std::shared_ptr<Device>;
+
+    // workerCount == 0 picks one less than the number of hardware threads.
+    explicit ParallelDecodePool(size_t workerCount = 0);
+    ~ParallelDecodePool();
+
+    ParallelDecodePool(const ParallelDecodePool&) = delete;
+    void operator=(const ParallelDecodePool&) = delete;
+
+    DeviceId AddDevice(DecodeFn decode);
+
+    // Drops queued reports and waits for an in-flight decode to finish.
+    // The callback is not called again afterwards.
+    void RemoveDevice(const DeviceId& device);
+
+    // Copies the report and schedules the device if it is idle.
+    void Submit(const DeviceId& device, const void* data, size_t size);
+
+    // Blocks until every submitted report has been decoded.
+    void WaitIdle();
+
+    size_t GetWorkerCount() const { return m_Workers.size(); }
+
+    struct Device
+    {
+        DecodeFn decode;
+        size_t   homeWorker = 0;
+
+        std::mutex            mutex;
+        std::condition_variable idle;
+        std::vector<uint8_t>  pending;    // frames appended by Submit, see kFrameHeader
+        std::vector<uint8_t>  processing; // swapped with pending by the worker
+        bool                  scheduled = false;
+        bool                  removed = false;
+    };
+
+private:
+    // Frame: uint32_t size, padding to kFrameHeader, payload padded to kFrameAlign.
+    static constexpr size_t kFrameAlign = 8;
+    static constexpr size_t kFrameHeader = 8;
+
+    struct Worker
+    {
+        std::mutex           mutex;
+        std::deque<DeviceId> tasks; // owner pops back, thieves pop front
+        std::thread          thread;
+    };
+
+    void WorkerRun(size_t index);
+    bool PopTask(size_t index, DeviceId& task);
+    void Schedule(const DeviceId& device);
+    void RunDevice(Device& device);
+
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+    std::atomic<size_t> m_NextHome{ 0 };
+
+    // Workers sleep here when no deque has work.
+    std::mutex              m_WakeMutex;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Idle;
+    size_t                  m_QueuedTasks = 0;  // tasks sitting in deques
+    size_t                  m_ActiveTasks = 0;  // tasks queued or running
+    bool                    m_Stop = false;
+};
@@ -22,27 +22,95 @@ RawInputDevice::~RawInputDevice() = default;
 
 bool RawInputDevice::Initialize()
 {
+    // The remaining facets are resolved by their getters.
     if (!QueryRawInputDeviceInfo())  return false;
 
-	TryQueryDeviceNodeInfo();
-    TryQueryUsbInfo();
-    TryQueryXboxInfo();
-    TryQueryBluetoothLEInfo();
-
-    ResolveIdentity();
+    const DevicePathInfo& pathInfo = GetInterfacePathInfo();
+    MixFingerprint(GetType());
+    MixFingerprint(simd::HashNoCase(pathInfo.bus.data(), pathInfo.bus.size()));
+    MixFingerprint(simd::HashNoCase(pathInfo.deviceId.data(), pathInfo.deviceId.size()));
+    MixFingerprint(simd::HashNoCase(pathInfo.instance.data(), pathInfo.instance.size()));
 
     return true;
 }
 
+void RawInputDevice::MixFingerprint(uint64_t value)
+{
+    uint64_t h = m_Fingerprint ? m_Fingerprint : 0xCBF29CE484222325ull;
+    h ^= value;
+    h *= 0x9E3779B97F4A7C15ull;
+    h ^= h >> 32;
+    m_Fingerprint = h;
+}
+
+std::unique_ptr<RawInputDevice::SavedState> RawInputDevice::SaveState() const
+{
+    auto state = std::make_unique<SavedState>();
+    state->userSlot = m_UserSlot;
+    return state;
+}
+
+void RawInputDevice::RestoreState(const SavedState& state)
+{
+    m_UserSlot = state.userSlot;
+}
+
+// ---------------------------------------------------------------------------
+// Lazily resolved facets
+// ---------------------------------------------------------------------------
+
+// Devices are never created const, so the TryQuery* calls below may write
+// through `this`; the once flags make sure only one thread does.
+
+const RawInputDevice::DeviceIdentity& RawInputDevice::GetIdentity() const
+{
+    std::call_once(m_IdentityOnce, [this] { const_cast<RawInputDevice*>(this)->ResolveIdentity(); });
+    return m_Identity;
+}
+
+const RawInputDevice::DeviceNodeInfo* RawInputDevice::GetDevNode() const
+{
+    std::call_once(m_DevNodeOnce, [this] { const_cast<RawInputDevice*>(this)->TryQueryDeviceNodeInfo(); });
+    return m_DevNode ? &*m_DevNode : nullptr;
+}
+
+const UsbDeviceInfo* RawInputDevice::GetUsbInfo() const
+{
+    std::call_once(m_UsbInfoOnce, [this] { const_cast<RawInputDevice*>(this)->TryQueryUsbInfo(); });
+    return m_UsbInfo ? &*m_UsbInfo : nullptr;
+}
+
+const RawInputDevice::HidDeviceInfo* RawInputDevice::GetHidInfo() const
+{
+    std::call_once(m_HidInfoOnce, [this] { const_cast<RawInputDevice*>(this)->TryQueryHidInfo(); });
+    return m_HidInfo ? &*m_HidInfo : nullptr;
+}
+
+const RawInputDevice::XboxInfo* RawInputDevice::GetXboxInfo() const
+{
+    std::call_once(m_XboxInfoOnce, [this] { const_cast<RawInputDevice*>(this)->TryQueryXboxInfo(); });
+    return m_XboxInfo ? &*m_XboxInfo : nullptr;
+}
+
+const RawInputDevice::BluetoothLEInfo* RawInputDevice::GetBleInfo() const
+{
+    std::call_once(m_BleInfoOnce, [this] { const_cast<RawInputDevice*>(this)->TryQueryBluetoothLEInfo(); });
+    return m_BleInfo ? &*m_BleInfo : nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// TryQuery*
+// ---------------------------------------------------------------------------
+
 bool RawInputDevice::QueryRawInputDeviceInfo()
 {
     DCHECK(IsValidHandle(m_Handle));
 
-    m_InterfacePath = QueryRawDeviceInterfacePath(m_Handle);
-    if (m_InterfacePath.empty())
+    m_InterfacePath = DevicePath::Intern(QueryRawDeviceInterfacePath(m_Handle));
+    if (m_InterfacePath.IsEmpty())
         return false;
 
-    ScopedHandle interfaceHandle = OpenDeviceInterface(m_InterfacePath);
+    ScopedHandle interfaceHandle = OpenDeviceInterface(GetInterfacePath());
     if (!IsValidHandle(interfaceHandle.get()))
     {
         /* System devices, such as keyboards and mice, cannot be opened in
@@ -50,7 +118,7 @@ bool RawInputDevice::QueryRawInputDeviceInfo()
         them.  This is to prevent keyloggers.  However, feature reports
         can still be sent and received.  Retry opening the device, but
         without read/write access. */
-        interfaceHandle = OpenDeviceInterface(m_InterfacePath, true);
+        interfaceHandle = OpenDeviceInterface(GetInterfacePath(), true);
         if (IsValidHandle(interfaceHandle.get()))
             m_IsInterfaceReadOnly = true;
     }
@@ -60,26 +128,28 @@ bool RawInputDevice::QueryRawInputDeviceInfo()
 
 void RawInputDevice::TryQueryDeviceNodeInfo()
 {
-    DCHECK(!m_InterfacePath.empty());
+    DCHECK(!m_InterfacePath.IsEmpty());
+    if (!m_LazyTree || !m_LazyTree->Get())
+        return;
 
-    std::string instanceId = GetDeviceFromInterface(m_InterfacePath);
-    if (instanceId.empty())
+    m_DeviceTree = m_LazyTree->Get();
+    const DeviceTree& tree = *m_DeviceTree;
+    const DeviceTree::NodeId node = tree.FindNode(GetDeviceFromInterface(GetInterfacePath()));
+    if (node == DeviceTree::kNoNode)
         return;
 
-    auto info = DeviceNodeInfo{ instanceId };
+    m_TreeNode = node;
+    auto info = DeviceNodeInfo{ CopyString(tree.GetInstanceId(node)) };
 
     // TODO implement fHasSpecificHardwareMatch from DirectInput code?
 
-    DEVINST node = OpenDevNode(instanceId);
-
-    info.manufacturer = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_Device_Manufacturer, DEVPROP_TYPE_STRING));
-    info.displayName = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_NAME, DEVPROP_TYPE_STRING));
-    info.service = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_Device_Service, DEVPROP_TYPE_STRING));
-    info.deviceClass = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_Device_Class, DEVPROP_TYPE_STRING));
-    info.stack = PropertyDataCast<std::vector<std::string>>(GetDevNodeProperty(node, &DEVPKEY_Device_Stack, DEVPROP_TYPE_STRING_LIST));
-    // TODO extract VID/PID/COL from hardwareId?
-    info.hardwareIds = PropertyDataCast<std::vector<std::string>>(GetDevNodeProperty(node, &DEVPKEY_Device_HardwareIds, DEVPROP_TYPE_STRING_LIST));
-    info.busTypeGuid = PropertyDataCast<GUID>(GetDevNodeProperty(node, &DEVPKEY_Device_BusTypeGuid, DEVPROP_TYPE_GUID));
+    info.manufacturer = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_Device_Manufacturer, DEVPROP_TYPE_STRING)));
+    info.displayName = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_NAME, DEVPROP_TYPE_STRING)));
+    info.service = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_Device_Service, DEVPROP_TYPE_STRING)));
+    info.deviceClass = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_Device_Class, DEVPROP_TYPE_STRING)));
+    info.stack = CopyStringList(PropertyDataCast<std::vector<std::string>>(GetDevNodeProperty(tree, node, &DEVPKEY_Device_Stack, DEVPROP_TYPE_STRING_LIST)));
+    info.hardwareIds = CopyStringList(PropertyDataCast<std::vector<std::string>>(GetDevNodeProperty(tree, node, &DEVPKEY_Device_HardwareIds, DEVPROP_TYPE_STRING_LIST)));
+    info.busTypeGuid = PropertyDataCast<GUID>(GetDevNodeProperty(tree, node, &DEVPKEY_Device_BusTypeGuid, DEVPROP_TYPE_GUID));
 
     if (!info.instanceId.empty())
         m_DevNode = std::move(info);
@@ -87,19 +157,22 @@ void RawInputDevice::TryQueryDeviceNodeInfo()
 
 void RawInputDevice::TryQueryUsbInfo()
 {
-    if (!m_DevNode)
+    if (!GetDevNode())
         return;
 
-    std::string usbInterfacePath = SearchParentDeviceInterface(m_DevNode->instanceId, &GUID_DEVINTERFACE_USB_DEVICE);
+    std::string_view usbInterfacePath = SearchParentDeviceInterface(*m_DeviceTree, m_TreeNode, &GUID_DEVINTERFACE_USB_DEVICE);
     if (!usbInterfacePath.empty())
     {
-        m_UsbInfo = UsbDeviceInfo(GetDeviceFromInterface(m_InterfacePath));
+        // Copies into the arena as it goes. Other facets of this device wait
+        // for the descriptor requests to finish before they can copy theirs.
+        std::lock_guard lock(m_MetadataMutex);
+        m_UsbInfo.emplace(*m_DeviceTree, m_TreeNode, m_Metadata);
 	}
 }
 
 void RawInputDevice::TryQueryXboxInfo()
 {
-    if (!m_DevNode)
+    if (!GetDevNode())
         return;
 
     XboxInfo info;
@@ -110,10 +183,10 @@ void RawInputDevice::TryQueryXboxInfo()
     static constexpr GUID XUSB_INTERFACE_CLASS_GUID =
     { 0xEC87F1E3, 0xC13B, 0x4100, { 0xB5, 0xF7, 0x8B, 0x84, 0xD5, 0x42, 0x60, 0xCB } };
 
-    std::string xInputInterfacePath = SearchParentDeviceInterface(m_DevNode->instanceId, &XUSB_INTERFACE_CLASS_GUID);
+    std::string_view xInputInterfacePath = SearchParentDeviceInterface(*m_DeviceTree, m_TreeNode, &XUSB_INTERFACE_CLASS_GUID);
     if (!xInputInterfacePath.empty())
     {
-        info.xInputInterfacePath = xInputInterfacePath;
+        info.xInputInterfacePath = CopyString(xInputInterfacePath);
 
         ScopedHandle h = OpenDeviceInterface(xInputInterfacePath);
         if (IsValidHandle(h.get()))
@@ -155,15 +228,15 @@ void RawInputDevice::TryQueryXboxInfo()
     static constexpr GUID GUID_DEVINTERFACE_DC1_CONTROLLER =
     { 0x020BC73C, 0x0DCA, 0x4EE3, { 0x96, 0xD5, 0xAB, 0x00, 0x6A, 0xDA, 0x59, 0x38 } };
 
-    std::string gipInterfacePath = SearchParentDeviceInterface(m_DevNode->instanceId, &GUID_DEVINTERFACE_DC1_CONTROLLER);
+    std::string_view gipInterfacePath = SearchParentDeviceInterface(*m_DeviceTree, m_TreeNode, &GUID_DEVINTERFACE_DC1_CONTROLLER);
     if (!gipInterfacePath.empty())
     {
-        info.gipInterfacePath = gipInterfacePath;
+        info.gipInterfacePath = CopyString(gipInterfacePath);
 
 		// Fixup serial number for Xbox One GIP controllers.
-        if ((IsUsbDevice() && m_UsbInfo->m_VendorId == 0x045E && m_UsbInfo->m_ProductId == 0x02FF))
+        if ((IsUsbDevice() && GetUsbInfo()->m_VendorId == 0x045E && GetUsbInfo()->m_ProductId == 0x02FF))
         {
-            const std::string& serial = m_UsbInfo->m_SerialNumber;
+            const std::string_view serial = GetUsbInfo()->m_SerialNumber;
 
             if (serial.size() <= 12)
             {
@@ -171,10 +244,11 @@ void RawInputDevice::TryQueryXboxInfo()
             }
             else
             {
-                info.gipSerial.clear();
+                std::string gipSerial;
                 for (size_t i = 0; i < serial.size(); ++i)
                     if (i % 2 != 0)
-                        info.gipSerial.push_back(serial[i]);
+                        gipSerial.push_back(serial[i]);
+                info.gipSerial = CopyString(gipSerial);
             }
         }
     }
@@ -185,20 +259,20 @@ void RawInputDevice::TryQueryXboxInfo()
 
 void RawInputDevice::TryQueryBluetoothLEInfo()
 {
-    if (!m_DevNode)
+    if (!GetDevNode())
         return;
 
     // {6e3bb679-4372-40c8-9eaa-4509df260cd8}
     static constexpr GUID GUID_BLUETOOTH_GATT_SERVICE_DEVICE_INTERFACE =
     { 0x6e3bb679, 0x4372, 0x40c8, { 0x9e, 0xaa, 0x45, 0x09, 0xdf, 0x26, 0x0c, 0xd8 } };
 
-    std::string bleInterfacePath = SearchParentDeviceInterface(m_DevNode->instanceId, &GUID_BLUETOOTH_GATT_SERVICE_DEVICE_INTERFACE);
+    const DeviceTree& tree = *m_DeviceTree;
+    DeviceTree::NodeId node = DeviceTree::kNoNode;
+    std::string_view bleInterfacePath = SearchParentDeviceInterface(tree, m_TreeNode, &GUID_BLUETOOTH_GATT_SERVICE_DEVICE_INTERFACE, &node);
     if (bleInterfacePath.empty())
         return;
 
-    auto info = BluetoothLEInfo{ bleInterfacePath };
-
-    const DEVINST node = OpenDevNode(GetDeviceFromInterface(bleInterfacePath));
+    auto info = BluetoothLEInfo{ CopyString(bleInterfacePath) };
 
     static constexpr DEVPROPKEY DEVPKEY_Bluetooth_DeviceAddress = { { 0x2BD67D8B, 0x8BEB, 0x48D5, { 0x87, 0xE0, 0x6C, 0xDA, 0x34, 0x28, 0x04, 0x0A } }, 1 };
     static constexpr DEVPROPKEY DEVPKEY_Bluetooth_DeviceManufacturer = { { 0x2BD67D8B, 0x8BEB, 0x48D5, { 0x87, 0xE0, 0x6C, 0xDA, 0x34, 0x28, 0x04, 0x0A } }, 4 };
@@ -207,34 +281,49 @@ void RawInputDevice::TryQueryBluetoothLEInfo()
     static constexpr DEVPROPKEY DEVPKEY_Bluetooth_DevicePID = { { 0x2BD67D8B, 0x8BEB, 0x48D5, { 0x87, 0xE0, 0x6C, 0xDA, 0x34, 0x28, 0x04, 0x0A } }, 8 };
     static constexpr DEVPROPKEY DEVPKEY_Bluetooth_DeviceProductVersion = { { 0x2BD67D8B, 0x8BEB, 0x48D5, { 0x87, 0xE0, 0x6C, 0xDA, 0x34, 0x28, 0x04, 0x0A } }, 9 };
 
-    info.manufacturer = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_Bluetooth_DeviceManufacturer, DEVPROP_TYPE_STRING));
-    info.modelNumber = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_Bluetooth_DeviceModelNumber, DEVPROP_TYPE_STRING));
-    info.address = PropertyDataCast<std::string>(GetDevNodeProperty(node, &DEVPKEY_Bluetooth_DeviceAddress, DEVPROP_TYPE_STRING));
-    info.vendorId = PropertyDataCast<uint16_t>(GetDevNodeProperty(node, &DEVPKEY_Bluetooth_DeviceVID, DEVPROP_TYPE_UINT16));
-    info.productId = PropertyDataCast<uint16_t>(GetDevNodeProperty(node, &DEVPKEY_Bluetooth_DevicePID, DEVPROP_TYPE_UINT16));
-    info.versionNumber = PropertyDataCast<uint16_t>(GetDevNodeProperty(node, &DEVPKEY_Bluetooth_DeviceProductVersion, DEVPROP_TYPE_UINT16));
+    info.manufacturer = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_Bluetooth_DeviceManufacturer, DEVPROP_TYPE_STRING)));
+    info.modelNumber = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_Bluetooth_DeviceModelNumber, DEVPROP_TYPE_STRING)));
+    info.address = CopyString(PropertyDataCast<std::string>(GetDevNodeProperty(tree, node, &DEVPKEY_Bluetooth_DeviceAddress, DEVPROP_TYPE_STRING)));
+    info.vendorId = PropertyDataCast<uint16_t>(GetDevNodeProperty(tree, node, &DEVPKEY_Bluetooth_DeviceVID, DEVPROP_TYPE_UINT16));
+    info.productId = PropertyDataCast<uint16_t>(GetDevNodeProperty(tree, node, &DEVPKEY_Bluetooth_DevicePID, DEVPROP_TYPE_UINT16));
+    info.versionNumber = PropertyDataCast<uint16_t>(GetDevNodeProperty(tree, node, &DEVPKEY_Bluetooth_DeviceProductVersion, DEVPROP_TYPE_UINT16));
 
     if (!info.interfacePath.empty())
         m_BleInfo = std::move(info);
 }
 
-void RawInputDevice::ResolveIdentity()
+void RawInputDevice::TryQueryHidInfo()
 {
-    if (!m_DevNode)
+    if (!GetDevNode())
         return;
 
     GUID hid_guid;
     ::HidD_GetHidGuid(&hid_guid);
 
-	std::string hidInterfacePath = SearchParentDeviceInterface(m_DevNode->instanceId, &hid_guid);
+	std::string_view hidInterfacePath = SearchParentDeviceInterface(*m_DeviceTree, m_TreeNode, &hid_guid);
     if (!hidInterfacePath.empty())
     {
-		m_HidInfo = HidDeviceInfo { hidInterfacePath };
+		m_HidInfo = HidDeviceInfo { CopyString(hidInterfacePath) };
     }
+}
+
+void RawInputDevice::ResolveIdentity()
+{
+    // IDs encoded in the interface path; overridden below by what the device reports.
+    const DevicePathInfo& pathInfo = GetInterfacePathInfo();
+    m_Identity.vendorId = pathInfo.vendorId.value_or(0);
+    m_Identity.productId = pathInfo.productId.value_or(0);
+    m_Identity.versionNumber = pathInfo.revision.value_or(0);
 
-    DCHECK(m_HidInfo);
+    if (!GetDevNode())
+        return;
 
-    ScopedHandle hidHandle = OpenDeviceInterface(m_HidInfo->hidInterfacePath, m_IsInterfaceReadOnly);
+    const HidDeviceInfo* hidInfo = GetHidInfo();
+    DCHECK(hidInfo);
+    if (!hidInfo)
+        return;
+
+    ScopedHandle hidHandle = OpenDeviceInterface(hidInfo->hidInterfacePath, m_IsInterfaceReadOnly);
     if (!IsValidHandle(hidHandle.get()))
         return;
 
@@ -242,13 +331,13 @@ void RawInputDevice::ResolveIdentity()
     buffer.resize(128);
 
     if (::HidD_GetManufacturerString(hidHandle.get(), buffer.data(), static_cast<ULONG>(buffer.size())))
-        m_Identity.manufacturer = utf8::narrow(buffer);
+        m_Identity.manufacturer = CopyString(utf8::narrow(buffer));
 
     if (::HidD_GetProductString(hidHandle.get(), buffer.data(), static_cast<ULONG>(buffer.size())))
-        m_Identity.product = utf8::narrow(buffer);
+        m_Identity.product = CopyString(utf8::narrow(buffer));
 
     if (::HidD_GetSerialNumberString(hidHandle.get(), buffer.data(), static_cast<ULONG>(buffer.size())))
-        m_Identity.serial = utf8::narrow(buffer);
+        m_Identity.serial = CopyString(utf8::narrow(buffer));
 
     HIDD_ATTRIBUTES attrib { sizeof(HIDD_ATTRIBUTES) };
     if (::HidD_GetAttributes(hidHandle.get(), &attrib))
@@ -258,46 +347,56 @@ void RawInputDevice::ResolveIdentity()
         m_Identity.versionNumber = attrib.VersionNumber;
     }
 
-    if (m_UsbInfo)
+    if (const UsbDeviceInfo* usbInfo = GetUsbInfo())
     {
-        m_Identity.vendorId = m_UsbInfo->m_VendorId;
-        m_Identity.productId = m_UsbInfo->m_ProductId;
-        m_Identity.versionNumber = m_UsbInfo->m_VersionNumber;
-        m_Identity.manufacturer = m_UsbInfo->m_Manufacturer;
-        m_Identity.product = m_UsbInfo->m_Product;
-        m_Identity.serial = m_UsbInfo->m_SerialNumber;
+        m_Identity.vendorId = usbInfo->m_VendorId;
+        m_Identity.productId = usbInfo->m_ProductId;
+        m_Identity.versionNumber = usbInfo->m_VersionNumber;
+        m_Identity.manufacturer = usbInfo->m_Manufacturer;
+        m_Identity.product = usbInfo->m_Product;
+        m_Identity.serial = usbInfo->m_SerialNumber;
     }
 
-    if (m_BleInfo)
+    if (const BluetoothLEInfo* bleInfo = GetBleInfo())
     {
-        if (!m_BleInfo->manufacturer.empty())
-            m_Identity.manufacturer = m_BleInfo->manufacturer;
-        if (!m_BleInfo->modelNumber.empty())
-            m_Identity.product = m_BleInfo->modelNumber;
-        if (!m_BleInfo->address.empty())
-            m_Identity.serial = m_BleInfo->address;
-        if (m_BleInfo->vendorId)
-            m_Identity.vendorId = m_BleInfo->vendorId;
-        if (m_BleInfo->productId)
-            m_Identity.productId = m_BleInfo->productId;
-        if (m_BleInfo->versionNumber)
-            m_Identity.versionNumber = m_BleInfo->versionNumber;
+        if (!bleInfo->manufacturer.empty())
+            m_Identity.manufacturer = bleInfo->manufacturer;
+        if (!bleInfo->modelNumber.empty())
+            m_Identity.product = bleInfo->modelNumber;
+        if (!bleInfo->address.empty())
+            m_Identity.serial = bleInfo->address;
+        if (bleInfo->vendorId)
+            m_Identity.vendorId = bleInfo->vendorId;
+        if (bleInfo->productId)
+            m_Identity.productId = bleInfo->productId;
+        if (bleInfo->versionNumber)
+            m_Identity.versionNumber = bleInfo->versionNumber;
     }
 
-    if (m_XboxInfo && !m_XboxInfo->gipInterfacePath.empty())
+    if (const XboxInfo* xboxInfo = GetXboxInfo(); xboxInfo && !xboxInfo->gipInterfacePath.empty())
     {
-        m_Identity.serial = m_XboxInfo->gipSerial;
+        m_Identity.serial = xboxInfo->gipSerial;
     }
 
     // fallback
     if (m_Identity.product.empty())
     {
-        m_Identity.product = std::format("Unknown Device (VID:{:04X} PID:{:04X})",
+        m_Identity.product = CopyString(std::format("Unknown Device (VID:{:04X} PID:{:04X})",
             m_Identity.vendorId,
-            m_Identity.productId);
+            m_Identity.productId));
     }
 }
 
+std::span<const std::string_view> RawInputDevice::CopyStringList(const std::vector<std::string>& list)
+{
+    std::lock_guard lock(m_MetadataMutex);
+
+    const std::span<std::string_view> views = m_Metadata.Allocate<std::string_view>(list.size());
+    for (size_t i = 0; i < list.size(); ++i)
+        views[i] = m_Metadata.CopyString(list[i]);
+    return views;
+}
+
 bool RawInputDevice::QueryRawDeviceInfo(HANDLE handle, RID_DEVICE_INFO* deviceInfo)
 {
     UINT size = sizeof(RID_DEVICE_INFO);
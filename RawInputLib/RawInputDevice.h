@@ -1,14 +1,22 @@
 #pragma once
 
 #include "utils.h"
+#include "utils_arena.h"
+
+#include "DevicePath.h"
+#include "DeviceTree.h"
 
 #include "RawInputDeviceFactory.h"
 
 #include "UsbDevice.h"
 
+#include <atomic>
+#include <mutex>
+
 class RawInputDevice
 {
     friend class RawInputDeviceManager;
+    friend class Win32InputBackend;
 
 public:
     virtual ~RawInputDevice() = 0;
@@ -19,29 +27,56 @@ public:
     virtual uint32_t GetType() const = 0;
 
     // Device Interface Path. Example: `\\?\HID#VID_203A&PID_FFFC&MI_01#7&2de99099&0&0000#{378de44c-56ef-11d1-bc8c-00a0c91405dd}`
-    std::string GetInterfacePath() const { return m_InterfacePath; }
-
-    const std::string& GetManufacturerString() const { return m_Identity.manufacturer; }
-    const std::string& GetProductString()      const { return m_Identity.product; }
-    const std::string& GetSerialNumberString() const { return m_Identity.serial; }
-    uint16_t GetVendorId()      const { return m_Identity.vendorId; }
-    uint16_t GetProductId()     const { return m_Identity.productId; }
-    uint16_t GetVersionNumber() const { return m_Identity.versionNumber; }
-
-    bool IsXInputDevice()     const { return m_XboxInfo && !m_XboxInfo->xInputInterfacePath.empty(); }
-    uint8_t GetXInputUserIndex() const { return m_XboxInfo ? m_XboxInfo->xInputUserIndex : 0xff; }
-    bool IsXboxGipDevice()    const { return m_XboxInfo && !m_XboxInfo->gipInterfacePath.empty(); }
-    bool IsBluetoothLEDevice() const { return m_BleInfo.has_value(); }
-
-    bool IsUsbDevice() const { return m_UsbInfo && !m_UsbInfo->m_DeviceInterfacePath.empty(); }
-
-    std::string GetUsbInterfacePath() const { return m_UsbInfo->m_DeviceInterfacePath; }
-
-    bool IsHidDevice() const { return m_HidInfo && !m_HidInfo->hidInterfacePath.empty(); }
-    std::string GetHidInterfacePath() const { return m_HidInfo->hidInterfacePath; }
-
-    const std::vector<uint8_t>& GetUsbConfigurationDescriptor() const { return m_UsbInfo->m_ConfigurationDescriptor; }
-    const std::vector<uint8_t>& GetUsbHidReportDescriptor() const { return m_UsbInfo->m_HidReportDescriptor; }
+    //
+    // Strings returned by the device live in its metadata arena: they stay
+    // valid as long as the device and are NUL-terminated.
+    std::string_view GetInterfacePath() const { return m_InterfacePath.GetString(); }
+
+    // Bus, VID/PID, MI, COL, instance and interface class of the path.
+    const DevicePathInfo& GetInterfacePathInfo() const { return m_InterfacePath.GetInfo(); }
+
+    // Everything below the interface path is resolved on first access and
+    // then cached: connecting a device does not touch its strings or
+    // descriptors. Any getter may be called from any thread; the first call
+    // for a facet does the device I/O, concurrent callers wait for it.
+    std::string_view GetManufacturerString() const { return GetIdentity().manufacturer; }
+    std::string_view GetProductString()      const { return GetIdentity().product; }
+    std::string_view GetSerialNumberString() const { return GetIdentity().serial; }
+    uint16_t GetVendorId()      const { return GetIdentity().vendorId; }
+    uint16_t GetProductId()     const { return GetIdentity().productId; }
+    uint16_t GetVersionNumber() const { return GetIdentity().versionNumber; }
+
+    bool IsXInputDevice()     const { return GetXboxInfo() && !GetXboxInfo()->xInputInterfacePath.empty(); }
+    uint8_t GetXInputUserIndex() const { return GetXboxInfo() ? GetXboxInfo()->xInputUserIndex : 0xff; }
+    bool IsXboxGipDevice()    const { return GetXboxInfo() && !GetXboxInfo()->gipInterfacePath.empty(); }
+    bool IsBluetoothLEDevice() const { return GetBleInfo() != nullptr; }
+
+    bool IsUsbDevice() const { return GetUsbInfo() && !GetUsbInfo()->m_DeviceInterfacePath.empty(); }
+
+    std::string_view GetUsbInterfacePath() const { return GetUsbInfo()->m_DeviceInterfacePath; }
+
+    bool IsHidDevice() const { return GetHidInfo() && !GetHidInfo()->hidInterfacePath.empty(); }
+    std::string_view GetHidInterfacePath() const { return GetHidInfo()->hidInterfacePath; }
+
+    std::span<const uint8_t> GetUsbConfigurationDescriptor() const { return GetUsbInfo()->m_ConfigurationDescriptor; }
+    std::span<const uint8_t> GetUsbHidReportDescriptor() const { return GetUsbInfo()->m_HidReportDescriptor; }
+
+    // Identifies the physical device across reconnects, when it comes back
+    // with a new handle: a hash of the device type, the bus, device and
+    // instance IDs of the interface path and, for HID, the report descriptor
+    // model. PnP derives the instance ID from the serial number or Bluetooth
+    // address where the device has one. Computed at connect without device I/O.
+    uint64_t GetFingerprint() const { return m_Fingerprint; }
+
+    // Slot the consumer assigned to the device (player index, ...), kept
+    // when it reconnects.
+    static constexpr uint32_t kNoUserSlot = UINT32_MAX;
+    void     SetUserSlot(uint32_t slot) { m_UserSlot = slot; }
+    uint32_t GetUserSlot() const { return m_UserSlot; }
+
+    // Memory held by the device's metadata (strings, ID lists, descriptors).
+    size_t GetMetadataBytes()      const { std::lock_guard lock(m_MetadataMutex); return m_Metadata.GetReservedBytes(); }
+    size_t GetMetadataBlockCount() const { std::lock_guard lock(m_MetadataMutex); return m_Metadata.GetBlockCount(); }
 
 protected:
     RawInputDevice(HANDLE handle);
@@ -56,9 +91,29 @@ protected:
     void TryQueryUsbInfo();
     void TryQueryXboxInfo();
     void TryQueryBluetoothLEInfo();
+    void TryQueryHidInfo();
 
     void ResolveIdentity();
 
+    // What a device hands over to the device replacing it after a reconnect:
+    // consumer settings and whatever is expensive to rebuild. Subclasses
+    // extend it with their own state.
+    struct SavedState
+    {
+        virtual ~SavedState() = default;
+
+        uint32_t userSlot = kNoUserSlot;
+    };
+
+    virtual std::unique_ptr<SavedState> SaveState() const;
+    // Called right after Initialize() on a device with the same fingerprint.
+    virtual void RestoreState(const SavedState& state);
+
+    void MixFingerprint(uint64_t value);
+
+    std::string_view CopyString(std::string_view s) { std::lock_guard lock(m_MetadataMutex); return m_Metadata.CopyString(s); }
+    std::span<const std::string_view> CopyStringList(const std::vector<std::string>& list);
+
     // (RIDI_DEVICEINFO). nullptr on failure.
     static bool QueryRawDeviceInfo(HANDLE handle, RID_DEVICE_INFO* deviceInfo);
 	static std::string QueryRawDeviceInterfacePath(HANDLE handle);
@@ -66,14 +121,32 @@ protected:
     // Raw input device handle
     HANDLE m_Handle = INVALID_HANDLE_VALUE;
 
-    std::string m_InterfacePath;
+    // Device tree the device was created against. The snapshot is taken when
+    // the first facet needs it; m_DeviceTree and m_TreeNode are set then.
+    std::shared_ptr<const LazyDeviceTree> m_LazyTree;
+    std::shared_ptr<const DeviceTree>     m_DeviceTree;
+    DeviceTree::NodeId                    m_TreeNode = DeviceTree::kNoNode;
+
+    // Typical devices fit all their metadata into the first block.
+    static constexpr size_t kMetadataBlockBytes = 2048;
+
+    // Backing store of every string / list / descriptor below. Declared first
+    // so it outlives the views. Facets resolve on different threads, so every
+    // allocation takes m_MetadataMutex.
+    ChunkedArena       m_Metadata{ kMetadataBlockBytes };
+    mutable std::mutex m_MetadataMutex;
+
+    DevicePath m_InterfacePath;
     bool m_IsInterfaceReadOnly = false;
 
+    uint64_t              m_Fingerprint = 0;
+    std::atomic<uint32_t> m_UserSlot{ kNoUserSlot };
+
     struct DeviceIdentity
     {
-        std::string manufacturer;
-        std::string product;
-        std::string serial;
+        std::string_view manufacturer = "";
+        std::string_view product = "";
+        std::string_view serial = "";
         uint16_t    vendorId = 0;
         uint16_t    productId = 0;
         uint16_t    versionNumber = 0;
@@ -81,46 +154,66 @@ protected:
 
     struct DeviceNodeInfo
     {
-        std::string              instanceId;
-        std::string              manufacturer;
-        std::string              displayName;
-        std::string              service;
-        std::string              deviceClass;
-        std::vector<std::string> stack;
-        std::vector<std::string> hardwareIds;
-        GUID                     busTypeGuid{};
+        std::string_view                  instanceId;
+        std::string_view                  manufacturer;
+        std::string_view                  displayName;
+        std::string_view                  service;
+        std::string_view                  deviceClass;
+        std::span<const std::string_view> stack;
+        std::span<const std::string_view> hardwareIds;
+        GUID                              busTypeGuid{};
     };
 
     struct HidDeviceInfo
     {
-        std::string hidInterfacePath;
+        std::string_view hidInterfacePath;
     };
 
     struct XboxInfo
     {
-        std::string xInputInterfacePath;
-        uint8_t     xInputUserIndex = 0xff;
-        std::string gipInterfacePath;
-        std::string gipSerial;
+        std::string_view xInputInterfacePath;
+        uint8_t          xInputUserIndex = 0xff;
+        std::string_view gipInterfacePath;
+        std::string_view gipSerial;
     };
 
     // Bluetooth LE
     struct BluetoothLEInfo
     {
-        std::string interfacePath;
-        std::string manufacturer;
-        std::string modelNumber;
-        std::string address;
-        uint16_t    vendorId = 0;
-        uint16_t    productId = 0;
-        uint16_t    versionNumber = 0;
+        std::string_view interfacePath;
+        std::string_view manufacturer;
+        std::string_view modelNumber;
+        std::string_view address;
+        uint16_t         vendorId = 0;
+        uint16_t         productId = 0;
+        uint16_t         versionNumber = 0;
 
     };
 
+    // Resolve the facet on first call (see TryQuery*), nullptr if the device
+    // does not have it.
+    const DeviceIdentity&  GetIdentity() const;
+    const DeviceNodeInfo*  GetDevNode() const;
+    const UsbDeviceInfo*   GetUsbInfo() const;
+    const HidDeviceInfo*   GetHidInfo() const;
+    const XboxInfo*        GetXboxInfo() const;
+    const BluetoothLEInfo* GetBleInfo() const;
+
+    // Written once, by the first getter call, before its flag is set.
+    // Subclasses that never call RawInputDevice::Initialize() (the default
+    // devices) may still fill m_Identity up front; ResolveIdentity() keeps
+    // what it cannot improve on.
     DeviceIdentity                 m_Identity;
     std::optional<DeviceNodeInfo>  m_DevNode;
     std::optional<UsbDeviceInfo>   m_UsbInfo;
 	std::optional<HidDeviceInfo>   m_HidInfo;
     std::optional<XboxInfo>        m_XboxInfo;
     std::optional<BluetoothLEInfo> m_BleInfo;
+
+    mutable std::once_flag m_IdentityOnce;
+    mutable std::once_flag m_DevNodeOnce;
+    mutable std::once_flag m_UsbInfoOnce;
+    mutable std::once_flag m_HidInfoOnce;
+    mutable std::once_flag m_XboxInfoOnce;
+    mutable std::once_flag m_BleInfoOnce;
 };
@@ -5,7 +5,7 @@
 #include "RawInputDeviceHid.h"
 
 std::unique_ptr<RawInputDevice>
-RawInputDeviceFactory<RawInputDeviceHid>::Create(HANDLE handle) const
+RawInputDeviceFactory<RawInputDeviceHid>::Create(HANDLE handle, std::shared_ptr<const LazyDeviceTree> tree) const
 {
-    return RawInputDeviceHid::Create(handle);
+    return RawInputDeviceHid::Create(handle, std::move(tree));
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DeviceTree.h"
+
 class RawInputDevice;
 
 template<typename T>
@@ -7,9 +9,10 @@ class RawInputDeviceFactory
 {
     friend class RawInputDeviceManager;
 
-    std::unique_ptr<RawInputDevice> Create(HANDLE handle) const
+    std::unique_ptr<RawInputDevice> Create(HANDLE handle, std::shared_ptr<const LazyDeviceTree> tree) const
     {
         auto device = new T(handle);
+        device->m_LazyTree = std::move(tree);
 		device->Initialize();
 
         return std::unique_ptr<T>(device);
@@ -23,5 +26,5 @@ class RawInputDeviceFactory<RawInputDeviceHid>
 {
     friend class RawInputDeviceManager;
 
-    std::unique_ptr<RawInputDevice> Create(HANDLE handle) const;
+    std::unique_ptr<RawInputDevice> Create(HANDLE handle, std::shared_ptr<const LazyDeviceTree> tree) const;
 };
\ No newline at end of file
@@ -1,31 +1,20 @@
 #pragma once
 
 #include "RawInputDevice.h"
+#include "HidReportDecoder.h"
 
 #include <hidsdi.h>
 #include <hidpi.h>
 
-class RawInputDeviceManager;
+#include <span>
 
-enum class SwitchPosition : uint8_t
-{
-    Center = 0,
-    Up = 1,
-    UpRight = 2,
-    Right = 3,
-    DownRight = 4,
-    Down = 5,
-    DownLeft = 6,
-    Left = 7,
-    UpLeft = 8,
-};
+class RawInputDeviceManager;
 
+// HID device read through Raw Input. Decoding is done by a HidReportDecoder;
+// the accessors below forward to it. The manager decodes on a pool worker,
+// so they follow the decoder's thread rules: any thread, under its lock.
 class RawInputDeviceHid : public RawInputDevice
 {
-    static constexpr size_t kAxesLengthCap = 16;
-    static constexpr size_t kButtonsLengthCap = 32;
-    static constexpr size_t kSwitchLengthCap = 4;
-
 public:
     ~RawInputDeviceHid();
 
@@ -35,142 +24,94 @@ public:
     // Inspects the HID descriptor and constructs the appropriate subclass:
     // RawInputDeviceGamepad, RawInputDeviceWheel, or RawInputDeviceHid.
     // Returns nullptr if the device cannot be initialised.
-    static std::unique_ptr<RawInputDevice> Create(HANDLE handle);
+    static std::unique_ptr<RawInputDevice> Create(HANDLE handle, std::shared_ptr<const LazyDeviceTree> tree);
 
     uint32_t GetType() const override { return RIM_TYPEHID; }
 
-    uint16_t GetUsagePage() const { return m_UsagePage; }
-    uint16_t GetUsageId()   const { return m_UsageId; }
+    uint16_t GetUsagePage() const { return GetModel()->GetUsagePage(); }
+    uint16_t GetUsageId()   const { return GetModel()->GetUsageId(); }
 
-    // Normalised axis value: [-1, +1] for absolute, raw delta for relative.
-    float   GetAxis(size_t i)   const { return i < m_AxisCount ? m_Axis[i].value : 0.f; }
-    bool    GetButton(size_t i) const { return i < m_ButtonCount ? m_Buttons[i].value : false; }
+    // Descriptor-derived data, shared with every device of the same model.
+    const std::shared_ptr<const HidDeviceModel>& GetModel() const { return m_Decoder->GetModel(); }
 
-    // Switch / Hat / POV
-    SwitchPosition GetSwitch(size_t i)    const { return i < m_SwitchCount ? m_Switches[i].value : SwitchPosition::Center; }
+    // Control state decoded from this device's reports; OnInput() feeds it
+    // every RAWHID batch, stamped with QueryPerformanceCounter ticks.
+    HidReportDecoder& GetDecoder() { return *m_Decoder; }
+    const HidReportDecoder& GetDecoder() const { return *m_Decoder; }
 
-    size_t GetAxisCount()    const { return m_AxisCount; }
-    size_t GetButtonCount() const { return m_ButtonCount; }
-    size_t GetSwitchCount()    const { return m_SwitchCount; }
+    void SetDeferredDecode(bool deferred) { m_Decoder->SetDeferredDecode(deferred); }
+    bool IsDeferredDecode() const { return m_Decoder->IsDeferredDecode(); }
 
-protected:
-    explicit RawInputDeviceHid(HANDLE handle);
+    void SetAxisCalibration(size_t i, const AxisCalibration& calibration) { m_Decoder->SetAxisCalibration(i, calibration); }
+    AxisCalibration GetAxisCalibration(size_t i) const { return m_Decoder->GetAxisCalibration(i); }
 
-    void OnInput(const RAWINPUT* input) override;
-    bool Initialize() override;
+    size_t GetAxisCount()   const { return m_Decoder->GetAxisCount(); }
+    size_t GetButtonCount() const { return m_Decoder->GetButtonCount(); }
+    size_t GetSwitchCount() const { return m_Decoder->GetSwitchCount(); }
 
-    struct ButtonState
-    {
-        // ---- hot path ----
-        bool value = false;
-
-        // ---- metadata ----
-        uint16_t usagePage = 0;
-        uint16_t usage = 0;
-
-        // If > 1, this button is the first element of a button array
-        // of reportCount elements occupying consecutive slots in m_Buttons.
-        // HidP_GetButtonArray is needed to read individual elements (Windows 11+).
-        // For subsequent elements (slots 1..N-1) this field is 0.
-        uint16_t reportCount = 1;
-    };
+    // Control state, read through one snapshot; see HidReportDecoder.
+    void ReadSnapshot(HidReportDecoder::Snapshot& out) const { m_Decoder->ReadSnapshot(out); }
+    HidReportDecoder::Snapshot ReadSnapshot() const { return m_Decoder->ReadSnapshot(); }
+    HidDecodeStats GetDecodeStats() const { return m_Decoder->GetDecodeStats(); }
 
-    struct AxisState
-    {
-        // ---- hot path ----
-        float   value = 0.f;
-        int32_t logicalMin = 0;
-        int32_t logicalMax = 0;
-        uint16_t bitSize = 0;
-        bool    isSigned = false;
-        bool    isAbsolute = true; // false → relative, accumulate delta
-
-        // ---- metadata for subclasses ----
-        uint16_t usagePage = 0;
-        uint16_t usage = 0;
-        int32_t  physicalMin = 0;
-        int32_t  physicalMax = 0;
-        uint32_t units = 0;
-        int16_t  unitsExp = 0;
-
-        // If > 1, this axis is the first element of a value array
-        // of reportCount elements occupying consecutive slots in m_Axes.
-        // HidP_GetData does not report these — parsed via HidP_GetUsageValueArray.
-        // For subsequent elements (slots 1..N-1) this field is 0.
-        uint16_t reportCount = 1;
-    };
+    void SetBatchMode(HidBatchMode mode) { m_Decoder->SetBatchMode(mode); }
+    HidBatchMode GetBatchMode() const { return m_Decoder->GetBatchMode(); }
+
+    void CopyHistory(HidReportHistory& out) const { m_Decoder->CopyHistory(out); }
 
-    struct SwitchState
+    void EnableRawReportRing(size_t capacity) { m_Decoder->EnableRawReportRing(capacity); }
+    const RawReportRing* GetRawReportRing() const { return m_Decoder->GetRawReportRing(); }
+
+    // Every input control of the device, of any usage page, addressable by usage.
+    // Entry::kind / Entry::index select the Snapshot's GetButton / GetAxis /
+    // GetSwitch.
+    const HidControlRegistry& GetControls() const { return GetModel()->GetControls(); }
+
+    const HidControlRegistry::Entry* FindControl(uint16_t usagePage, uint16_t usage,
+        uint16_t linkCollection = HidControlRegistry::kAnyCollection) const
     {
-        SwitchPosition value = SwitchPosition::Center;
-
-        // ---- metadata ----
-        uint16_t       usagePage = 0;
-        uint16_t       usage = 0;
-        int32_t        logicalMin = 0;
-        int32_t        logicalMax = 0;
-        uint16_t       granularity = 0; // 36000 / (logicalMax - logicalMin + 1)
-    };
+        return GetModel()->GetControls().Find(usagePage, usage, linkCollection);
+    }
 
-    const ButtonState& GetButtonState(size_t i) const { return m_Buttons[i]; }
-    const AxisState& GetAxisState(size_t i)   const { return m_Axis[i]; }
-    const SwitchState& GetSwitchState(size_t i)    const { return m_Switches[i]; }
+protected:
+    explicit RawInputDeviceHid(HANDLE handle);
 
-private:
-    bool QueryDeviceCapabilities();
-    void QueryButtonCapabilities(uint16_t count);
-    void QueryAxisCapabilities(uint16_t count);
+    void OnInput(const RAWINPUT* input) override;
+    bool Initialize() override;
 
-    static float NormaliseAxis(int32_t lv, const AxisState& ax);
-    static SwitchPosition NormaliseSwitch(int32_t lv, const SwitchState& ss);
+    std::unique_ptr<SavedState> SaveState() const override;
+    void RestoreState(const SavedState& state) override;
 
-    // Dispatch table entry indexed by HIDP_DATA::DataIndex.
-    // Kind::ButtonArray → index is the first slot; individual buttons read via HidP_GetButtonArray.
-    // Kind::ValueArray  → index is the first slot; individual values read via HidP_GetUsageValueArray.
-    enum class Kind : uint8_t { None, Axis, Switch, Button, ButtonArray, ValueArray };
-    struct DataIndexEntry
-    {
-        Kind    kind = Kind::None;
-        uint8_t index = 0;   // index into m_Axes / m_Switches / m_Buttons
-        uint8_t reportId = 0;
-    };
+    // Descriptor metadata; the values read on every report are per device.
+    using ButtonState = HidDeviceModel::ButtonState;
+    using AxisState = HidDeviceModel::AxisState;
+    using SwitchState = HidDeviceModel::SwitchState;
 
-    // Per-Report-ID button reset mask.
-    // When a device has multiple Report IDs, only buttons belonging to the
-    // received report should be cleared.
-    std::unordered_map<uint8_t, std::vector<bool>> m_ButtonReportMasks;
+    const ButtonState& GetButtonState(size_t i) const { return GetModel()->GetButtons()[i]; }
+    const AxisState& GetAxisState(size_t i)     const { return GetModel()->GetAxes()[i]; }
+    const SwitchState& GetSwitchState(size_t i) const { return GetModel()->GetSwitches()[i]; }
 
-    struct InputReport
-    {
-        std::vector<HIDP_DATA>              parsedData;
-        std::vector<uint8_t>                valueArrayBuffer;  // for HidP_GetUsageValueArray
-        std::vector<HIDP_BUTTON_ARRAY_DATA> buttonArrayBuffer; // for HidP_GetButtonArray (Win11+)
-    };
+private:
+    bool QueryDeviceCapabilities();
 
     // Wrapper around PHIDP_PREPARSED_DATA that owns the backing buffer.
     struct PreparsedData
     {
         std::unique_ptr<uint8_t[]> buffer;
+        size_t                     size = 0;
         PHIDP_PREPARSED_DATA       data = nullptr;
 
         bool Load(HANDLE handle);
         explicit operator bool() const { return data != nullptr; }
     };
 
-    uint16_t m_UsagePage = 0;
-    uint16_t m_UsageId = 0;
-
-    PreparsedData m_PreparsedData;
-
-    size_t      m_AxisCount = 0;
-    AxisState   m_Axis[kAxesLengthCap]{};
-
-    size_t      m_ButtonCount = 0;
-    ButtonState m_Buttons[kButtonsLengthCap]{};
-
-    size_t   m_SwitchCount = 0;
-    SwitchState m_Switches[kSwitchLengthCap]{};
+    // Carried over to the same device after a reconnect, so the new device
+    // skips the capability scan and keeps its calibration.
+    struct HidSavedState : SavedState
+    {
+        HidReportDecoder::Settings decoder;
+    };
 
-    std::vector<DataIndexEntry> m_DataIndexTable;
-    InputReport                 m_InputReport;
-};
\ No newline at end of file
+    // Never null; devices without usable capabilities decode with the empty model.
+    std::unique_ptr<HidReportDecoder> m_Decoder;
+};
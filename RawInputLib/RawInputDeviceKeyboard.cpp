@@ -206,13 +206,13 @@ namespace HID
 RawInputDeviceKeyboard::RawInputDeviceKeyboard(HANDLE handle)
     : RawInputDevice(handle)
 {
-    //DBGPRINT("New Keyboard device: '%s', Interface: `%s`", GetProductString().c_str(), GetInterfacePath().c_str());
+    //DBGPRINT("New Keyboard device: '%s', Interface: `%s`", GetProductString().data(), GetInterfacePath().data());
 
 }
 
 RawInputDeviceKeyboard::~RawInputDeviceKeyboard()
 {
-    //DBGPRINT("Removed Keyboard device: '%s', Interface: `%s`", GetProductString().c_str(), GetInterfacePath().c_str());
+    //DBGPRINT("Removed Keyboard device: '%s', Interface: `%s`", GetProductString().data(), GetInterfacePath().data());
 }
 
 void RawInputDeviceKeyboard::OnInput(const RAWINPUT* input)
@@ -288,7 +288,7 @@ void RawInputDeviceKeyboard::OnInput(const RAWINPUT* input)
     std::string vkCodeName = VkToString(vkCode);
 
     DBGPRINT("Keyboard '%s': %s Usage(%04x: %04x), ScanCode(0x%04x), VirtualKeyCode(%s), ScanCodeName(`%s`), DIKCode(0x%02x), DIKCodeName(`%s`)\n",
-        GetInterfacePath().c_str(),
+        GetInterfacePath().data(),
         keyUp ? "release" : "press",
         HIWORD(usbKeyCode),
         LOWORD(usbKeyCode),
@@ -306,17 +306,17 @@ bool RawInputDeviceKeyboard::Initialize()
 
     if (!m_KeyboardInfo.QueryInfo(m_Handle))
     {
-        DBGPRINT("Cannot get Raw Input Keyboard info from: %s", m_InterfacePath.c_str());
+        DBGPRINT("Cannot get Raw Input Keyboard info from: %s", GetInterfacePath().data());
         return false;
     }
 
     // Seems only HID keyboard does support this
     if (IsHidDevice())
     {
-        ScopedHandle hidHandle = OpenDeviceInterface(m_InterfacePath, m_IsInterfaceReadOnly);
+        ScopedHandle hidHandle = OpenDeviceInterface(GetInterfacePath(), m_IsInterfaceReadOnly);
         if (!hidHandle || !m_ExtendedKeyboardInfo.QueryInfo(hidHandle))
         {
-            DBGPRINT("Cannot get Extended Keyboard info from: %s", m_InterfacePath.c_str());
+            DBGPRINT("Cannot get Extended Keyboard info from: %s", GetInterfacePath().data());
             return false;
         }
 
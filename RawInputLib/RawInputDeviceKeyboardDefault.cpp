@@ -12,7 +12,7 @@ RawInputDeviceKeyboardDefault::RawInputDeviceKeyboardDefault()
 
 bool RawInputDeviceKeyboardDefault::Initialize()
 {
-    m_InterfacePath = "Default Keyboard";
+    m_InterfacePath = DevicePath::Intern("Default Keyboard");
     m_Identity.product = "Default Keyboard";
 
     return true;
@@ -87,7 +87,7 @@ void RawInputDeviceKeyboardDefault::OnInput(const RAWINPUT* input)
             std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> utf32conv;
             std::string utf8ch = utf32conv.to_bytes(cp);
             DBGPRINT("Keyboard '%s': OnCharacter: %s\n",
-                GetInterfacePath().c_str(),
+                GetInterfacePath().data(),
                 GetUnicodeCharacterNames(utf8ch).c_str());
         }
     }
@@ -9,61 +9,108 @@
 #include "RawInputDeviceKeyboard.h"
 #include "RawInputDeviceKeyboardDefault.h"
 #include "RawInputDeviceHid.h"
+#include "ParallelDecodePool.h"
+#include "HotplugCoalescer.h"
+#include "Win32InputBackend.h"
+#include "CfgMgr32Wrapper.h"
+#include "utils_lru.h"
 
 #include <array>
 #include <unordered_map>
-#include <thread>
-#include <future>
 #include <memory>
+#include <mutex>
 
 namespace
 {
     void DumpInfo(const RawInputDevice* device)
     {
-        DBGPRINT("Interface path: %s", device->GetInterfacePath().c_str());
-        DBGPRINT("Manufacturer String: %s", device->GetManufacturerString().c_str());
-        DBGPRINT("Product String: %s", device->GetProductString().c_str());
+        DBGPRINT("Interface path: %s", device->GetInterfacePath().data());
+        DBGPRINT("Manufacturer String: %s", device->GetManufacturerString().data());
+        DBGPRINT("Product String: %s", device->GetProductString().data());
 
     }
 
-    bool IsVirtualRIDDevice(const std::string& path)
+    bool IsVirtualRIDDevice(std::string_view path)
     {
         // Case-insensitive, covers both keyboard and mouse variants
-        stringutils::ci_string ci(path.c_str(), path.size());
-        return ci.find("\\microsoft keyboard rid\\") != ci.npos
-            || ci.find("\\microsoft mouse rid\\") != ci.npos;
+        return stringutils::contains_ci(path, "\\microsoft keyboard rid\\")
+            || stringutils::contains_ci(path, "\\microsoft mouse rid\\");
     }
 
-    // Window class name for the message-only sink window.
-    constexpr LPCWSTR RAW_SINK_CLASS = L"RawInputSink";
+    // Arrivals and removals are reconciled in batches: once none has come
+    // in for kHotplugQuietPeriod, or the oldest has waited kHotplugMaxDelay.
+    constexpr auto kHotplugQuietPeriod = std::chrono::milliseconds(30);
+    constexpr auto kHotplugMaxDelay = std::chrono::milliseconds(250);
+
+    HANDLE ToHandle(InputBackend::DeviceHandle handle) { return Win32InputBackend::FromDeviceHandle(handle); }
+
+    const char* GetDeviceTypeString(InputBackend::DeviceType type)
+    {
+        switch (type)
+        {
+        case InputBackend::DeviceType::Mouse:    return "Mouse";
+        case InputBackend::DeviceType::Keyboard: return "Keyboard";
+        case InputBackend::DeviceType::Hid:      return "HID";
+        }
+        return "";
+    }
 }
 
-struct RawInputDeviceManager::RawInputManagerImpl
+struct RawInputDeviceManager::RawInputManagerImpl : InputBackend::Listener
 {
-    RawInputManagerImpl();
-    ~RawInputManagerImpl();
+    using DeviceHandle = InputBackend::DeviceHandle;
+    using DeviceType = InputBackend::DeviceType;
 
-    void ThreadRun(std::promise<void> readyPromise);
+    explicit RawInputManagerImpl(std::unique_ptr<InputBackend> backend);
+    ~RawInputManagerImpl();
 
-    bool SetDeviceEnabled(USHORT usUsage, bool enabled);
-    bool Register();
-    bool Unregister();
+    // InputBackend::Listener, all on the backend thread.
+    void OnStarted() override;
+    void OnStopping() override;
+    void OnDeviceArrived(DeviceHandle handle) override;
+    void OnDeviceRemoved(DeviceHandle handle) override;
+    void OnInput(DeviceHandle handle, DeviceType type, std::span<const uint8_t> packet) override;
+    void OnWakeup() override;
 
-    void OnDeviceConnected(HANDLE deviceHandle);
-    void OnDeviceDisconnected(HANDLE deviceHandle);
+    void ScheduleHotplug(HotplugCoalescer::Clock::time_point now);
+    void ReconcileHotplug(const HotplugCoalescer::Batch& batch);
+    void OnDeviceConnected(DeviceHandle handle);
+    void OnDeviceDisconnected(DeviceHandle handle);
 
+    void RefreshDeviceTree();
     void EnumerateDevices();
 
-    void OnInput(const RAWINPUT* input);
+    // Makes the current m_Devices visible to GetRawInputDevices().
+    void PublishDevices();
+    std::shared_ptr<const std::vector<std::shared_ptr<RawInputDevice>>> GetPublishedDevices() const;
+
+    std::unique_ptr<RawInputDevice> CreateRawInputDevice(DeviceType deviceType, HANDLE deviceHandle) const;
+
+    std::unique_ptr<InputBackend> m_Backend;
+
+    // Owned by the backend thread; other threads see the copy last published.
+    std::unordered_map<DeviceHandle, std::shared_ptr<RawInputDevice>> m_Devices;
+
+    mutable std::mutex                                                  m_PublishMutex;
+    std::shared_ptr<const std::vector<std::shared_ptr<RawInputDevice>>> m_PublishedDevices;
 
-    std::unique_ptr<RawInputDevice> CreateRawInputDevice(DWORD deviceType, HANDLE deviceHandle) const;
+    HotplugCoalescer m_Hotplug{ kHotplugQuietPeriod, kHotplugMaxDelay };
 
-    std::thread       m_Thread;
-    HWND              m_hWnd     = nullptr;
+    // State of recently removed devices by fingerprint, handed to the device
+    // that replaces one when it reconnects.
+    static constexpr size_t kRecentDeviceCount = 16;
+    LruCache<uint64_t, std::unique_ptr<RawInputDevice::SavedState>> m_RecentDevices{ kRecentDeviceCount };
 
-    std::vector<BYTE> m_InputBuffer;
+    // Devices resolve their facets against this snapshot. A fresh one is
+    // handed out per enumeration and per arrival; it is only taken once a
+    // device created against it is inspected.
+    std::shared_ptr<DeviceTreeSource>     m_TreeSource = CreateSystemDeviceTreeSource();
+    std::shared_ptr<const LazyDeviceTree> m_DeviceTree;
 
-    std::unordered_map<HANDLE, std::unique_ptr<RawInputDevice>> m_Devices;
+    // HID reports are decoded on the pool; the backend thread only copies
+    // them. Keyboard and mouse input stays on the backend thread.
+    std::unique_ptr<ParallelDecodePool>                           m_DecodePool;
+    std::unordered_map<DeviceHandle, ParallelDecodePool::DeviceId> m_DecodeQueues;
 
     std::unique_ptr<RawInputDeviceKeyboardDefault> m_DefaultKeyboard;
     std::unique_ptr<RawInputDeviceMouse>           m_DefaultMouse;
@@ -73,90 +120,27 @@ struct RawInputDeviceManager::RawInputManagerImpl
 // RawInputManagerImpl
 // ---------------------------------------------------------------------------
 
-RawInputDeviceManager::RawInputManagerImpl::RawInputManagerImpl()
-    : m_InputBuffer(sizeof(RAWINPUT) + 64, 0)
+RawInputDeviceManager::RawInputManagerImpl::RawInputManagerImpl(std::unique_ptr<InputBackend> backend)
+    : m_Backend(std::move(backend))
 {
-    // The promise/future pair replaces m_ReadyEvent (CreateEvent / WaitForSingleObject).
-    // The worker thread signals readiness by calling promise.set_value(); the
-    // constructor blocks on future.get() until that happens.
-    std::promise<void> readyPromise;
-    std::future<void>  readyFuture = readyPromise.get_future();
-
-    m_Thread = std::thread(&RawInputManagerImpl::ThreadRun, this, std::move(readyPromise));
-
-    // Block until the worker thread has created the window, registered
-    // devices, and finished EnumerateDevices.
-    readyFuture.get();
+    // Blocks until OnStarted() has enumerated the devices.
+    m_Backend->Start(*this);
 }
 
 RawInputDeviceManager::RawInputManagerImpl::~RawInputManagerImpl()
 {
-    ::PostMessageW(m_hWnd, WM_QUIT, 0, 0);
-    m_Thread.join();
+    m_Backend->Stop();
+
+    // Stop decoding before the devices go away.
+    for (auto& [handle, queue] : m_DecodeQueues)
+        m_DecodePool->RemoveDevice(queue);
+    m_DecodeQueues.clear();
+    m_DecodePool.reset();
 }
 
-void RawInputDeviceManager::RawInputManagerImpl::ThreadRun(std::promise<void> readyPromise)
+void RawInputDeviceManager::RawInputManagerImpl::OnStarted()
 {
-    HINSTANCE hInstance = ::GetModuleHandleW(nullptr);
-
-    WNDCLASSEXW wc = { sizeof(wc) };
-    wc.lpfnWndProc = [](HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) -> LRESULT
-        {
-            if (uMsg == WM_NCCREATE)
-            {
-                auto* cs = reinterpret_cast<CREATESTRUCTW*>(lParam);
-                ::SetWindowLongPtrW(hWnd, GWLP_USERDATA,
-                    reinterpret_cast<LONG_PTR>(cs->lpCreateParams));
-                return ::DefWindowProcW(hWnd, uMsg, wParam, lParam);
-            }
-
-            auto* self = reinterpret_cast<RawInputManagerImpl*>(
-                ::GetWindowLongPtrW(hWnd, GWLP_USERDATA));
-
-            if (!self)
-                return ::DefWindowProcW(hWnd, uMsg, wParam, lParam);
-
-            switch (uMsg)
-            {
-            case WM_INPUT:
-            {
-                UINT size = static_cast<UINT>(self->m_InputBuffer.size());
-                while (::GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam),
-                    RID_INPUT, self->m_InputBuffer.data(), &size, sizeof(RAWINPUTHEADER)) == UINT_MAX)
-                {
-                    if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-                        return 0;
-
-                    // Buffer too small — size is updated by GetRawInputData to required size
-                    self->m_InputBuffer.resize(size);
-                }
-                self->OnInput(reinterpret_cast<RAWINPUT*>(self->m_InputBuffer.data()));
-                return 0;
-            }
-
-            case WM_INPUT_DEVICE_CHANGE:
-                if (wParam == GIDC_ARRIVAL)
-                    self->OnDeviceConnected(reinterpret_cast<HANDLE>(lParam));
-                else
-                    self->OnDeviceDisconnected(reinterpret_cast<HANDLE>(lParam));
-                return 0;
-
-            case WM_INPUTLANGCHANGE:
-				self->m_DefaultKeyboard->OnInputLanguageChanged(reinterpret_cast<HKL>(lParam));
-                return 0;
-            }
-
-            return ::DefWindowProcW(hWnd, uMsg, wParam, lParam);
-        };
-    wc.hInstance = hInstance;
-    wc.lpszClassName = RAW_SINK_CLASS;
-    ::RegisterClassExW(&wc);
-
-    m_hWnd = ::CreateWindowExW(0, RAW_SINK_CLASS, nullptr, 0,
-        0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, this);
-    CHECK(IsValidHandle(m_hWnd));
-
-    CHECK(Register());
+    m_DecodePool = std::make_unique<ParallelDecodePool>();
 
     m_DefaultKeyboard.reset(new RawInputDeviceKeyboardDefault());
     m_DefaultMouse.reset(new RawInputDeviceMouse(nullptr));
@@ -165,178 +149,237 @@ void RawInputDeviceManager::RawInputManagerImpl::ThreadRun(std::promise<void> re
     m_DefaultMouse->Initialize();
 
     EnumerateDevices();
+}
 
-    readyPromise.set_value();
-
-    MSG msg;
-    while (::GetMessageW(&msg, nullptr, 0, 0) > 0)
-    {
-        ::DispatchMessageW(&msg);
-    }
+void RawInputDeviceManager::RawInputManagerImpl::OnStopping()
+{
+    m_Backend->CancelWakeup();
+}
 
-    CHECK(Unregister());
-    CHECK(::DestroyWindow(m_hWnd));
-    m_hWnd = nullptr;
+void RawInputDeviceManager::RawInputManagerImpl::OnDeviceArrived(DeviceHandle handle)
+{
+    const auto now = HotplugCoalescer::Clock::now();
+    m_Hotplug.OnArrival(handle, now);
+    ScheduleHotplug(now);
+}
 
-    ::UnregisterClassW(RAW_SINK_CLASS, hInstance);
+void RawInputDeviceManager::RawInputManagerImpl::OnDeviceRemoved(DeviceHandle handle)
+{
+    const auto now = HotplugCoalescer::Clock::now();
+    m_Hotplug.OnRemoval(handle, now);
+    ScheduleHotplug(now);
 }
 
-bool RawInputDeviceManager::RawInputManagerImpl::SetDeviceEnabled(USHORT usUsage, bool enabled)
+void RawInputDeviceManager::RawInputManagerImpl::ScheduleHotplug(HotplugCoalescer::Clock::time_point now)
 {
-    RAWINPUTDEVICE rid =
-    {
-        HID_USAGE_PAGE_GENERIC,
-        usUsage,
-        enabled ? DWORD(RIDEV_DEVNOTIFY | RIDEV_INPUTSINK)
-                : RIDEV_REMOVE,
-        enabled ? m_hWnd : nullptr
-    };
-
-    return ::RegisterRawInputDevices(&rid, 1, sizeof(RAWINPUTDEVICE));
+    m_Backend->ScheduleWakeup(m_Hotplug.GetDeadline() - now);
 }
 
-bool RawInputDeviceManager::RawInputManagerImpl::Register()
+void RawInputDeviceManager::RawInputManagerImpl::OnWakeup()
 {
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_MOUSE, true));
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_KEYBOARD, true));
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_GAMEPAD, true));
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_JOYSTICK, true));
+    if (m_Hotplug.IsEmpty())
+        return;
 
-    return true;
+    const auto now = HotplugCoalescer::Clock::now();
+    if (!m_Hotplug.IsDue(now))
+    {
+        ScheduleHotplug(now);
+        return;
+    }
+
+    ReconcileHotplug(m_Hotplug.Take());
 }
 
-bool RawInputDeviceManager::RawInputManagerImpl::Unregister()
+void RawInputDeviceManager::RawInputManagerImpl::ReconcileHotplug(const HotplugCoalescer::Batch& batch)
 {
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_MOUSE, false));
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_KEYBOARD, false));
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_GAMEPAD, false));
-    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_JOYSTICK, false));
+    for (DeviceHandle handle : batch.removed)
+        OnDeviceDisconnected(handle);
+
+    // One snapshot for every arrival of the batch; their nodes are not in
+    // the current one.
+    bool refreshed = false;
+    for (DeviceHandle handle : batch.arrived)
+    {
+        if (m_Devices.count(handle))
+            continue;
+
+        if (!refreshed)
+        {
+            RefreshDeviceTree();
+            refreshed = true;
+        }
+        OnDeviceConnected(handle);
+    }
+
+    DBGPRINT("Hotplug: %zu notifications, %zu removed, %zu arrived", batch.notifications, batch.removed.size(), batch.arrived.size());
 
-    return true;
+    PublishDevices();
 }
 
-void RawInputDeviceManager::RawInputManagerImpl::OnDeviceConnected(HANDLE deviceHandle)
+void RawInputDeviceManager::RawInputManagerImpl::OnDeviceConnected(DeviceHandle handle)
 {
-	std::string interfacePath = RawInputDevice::QueryRawDeviceInterfacePath(deviceHandle);
-    if (IsVirtualRIDDevice(interfacePath))
+    const HANDLE deviceHandle = ToHandle(handle);
+
+    const std::optional<InputBackend::DeviceInfo> deviceInfo = m_Backend->GetDeviceInfo(handle);
+    if (!deviceInfo)
     {
-        DBGPRINT("Skipping virtual device. Handle=0x%08x, Path: %s", deviceHandle, interfacePath.c_str());
+        DBGPRINT("Skipping vanished device. Handle=0x%08x", deviceHandle);
         return;
     }
 
-    RID_DEVICE_INFO deviceInfo;
-    CHECK(RawInputDevice::QueryRawDeviceInfo(deviceHandle, &deviceInfo));
-
-    std::string deviceTypeStr;
-    switch (deviceInfo.dwType)
+    // Interned here so the device's own lookup below is a pool hit.
+    const DevicePath interfacePath = DevicePath::Intern(deviceInfo->interfacePath);
+    if (IsVirtualRIDDevice(interfacePath.GetString()))
     {
-    case RIM_TYPEMOUSE:    deviceTypeStr = "Mouse";    break;
-    case RIM_TYPEKEYBOARD: deviceTypeStr = "Keyboard"; break;
-    case RIM_TYPEHID:      deviceTypeStr = "HID";      break;
+        DBGPRINT("Skipping virtual device. Handle=0x%08x, Path: %s", deviceHandle, interfacePath.GetString().data());
+        return;
     }
 
-    if (m_Devices.find(deviceHandle) != m_Devices.end())
+    const char* deviceTypeStr = GetDeviceTypeString(deviceInfo->type);
+
+    if (m_Devices.find(handle) != m_Devices.end())
     {
-        //DBGPRINT("Skipping already detected %s device. Handle=0x%08x, Path: %s", deviceTypeStr.c_str(), deviceHandle, interfacePath.c_str());
+        //DBGPRINT("Skipping already detected %s device. Handle=0x%08x, Path: %s", deviceTypeStr, deviceHandle, interfacePath.GetString().data());
         return;
     }
 
-    auto new_device = CreateRawInputDevice(deviceInfo.dwType, deviceHandle);
+    auto new_device = CreateRawInputDevice(deviceInfo->type, deviceHandle);
+    bool reconnected = false;
+    if (new_device)
+    {
+        if (auto state = m_RecentDevices.Take(new_device->GetFingerprint()))
+        {
+            new_device->RestoreState(**state);
+            reconnected = true;
+        }
+    }
 
-    auto emplace_result = m_Devices.emplace(deviceHandle, std::move(new_device));
+    auto emplace_result = m_Devices.emplace(handle, std::move(new_device));
     CHECK(emplace_result.second);
 
-    DBGPRINT("Connected %s device. Handle=0x%08x, Path: %s", deviceTypeStr.c_str(), deviceHandle, interfacePath.c_str());
+    if (deviceInfo->type == DeviceType::Hid && emplace_result.first->second)
+    {
+        RawInputDevice* device = emplace_result.first->second.get();
+        m_DecodeQueues.emplace(handle, m_DecodePool->AddDevice(
+            [device](const uint8_t* data, size_t)
+            {
+                device->OnInput(reinterpret_cast<const RAWINPUT*>(data));
+            }));
+    }
+
+    DBGPRINT("%s %s device. Handle=0x%08x, Path: %s", reconnected ? "Reconnected" : "Connected", deviceTypeStr, deviceHandle, interfacePath.GetString().data());
 
     //DumpInfo(emplace_result.first->second.get());
 }
 
-void RawInputDeviceManager::RawInputManagerImpl::OnDeviceDisconnected(HANDLE deviceHandle)
+void RawInputDeviceManager::RawInputManagerImpl::OnDeviceDisconnected(DeviceHandle handle)
 {
-    auto it = m_Devices.find(deviceHandle);
+    // Skipped virtual devices were never added.
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return;
+
+    if (auto queue = m_DecodeQueues.find(handle); queue != m_DecodeQueues.end())
+    {
+        m_DecodePool->RemoveDevice(queue->second);
+        m_DecodeQueues.erase(queue);
+    }
 
-    std::string deviceTypeStr;
-    switch (it->second->GetType())
+    if (const RawInputDevice* device = it->second.get())
     {
-    case RIM_TYPEMOUSE:    deviceTypeStr = "Mouse";    break;
-    case RIM_TYPEKEYBOARD: deviceTypeStr = "Keyboard"; break;
-    case RIM_TYPEHID:      deviceTypeStr = "HID";      break;
+        const char* deviceTypeStr = GetDeviceTypeString(static_cast<DeviceType>(device->GetType()));
+
+        DBGPRINT("Disconnected %s device. Handle=0x%08x, Path: %s", deviceTypeStr, ToHandle(handle), device->GetInterfacePath().data());
+
+        // After the decode queue is gone, so the state is not read mid-decode.
+        m_RecentDevices.Put(device->GetFingerprint(), device->SaveState());
     }
 
-    DBGPRINT("Disconnected %s device. Handle=0x%08x, Path: %s", deviceTypeStr.c_str(), deviceHandle, it->second->GetInterfacePath().c_str());
-    CHECK(m_Devices.erase(deviceHandle));
+    m_Devices.erase(it);
 }
 
-void RawInputDeviceManager::RawInputManagerImpl::EnumerateDevices()
+void RawInputDeviceManager::RawInputManagerImpl::RefreshDeviceTree()
 {
-    std::vector<RAWINPUTDEVICELIST> deviceList(32);
-    UINT count = static_cast<UINT>(deviceList.size());
-    UINT result;
+    m_DeviceTree = std::make_shared<LazyDeviceTree>(m_TreeSource);
+}
 
-    while ((result = ::GetRawInputDeviceList(deviceList.data(), &count, sizeof(RAWINPUTDEVICELIST))) == UINT_MAX)
-    {
-        if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-        {
-            DBGPRINT("GetRawInputDeviceList() failed. GetLastError=%d", ::GetLastError());
-            return;
-        }
+void RawInputDeviceManager::RawInputManagerImpl::EnumerateDevices()
+{
+    RefreshDeviceTree();
 
-        // Buffer too small — count is updated by GetRawInputDeviceList to required count
-        deviceList.resize(count);
-    }
+    const std::vector<DeviceHandle> deviceList = m_Backend->EnumerateDevices();
 
-    deviceList.resize(result);
+    std::unordered_set<DeviceHandle> current(deviceList.begin(), deviceList.end());
 
-    std::unordered_set<HANDLE> current;
-    current.reserve(deviceList.size());
-    for (const auto& d : deviceList)
-        current.insert(d.hDevice);
+    // Remove devices no longer present. OnDeviceDisconnected() erases from
+    // m_Devices, so collect the handles first.
+    std::vector<DeviceHandle> removed;
+    for (const auto& [handle, device] : m_Devices)
+        if (!current.count(handle))
+            removed.push_back(handle);
 
-    // Remove devices no longer present.
-    for (auto it = m_Devices.begin(); it != m_Devices.end(); )
-    {
-        if (!current.count(it->first))
-        {
-            OnDeviceDisconnected(it->first);
-            it = m_Devices.erase(it);
-        }
-        else
-            ++it;
-    }
+    for (DeviceHandle handle : removed)
+        OnDeviceDisconnected(handle);
 
     // Add newly appeared devices.
-    for (const auto& d : deviceList)
-        if (!m_Devices.count(d.hDevice))
-            OnDeviceConnected(d.hDevice);
+    for (DeviceHandle handle : deviceList)
+        if (!m_Devices.count(handle))
+            OnDeviceConnected(handle);
+
+    PublishDevices();
 }
 
-void RawInputDeviceManager::RawInputManagerImpl::OnInput(const RAWINPUT* input)
+void RawInputDeviceManager::RawInputManagerImpl::OnInput(DeviceHandle handle, DeviceType type, std::span<const uint8_t> packet)
 {
-    HANDLE hDevice = input->header.hDevice;
+    const RAWINPUT* input = reinterpret_cast<const RAWINPUT*>(packet.data());
 
     // Route to default device first — it always receives all input of its type.
-    switch (input->header.dwType)
+    switch (type)
     {
-    case RIM_TYPEKEYBOARD: m_DefaultKeyboard->OnInput(input); break;
-    case RIM_TYPEMOUSE:    m_DefaultMouse->OnInput(input);    break;
+    case DeviceType::Keyboard: m_DefaultKeyboard->OnInput(input); break;
+    case DeviceType::Mouse:    m_DefaultMouse->OnInput(input);    break;
     }
 
     // Also route to the specific physical device if known.
-    if (hDevice != NULL)
+    if (handle != 0)
     {
-        auto it = m_Devices.find(hDevice);
-        if (it != m_Devices.end())
+        if (auto queue = m_DecodeQueues.find(handle); queue != m_DecodeQueues.end())
+        {
+            m_DecodePool->Submit(queue->second, packet.data(), packet.size());
+            return;
+        }
+
+        auto it = m_Devices.find(handle);
+        if (it != m_Devices.end() && it->second)
             it->second->OnInput(input);
     }
 }
 
-std::unique_ptr<RawInputDevice> RawInputDeviceManager::RawInputManagerImpl::CreateRawInputDevice(DWORD deviceType, HANDLE handle) const
+void RawInputDeviceManager::RawInputManagerImpl::PublishDevices()
+{
+    auto devices = std::make_shared<std::vector<std::shared_ptr<RawInputDevice>>>();
+    devices->reserve(m_Devices.size());
+    for (const auto& [handle, device] : m_Devices)
+        if (device)
+            devices->push_back(device);
+
+    std::lock_guard lock(m_PublishMutex);
+    m_PublishedDevices = std::move(devices);
+}
+
+std::shared_ptr<const std::vector<std::shared_ptr<RawInputDevice>>> RawInputDeviceManager::RawInputManagerImpl::GetPublishedDevices() const
+{
+    std::lock_guard lock(m_PublishMutex);
+    return m_PublishedDevices;
+}
+
+std::unique_ptr<RawInputDevice> RawInputDeviceManager::RawInputManagerImpl::CreateRawInputDevice(DeviceType deviceType, HANDLE handle) const
 {
     switch (deviceType)
     {
-    case RIM_TYPEMOUSE:    return RawInputDeviceFactory<RawInputDeviceMouse>().Create(handle);
-    case RIM_TYPEKEYBOARD: return RawInputDeviceFactory<RawInputDeviceKeyboard>().Create(handle);
-    case RIM_TYPEHID:      return RawInputDeviceFactory<RawInputDeviceHid>().Create(handle);
+    case DeviceType::Mouse:    return RawInputDeviceFactory<RawInputDeviceMouse>().Create(handle, m_DeviceTree);
+    case DeviceType::Keyboard: return RawInputDeviceFactory<RawInputDeviceKeyboard>().Create(handle, m_DeviceTree);
+    case DeviceType::Hid:      return RawInputDeviceFactory<RawInputDeviceHid>().Create(handle, m_DeviceTree);
     }
 
     DBGPRINT("Unknown device type %d.", deviceType);
@@ -344,7 +387,7 @@ std::unique_ptr<RawInputDevice> RawInputDeviceManager::RawInputManagerImpl::Crea
 }
 
 RawInputDeviceManager::RawInputDeviceManager()
-    : m_RawInputManagerImpl(std::make_unique<RawInputManagerImpl>())
+    : m_RawInputManagerImpl(std::make_unique<RawInputManagerImpl>(std::make_unique<Win32InputBackend>()))
 {
 }
 
@@ -352,19 +395,20 @@ RawInputDeviceManager::~RawInputDeviceManager() = default;
 
 void RawInputDeviceManager::OnInputLanguageChanged(HKL hkl)
 {
-    if (m_RawInputManagerImpl->m_hWnd)
-    {
-        ::PostMessageW(m_RawInputManagerImpl->m_hWnd, WM_INPUTLANGCHANGE, 0, reinterpret_cast<LPARAM>(hkl));
-    }
+    RawInputManagerImpl* impl = m_RawInputManagerImpl.get();
+    impl->m_Backend->Post([impl, hkl]()
+        {
+            impl->m_DefaultKeyboard->OnInputLanguageChanged(hkl);
+        });
 }
 
 std::vector<std::shared_ptr<RawInputDevice>> RawInputDeviceManager::GetRawInputDevices() const
 {
-    std::vector<std::shared_ptr<RawInputDevice>> devices;
-    for (auto& dev : m_RawInputManagerImpl->m_Devices)
-        devices.emplace_back(dev.second.get());
+    const auto devices = m_RawInputManagerImpl->GetPublishedDevices();
+    if (!devices)
+        return {};
 
-    return devices;
+    return *devices;
 }
 
 RawInputDeviceKeyboard* RawInputDeviceManager::GetDefaultKeyboard() const
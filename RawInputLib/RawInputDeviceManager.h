@@ -7,6 +7,9 @@
 class RawInputDeviceManager
 {
 public:
+    // Reads devices and input through Raw Input (Win32InputBackend). Devices
+    // query Raw Input for their metadata and decode RAWINPUT packets, so no
+    // other backend fits here; InputPipeline decodes the others.
     RawInputDeviceManager();
     ~RawInputDeviceManager();
 
@@ -17,6 +20,8 @@ public:
     // hkl — new keyboard layout handle from lParam.
     void OnInputLanguageChanged(HKL hkl);
 
+    // Devices as of the last enumeration or hotplug batch. Thread-safe; a
+    // removed device stays valid for as long as the caller holds it.
     std::vector<std::shared_ptr<RawInputDevice>> GetRawInputDevices() const;
 
     RawInputDeviceKeyboard* GetDefaultKeyboard() const;
@@ -10,12 +10,12 @@
 RawInputDeviceMouse::RawInputDeviceMouse(HANDLE handle)
     : RawInputDevice(handle)
 {
-    //DBGPRINT("New Mouse device: '%s', Interface: `%s`", GetProductString().c_str(), GetInterfacePath().c_str());
+    //DBGPRINT("New Mouse device: '%s', Interface: `%s`", GetProductString().data(), GetInterfacePath().data());
 }
 
 RawInputDeviceMouse::~RawInputDeviceMouse()
 {
-    //DBGPRINT("Removed Mouse device: '%s', Interface: `%s`", GetProductString().c_str(), GetInterfacePath().c_str());
+    //DBGPRINT("Removed Mouse device: '%s', Interface: `%s`", GetProductString().data(), GetInterfacePath().data());
 }
 
 void RawInputDeviceMouse::OnInput(const RAWINPUT* input)
@@ -99,7 +99,7 @@ bool RawInputDeviceMouse::Initialize()
 {
     if (m_Handle == NULL)
     {
-        m_InterfacePath = "Default Mouse";
+        m_InterfacePath = DevicePath::Intern("Default Mouse");
         m_Identity.product = "Default Mouse";
         return true;
     }
@@ -109,7 +109,7 @@ bool RawInputDeviceMouse::Initialize()
 
     if (!m_MouseInfo.QueryInfo(m_Handle))
     {
-        DBGPRINT("Cannot get Raw Input Mouse info from '%s'.", m_InterfacePath.c_str());
+        DBGPRINT("Cannot get Raw Input Mouse info from '%s'.", GetInterfacePath().data());
         return false;
     }
 
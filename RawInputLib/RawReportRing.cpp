@@ -0,0 +1,74 @@
+#include "RawReportRing.h"
+
+#include <algorithm>
+#include <cstring>
+
+RawReportRing::RawReportRing(size_t capacity, size_t maxReportSize)
+    : m_Capacity(std::max<size_t>(capacity, 1))
+    , m_Stride(maxReportSize)
+    , m_Slots(std::make_unique<Slot[]>(m_Capacity))
+    , m_Bytes(std::make_unique<uint8_t[]>(m_Capacity * maxReportSize))
+{
+    for (auto& latest : m_LatestByReportId)
+        latest.store(kNoSequence, std::memory_order_relaxed);
+}
+
+void RawReportRing::Push(const uint8_t* report, size_t size, uint64_t timestamp)
+{
+    const uint64_t sequence = m_Next.load(std::memory_order_relaxed);
+    const uint8_t reportId = size > 0 ? report[0] : 0;
+    Slot& slot = m_Slots[sequence % m_Capacity];
+
+    // Seqlock write: odd lock value announces the slot is being rewritten.
+    const uint32_t lock = slot.lock.load(std::memory_order_relaxed);
+    slot.lock.store(lock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t stored = std::min(size, m_Stride);
+    std::memcpy(m_Bytes.get() + (sequence % m_Capacity) * m_Stride, report, stored);
+    slot.size = static_cast<uint32_t>(stored);
+    slot.reportId = reportId;
+    slot.timestamp = timestamp;
+    slot.previousSameId = m_LatestByReportId[reportId].load(std::memory_order_relaxed);
+    slot.sequence.store(sequence, std::memory_order_relaxed);
+
+    slot.lock.store(lock + 2, std::memory_order_release);
+
+    m_LatestByReportId[reportId].store(sequence, std::memory_order_release);
+    m_Next.store(sequence + 1, std::memory_order_release);
+}
+
+bool RawReportRing::Read(uint64_t sequence, View& out) const
+{
+    if (sequence >= GetNextSequence())
+        return false;
+
+    const Slot& slot = m_Slots[sequence % m_Capacity];
+
+    const uint32_t lock = slot.lock.load(std::memory_order_acquire);
+    if (lock & 1)
+        return false; // being overwritten right now
+
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        return false; // overrun
+
+    out.sequence = sequence;
+    out.timestamp = slot.timestamp;
+    out.reportId = slot.reportId;
+    out.previousSameId = slot.previousSameId;
+    out.bytes = { m_Bytes.get() + (sequence % m_Capacity) * m_Stride, slot.size };
+    out.lock = lock;
+
+    // The header fields above were read under the lock; recheck it.
+    return Validate(out);
+}
+
+bool RawReportRing::Validate(const View& view) const
+{
+    if (view.sequence == kNoSequence)
+        return false;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const Slot& slot = m_Slots[view.sequence % m_Capacity];
+    return slot.lock.load(std::memory_order_relaxed) == view.lock;
+}
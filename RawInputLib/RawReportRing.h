@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+// Fixed-capacity ring of the most recent raw input reports of one device.
+//
+// One thread writes (the thread decoding the device); any number of threads
+// read. Writing never blocks or allocates: the oldest report is overwritten.
+// Every slot is guarded by a sequence lock, so readers get views straight into
+// the ring memory and check afterwards whether the slot was overwritten while
+// they were looking at it:
+//
+//     RawReportRing::View view;
+//     if (ring.Read(seq, view))
+//     {
+//         Parse(view.bytes);
+//         if (!ring.Validate(view))
+//             ; // overrun: discard what was parsed
+//     }
+//
+// Reports are numbered from 0 in arrival order; GetNextSequence() is the number
+// the next report will get.
+class RawReportRing
+{
+public:
+    static constexpr uint64_t kNoSequence = UINT64_MAX;
+
+    struct View
+    {
+        uint64_t                 sequence = kNoSequence;
+        uint64_t                 timestamp = 0;  // caller-defined clock, see Push()
+        uint8_t                  reportId = 0;
+        std::span<const uint8_t> bytes;          // whole report, Report ID byte included
+
+        // Previous report with the same Report ID, or kNoSequence.
+        uint64_t                 previousSameId = kNoSequence;
+
+        uint32_t                 lock = 0;       // slot lock value seen by Read()
+    };
+
+    // Reports longer than `maxReportSize` are truncated.
+    RawReportRing(size_t capacity, size_t maxReportSize);
+
+    RawReportRing(const RawReportRing&) = delete;
+    void operator=(const RawReportRing&) = delete;
+
+    // Writer side. The first byte of `report` is taken as the Report ID.
+    void Push(const uint8_t* report, size_t size, uint64_t timestamp);
+
+    // Reader side. Returns false if `sequence` was not written yet or has
+    // already been overwritten.
+    bool Read(uint64_t sequence, View& out) const;
+
+    // True if the slot behind `view` was not rewritten since Read().
+    bool Validate(const View& view) const;
+
+    // Newest report with this Report ID, or kNoSequence.
+    uint64_t FindLatest(uint8_t reportId) const
+    {
+        return m_LatestByReportId[reportId].load(std::memory_order_acquire);
+    }
+
+    uint64_t GetNextSequence() const { return m_Next.load(std::memory_order_acquire); }
+
+    // Oldest sequence that may still be readable.
+    uint64_t GetOldestSequence() const
+    {
+        const uint64_t next = GetNextSequence();
+        return next > m_Capacity ? next - m_Capacity : 0;
+    }
+
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetMaxReportSize() const { return m_Stride; }
+
+private:
+    struct Slot
+    {
+        // Odd while the writer is filling the slot; bumped twice per write.
+        std::atomic<uint32_t> lock{ 0 };
+        std::atomic<uint64_t> sequence{ kNoSequence };
+        uint64_t              timestamp = 0;
+        uint64_t              previousSameId = kNoSequence;
+        uint32_t              size = 0;
+        uint8_t               reportId = 0;
+    };
+
+    size_t                      m_Capacity = 0;
+    size_t                      m_Stride = 0;
+    std::unique_ptr<Slot[]>     m_Slots;
+    std::unique_ptr<uint8_t[]>  m_Bytes;
+
+    std::atomic<uint64_t>       m_Next{ 0 };
+    std::array<std::atomic<uint64_t>, 256> m_LatestByReportId;
+};
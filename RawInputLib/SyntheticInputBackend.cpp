@@ -0,0 +1,322 @@
+#include "SyntheticInputBackend.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    // Events dispatched per turn before posted tasks and Stop() are looked
+    // at again.
+    constexpr size_t kDispatchBatch = 256;
+
+    // Made-up vendor ID of generated interface paths.
+    constexpr unsigned kSyntheticVendorId = 0xF0F0;
+}
+
+SyntheticInputBackend::SyntheticInputBackend(Config config)
+    : m_Config(std::move(config))
+    , m_Random(m_Config.seed | 1)
+{
+}
+
+SyntheticInputBackend::~SyntheticInputBackend()
+{
+    if (m_Thread.joinable())
+        Stop();
+}
+
+void SyntheticInputBackend::Start(Listener& listener)
+{
+    m_Listener = &listener;
+
+    std::promise<void> readyPromise;
+    std::future<void>  readyFuture = readyPromise.get_future();
+
+    m_Thread = std::thread(&SyntheticInputBackend::ThreadRun, this, std::move(readyPromise));
+
+    readyFuture.get();
+}
+
+void SyntheticInputBackend::Stop()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Changed.notify_one();
+
+    m_Thread.join();
+}
+
+void SyntheticInputBackend::Post(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        if (m_Stopping)
+            return;
+
+        m_Tasks.push_back(std::move(task));
+    }
+    m_Changed.notify_one();
+}
+
+void SyntheticInputBackend::ScheduleWakeup(Clock::duration delay)
+{
+    m_Wakeup = GetNow() + delay;
+}
+
+void SyntheticInputBackend::CancelWakeup()
+{
+    m_Wakeup = Clock::time_point::max();
+}
+
+std::vector<InputBackend::DeviceHandle> SyntheticInputBackend::EnumerateDevices()
+{
+    return m_Order;
+}
+
+std::optional<InputBackend::DeviceInfo> SyntheticInputBackend::GetDeviceInfo(DeviceHandle handle)
+{
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return std::nullopt;
+
+    const DeviceSpec& spec = it->second.spec;
+    return DeviceInfo{ spec.type, spec.interfacePath, spec.reportDescriptor.empty() ? PacketFormat::Native : PacketFormat::HidReport };
+}
+
+std::span<const uint8_t> SyntheticInputBackend::GetReportDescriptor(DeviceHandle handle) const
+{
+    auto it = m_Devices.find(handle);
+    if (it == m_Devices.end())
+        return {};
+
+    return it->second.spec.reportDescriptor;
+}
+
+void SyntheticInputBackend::Plug(DeviceSpec spec)
+{
+    Post([this, spec = std::move(spec)]() mutable
+        {
+            m_Listener->OnDeviceArrived(AddDevice(std::move(spec)));
+        });
+}
+
+void SyntheticInputBackend::Unplug(DeviceHandle handle)
+{
+    Post([this, handle]()
+        {
+            if (RemoveDevice(handle))
+                m_Listener->OnDeviceRemoved(handle);
+        });
+}
+
+uint64_t SyntheticInputBackend::GetPacketCount() const
+{
+    return m_PacketCount.load(std::memory_order_relaxed);
+}
+
+SyntheticInputBackend::Clock::time_point SyntheticInputBackend::GetNow() const
+{
+    return m_Config.realTime ? Clock::now() : m_VirtualNow;
+}
+
+void SyntheticInputBackend::ThreadRun(std::promise<void> readyPromise)
+{
+    m_VirtualNow = Clock::now();
+
+    for (const DeviceSpec& spec : m_Config.devices)
+        AddDevice(spec);
+
+    if (m_Config.churnInterval > Clock::duration::zero())
+        m_NextChurn = GetNow() + m_Config.churnInterval;
+
+    m_Listener->OnStarted();
+
+    readyPromise.set_value();
+
+    std::unique_lock lock(m_Mutex);
+    while (!m_Stopping)
+    {
+        if (!m_Tasks.empty())
+        {
+            std::deque<std::function<void()>> tasks;
+            tasks.swap(m_Tasks);
+
+            lock.unlock();
+            for (auto& task : tasks)
+                task();
+            lock.lock();
+            continue;
+        }
+
+        const bool sending = !m_Config.packetLimit || m_PacketCount.load(std::memory_order_relaxed) < m_Config.packetLimit;
+
+        Clock::time_point next = std::min(m_Wakeup, m_NextChurn);
+        if (sending && !m_Events.empty())
+            next = std::min(next, m_Events.top().time);
+
+        if (next == Clock::time_point::max())
+        {
+            m_Changed.wait(lock);
+            continue;
+        }
+
+        if (m_Config.realTime)
+        {
+            if (Clock::now() < next)
+            {
+                m_Changed.wait_until(lock, next);
+                continue;
+            }
+        }
+        else
+        {
+            m_VirtualNow = std::max(m_VirtualNow, next);
+        }
+
+        lock.unlock();
+
+        const Clock::time_point now = GetNow();
+
+        if (m_Wakeup <= now)
+        {
+            m_Wakeup = Clock::time_point::max();
+            m_Listener->OnWakeup();
+        }
+
+        if (m_NextChurn <= now)
+        {
+            Churn();
+            // Skip intervals a slow listener made us miss.
+            m_NextChurn = std::max(m_NextChurn + m_Config.churnInterval, now);
+        }
+
+        for (size_t i = 0; sending && i < kDispatchBatch && !m_Events.empty() && m_Events.top().time <= now; ++i)
+        {
+            Event event = m_Events.top();
+            m_Events.pop();
+
+            // Events of removed devices are dropped here.
+            auto it = m_Devices.find(event.handle);
+            if (it == m_Devices.end())
+                continue;
+
+            SendPacket(event.handle, it->second);
+
+            event.time += it->second.period;
+            event.order = m_NextOrder++;
+            m_Events.push(event);
+
+            if (m_Config.packetLimit && m_PacketCount.load(std::memory_order_relaxed) >= m_Config.packetLimit)
+                break;
+        }
+
+        lock.lock();
+    }
+    lock.unlock();
+
+    m_Listener->OnStopping();
+}
+
+InputBackend::DeviceHandle SyntheticInputBackend::AddDevice(DeviceSpec spec)
+{
+    const DeviceHandle handle = m_NextHandle++;
+
+    if (spec.interfacePath.empty())
+    {
+        // Shaped like a HID interface path, so DevicePath parses it.
+        char path[128];
+        std::snprintf(path, sizeof(path), "\\\\?\\HID#VID_%04X&PID_%04X#%llu#{4d1e55b2-f16f-11cf-88cb-001111000030}",
+            kSyntheticVendorId, static_cast<unsigned>(spec.type), static_cast<unsigned long long>(handle));
+        spec.interfacePath = path;
+    }
+
+    Device& device = m_Devices[handle];
+    device.spec = std::move(spec);
+    device.buffer.resize(device.spec.reportSize);
+
+    m_Order.push_back(handle);
+
+    if (device.spec.reportRate > 0)
+    {
+        device.period = std::max<Clock::duration>(Clock::duration(1),
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / device.spec.reportRate)));
+
+        // A random phase, so devices of the same rate do not report in lockstep.
+        const auto phase = Clock::duration(static_cast<Clock::rep>(NextRandom() % static_cast<uint64_t>(device.period.count())));
+        m_Events.push(Event{ GetNow() + phase, m_NextOrder++, handle });
+    }
+
+    return handle;
+}
+
+bool SyntheticInputBackend::RemoveDevice(DeviceHandle handle)
+{
+    if (!m_Devices.erase(handle))
+        return false;
+
+    m_Order.erase(std::find(m_Order.begin(), m_Order.end(), handle));
+    return true;
+}
+
+void SyntheticInputBackend::SendPacket(DeviceHandle handle, Device& device)
+{
+    std::span<const uint8_t> packet;
+
+    if (!device.spec.packets.empty())
+    {
+        packet = device.spec.packets[device.nextPacket];
+        device.nextPacket = (device.nextPacket + 1) % device.spec.packets.size();
+    }
+    else
+    {
+        // Report ID 1, a little-endian sequence number, then noise.
+        std::vector<uint8_t>& buffer = device.buffer;
+        const uint32_t sequence = device.sequence++;
+        uint64_t noise = 0;
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+            if (i == 0)
+                buffer[i] = 1;
+            else if (i <= sizeof(sequence))
+                buffer[i] = static_cast<uint8_t>(sequence >> (8 * (i - 1)));
+            else
+            {
+                if ((i - 1 - sizeof(sequence)) % sizeof(noise) == 0)
+                    noise = NextRandom();
+                buffer[i] = static_cast<uint8_t>(noise);
+                noise >>= 8;
+            }
+        }
+        packet = buffer;
+    }
+
+    m_PacketCount.fetch_add(1, std::memory_order_relaxed);
+    m_Listener->OnInput(handle, device.spec.type, packet);
+}
+
+void SyntheticInputBackend::Churn()
+{
+    if (m_Order.empty())
+        return;
+
+    const DeviceHandle handle = m_Order[NextRandom() % m_Order.size()];
+
+    // Same spec and interface path, as if the same device was plugged back in.
+    DeviceSpec spec = m_Devices[handle].spec;
+
+    RemoveDevice(handle);
+    m_Listener->OnDeviceRemoved(handle);
+
+    m_Listener->OnDeviceArrived(AddDevice(std::move(spec)));
+}
+
+uint64_t SyntheticInputBackend::NextRandom()
+{
+    // xorshift64*
+    m_Random ^= m_Random >> 12;
+    m_Random ^= m_Random << 25;
+    m_Random ^= m_Random >> 27;
+    return m_Random * 0x2545F4914F6CDD1DULL;
+}
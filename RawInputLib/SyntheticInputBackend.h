@@ -0,0 +1,136 @@
+#pragma once
+
+#include "InputBackend.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+// A backend that makes its devices up, for running and profiling the input
+// pipeline without hardware or Windows.
+//
+// It starts with a configured device population, sends each device's
+// reports at its configured rate and can churn devices (remove one, plug an
+// identical one back in under a new handle) at a fixed interval. A device
+// either replays recorded packets in a loop or gets generated ones. Devices
+// can also be plugged and unplugged by hand from any thread.
+//
+// In real time, events are paced by the clock. Otherwise time is virtual:
+// the backend thread jumps straight to the next event, so reports arrive as
+// fast as the listener takes them, in the order their rates give.
+//
+// Platform-independent; handles are never reused.
+class SyntheticInputBackend : public InputBackend
+{
+public:
+    struct DeviceSpec
+    {
+        DeviceType  type = DeviceType::Hid;
+        std::string interfacePath;      // made up from the handle if empty
+        double      reportRate = 0;     // packets per second; 0 sends none
+        size_t      reportSize = 8;     // of generated packets
+
+        // Sent in a loop instead of generated packets, as recorded.
+        std::vector<std::vector<uint8_t>> packets;
+
+        // The HID report descriptor the packets follow, if known. Packets of
+        // devices with one are PacketFormat::HidReport.
+        std::vector<uint8_t> reportDescriptor;
+    };
+
+    struct Config
+    {
+        std::vector<DeviceSpec> devices; // present at start
+
+        // Zero for none.
+        Clock::duration churnInterval{};
+
+        bool     realTime = true;
+        uint64_t seed = 1;
+
+        // Sending stops after this many packets; 0 for no limit.
+        uint64_t packetLimit = 0;
+    };
+
+    explicit SyntheticInputBackend(Config config);
+    ~SyntheticInputBackend() override;
+
+    SyntheticInputBackend(const SyntheticInputBackend&) = delete;
+    void operator=(const SyntheticInputBackend&) = delete;
+
+    void Start(Listener& listener) override;
+    void Stop() override;
+    void Post(std::function<void()> task) override;
+
+    void ScheduleWakeup(Clock::duration delay) override;
+    void CancelWakeup() override;
+
+    std::vector<DeviceHandle> EnumerateDevices() override;
+    std::optional<DeviceInfo> GetDeviceInfo(DeviceHandle handle) override;
+
+    // Backend thread only. Empty if unknown or not given in the spec.
+    std::span<const uint8_t> GetReportDescriptor(DeviceHandle handle) const override;
+
+    // Hotplug by hand; callable from any thread while started.
+    void Plug(DeviceSpec spec);
+    void Unplug(DeviceHandle handle);
+
+    // Packets sent so far. Callable from any thread.
+    uint64_t GetPacketCount() const;
+
+private:
+    struct Device
+    {
+        DeviceSpec           spec;
+        Clock::duration      period{};
+        size_t               nextPacket = 0; // into spec.packets
+        uint32_t             sequence = 0;   // of generated packets
+        std::vector<uint8_t> buffer;         // generated packet
+    };
+
+    struct Event
+    {
+        Clock::time_point time;
+        uint64_t          order = 0; // FIFO among equal times
+        DeviceHandle      handle = 0;
+
+        bool operator>(const Event& other) const { return time != other.time ? time > other.time : order > other.order; }
+    };
+
+    void ThreadRun(std::promise<void> readyPromise);
+    Clock::time_point GetNow() const;
+
+    DeviceHandle AddDevice(DeviceSpec spec);
+    bool RemoveDevice(DeviceHandle handle);
+    void SendPacket(DeviceHandle handle, Device& device);
+    void Churn();
+    uint64_t NextRandom();
+
+    Config      m_Config;
+    Listener*   m_Listener = nullptr;
+    std::thread m_Thread;
+
+    // Backend thread only.
+    std::unordered_map<DeviceHandle, Device> m_Devices;
+    std::vector<DeviceHandle>                m_Order; // m_Devices in arrival order
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_Events;
+    DeviceHandle      m_NextHandle = 1;
+    uint64_t          m_NextOrder = 0;
+    uint64_t          m_Random = 0;
+    Clock::time_point m_VirtualNow;
+    Clock::time_point m_NextChurn = Clock::time_point::max();
+    Clock::time_point m_Wakeup = Clock::time_point::max();
+
+    mutable std::mutex                m_Mutex;
+    std::condition_variable           m_Changed;
+    std::deque<std::function<void()>> m_Tasks;
+    bool                              m_Stopping = false;
+
+    std::atomic<uint64_t> m_PacketCount = 0;
+};
@@ -0,0 +1,281 @@
+#include "UsbDescriptor.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr size_t kHeaderSize = 2; // bLength, bDescriptorType
+
+    // The descriptor at the start of `data`, if its header is well-formed and
+    // it fits in `data`. Checks the minimum size its parser needs.
+    std::span<const uint8_t> GetDescriptor(std::span<const uint8_t> data, uint8_t type, size_t minLength)
+    {
+        if (data.size() < kHeaderSize || data[1] != type)
+            return {};
+
+        const size_t length = data[0];
+        if (length < minLength || length > data.size())
+            return {};
+
+        return data.first(length);
+    }
+
+    uint16_t ReadU16(std::span<const uint8_t> data, size_t offset)
+    {
+        return static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+    }
+
+    // Length of the descriptor at the start of `data`, or 0 if it is
+    // truncated or malformed.
+    size_t GetDescriptorLength(std::span<const uint8_t> data)
+    {
+        if (data.size() < kHeaderSize)
+            return 0;
+
+        const size_t length = data[0];
+        return (length >= kHeaderSize && length <= data.size()) ? length : 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// UsbDescriptorList
+// ---------------------------------------------------------------------------
+
+void UsbDescriptorList::Iterator::Load()
+{
+    const size_t length = GetDescriptorLength(m_Rest);
+    if (!length)
+    {
+        m_Rest = m_Rest.last(0);
+        m_Current = {};
+        return;
+    }
+
+    m_Current.type = m_Rest[1];
+    m_Current.data = m_Rest.first(length);
+}
+
+bool UsbDescriptorList::IsTruncated() const
+{
+    std::span<const uint8_t> rest = m_Data;
+    while (!rest.empty())
+    {
+        const size_t length = GetDescriptorLength(rest);
+        if (!length)
+            return true;
+
+        rest = rest.subspan(length);
+    }
+
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Descriptor parsers
+// ---------------------------------------------------------------------------
+
+std::optional<UsbDeviceDescriptor> ParseUsbDeviceDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_Device, 18);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbDeviceDescriptor result;
+    result.bcdUSB = ReadU16(d, 2);
+    result.bDeviceClass = d[4];
+    result.bDeviceSubClass = d[5];
+    result.bDeviceProtocol = d[6];
+    result.bMaxPacketSize0 = d[7];
+    result.idVendor = ReadU16(d, 8);
+    result.idProduct = ReadU16(d, 10);
+    result.bcdDevice = ReadU16(d, 12);
+    result.iManufacturer = d[14];
+    result.iProduct = d[15];
+    result.iSerialNumber = d[16];
+    result.bNumConfigurations = d[17];
+    return result;
+}
+
+std::optional<UsbConfigurationDescriptor> ParseUsbConfigurationDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_Configuration, 9);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbConfigurationDescriptor result;
+    result.wTotalLength = ReadU16(d, 2);
+    result.bNumInterfaces = d[4];
+    result.bConfigurationValue = d[5];
+    result.iConfiguration = d[6];
+    result.bmAttributes = d[7];
+    result.bMaxPower = d[8];
+    return result;
+}
+
+std::optional<UsbInterfaceDescriptor> ParseUsbInterfaceDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_Interface, 9);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbInterfaceDescriptor result;
+    result.bInterfaceNumber = d[2];
+    result.bAlternateSetting = d[3];
+    result.bNumEndpoints = d[4];
+    result.bInterfaceClass = d[5];
+    result.bInterfaceSubClass = d[6];
+    result.bInterfaceProtocol = d[7];
+    result.iInterface = d[8];
+    return result;
+}
+
+std::optional<UsbEndpointDescriptor> ParseUsbEndpointDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_Endpoint, 7);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbEndpointDescriptor result;
+    result.bEndpointAddress = d[2];
+    result.bmAttributes = d[3];
+    result.wMaxPacketSize = ReadU16(d, 4);
+    result.bInterval = d[6];
+    return result;
+}
+
+std::optional<UsbInterfaceAssociationDescriptor> ParseUsbInterfaceAssociationDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_InterfaceAssociation, 8);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbInterfaceAssociationDescriptor result;
+    result.bFirstInterface = d[2];
+    result.bInterfaceCount = d[3];
+    result.bFunctionClass = d[4];
+    result.bFunctionSubClass = d[5];
+    result.bFunctionProtocol = d[6];
+    result.iFunction = d[7];
+    return result;
+}
+
+std::optional<UsbHidDescriptor> ParseUsbHidDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_Hid, 6);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbHidDescriptor result;
+    result.bcdHID = ReadU16(d, 2);
+    result.bCountryCode = d[4];
+    result.bNumDescriptors = d[5];
+
+    // Entries that do not fit in bLength are dropped.
+    const size_t count = std::min<size_t>(result.bNumDescriptors, (d.size() - 6) / 3);
+    result.classDescriptors = d.subspan(6, count * 3);
+    return result;
+}
+
+uint16_t UsbHidDescriptor::GetReportDescriptorLength() const
+{
+    for (size_t offset = 0; offset + 3 <= classDescriptors.size(); offset += 3)
+    {
+        if (classDescriptors[offset] == UsbDescriptorType_HidReport)
+            return ReadU16(classDescriptors, offset + 1);
+    }
+
+    return 0;
+}
+
+std::optional<UsbBosDescriptor> ParseUsbBosDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_Bos, 5);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbBosDescriptor result;
+    result.wTotalLength = ReadU16(d, 2);
+    result.bNumDeviceCaps = d[4];
+    return result;
+}
+
+std::optional<UsbDeviceCapabilityDescriptor> ParseUsbDeviceCapabilityDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_DeviceCapability, 3);
+    if (d.empty())
+        return std::nullopt;
+
+    UsbDeviceCapabilityDescriptor result;
+    result.bDevCapabilityType = d[2];
+    result.capability = d.subspan(3);
+    return result;
+}
+
+std::span<const uint8_t> ParseUsbStringDescriptor(std::span<const uint8_t> data)
+{
+    const std::span<const uint8_t> d = GetDescriptor(data, UsbDescriptorType_String, kHeaderSize);
+    if (d.empty())
+        return {};
+
+    // Whole code units only.
+    const std::span<const uint8_t> units = d.subspan(kHeaderSize);
+    return units.first(units.size() & ~size_t(1));
+}
+
+// ---------------------------------------------------------------------------
+// UsbInterfaceView
+// ---------------------------------------------------------------------------
+
+UsbDescriptorList UsbInterfaceView::GetDescriptors() const
+{
+    return UsbDescriptorList(data.subspan(data[0]));
+}
+
+std::optional<UsbHidDescriptor> UsbInterfaceView::GetHidDescriptor() const
+{
+    // https://www.usb.org/document-library/device-class-definition-hid-111
+    // 7.1  Standard Requests
+    // The HID descriptor shall be interleaved between the Interface and
+    // Endpoint descriptors for HID Interfaces. Some devices put it after the
+    // endpoints, so look at everything up to the next interface.
+    constexpr uint8_t USB_DEVICE_CLASS_HUMAN_INTERFACE = 0x03;
+    if (descriptor.bInterfaceClass != USB_DEVICE_CLASS_HUMAN_INTERFACE)
+        return std::nullopt;
+
+    for (const UsbDescriptorView& desc : GetDescriptors())
+    {
+        if (desc.type == UsbDescriptorType_Hid)
+            return ParseUsbHidDescriptor(desc.data);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<UsbInterfaceView> FindUsbInterface(std::span<const uint8_t> configurationDescriptor, uint8_t interfaceNumber, uint8_t alternateSetting)
+{
+    const UsbDescriptorList descriptors(configurationDescriptor);
+
+    for (auto it = descriptors.begin(); it != descriptors.end(); ++it)
+    {
+        if (it->type != UsbDescriptorType_Interface)
+            continue;
+
+        const std::optional<UsbInterfaceDescriptor> desc = ParseUsbInterfaceDescriptor(it->data);
+        if (!desc || desc->bInterfaceNumber != interfaceNumber || desc->bAlternateSetting != alternateSetting)
+            continue;
+
+        // Extend up to the next interface or interface association.
+        const std::span<const uint8_t> start = it.GetRemaining();
+        size_t size = it->data.size();
+        for (++it; it != descriptors.end(); ++it)
+        {
+            if (it->type == UsbDescriptorType_Interface || it->type == UsbDescriptorType_InterfaceAssociation)
+                break;
+            size += it->data.size();
+        }
+
+        return UsbInterfaceView{ *desc, start.first(size) };
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+// Standard USB descriptors (USB 2.0 chapter 9, USB 3.2 chapter 9.6.2, HID 1.11
+// chapter 6.2.1), parsed straight out of the bytes returned by the device.
+//
+// Nothing is copied or cast: multi-byte fields are read little-endian, every
+// access is bounds-checked against the buffer and every span points into it.
+// Malformed input never reads out of bounds. It ends the walk early and is
+// reported by UsbDescriptorList::IsTruncated().
+
+enum UsbDescriptorType : uint8_t
+{
+    UsbDescriptorType_Device               = 0x01,
+    UsbDescriptorType_Configuration        = 0x02,
+    UsbDescriptorType_String               = 0x03,
+    UsbDescriptorType_Interface            = 0x04,
+    UsbDescriptorType_Endpoint             = 0x05,
+    UsbDescriptorType_InterfaceAssociation = 0x0B,
+    UsbDescriptorType_Bos                  = 0x0F,
+    UsbDescriptorType_DeviceCapability     = 0x10,
+    UsbDescriptorType_Hid                  = 0x21,
+    UsbDescriptorType_HidReport            = 0x22,
+};
+
+// One descriptor: bLength bytes starting at bLength itself.
+struct UsbDescriptorView
+{
+    uint8_t                  type = 0;
+    std::span<const uint8_t> data;
+};
+
+// Walks the descriptors packed back to back in a buffer, such as the
+// configuration descriptor set or the BOS descriptor set.
+class UsbDescriptorList
+{
+public:
+    class Iterator
+    {
+    public:
+        using value_type = UsbDescriptorView;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(std::span<const uint8_t> rest) : m_Rest(rest) { Load(); }
+
+        const UsbDescriptorView& operator*() const { return m_Current; }
+        const UsbDescriptorView* operator->() const { return &m_Current; }
+
+        Iterator& operator++()
+        {
+            m_Rest = m_Rest.subspan(m_Current.data.size());
+            Load();
+            return *this;
+        }
+        Iterator operator++(int) { Iterator it = *this; ++*this; return it; }
+
+        bool operator==(const Iterator& other) const { return m_Rest.data() == other.m_Rest.data() && m_Rest.size() == other.m_Rest.size(); }
+
+        // Bytes from the current descriptor to the end of the buffer.
+        std::span<const uint8_t> GetRemaining() const { return m_Rest; }
+
+    private:
+        void Load();
+
+        std::span<const uint8_t> m_Rest;
+        UsbDescriptorView        m_Current;
+    };
+
+    UsbDescriptorList() = default;
+    explicit UsbDescriptorList(std::span<const uint8_t> data) : m_Data(data) {}
+
+    Iterator begin() const { return Iterator(m_Data); }
+    Iterator end() const { return Iterator(m_Data.last(0)); }
+
+    // True if the buffer ends in a descriptor that is shorter than two bytes
+    // or runs past the end of the buffer. The walk stops before it.
+    bool IsTruncated() const;
+
+private:
+    std::span<const uint8_t> m_Data;
+};
+
+struct UsbDeviceDescriptor
+{
+    uint16_t bcdUSB = 0;
+    uint8_t  bDeviceClass = 0;
+    uint8_t  bDeviceSubClass = 0;
+    uint8_t  bDeviceProtocol = 0;
+    uint8_t  bMaxPacketSize0 = 0;
+    uint16_t idVendor = 0;
+    uint16_t idProduct = 0;
+    uint16_t bcdDevice = 0;
+    uint8_t  iManufacturer = 0;
+    uint8_t  iProduct = 0;
+    uint8_t  iSerialNumber = 0;
+    uint8_t  bNumConfigurations = 0;
+};
+
+struct UsbConfigurationDescriptor
+{
+    uint16_t wTotalLength = 0;
+    uint8_t  bNumInterfaces = 0;
+    uint8_t  bConfigurationValue = 0;
+    uint8_t  iConfiguration = 0;
+    uint8_t  bmAttributes = 0;
+    uint8_t  bMaxPower = 0;
+};
+
+struct UsbInterfaceDescriptor
+{
+    uint8_t bInterfaceNumber = 0;
+    uint8_t bAlternateSetting = 0;
+    uint8_t bNumEndpoints = 0;
+    uint8_t bInterfaceClass = 0;
+    uint8_t bInterfaceSubClass = 0;
+    uint8_t bInterfaceProtocol = 0;
+    uint8_t iInterface = 0;
+};
+
+struct UsbEndpointDescriptor
+{
+    uint8_t  bEndpointAddress = 0;
+    uint8_t  bmAttributes = 0;
+    uint16_t wMaxPacketSize = 0;
+    uint8_t  bInterval = 0;
+
+    bool IsIn() const { return (bEndpointAddress & 0x80) != 0; }
+};
+
+struct UsbInterfaceAssociationDescriptor
+{
+    uint8_t bFirstInterface = 0;
+    uint8_t bInterfaceCount = 0;
+    uint8_t bFunctionClass = 0;
+    uint8_t bFunctionSubClass = 0;
+    uint8_t bFunctionProtocol = 0;
+    uint8_t iFunction = 0;
+};
+
+struct UsbHidDescriptor
+{
+    uint16_t bcdHID = 0;
+    uint8_t  bCountryCode = 0;
+    uint8_t  bNumDescriptors = 0;
+
+    // bNumDescriptors entries of { bDescriptorType, wDescriptorLength }.
+    std::span<const uint8_t> classDescriptors;
+
+    // wDescriptorLength of the first report descriptor, or 0.
+    uint16_t GetReportDescriptorLength() const;
+};
+
+struct UsbBosDescriptor
+{
+    uint16_t wTotalLength = 0;
+    uint8_t  bNumDeviceCaps = 0;
+};
+
+struct UsbDeviceCapabilityDescriptor
+{
+    uint8_t                  bDevCapabilityType = 0;
+    std::span<const uint8_t> capability; // type-specific bytes after the header
+};
+
+// Each parser takes one descriptor (a UsbDescriptorView's data, or the start
+// of a buffer) and fails if its type is wrong or it is too short for the
+// fields above. Longer descriptors are accepted and the extra bytes ignored.
+std::optional<UsbDeviceDescriptor>               ParseUsbDeviceDescriptor(std::span<const uint8_t> data);
+std::optional<UsbConfigurationDescriptor>        ParseUsbConfigurationDescriptor(std::span<const uint8_t> data);
+std::optional<UsbInterfaceDescriptor>            ParseUsbInterfaceDescriptor(std::span<const uint8_t> data);
+std::optional<UsbEndpointDescriptor>             ParseUsbEndpointDescriptor(std::span<const uint8_t> data);
+std::optional<UsbInterfaceAssociationDescriptor> ParseUsbInterfaceAssociationDescriptor(std::span<const uint8_t> data);
+std::optional<UsbHidDescriptor>                  ParseUsbHidDescriptor(std::span<const uint8_t> data);
+std::optional<UsbBosDescriptor>                  ParseUsbBosDescriptor(std::span<const uint8_t> data);
+std::optional<UsbDeviceCapabilityDescriptor>     ParseUsbDeviceCapabilityDescriptor(std::span<const uint8_t> data);
+
+// UTF-16LE code units of a string descriptor, or of the LANGID array of
+// string descriptor 0. Empty if `data` is not a string descriptor.
+std::span<const uint8_t> ParseUsbStringDescriptor(std::span<const uint8_t> data);
+
+// An interface within a configuration descriptor set, with the class-specific
+// and endpoint descriptors that follow it up to the next interface.
+struct UsbInterfaceView
+{
+    UsbInterfaceDescriptor   descriptor;
+    std::span<const uint8_t> data; // interface descriptor and what follows it
+
+    // Descriptors after the interface descriptor itself.
+    UsbDescriptorList GetDescriptors() const;
+
+    // The HID descriptor, present on HID class interfaces only.
+    std::optional<UsbHidDescriptor> GetHidDescriptor() const;
+};
+
+// Interface `interfaceNumber`, alternate setting `alternateSetting`, of a
+// full configuration descriptor set (as returned for wTotalLength bytes).
+std::optional<UsbInterfaceView> FindUsbInterface(std::span<const uint8_t> configurationDescriptor, uint8_t interfaceNumber, uint8_t alternateSetting = 0);
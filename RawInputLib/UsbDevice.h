@@ -1,32 +1,37 @@
 #pragma once
 
+#include "DeviceTree.h"
+#include "utils_arena.h"
+
+#include <span>
 #include <string>
+#include <string_view>
 
 class UsbDeviceInfo
 {
 public:
-    UsbDeviceInfo(const std::string& hidDeviceInstanceId);
+    // `hidNode` is the HID device node in `tree`. Strings and descriptors
+    // are copied into `arena`, which must outlive this object.
+    UsbDeviceInfo(const DeviceTree& tree, DeviceTree::NodeId hidNode, ChunkedArena& arena);
 
     //UsbDeviceInfo(UsbDeviceInfo&) = delete;
     //void operator=(UsbDeviceInfo) = delete;
 
 public:
-    std::string m_DeviceInstanceId;
-    std::string m_DeviceInterfacePath;
+    std::string_view m_DeviceInstanceId;
+    std::string_view m_DeviceInterfacePath;
 
     uint16_t m_VendorId = 0;
     uint16_t m_ProductId = 0;
     uint16_t m_VersionNumber = 0;
 
-    std::string m_Manufacturer;
-    std::string m_Product;
-    std::string m_SerialNumber;
+    std::string_view m_Manufacturer;
+    std::string_view m_Product;
+    std::string_view m_SerialNumber;
 
-    std::vector<uint8_t> m_ConfigurationDescriptor;
-    std::vector<uint8_t> m_HidReportDescriptor;
+    std::span<const uint8_t> m_ConfigurationDescriptor;
+    std::span<const uint8_t> m_HidReportDescriptor;
 
-    std::string m_UsbHubInterfacePath;
-    ScopedHandle m_UsbHubHandle;
     ULONG m_UsbPortIndex = 0;
     UCHAR m_UsbInterfaceNumber = 0;
 
@@ -0,0 +1,518 @@
+#include "UsbmonCapture.h"
+
+#include "MappedFile.h"
+#include "UsbDescriptor.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    // https://www.tcpdump.org/linktypes.html
+    constexpr uint16_t kLinkTypeUsbLinux = 189;         // 48-byte header
+    constexpr uint16_t kLinkTypeUsbLinuxMmapped = 220;  // 64-byte header
+    constexpr size_t   kUsbmonHeaderSize = 48;
+    constexpr size_t   kUsbmonMmappedHeaderSize = 64;
+    constexpr size_t   kIsoDescriptorSize = 16;
+
+    constexpr size_t   kPcapHeaderSize = 24;
+    constexpr size_t   kPcapRecordHeaderSize = 16;
+    constexpr uint32_t kPcapMagic = 0xA1B2C3D4;
+    constexpr uint32_t kPcapMagicNs = 0xA1B23C4D;
+
+    // https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-02.html
+    constexpr uint32_t kPcapNgSectionHeader = 0x0A0D0D0A;
+    constexpr uint32_t kPcapNgInterfaceDescription = 1;
+    constexpr uint32_t kPcapNgSimplePacket = 3;
+    constexpr uint32_t kPcapNgEnhancedPacket = 6;
+    constexpr uint32_t kPcapNgByteOrderMagic = 0x1A2B3C4D;
+    constexpr uint16_t kPcapNgOptionEnd = 0;
+    constexpr uint16_t kPcapNgOptionTsResol = 9;
+
+    // USB 2.0 9.4 Standard Device Requests
+    constexpr uint8_t kRequestGetDescriptor = 0x06;
+    constexpr uint8_t kRequestDirectionIn = 0x80;
+    constexpr uint8_t kRequestRecipientMask = 0x1F;
+    constexpr uint8_t kRequestRecipientDevice = 0x00;
+    constexpr uint8_t kRequestRecipientInterface = 0x01;
+
+    uint16_t ByteSwap(uint16_t value) { return static_cast<uint16_t>((value >> 8) | (value << 8)); }
+    uint32_t ByteSwap(uint32_t value) { return (uint32_t(ByteSwap(uint16_t(value))) << 16) | ByteSwap(uint16_t(value >> 16)); }
+    uint64_t ByteSwap(uint64_t value) { return (uint64_t(ByteSwap(uint32_t(value))) << 32) | ByteSwap(uint32_t(value >> 32)); }
+
+    uint32_t ReadLe32(std::span<const uint8_t> data, size_t offset)
+    {
+        return data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (uint32_t(data[offset + 3]) << 24);
+    }
+
+    uint64_t ToNanoseconds(uint64_t ticks, uint64_t ticksPerSecond)
+    {
+        return ticks / ticksPerSecond * 1'000'000'000 + ticks % ticksPerSecond * 1'000'000'000 / ticksPerSecond;
+    }
+
+    size_t Align4(size_t size)
+    {
+        return (size + 3) & ~size_t(3);
+    }
+
+    uint32_t PackKey(const UsbmonHidImporter::InterfaceKey& key)
+    {
+        return (uint32_t(key.bus) << 16) | (uint32_t(key.device) << 8) | key.interfaceNumber;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// UsbmonCaptureReader
+// ---------------------------------------------------------------------------
+
+UsbmonCaptureReader::UsbmonCaptureReader(std::span<const uint8_t> capture)
+    : m_Capture(capture)
+{
+    if (capture.size() < 4)
+        return;
+
+    const uint32_t magic = ReadLe32(capture, 0);
+    if (magic == kPcapNgSectionHeader)
+    {
+        m_Format = Format::PcapNg;
+        return;
+    }
+
+    if (capture.size() < kPcapHeaderSize)
+        return;
+
+    if (magic == kPcapMagic || magic == kPcapMagicNs)
+        m_Swapped = false;
+    else if (ByteSwap(magic) == kPcapMagic || ByteSwap(magic) == kPcapMagicNs)
+        m_Swapped = true;
+    else
+        return;
+
+    m_Format = Format::Pcap;
+    m_Nanoseconds = (m_Swapped ? ByteSwap(magic) : magic) == kPcapMagicNs;
+    m_LinkType = static_cast<uint16_t>(Read32(capture, 20));
+    m_Offset = kPcapHeaderSize;
+}
+
+uint16_t UsbmonCaptureReader::Read16(std::span<const uint8_t> data, size_t offset) const
+{
+    const uint16_t value = static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+    return m_Swapped ? ByteSwap(value) : value;
+}
+
+uint32_t UsbmonCaptureReader::Read32(std::span<const uint8_t> data, size_t offset) const
+{
+    const uint32_t value = ReadLe32(data, offset);
+    return m_Swapped ? ByteSwap(value) : value;
+}
+
+uint64_t UsbmonCaptureReader::Read64(std::span<const uint8_t> data, size_t offset) const
+{
+    const uint64_t value = ReadLe32(data, offset) | (uint64_t(ReadLe32(data, offset + 4)) << 32);
+    return m_Swapped ? ByteSwap(value) : value;
+}
+
+std::optional<UsbmonPacket> UsbmonCaptureReader::Next()
+{
+    switch (m_Format)
+    {
+    case Format::Pcap:   return NextPcap();
+    case Format::PcapNg: return NextPcapNg();
+    case Format::Invalid: break;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<UsbmonPacket> UsbmonCaptureReader::NextPcap()
+{
+    while (m_Offset < m_Capture.size())
+    {
+        const std::span<const uint8_t> rest = m_Capture.subspan(m_Offset);
+        if (rest.size() < kPcapRecordHeaderSize)
+        {
+            m_Truncated = true;
+            return std::nullopt;
+        }
+
+        const uint64_t seconds = Read32(rest, 0);
+        const uint64_t fraction = Read32(rest, 4);
+        const size_t   length = Read32(rest, 8);
+        if (length > rest.size() - kPcapRecordHeaderSize)
+        {
+            m_Truncated = true;
+            return std::nullopt;
+        }
+
+        m_Offset += kPcapRecordHeaderSize + length;
+
+        const uint64_t timestamp = seconds * 1'000'000'000 + (m_Nanoseconds ? fraction : fraction * 1000);
+        if (auto packet = ParsePacket(m_LinkType, timestamp, rest.subspan(kPcapRecordHeaderSize, length)))
+            return packet;
+    }
+
+    return std::nullopt;
+}
+
+bool UsbmonCaptureReader::ReadSectionHeader()
+{
+    const std::span<const uint8_t> rest = m_Capture.subspan(m_Offset);
+    if (rest.size() < 12)
+        return false;
+
+    // The byte-order magic decides how the section is read, its own block
+    // length included.
+    const uint32_t byteOrder = ReadLe32(rest, 8);
+    if (byteOrder == kPcapNgByteOrderMagic)
+        m_Swapped = false;
+    else if (ByteSwap(byteOrder) == kPcapNgByteOrderMagic)
+        m_Swapped = true;
+    else
+        return false;
+
+    m_Interfaces.clear();
+    return true;
+}
+
+void UsbmonCaptureReader::ReadInterfaceDescription(std::span<const uint8_t> body)
+{
+    Interface iface;
+    iface.linkType = Read16(body, 0);
+
+    for (size_t offset = 8; offset + 4 <= body.size();)
+    {
+        const uint16_t code = Read16(body, offset);
+        const uint16_t length = Read16(body, offset + 2);
+        if (code == kPcapNgOptionEnd || offset + 4 + length > body.size())
+            break;
+
+        if (code == kPcapNgOptionTsResol && length >= 1)
+        {
+            // Negative power of 10, or of 2 if the top bit is set.
+            const uint8_t resolution = body[offset + 4];
+            const uint8_t exponent = resolution & 0x7F;
+            if (resolution & 0x80)
+                iface.tsUnitsPerSecond = exponent < 64 ? uint64_t(1) << exponent : 0;
+            else
+            {
+                iface.tsUnitsPerSecond = 1;
+                for (uint8_t i = 0; i < exponent && i < 19; ++i)
+                    iface.tsUnitsPerSecond *= 10;
+            }
+            if (!iface.tsUnitsPerSecond)
+                iface.tsUnitsPerSecond = 1'000'000;
+        }
+
+        offset += 4 + Align4(length);
+    }
+
+    m_Interfaces.push_back(iface);
+}
+
+std::optional<UsbmonPacket> UsbmonCaptureReader::NextPcapNg()
+{
+    while (m_Offset < m_Capture.size())
+    {
+        std::span<const uint8_t> rest = m_Capture.subspan(m_Offset);
+        if (rest.size() < 12)
+        {
+            m_Truncated = true;
+            return std::nullopt;
+        }
+
+        const bool sectionHeader = ReadLe32(rest, 0) == kPcapNgSectionHeader;
+        if (sectionHeader && !ReadSectionHeader())
+        {
+            m_Truncated = true;
+            return std::nullopt;
+        }
+
+        const uint32_t type = Read32(rest, 0);
+        const size_t   length = Read32(rest, 4);
+        if (length < 12 || length % 4 || length > rest.size())
+        {
+            m_Truncated = true;
+            return std::nullopt;
+        }
+
+        m_Offset += length;
+        const std::span<const uint8_t> body = rest.subspan(8, length - 12);
+
+        if (type == kPcapNgInterfaceDescription && body.size() >= 8)
+        {
+            ReadInterfaceDescription(body);
+        }
+        else if (type == kPcapNgEnhancedPacket && body.size() >= 20)
+        {
+            const uint32_t ifaceId = Read32(body, 0);
+            const size_t   captured = Read32(body, 12);
+            if (ifaceId >= m_Interfaces.size() || captured > body.size() - 20)
+                continue;
+
+            const Interface& iface = m_Interfaces[ifaceId];
+            const uint64_t ticks = (uint64_t(Read32(body, 4)) << 32) | Read32(body, 8);
+            if (auto packet = ParsePacket(iface.linkType, ToNanoseconds(ticks, iface.tsUnitsPerSecond), body.subspan(20, captured)))
+                return packet;
+        }
+        else if (type == kPcapNgSimplePacket && body.size() >= 4 && !m_Interfaces.empty())
+        {
+            // No timestamp, and always interface 0.
+            const size_t captured = std::min<size_t>(Read32(body, 0), body.size() - 4);
+            if (auto packet = ParsePacket(m_Interfaces[0].linkType, 0, body.subspan(4, captured)))
+                return packet;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<UsbmonPacket> UsbmonCaptureReader::ParsePacket(uint16_t linkType, uint64_t timestamp, std::span<const uint8_t> data) const
+{
+    size_t headerSize;
+    if (linkType == kLinkTypeUsbLinux)
+        headerSize = kUsbmonHeaderSize;
+    else if (linkType == kLinkTypeUsbLinuxMmapped)
+        headerSize = kUsbmonMmappedHeaderSize;
+    else
+        return std::nullopt;
+
+    if (data.size() < headerSize)
+        return std::nullopt;
+
+    // struct mon_bin_hdr, Documentation/usb/usbmon.rst
+    UsbmonPacket packet;
+    packet.urbId = Read64(data, 0);
+    packet.eventType = static_cast<char>(data[8]);
+    packet.transferType = data[9];
+    packet.endpoint = data[10];
+    packet.device = data[11];
+    packet.bus = Read16(data, 12);
+    packet.hasSetup = data[14] == 0;
+    packet.status = static_cast<int32_t>(Read32(data, 28));
+    packet.timestamp = timestamp;
+    std::copy_n(data.begin() + 40, packet.setup.size(), packet.setup.begin());
+
+    // Isochronous descriptors come before the data in the mmapped format.
+    size_t dataOffset = headerSize;
+    if (linkType == kLinkTypeUsbLinuxMmapped && packet.transferType == UsbmonPacket::Isochronous)
+        dataOffset += static_cast<size_t>(Read32(data, 60)) * kIsoDescriptorSize;
+
+    const size_t captured = Read32(data, 36);
+    if (data[15] == 0 && dataOffset < data.size())
+        packet.data = data.subspan(dataOffset, std::min(captured, data.size() - dataOffset));
+
+    return packet;
+}
+
+// ---------------------------------------------------------------------------
+// UsbmonHidImporter
+// ---------------------------------------------------------------------------
+
+void UsbmonHidImporter::Feed(const UsbmonPacket& packet, Sink& sink)
+{
+    ++m_Stats.packets;
+
+    const DeviceKey device = (uint32_t(packet.bus) << 8) | packet.device;
+
+    if (packet.transferType == UsbmonPacket::Control)
+    {
+        if (packet.eventType == 'S')
+        {
+            // A submission with the same URB ID replaces an unanswered one.
+            m_PendingControl.erase(packet.urbId);
+            if (!packet.hasSetup)
+                return;
+
+            const uint8_t  bmRequestType = packet.setup[0];
+            const uint8_t  bRequest = packet.setup[1];
+            const uint8_t  descriptorType = packet.setup[3];
+            const uint16_t wIndex = static_cast<uint16_t>(packet.setup[4] | (packet.setup[5] << 8));
+            if (bRequest != kRequestGetDescriptor || !(bmRequestType & kRequestDirectionIn))
+                return;
+
+            const uint8_t recipient = bmRequestType & kRequestRecipientMask;
+            if ((descriptorType == UsbDescriptorType_HidReport && recipient == kRequestRecipientInterface)
+                || (descriptorType == UsbDescriptorType_Configuration && recipient == kRequestRecipientDevice))
+                m_PendingControl[packet.urbId] = PendingControl{ descriptorType, wIndex };
+            return;
+        }
+
+        auto it = m_PendingControl.find(packet.urbId);
+        if (it == m_PendingControl.end())
+            return;
+
+        const PendingControl pending = it->second;
+        m_PendingControl.erase(it);
+        if (packet.eventType != 'C' || packet.status != 0 || packet.data.empty())
+            return;
+
+        if (pending.descriptorType == UsbDescriptorType_HidReport)
+        {
+            ++m_Stats.descriptors;
+            sink.OnReportDescriptor(InterfaceKey{ packet.bus, packet.device, static_cast<uint8_t>(pending.index) }, packet.data);
+        }
+        else
+        {
+            OnConfigurationDescriptor(device, packet.data);
+        }
+        return;
+    }
+
+    if (packet.transferType == UsbmonPacket::Interrupt && packet.IsIn() && packet.eventType == 'C'
+        && packet.status == 0 && !packet.data.empty())
+    {
+        ++m_Stats.reports;
+        m_Stats.bytes += packet.data.size();
+        sink.OnReport(InterfaceKey{ packet.bus, packet.device, GetInterface(device, packet.endpoint) }, packet.timestamp, packet.data);
+    }
+}
+
+void UsbmonHidImporter::Import(UsbmonCaptureReader& reader, Sink& sink)
+{
+    while (std::optional<UsbmonPacket> packet = reader.Next())
+        Feed(*packet, sink);
+}
+
+void UsbmonHidImporter::OnConfigurationDescriptor(DeviceKey device, std::span<const uint8_t> data)
+{
+    std::array<uint8_t, 16> interfaces;
+    interfaces.fill(kUnknownInterface);
+
+    // The first request usually asks for the 9-byte header only; it has
+    // no endpoints and changes nothing.
+    bool found = false;
+    uint8_t interfaceNumber = kUnknownInterface;
+    for (const UsbDescriptorView& desc : UsbDescriptorList(data))
+    {
+        if (desc.type == UsbDescriptorType_Interface)
+        {
+            if (auto iface = ParseUsbInterfaceDescriptor(desc.data))
+                interfaceNumber = iface->bInterfaceNumber;
+        }
+        else if (desc.type == UsbDescriptorType_Endpoint)
+        {
+            auto endpoint = ParseUsbEndpointDescriptor(desc.data);
+            if (endpoint && endpoint->IsIn())
+            {
+                interfaces[endpoint->bEndpointAddress & 0x0F] = interfaceNumber;
+                found = true;
+            }
+        }
+    }
+
+    if (found)
+        m_EndpointInterfaces[device] = interfaces;
+}
+
+uint8_t UsbmonHidImporter::GetInterface(DeviceKey device, uint8_t endpoint) const
+{
+    auto it = m_EndpointInterfaces.find(device);
+    if (it == m_EndpointInterfaces.end())
+        return kUnknownInterface;
+
+    return it->second[endpoint & 0x0F];
+}
+
+// ---------------------------------------------------------------------------
+// UsbmonHidDevice
+// ---------------------------------------------------------------------------
+
+SyntheticInputBackend::DeviceSpec UsbmonHidDevice::ToDeviceSpec() const
+{
+    SyntheticInputBackend::DeviceSpec spec;
+    spec.type = InputBackend::DeviceType::Hid;
+
+    char path[64];
+    std::snprintf(path, sizeof(path), "usbmon:%u:%u:%u", unsigned(key.bus), unsigned(key.device), unsigned(key.interfaceNumber));
+    spec.interfacePath = path;
+
+    if (reports.size() > 1 && lastTimestamp > firstTimestamp)
+        spec.reportRate = double(reports.size() - 1) * 1e9 / double(lastTimestamp - firstTimestamp);
+
+    spec.packets = reports;
+    spec.reportDescriptor = reportDescriptor;
+    return spec;
+}
+
+std::optional<std::vector<UsbmonHidDevice>> ImportUsbmonHidDevices(const std::string& path, size_t maxReports)
+{
+    std::optional<MappedFile> file = MappedFile::Open(path);
+    if (!file)
+        return std::nullopt;
+
+    file->AdviseSequential();
+
+    UsbmonCaptureReader reader(file->GetData());
+    if (!reader.IsValid())
+        return std::nullopt;
+
+    struct Collector : UsbmonHidImporter::Sink
+    {
+        size_t                               maxReports = 0;
+        std::vector<UsbmonHidDevice>         devices;
+        std::unordered_map<uint32_t, size_t> index;
+
+        UsbmonHidDevice& Get(const UsbmonHidImporter::InterfaceKey& key)
+        {
+            auto [it, inserted] = index.try_emplace(PackKey(key), devices.size());
+            if (inserted)
+                devices.emplace_back().key = key;
+            return devices[it->second];
+        }
+
+        void OnReportDescriptor(const UsbmonHidImporter::InterfaceKey& key, std::span<const uint8_t> descriptor) override
+        {
+            // The last one wins if the device was enumerated again.
+            Get(key).reportDescriptor.assign(descriptor.begin(), descriptor.end());
+        }
+
+        void OnReport(const UsbmonHidImporter::InterfaceKey& key, uint64_t timestamp, std::span<const uint8_t> report) override
+        {
+            UsbmonHidDevice& device = Get(key);
+            if (maxReports && device.reports.size() >= maxReports)
+                return;
+
+            if (device.reports.empty())
+                device.firstTimestamp = timestamp;
+            device.lastTimestamp = timestamp;
+            device.reports.emplace_back(report.begin(), report.end());
+        }
+    };
+
+    Collector collector;
+    collector.maxReports = maxReports;
+
+    UsbmonHidImporter importer;
+    importer.Import(reader, collector);
+
+    // Without a configuration descriptor reports have no interface. If the
+    // device has a single report descriptor, they are that interface's.
+    std::vector<UsbmonHidDevice>& devices = collector.devices;
+    for (UsbmonHidDevice& unknown : devices)
+    {
+        if (unknown.key.interfaceNumber != UsbmonHidImporter::kUnknownInterface || unknown.reports.empty())
+            continue;
+
+        UsbmonHidDevice* owner = nullptr;
+        size_t owners = 0;
+        for (UsbmonHidDevice& device : devices)
+        {
+            if (&device != &unknown && device.key.bus == unknown.key.bus && device.key.device == unknown.key.device && !device.reportDescriptor.empty())
+            {
+                owner = &device;
+                ++owners;
+            }
+        }
+
+        if (owners != 1 || !owner->reports.empty())
+            continue;
+
+        owner->reports = std::move(unknown.reports);
+        owner->firstTimestamp = unknown.firstTimestamp;
+        owner->lastTimestamp = unknown.lastTimestamp;
+        unknown.reports.clear();
+    }
+
+    std::erase_if(devices, [](const UsbmonHidDevice& device) { return device.reports.empty() && device.reportDescriptor.empty(); });
+    return std::move(devices);
+}
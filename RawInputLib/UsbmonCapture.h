@@ -0,0 +1,189 @@
+#pragma once
+
+#include "SyntheticInputBackend.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Linux usbmon captures (usbmon + tcpdump/Wireshark), read straight out of
+// the capture bytes.
+//
+// UsbmonCaptureReader walks the packets of a pcap or pcapng file with link
+// type LINUX_USB (189) or LINUX_USB_MMAPPED (220). UsbmonHidImporter picks
+// out the HID traffic: report descriptors from GET_DESCRIPTOR(Report)
+// control transfers and input reports from completed interrupt-IN transfers,
+// per interface. Neither copies packet data, so multi-GB captures can be
+// walked from a MappedFile with memory use bounded by the number of devices.
+
+// One usbmon event (struct mon_bin_hdr and the data captured after it).
+struct UsbmonPacket
+{
+    enum TransferType : uint8_t
+    {
+        Isochronous = 0,
+        Interrupt = 1,
+        Control = 2,
+        Bulk = 3,
+    };
+
+    uint64_t urbId = 0;
+    uint64_t timestamp = 0;    // capture time, ns since the epoch
+    char     eventType = 0;    // 'S'ubmit, 'C'omplete or 'E'rror
+    uint8_t  transferType = 0;
+    uint8_t  endpoint = 0;     // with the IN bit, 0x80
+    uint8_t  device = 0;
+    uint16_t bus = 0;
+    int32_t  status = 0;
+    bool     hasSetup = false;
+    std::array<uint8_t, 8> setup{};
+    std::span<const uint8_t> data;  // as captured; may be shorter than the transfer
+
+    bool IsIn() const { return (endpoint & 0x80) != 0; }
+};
+
+class UsbmonCaptureReader
+{
+public:
+    explicit UsbmonCaptureReader(std::span<const uint8_t> capture);
+
+    // False if the file is neither pcap nor pcapng.
+    bool IsValid() const { return m_Format != Format::Invalid; }
+
+    // The next usbmon packet. Packets of other link types are skipped.
+    // nullopt at the end of the capture or at the first malformed record.
+    std::optional<UsbmonPacket> Next();
+
+    // True if Next() stopped at a malformed or cut-off record.
+    bool IsTruncated() const { return m_Truncated; }
+
+    // Bytes consumed so far.
+    size_t GetOffset() const { return m_Offset; }
+
+private:
+    enum class Format
+    {
+        Invalid,
+        Pcap,
+        PcapNg,
+    };
+
+    struct Interface
+    {
+        uint16_t linkType = 0;
+        uint64_t tsUnitsPerSecond = 1'000'000;
+    };
+
+    std::optional<UsbmonPacket> NextPcap();
+    std::optional<UsbmonPacket> NextPcapNg();
+    bool ReadSectionHeader();
+    void ReadInterfaceDescription(std::span<const uint8_t> body);
+    std::optional<UsbmonPacket> ParsePacket(uint16_t linkType, uint64_t timestamp, std::span<const uint8_t> data) const;
+
+    uint16_t Read16(std::span<const uint8_t> data, size_t offset) const;
+    uint32_t Read32(std::span<const uint8_t> data, size_t offset) const;
+    uint64_t Read64(std::span<const uint8_t> data, size_t offset) const;
+
+    std::span<const uint8_t> m_Capture;
+    size_t                   m_Offset = 0;
+    Format                   m_Format = Format::Invalid;
+    bool                     m_Swapped = false; // file byte order differs from little-endian
+    bool                     m_Truncated = false;
+
+    // pcap
+    uint16_t m_LinkType = 0;
+    bool     m_Nanoseconds = false;
+
+    // pcapng, for the current section
+    std::vector<Interface> m_Interfaces;
+};
+
+// Collects HID report descriptors and input reports per interface.
+class UsbmonHidImporter
+{
+public:
+    static constexpr uint8_t kUnknownInterface = 0xFF;
+
+    struct InterfaceKey
+    {
+        uint16_t bus = 0;
+        uint8_t  device = 0;
+        uint8_t  interfaceNumber = kUnknownInterface; // if no configuration descriptor was captured
+
+        bool operator==(const InterfaceKey&) const = default;
+    };
+
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+
+        // Spans point into the capture.
+        virtual void OnReportDescriptor(const InterfaceKey& key, std::span<const uint8_t> descriptor) = 0;
+        virtual void OnReport(const InterfaceKey& key, uint64_t timestamp, std::span<const uint8_t> report) = 0;
+    };
+
+    struct Stats
+    {
+        uint64_t packets = 0;
+        uint64_t descriptors = 0;
+        uint64_t reports = 0;
+        uint64_t bytes = 0; // of reports
+    };
+
+    void Feed(const UsbmonPacket& packet, Sink& sink);
+
+    // Reads every packet of `reader` into `sink`.
+    void Import(UsbmonCaptureReader& reader, Sink& sink);
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    // bus << 8 | device
+    using DeviceKey = uint32_t;
+
+    struct PendingControl
+    {
+        uint8_t  descriptorType = 0;
+        uint16_t index = 0; // wIndex: the interface for report descriptors
+    };
+
+    void OnConfigurationDescriptor(DeviceKey device, std::span<const uint8_t> data);
+    uint8_t GetInterface(DeviceKey device, uint8_t endpoint) const;
+
+    // Interface of each IN endpoint (address & 0x0F), from the configuration
+    // descriptor.
+    std::unordered_map<DeviceKey, std::array<uint8_t, 16>> m_EndpointInterfaces;
+
+    // GET_DESCRIPTOR submissions waiting for their completion, by URB ID.
+    std::unordered_map<uint64_t, PendingControl> m_PendingControl;
+
+    Stats m_Stats;
+};
+
+// A captured HID interface, ready to replay through SyntheticInputBackend.
+// Reports are as the device sent them, so an InputPipeline over that backend
+// decodes them with the captured descriptor, through the same
+// HidReportDecoder RawInputDeviceHid uses.
+struct UsbmonHidDevice
+{
+    UsbmonHidImporter::InterfaceKey   key;
+    std::vector<uint8_t>              reportDescriptor;
+    std::vector<std::vector<uint8_t>> reports;
+    uint64_t                          firstTimestamp = 0;
+    uint64_t                          lastTimestamp = 0;
+
+    // Replays the reports in a loop at their average captured rate; set
+    // Config::packetLimit to the report count to replay them once.
+    SyntheticInputBackend::DeviceSpec ToDeviceSpec() const;
+};
+
+// Maps the capture at `path` and collects every HID interface in it, keeping
+// at most `maxReports` reports of each (0 for all). nullopt if the file
+// cannot be mapped or is not a capture.
+std::optional<std::vector<UsbmonHidDevice>> ImportUsbmonHidDevices(const std::string& path, size_t maxReports = 0);
@@ -0,0 +1,262 @@
+#include "pch.h"
+#include "framework.h"
+
+#include "Win32InputBackend.h"
+
+#include "RawInputDevice.h"
+
+namespace
+{
+    // Window class name for the message-only sink window.
+    constexpr LPCWSTR RAW_SINK_CLASS = L"RawInputSink";
+
+    constexpr UINT_PTR kWakeupTimerId = 1;
+
+    // Posted when m_Tasks goes from empty to non-empty.
+    constexpr UINT WM_RUN_TASKS = WM_APP + 1;
+}
+
+Win32InputBackend::~Win32InputBackend()
+{
+    DCHECK(!m_Thread.joinable());
+}
+
+void Win32InputBackend::Start(Listener& listener)
+{
+    m_Listener = &listener;
+
+    // The worker thread signals readiness by calling promise.set_value(); we
+    // block on future.get() until that happens.
+    std::promise<void> readyPromise;
+    std::future<void>  readyFuture = readyPromise.get_future();
+
+    m_Thread = std::thread(&Win32InputBackend::ThreadRun, this, std::move(readyPromise));
+
+    // Block until the worker thread has created the window, registered
+    // devices, and the listener has finished OnStarted().
+    readyFuture.get();
+}
+
+void Win32InputBackend::Stop()
+{
+    {
+        std::lock_guard lock(m_TasksMutex);
+        m_Stopping = true;
+    }
+
+    ::PostMessageW(m_hWnd, WM_QUIT, 0, 0);
+    m_Thread.join();
+}
+
+void Win32InputBackend::Post(std::function<void()> task)
+{
+    bool wasEmpty;
+    {
+        std::lock_guard lock(m_TasksMutex);
+        if (m_Stopping)
+            return;
+
+        wasEmpty = m_Tasks.empty();
+        m_Tasks.push_back(std::move(task));
+    }
+
+    if (wasEmpty)
+        ::PostMessageW(m_hWnd, WM_RUN_TASKS, 0, 0);
+}
+
+void Win32InputBackend::RunPostedTasks()
+{
+    std::deque<std::function<void()>> tasks;
+    {
+        std::lock_guard lock(m_TasksMutex);
+        tasks.swap(m_Tasks);
+    }
+
+    for (auto& task : tasks)
+        task();
+}
+
+void Win32InputBackend::ScheduleWakeup(Clock::duration delay)
+{
+    // Re-arming replaces the previous timeout.
+    const auto wait = std::chrono::ceil<std::chrono::milliseconds>(delay);
+    ::SetTimer(m_hWnd, kWakeupTimerId, static_cast<UINT>(std::max<int64_t>(wait.count(), USER_TIMER_MINIMUM)), nullptr);
+}
+
+void Win32InputBackend::CancelWakeup()
+{
+    ::KillTimer(m_hWnd, kWakeupTimerId);
+}
+
+LRESULT CALLBACK Win32InputBackend::WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    if (uMsg == WM_NCCREATE)
+    {
+        auto* cs = reinterpret_cast<CREATESTRUCTW*>(lParam);
+        ::SetWindowLongPtrW(hWnd, GWLP_USERDATA,
+            reinterpret_cast<LONG_PTR>(cs->lpCreateParams));
+        return ::DefWindowProcW(hWnd, uMsg, wParam, lParam);
+    }
+
+    auto* self = reinterpret_cast<Win32InputBackend*>(
+        ::GetWindowLongPtrW(hWnd, GWLP_USERDATA));
+
+    if (!self)
+        return ::DefWindowProcW(hWnd, uMsg, wParam, lParam);
+
+    switch (uMsg)
+    {
+    case WM_INPUT:
+        self->OnRawInput(reinterpret_cast<HRAWINPUT>(lParam));
+        return 0;
+
+    case WM_INPUT_DEVICE_CHANGE:
+        if (wParam == GIDC_ARRIVAL)
+            self->m_Listener->OnDeviceArrived(ToDeviceHandle(reinterpret_cast<HANDLE>(lParam)));
+        else
+            self->m_Listener->OnDeviceRemoved(ToDeviceHandle(reinterpret_cast<HANDLE>(lParam)));
+        return 0;
+
+    case WM_TIMER:
+        if (wParam == kWakeupTimerId)
+        {
+            // One-shot, like ScheduleWakeup() promises.
+            ::KillTimer(hWnd, kWakeupTimerId);
+            self->m_Listener->OnWakeup();
+            return 0;
+        }
+        break;
+
+    case WM_RUN_TASKS:
+        self->RunPostedTasks();
+        return 0;
+    }
+
+    return ::DefWindowProcW(hWnd, uMsg, wParam, lParam);
+}
+
+void Win32InputBackend::ThreadRun(std::promise<void> readyPromise)
+{
+    HINSTANCE hInstance = ::GetModuleHandleW(nullptr);
+
+    WNDCLASSEXW wc = { sizeof(wc) };
+    wc.lpfnWndProc = &Win32InputBackend::WindowProc;
+    wc.hInstance = hInstance;
+    wc.lpszClassName = RAW_SINK_CLASS;
+    ::RegisterClassExW(&wc);
+
+    m_hWnd = ::CreateWindowExW(0, RAW_SINK_CLASS, nullptr, 0,
+        0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, this);
+    CHECK(IsValidHandle(m_hWnd));
+
+    CHECK(Register());
+
+    m_Listener->OnStarted();
+
+    readyPromise.set_value();
+
+    MSG msg;
+    while (::GetMessageW(&msg, nullptr, 0, 0) > 0)
+    {
+        ::DispatchMessageW(&msg);
+    }
+
+    m_Listener->OnStopping();
+
+    ::KillTimer(m_hWnd, kWakeupTimerId);
+    CHECK(Unregister());
+    CHECK(::DestroyWindow(m_hWnd));
+    m_hWnd = nullptr;
+
+    ::UnregisterClassW(RAW_SINK_CLASS, hInstance);
+}
+
+void Win32InputBackend::OnRawInput(HRAWINPUT hRawInput)
+{
+    UINT size = static_cast<UINT>(m_InputBuffer.size());
+    while (::GetRawInputData(hRawInput, RID_INPUT, m_InputBuffer.data(), &size, sizeof(RAWINPUTHEADER)) == UINT_MAX)
+    {
+        if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+            return;
+
+        // Buffer too small — size is updated by GetRawInputData to required size
+        m_InputBuffer.resize(size);
+    }
+
+    const RAWINPUT* input = reinterpret_cast<const RAWINPUT*>(m_InputBuffer.data());
+    m_Listener->OnInput(ToDeviceHandle(input->header.hDevice),
+        static_cast<DeviceType>(input->header.dwType),
+        std::span<const uint8_t>(m_InputBuffer.data(), input->header.dwSize));
+}
+
+bool Win32InputBackend::SetDeviceEnabled(USHORT usUsage, bool enabled)
+{
+    RAWINPUTDEVICE rid =
+    {
+        HID_USAGE_PAGE_GENERIC,
+        usUsage,
+        enabled ? DWORD(RIDEV_DEVNOTIFY | RIDEV_INPUTSINK)
+                : RIDEV_REMOVE,
+        enabled ? m_hWnd : nullptr
+    };
+
+    return ::RegisterRawInputDevices(&rid, 1, sizeof(RAWINPUTDEVICE));
+}
+
+bool Win32InputBackend::Register()
+{
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_MOUSE, true));
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_KEYBOARD, true));
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_GAMEPAD, true));
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_JOYSTICK, true));
+
+    return true;
+}
+
+bool Win32InputBackend::Unregister()
+{
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_MOUSE, false));
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_KEYBOARD, false));
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_GAMEPAD, false));
+    CHECK(SetDeviceEnabled(HID_USAGE_GENERIC_JOYSTICK, false));
+
+    return true;
+}
+
+std::vector<InputBackend::DeviceHandle> Win32InputBackend::EnumerateDevices()
+{
+    std::vector<RAWINPUTDEVICELIST> deviceList(32);
+    UINT count = static_cast<UINT>(deviceList.size());
+    UINT result;
+
+    while ((result = ::GetRawInputDeviceList(deviceList.data(), &count, sizeof(RAWINPUTDEVICELIST))) == UINT_MAX)
+    {
+        if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+        {
+            DBGPRINT("GetRawInputDeviceList() failed. GetLastError=%d", ::GetLastError());
+            return {};
+        }
+
+        // Buffer too small — count is updated by GetRawInputDeviceList to required count
+        deviceList.resize(count);
+    }
+
+    std::vector<DeviceHandle> handles;
+    handles.reserve(result);
+    for (UINT i = 0; i < result; ++i)
+        handles.push_back(ToDeviceHandle(deviceList[i].hDevice));
+
+    return handles;
+}
+
+std::optional<InputBackend::DeviceInfo> Win32InputBackend::GetDeviceInfo(DeviceHandle handle)
+{
+    RID_DEVICE_INFO deviceInfo;
+    if (!RawInputDevice::QueryRawDeviceInfo(FromDeviceHandle(handle), &deviceInfo))
+        return std::nullopt;
+
+    DeviceInfo info;
+    info.type = static_cast<DeviceType>(deviceInfo.dwType);
+    info.interfacePath = RawInputDevice::QueryRawDeviceInterfacePath(FromDeviceHandle(handle));
+    return info;
+}
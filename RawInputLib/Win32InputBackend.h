@@ -0,0 +1,56 @@
+#pragma once
+
+#include "InputBackend.h"
+
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// Raw Input: a message-only window on its own thread, registered for mice,
+// keyboards, gamepads and joysticks with RIDEV_DEVNOTIFY | RIDEV_INPUTSINK.
+// Handles are the raw input HANDLEs and packets are the RAWINPUT returned by
+// GetRawInputData.
+class Win32InputBackend : public InputBackend
+{
+public:
+    Win32InputBackend() = default;
+    ~Win32InputBackend() override;
+
+    Win32InputBackend(const Win32InputBackend&) = delete;
+    void operator=(const Win32InputBackend&) = delete;
+
+    void Start(Listener& listener) override;
+    void Stop() override;
+    void Post(std::function<void()> task) override;
+
+    void ScheduleWakeup(Clock::duration delay) override;
+    void CancelWakeup() override;
+
+    std::vector<DeviceHandle> EnumerateDevices() override;
+    std::optional<DeviceInfo> GetDeviceInfo(DeviceHandle handle) override;
+
+    static DeviceHandle ToDeviceHandle(HANDLE handle) { return reinterpret_cast<uintptr_t>(handle); }
+    static HANDLE FromDeviceHandle(DeviceHandle handle) { return reinterpret_cast<HANDLE>(static_cast<uintptr_t>(handle)); }
+
+private:
+    static LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+
+    void ThreadRun(std::promise<void> readyPromise);
+    void OnRawInput(HRAWINPUT hRawInput);
+    void RunPostedTasks();
+
+    bool SetDeviceEnabled(USHORT usUsage, bool enabled);
+    bool Register();
+    bool Unregister();
+
+    Listener*   m_Listener = nullptr;
+    std::thread m_Thread;
+    HWND        m_hWnd = nullptr;
+
+    std::vector<BYTE> m_InputBuffer = std::vector<BYTE>(sizeof(RAWINPUT) + 64, 0);
+
+    std::mutex                        m_TasksMutex;
+    std::deque<std::function<void()>> m_Tasks;
+    bool                              m_Stopping = false;
+};
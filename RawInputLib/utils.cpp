@@ -98,6 +98,25 @@ namespace utf8
         out.resize((size_t)wsz - 1); //output is null-terminated
         return out;
     }
+
+    /*!
+      Conversion from UTF-8 to wide character
+      \param  s input string, not necessarily null-terminated
+      \return wide character string
+    */
+    std::wstring widen(std::string_view s)
+    {
+        if (s.empty())
+            return wstring();
+
+        int wsz = MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), 0, 0);
+        if (!wsz)
+            return wstring();
+
+        wstring out(wsz, 0);
+        MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), &out[0], wsz);
+        return out;
+    }
 }
 
 namespace stringutils
@@ -347,7 +366,7 @@ bool GetLayoutProfile(const std::string& layoutProfileId, LAYOUTORTIPPROFILE* ou
     std::vector<LAYOUTORTIPPROFILE> layouts = EnumLayoutProfiles();
     for (const auto& layout : layouts)
     {
-        if (stringutils::ci_wstring(layout.szId).compare(tmp.c_str()) != 0)
+        if (!stringutils::equals_ci(layout.szId, tmp))
             continue;
 
         std::memcpy(outProfile, &layout, sizeof(layout));
@@ -2,6 +2,7 @@
 
 #pragma warning(push, 0)
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -11,6 +12,8 @@
 #include <optional>
 #pragma warning(pop)
 
+#include "utils_simd.h"
+
 // UTF8<=>UTF16 conversion functions
 // recommended at http://utf8everywhere.org/#how.cvt
 namespace utf8
@@ -20,6 +23,7 @@ namespace utf8
 
     std::wstring widen(const char* s, size_t nch = 0);
     std::wstring widen(const std::string& s);
+    std::wstring widen(std::string_view s);
 }
 
 namespace stringutils
@@ -28,41 +32,37 @@ namespace stringutils
 
     // case-insensitive string
     // http://www.gotw.ca/gotw/029.htm
+    //
+    // Narrow strings are UTF-8, so only ASCII letters are folded: folding the
+    // bytes of a multi-byte sequence one by one would be meaningless. Wide
+    // strings fold ASCII the same way and everything else through towupper.
+    // compare/find run on the simd:: kernels.
     struct ci_char_traits : public std::char_traits<char> {
         static char to_upper(char ch) {
-            return (char)std::toupper((unsigned char)ch);
+            return (ch >= 'a' && ch <= 'z') ? static_cast<char>(ch - 0x20) : ch;
         }
         static bool eq(char c1, char c2) {
             return to_upper(c1) == to_upper(c2);
         }
         static bool lt(char c1, char c2) {
-            return to_upper(c1) < to_upper(c2);
+            return static_cast<unsigned char>(to_upper(c1)) < static_cast<unsigned char>(to_upper(c2));
         }
         static int compare(const char* s1, const char* s2, std::size_t n) {
-            while (n-- != 0) {
-                if (to_upper(*s1) < to_upper(*s2)) return -1;
-                if (to_upper(*s1) > to_upper(*s2)) return 1;
-                ++s1; ++s2;
-            }
-            return 0;
+            return simd::CompareNoCase(s1, s2, n);
         }
         static const char* find(const char* s, std::size_t n, char a) {
-            auto const ua(to_upper(a));
-            while (n-- != 0)
-            {
-                if (to_upper(*s) == ua)
-                    return s;
-                s++;
-            }
-            return nullptr;
+            return simd::FindCharNoCase(s, n, a);
         }
     };
 
     typedef std::basic_string<char, ci_char_traits> ci_string;
+    typedef std::basic_string_view<char, ci_char_traits> ci_string_view;
 
     struct ci_wchar_traits : public std::char_traits<wchar_t> {
-        static char to_upper(wchar_t ch) {
-            return (char)std::towupper(ch);
+        static wchar_t to_upper(wchar_t ch) {
+            if (ch < 0x80)
+                return (ch >= L'a' && ch <= L'z') ? static_cast<wchar_t>(ch - 0x20) : ch;
+            return static_cast<wchar_t>(std::towupper(ch));
         }
         static bool eq(wchar_t c1, wchar_t c2) {
             return to_upper(c1) == to_upper(c2);
@@ -71,12 +71,7 @@ namespace stringutils
             return to_upper(c1) < to_upper(c2);
         }
         static int compare(const wchar_t* s1, const wchar_t* s2, std::size_t n) {
-            while (n-- != 0) {
-                if (to_upper(*s1) < to_upper(*s2)) return -1;
-                if (to_upper(*s1) > to_upper(*s2)) return 1;
-                ++s1; ++s2;
-            }
-            return 0;
+            return simd::CompareNoCase(s1, s2, n);
         }
         static const wchar_t* find(const wchar_t* s, std::size_t n, wchar_t a) {
             auto const ua(to_upper(a));
@@ -91,6 +86,39 @@ namespace stringutils
     };
 
     typedef std::basic_string<wchar_t, ci_wchar_traits> ci_wstring;
+    typedef std::basic_string_view<wchar_t, ci_wchar_traits> ci_wstring_view;
+
+    // Case-insensitive views of plain strings, without copying them into a ci_string.
+    inline ci_string_view as_ci(std::string_view s) { return { s.data(), s.size() }; }
+    inline ci_wstring_view as_ci(std::wstring_view s) { return { s.data(), s.size() }; }
+
+    inline bool equals_ci(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && simd::CompareNoCase(a.data(), b.data(), a.size()) == 0;
+    }
+    inline bool equals_ci(std::wstring_view a, std::wstring_view b) {
+        return a.size() == b.size() && simd::CompareNoCase(a.data(), b.data(), a.size()) == 0;
+    }
+
+    // Offset of `needle` in `haystack`, or std::string_view::npos.
+    inline size_t find_ci(std::string_view haystack, std::string_view needle) {
+        const size_t pos = simd::FindNoCase(haystack.data(), haystack.size(), needle.data(), needle.size());
+        return pos == SIZE_MAX ? std::string_view::npos : pos;
+    }
+    inline bool contains_ci(std::string_view haystack, std::string_view needle) {
+        return find_ci(haystack, needle) != std::string_view::npos;
+    }
+
+    // Consistent with equals_ci, for case-insensitive hash containers.
+    struct ci_hash {
+        size_t operator()(std::string_view s) const {
+            return static_cast<size_t>(simd::HashNoCase(s.data(), s.size()));
+        }
+    };
+    struct ci_equal {
+        bool operator()(std::string_view a, std::string_view b) const {
+            return equals_ci(a, b);
+        }
+    };
 }
 
 inline bool IsValidHandle(void* handle)
@@ -109,7 +137,7 @@ struct ScopedHandleDeleter
 
 typedef std::unique_ptr<void, ScopedHandleDeleter> ScopedHandle;
 
-inline ScopedHandle OpenDeviceInterface(const std::string& deviceInterface, bool readOnly = false)
+inline ScopedHandle OpenDeviceInterface(std::string_view deviceInterface, bool readOnly = false)
 {
     DWORD desired_access = readOnly ? 0 : (GENERIC_WRITE | GENERIC_READ);
     DWORD share_mode = FILE_SHARE_READ | FILE_SHARE_WRITE;
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+// Computes the size of a block that will be carved by MonotonicArena::Allocate
+// in the same order. Use it to size the block exactly before Reserve().
+class ArenaLayout
+{
+public:
+    template<typename T>
+    ArenaLayout& Add(size_t count)
+    {
+        m_Bytes = AlignUp(m_Bytes, alignof(T)) + sizeof(T) * count;
+        return *this;
+    }
+
+    size_t GetBytes() const { return m_Bytes; }
+
+    static constexpr size_t AlignUp(size_t offset, size_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+private:
+    size_t m_Bytes = 0;
+};
+
+// Bump allocator over one contiguous block.
+//
+// The block lives inline in the owning object when it fits into InlineBytes;
+// otherwise Reserve() makes exactly one heap allocation of the requested size.
+// Individual allocations are never freed — the whole block is dropped on the
+// next Reserve() or on destruction — so only trivially destructible types
+// may be allocated.
+template<size_t InlineBytes>
+class MonotonicArena
+{
+public:
+    MonotonicArena() = default;
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    void operator=(const MonotonicArena&) = delete;
+
+    // Drops all previous allocations and makes room for `bytes` bytes.
+    void Reserve(size_t bytes)
+    {
+        m_Heap.reset();
+        m_Used = 0;
+
+        if (bytes <= InlineBytes)
+        {
+            m_Begin = m_Inline;
+            m_Capacity = InlineBytes;
+        }
+        else
+        {
+            // operator new[] already guarantees max_align_t alignment.
+            m_Heap = std::make_unique_for_overwrite<std::byte[]>(bytes);
+            m_Begin = m_Heap.get();
+            m_Capacity = bytes;
+        }
+    }
+
+    // Value-initialised storage for `count` objects. Aborts if the block
+    // reserved by Reserve() is too small — size it with ArenaLayout.
+    template<typename T>
+    std::span<T> Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+        static_assert(alignof(T) <= kAlignment, "over-aligned type");
+
+        if (count == 0)
+            return {};
+
+        const size_t offset = ArenaLayout::AlignUp(m_Used, alignof(T));
+        if (offset + sizeof(T) * count > m_Capacity)
+            std::abort(); // layout and allocation order disagree
+
+        T* first = reinterpret_cast<T*>(m_Begin + offset);
+        for (size_t i = 0; i < count; ++i)
+            new (first + i) T{};
+
+        m_Used = offset + sizeof(T) * count;
+        return { first, count };
+    }
+
+    bool   IsInline()    const { return m_Begin == m_Inline; }
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetUsed()     const { return m_Used; }
+
+private:
+    static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+    alignas(kAlignment) std::byte m_Inline[InlineBytes];
+    std::unique_ptr<std::byte[]>  m_Heap;
+
+    std::byte* m_Begin = m_Inline;
+    size_t     m_Capacity = InlineBytes;
+    size_t     m_Used = 0;
+};
+
+// Growable bump allocator for data whose total size is only known once it has
+// all been produced, such as strings queried one by one from the system.
+//
+// Memory comes in blocks: the first one is `firstBlockBytes`, and a request
+// that does not fit opens a new block at least as large as the previous one.
+// Sized for the common case, everything ends up in one or two blocks. As with
+// MonotonicArena, nothing is freed individually and only trivially
+// destructible types may be allocated.
+class ChunkedArena
+{
+public:
+    explicit ChunkedArena(size_t firstBlockBytes = 1024)
+        : m_NextBlockBytes(firstBlockBytes)
+    {}
+
+    ~ChunkedArena()
+    {
+        while (m_Head)
+        {
+            BlockHeader* next = m_Head->next;
+            ::operator delete(m_Head);
+            m_Head = next;
+        }
+    }
+
+    ChunkedArena(const ChunkedArena&) = delete;
+    void operator=(const ChunkedArena&) = delete;
+
+    template<typename T>
+    std::span<T> Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+        static_assert(alignof(T) <= kAlignment, "over-aligned type");
+
+        if (count == 0)
+            return {};
+
+        std::byte* p = AllocateBytes(sizeof(T) * count, alignof(T));
+        T* first = reinterpret_cast<T*>(p);
+        for (size_t i = 0; i < count; ++i)
+            new (first + i) T{};
+        return { first, count };
+    }
+
+    // Copies `s` into the arena; the view stays valid for the arena's lifetime.
+    // The copy is NUL-terminated, so view.data() can go to C APIs. Empty
+    // strings take no space and also yield a NUL-terminated "".
+    std::string_view CopyString(std::string_view s)
+    {
+        if (s.empty())
+            return "";
+
+        char* p = reinterpret_cast<char*>(AllocateBytes(s.size() + 1, 1));
+        std::memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        return { p, s.size() };
+    }
+
+    std::span<const uint8_t> CopyBytes(std::span<const uint8_t> bytes)
+    {
+        if (bytes.empty())
+            return {};
+
+        uint8_t* p = reinterpret_cast<uint8_t*>(AllocateBytes(bytes.size(), 1));
+        std::memcpy(p, bytes.data(), bytes.size());
+        return { p, bytes.size() };
+    }
+
+    size_t GetBlockCount()    const { return m_BlockCount; }
+    size_t GetUsedBytes()     const { return m_UsedBytes; }
+    size_t GetReservedBytes() const { return m_ReservedBytes; }
+
+private:
+    static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+    struct alignas(kAlignment) BlockHeader
+    {
+        BlockHeader* next = nullptr;
+    };
+
+    std::byte* AllocateBytes(size_t bytes, size_t alignment)
+    {
+        if (m_Head)
+        {
+            const size_t offset = ArenaLayout::AlignUp(m_HeadUsed, alignment);
+            if (offset + bytes <= m_HeadCapacity)
+            {
+                m_HeadUsed = offset + bytes;
+                m_UsedBytes += bytes;
+                return reinterpret_cast<std::byte*>(m_Head + 1) + offset;
+            }
+        }
+
+        // Blocks never shrink, so a burst of large strings does not keep
+        // opening new blocks.
+        const size_t capacity = std::max(bytes, m_NextBlockBytes);
+        m_NextBlockBytes = capacity;
+
+        void* memory = ::operator new(sizeof(BlockHeader) + capacity);
+        m_Head = new (memory) BlockHeader{ m_Head };
+        m_HeadCapacity = capacity;
+        m_HeadUsed = bytes;
+        ++m_BlockCount;
+        m_ReservedBytes += capacity;
+        m_UsedBytes += bytes;
+        return reinterpret_cast<std::byte*>(m_Head + 1);
+    }
+
+    // The head block's fill level lives here rather than in its header, so
+    // the fast path reads no heap memory and the compiler can bound the
+    // pointer it returns against the block it came from.
+    BlockHeader* m_Head = nullptr;
+    size_t       m_HeadCapacity = 0;
+    size_t       m_HeadUsed = 0;
+    size_t       m_NextBlockBytes = 0;
+    size_t       m_BlockCount = 0;
+    size_t       m_UsedBytes = 0;      // payload bytes, alignment padding excluded
+    size_t       m_ReservedBytes = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Helpers for bit sets stored as packed 64-bit words (bit i lives in
+// word i / 64, bit i % 64). All operations work on whole words; callers size
+// every span involved in one operation identically.
+
+constexpr size_t BitWordCount(size_t bits)
+{
+    return (bits + 63) / 64;
+}
+
+inline bool TestBit(std::span<const uint64_t> words, size_t i)
+{
+    return (words[i >> 6] >> (i & 63)) & 1;
+}
+
+inline void AssignBit(std::span<uint64_t> words, size_t i, bool on)
+{
+    const uint64_t bit = uint64_t(1) << (i & 63);
+    uint64_t& w = words[i >> 6];
+    w = on ? (w | bit) : (w & ~bit);
+}
+
+// True if any bit in [begin, end) is set.
+inline bool AnyBitInRange(std::span<const uint64_t> words, size_t begin, size_t end)
+{
+    while (begin < end)
+    {
+        const size_t w = begin >> 6;
+        const size_t lo = begin & 63;
+        const size_t hi = (w == ((end - 1) >> 6)) ? ((end - 1) & 63) : 63;
+        const uint64_t mask = (~uint64_t(0) >> (63 - hi)) & (~uint64_t(0) << lo);
+        if (words[w] & mask)
+            return true;
+        begin = (w + 1) << 6;
+    }
+    return false;
+}
+
+// words &= ~mask
+inline void ClearBits(std::span<uint64_t> words, std::span<const uint64_t> mask)
+{
+    for (size_t w = 0; w < words.size(); ++w)
+        words[w] &= ~mask[w];
+}
+
+// Accumulates transitions between two snapshots:
+// pressed |= after & ~before, released |= before & ~after.
+inline void AccumulateEdges(std::span<const uint64_t> before, std::span<const uint64_t> after,
+                            std::span<uint64_t> pressed, std::span<uint64_t> released)
+{
+    for (size_t w = 0; w < after.size(); ++w)
+    {
+        const uint64_t changed = before[w] ^ after[w];
+        pressed[w] |= changed & after[w];
+        released[w] |= changed & before[w];
+    }
+}
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "utils_hiddescriptor.h"
+#include "HidDescriptorItems.h"
 
 #include <windows.h>
 #include <hidsdi.h>   // HIDP_PREPARSED_DATA, HIDP_CAPS, etc.
@@ -142,182 +143,13 @@ struct HIDP_PRIVATE_LINK_COLLECTION_NODE {
 #pragma pack(pop)
 
 // ---------------------------------------------------------------------------
-// HID 1.11 short-item tag constants (table 6.2.2)
-// Lower 2 bits encode data size: 0=0B 1=1B 2=2B 3=4B — we fill them at emit.
+// Channel → item translation. Items and DescriptorWriter are in
+// HidDescriptorItems.h.
 // ---------------------------------------------------------------------------
 
-// Global items
-static constexpr UCHAR HID_USAGE_PAGE = 0x04;
-static constexpr UCHAR HID_LOG_MIN = 0x14;
-static constexpr UCHAR HID_LOG_MAX = 0x24;
-static constexpr UCHAR HID_PHY_MIN = 0x34;
-static constexpr UCHAR HID_PHY_MAX = 0x44;
-static constexpr UCHAR HID_UNIT_EXP = 0x54;
-static constexpr UCHAR HID_UNIT = 0x64;
-static constexpr UCHAR HID_REPORT_SIZE = 0x74;
-static constexpr UCHAR HID_REPORT_ID = 0x84;
-static constexpr UCHAR HID_REPORT_COUNT = 0x94;
-
-// Local items
-static constexpr UCHAR HID_USAGE = 0x08;
-static constexpr UCHAR HID_USAGE_MIN = 0x18;
-static constexpr UCHAR HID_USAGE_MAX = 0x28;
-static constexpr UCHAR HID_DESIGNATOR_INDEX = 0x38; // single designator
-static constexpr UCHAR HID_DESIGNATOR_MIN = 0x48; // designator range start
-static constexpr UCHAR HID_DESIGNATOR_MAX = 0x58; // designator range end
-static constexpr UCHAR HID_STRING_INDEX = 0x78; // single string
-static constexpr UCHAR HID_STRING_MIN = 0x88; // string range start
-static constexpr UCHAR HID_STRING_MAX = 0x98; // string range end
-static constexpr UCHAR HID_DELIMITER = 0xA8;
-
-// Main items
-static constexpr UCHAR HID_INPUT = 0x80;
-static constexpr UCHAR HID_OUTPUT = 0x90;
-static constexpr UCHAR HID_FEATURE = 0xB0;
-static constexpr UCHAR HID_COLLECTION = 0xA0;
-static constexpr UCHAR HID_END_COLLECTION = 0xC0; // 0-byte item
-
 // BitField flag: bit 1 clear = Array, bit 1 set = Variable
 static constexpr ULONG BITFIELD_VARIABLE = 0x02;
 
-// ---------------------------------------------------------------------------
-// Descriptor byte-stream builder
-// ---------------------------------------------------------------------------
-
-class DescriptorWriter {
-public:
-    // Unsigned item — always emits at least 1 data byte (val=0 → one 0x00 byte).
-    // force_bytes: 0=minimal(≥1), 1/2/4=exact width.
-    void itemU(UCHAR tag, ULONG val, int force_bytes = 0) {
-        int nb = (force_bytes > 0) ? force_bytes : minUnsignedBytes(val);
-        emitTagAndData(tag & 0xFC, val, nb);
-    }
-
-    // Signed item — sign-extended minimal encoding (0 → one 0x00 byte).
-    void itemS(UCHAR tag, LONG val) {
-        emitTagAndData(tag & 0xFC, static_cast<ULONG>(val), minSignedBytes(val));
-    }
-
-    // Raw bytes — for verbatim re-emission of unknown global tokens.
-    void raw(UCHAR b) { buf_.push_back(b); }
-    void raw(const void* p, size_t n) {
-        const auto* b = static_cast<const UCHAR*>(p);
-        for (size_t i = 0; i < n; ++i) buf_.push_back(b[i]);
-    }
-
-    const std::vector<UCHAR>& bytes() const { return buf_; }
-
-private:
-    std::vector<UCHAR> buf_;
-
-    void emitTagAndData(UCHAR base, ULONG val, int nb) {
-        switch (nb) {
-        case 0:
-            // Special case: 0-byte item (only valid for END_COLLECTION).
-            // For all other items we always emit ≥1 data byte.
-            buf_.push_back(base | 0);
-            break;
-        case 1:
-            buf_.push_back(base | 1);
-            buf_.push_back(static_cast<UCHAR>(val));
-            break;
-        case 2:
-            buf_.push_back(base | 2);
-            buf_.push_back(static_cast<UCHAR>(val));
-            buf_.push_back(static_cast<UCHAR>(val >> 8));
-            break;
-        default: // 4
-            buf_.push_back(base | 3);
-            buf_.push_back(static_cast<UCHAR>(val));
-            buf_.push_back(static_cast<UCHAR>(val >> 8));
-            buf_.push_back(static_cast<UCHAR>(val >> 16));
-            buf_.push_back(static_cast<UCHAR>(val >> 24));
-            break;
-        }
-    }
-
-    // Minimum bytes to represent v unsigned (always ≥ 1).
-    static int minUnsignedBytes(ULONG v) {
-        if (v <= 0xFF)   return 1;
-        if (v <= 0xFFFF) return 2;
-        return 4;
-    }
-
-    // Minimum bytes to represent v signed (always ≥ 1).
-    static int minSignedBytes(LONG v) {
-        if (v >= -128 && v <= 127)   return 1;
-        if (v >= -32768 && v <= 32767) return 2;
-        return 4;
-    }
-};
-
-// ---------------------------------------------------------------------------
-// Global item state — tracks last-emitted values to suppress redundant items.
-// Initialised to "nothing ever emitted" so first channel forces all globals.
-// ---------------------------------------------------------------------------
-
-struct GlobalState {
-    USHORT UsagePage = 0;
-    USHORT ReportSize = 0;
-    USHORT ReportCount = 0;
-    UCHAR  ReportID = 0xFF; // 0xFF = sentinel (never emitted)
-    LONG   LogMin = 1;    // intentionally ≠ any real 0 so first emit fires
-    LONG   LogMax = 0;
-    LONG   PhyMin = 1;
-    LONG   PhyMax = 0;
-    ULONG  UnitExp = 0xFFFFFFFF;
-    ULONG  Unit = 0xFFFFFFFF;
-};
-
-// Emit only globals that changed; update prev in-place.
-// Report_ID(0) is never emitted — value 0 is reserved (HID 1.11 §6.2.2.7)
-// and the Windows parser explicitly rejects it (descript.c:1430).
-static void emitChangedGlobals(DescriptorWriter& w,
-    GlobalState& prev,
-    const GlobalState& cur)
-{
-    if (cur.ReportID != 0 && cur.ReportID != prev.ReportID) {
-        w.itemU(HID_REPORT_ID, cur.ReportID, 1);
-        prev.ReportID = cur.ReportID;
-    }
-    if (cur.UsagePage != prev.UsagePage) {
-        w.itemU(HID_USAGE_PAGE, cur.UsagePage, cur.UsagePage > 0xFF ? 2 : 1);
-        prev.UsagePage = cur.UsagePage;
-    }
-    if (cur.LogMin != prev.LogMin) {
-        w.itemS(HID_LOG_MIN, cur.LogMin);
-        prev.LogMin = cur.LogMin;
-    }
-    if (cur.LogMax != prev.LogMax) {
-        w.itemS(HID_LOG_MAX, cur.LogMax);
-        prev.LogMax = cur.LogMax;
-    }
-    if (cur.PhyMin != prev.PhyMin) {
-        w.itemS(HID_PHY_MIN, cur.PhyMin);
-        prev.PhyMin = cur.PhyMin;
-    }
-    if (cur.PhyMax != prev.PhyMax) {
-        w.itemS(HID_PHY_MAX, cur.PhyMax);
-        prev.PhyMax = cur.PhyMax;
-    }
-    if (cur.UnitExp != prev.UnitExp) {
-        w.itemU(HID_UNIT_EXP, cur.UnitExp);
-        prev.UnitExp = cur.UnitExp;
-    }
-    if (cur.Unit != prev.Unit) {
-        w.itemU(HID_UNIT, cur.Unit);
-        prev.Unit = cur.Unit;
-    }
-    if (cur.ReportSize != prev.ReportSize) {
-        w.itemU(HID_REPORT_SIZE, cur.ReportSize);
-        prev.ReportSize = cur.ReportSize;
-    }
-    if (cur.ReportCount != prev.ReportCount) {
-        w.itemU(HID_REPORT_COUNT, cur.ReportCount);
-        prev.ReportCount = cur.ReportCount;
-    }
-}
-
 // Extract a GlobalState snapshot from a channel descriptor.
 //
 // Two corrections applied here (not to the preparsed data itself):
@@ -758,6 +590,7 @@ static void emitCollection(DescriptorWriter& w,
     w.itemU(HID_USAGE_PAGE, node.LinkUsagePage,
         node.LinkUsagePage > 0xFF ? 2 : 1);
     gs.UsagePage = node.LinkUsagePage; // sync so first channel won't re-emit
+    gs.UsagePageEmitted = true;
 
     w.itemU(HID_USAGE, node.LinkUsage, node.LinkUsage > 0xFF ? 2 : 1);
     w.itemU(HID_COLLECTION, node.CollectionType, 1);
@@ -843,21 +676,9 @@ static void emitCollection(DescriptorWriter& w,
 // Public API
 // ---------------------------------------------------------------------------
 
-/**
- * ReconstructDescriptor
- *
- * Reconstructs a HID Report Descriptor from a HIDP_PREPARSED_DATA blob.
- * The result is functionally equivalent to the original: feeding it back to
- * HidP_GetCollectionDescription produces the same channel layout.
- *
- * The input blob is treated as read-only and is never modified.
- *
- * @param ppd     Pointer to preparsed data obtained from HidD_GetPreparsedData.
- * @param outDesc Receives the reconstructed descriptor bytes on success.
- * @return        true on success, false if the blob is invalid or empty.
- */
-bool ReconstructDescriptor(const PHIDP_PREPARSED_DATA ppd,
-    std::vector<UCHAR>& outDesc)
+// Emits the whole descriptor of `ppd` into `w`. False if the blob is not
+// preparsed data.
+static bool emitDescriptor(DescriptorWriter& w, const PHIDP_PREPARSED_DATA ppd)
 {
     if (!ppd) return false;
 
@@ -894,8 +715,7 @@ bool ReconstructDescriptor(const PHIDP_PREPARSED_DATA ppd,
     for (int k = 0; k < featCount && !hasReportIDs; ++k)
         if (featCh[k].ReportID != 0) hasReportIDs = true;
 
-    DescriptorWriter w;
-    GlobalState gs; // sentinel-initialised; forces emission of all globals
+    GlobalState gs; // nothing emitted yet; forces emission of all globals
 
     // Node 0 is the top-level application collection.
     emitCollection(w, gs, 0, lcNodes,
@@ -905,8 +725,49 @@ bool ReconstructDescriptor(const PHIDP_PREPARSED_DATA ppd,
         hasReportIDs,
         hdr->Input, hdr->Output, hdr->Feature);
 
+    return w.size() != 0;
+}
+
+/**
+ * ReconstructDescriptor
+ *
+ * Reconstructs a HID Report Descriptor from a HIDP_PREPARSED_DATA blob.
+ * The result is functionally equivalent to the original: feeding it back to
+ * HidP_GetCollectionDescription produces the same channel layout.
+ *
+ * The input blob is treated as read-only and is never modified.
+ *
+ * @param ppd     Pointer to preparsed data obtained from HidD_GetPreparsedData.
+ * @param outDesc Receives the reconstructed descriptor bytes on success.
+ * @return        true on success, false if the blob is invalid or empty.
+ */
+bool ReconstructDescriptor(const PHIDP_PREPARSED_DATA ppd,
+    std::vector<UCHAR>& outDesc)
+{
+    DescriptorWriter w;
+    if (!emitDescriptor(w, ppd))
+        return false;
+
     outDesc = w.bytes();
-    return !outDesc.empty();
+    return true;
+}
+
+/**
+ * FingerprintDescriptor
+ *
+ * simd::HashBytes of what ReconstructDescriptor would return, hashed as it
+ * is emitted instead of collected first.
+ */
+bool FingerprintDescriptor(const PHIDP_PREPARSED_DATA ppd,
+    uint64_t& outFingerprint)
+{
+    simd::ByteHasher hasher;
+    DescriptorWriter w(hasher);
+    if (!emitDescriptor(w, ppd))
+        return false;
+
+    outFingerprint = hasher.Finish();
+    return true;
 }
 
 /**
@@ -926,6 +787,56 @@ bool ReconstructDescriptorFromDevice(HANDLE hDevice,
     return ok;
 }
 
+/**
+ * GetInputChannels
+ *
+ * Extracts the bit position and usage/DataIndex range of every input channel.
+ * Unlike chanBitStart(), bit offsets keep the Report ID byte, so they index
+ * straight into RAWHID::bRawData.
+ */
+bool GetInputChannels(const PHIDP_PREPARSED_DATA ppd,
+    std::vector<HidInputChannel>& outChannels)
+{
+    outChannels.clear();
+    if (!ppd) return false;
+
+    const auto* hdr = reinterpret_cast<const HIDP_PREPARSED_DATA_HDR*>(ppd);
+    if (memcmp(hdr->MagicKey, kPPDMagic, 8) != 0)
+        return false;
+
+    const auto* allCh = reinterpret_cast<const HIDP_CHANNEL_DESC*>(hdr + 1);
+    const HIDP_CHANNEL_DESC* inputCh = allCh + hdr->Input.Offset;
+
+    outChannels.reserve(hdr->Input.Index);
+    for (int k = 0; k < hdr->Input.Index; ++k)
+    {
+        const HIDP_CHANNEL_DESC& ch = inputCh[k];
+
+        HidInputChannel out;
+        out.reportId = ch.ReportID;
+        out.isButton = ch.IsButton;
+        out.isVariable = (ch.BitField & BITFIELD_VARIABLE) != 0;
+        out.isAbsolute = ch.IsAbsolute;
+        out.isRange = ch.IsRange;
+        out.isConst = ch.IsConst;
+        out.isAlias = ch.IsAlias;
+        out.moreChannels = ch.MoreChannels;
+        out.bitOffset = static_cast<uint32_t>(ch.ByteOffset) * 8u + ch.BitOffset;
+        out.reportSize = ch.ReportSize;
+        out.reportCount = ch.ReportCount;
+        out.usagePage = ch.UsagePage;
+        out.usageMin = ch.IsRange ? ch.Range.UsageMin : ch.NotRange.Usage;
+        out.usageMax = ch.IsRange ? ch.Range.UsageMax : ch.NotRange.Usage;
+        out.dataIndexMin = ch.IsRange ? ch.Range.DataIndexMin : ch.NotRange.DataIndex;
+        out.dataIndexMax = ch.IsRange ? ch.Range.DataIndexMax : ch.NotRange.DataIndex;
+        out.logicalMin = ch.IsButton ? ch.button.LogicalMin : ch.Data.LogicalMin;
+        out.logicalMax = ch.IsButton ? ch.button.LogicalMax : ch.Data.LogicalMax;
+        outChannels.push_back(out);
+    }
+
+    return true;
+}
+
 // ---------------------------------------------------------------------------
 // Smoke test — define HIDDESC_SELFTEST to build a standalone executable.
 // ---------------------------------------------------------------------------
@@ -2,4 +2,20 @@
 
 #include <hidsdi.h>   // HIDP_PREPARSED_DATA, HIDP_CAPS, etc.
 
-bool ReconstructDescriptor(const PHIDP_PREPARSED_DATA ppd, std::vector<UCHAR>& outDesc);
\ No newline at end of file
+#include "HidInputLayout.h"
+
+#include <cstdint>
+#include <vector>
+
+// The canonical descriptor of the preparsed data: item widths, redundant
+// globals, PUSH/POP and item order from the original are all gone, so
+// devices whose descriptors differ only in those get identical bytes.
+bool ReconstructDescriptor(const PHIDP_PREPARSED_DATA ppd, std::vector<UCHAR>& outDesc);
+
+// simd::HashBytes of ReconstructDescriptor(), computed without building it.
+bool FingerprintDescriptor(const PHIDP_PREPARSED_DATA ppd, uint64_t& outFingerprint);
+
+// Bit layout of every input channel, read from the HIDP_PREPARSED_DATA
+// internals, in preparsed-data order.
+// Returns false if the blob is not in the known preparsed data format.
+bool GetInputChannels(const PHIDP_PREPARSED_DATA ppd, std::vector<HidInputChannel>& outChannels);
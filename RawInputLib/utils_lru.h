@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+// Map of at most `capacity` entries. Inserting into a full cache evicts the
+// least recently used entry; Put() and Find() make an entry the most recent.
+// Contains() does not count as a use. Not thread-safe.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache
+{
+public:
+    explicit LruCache(size_t capacity) : m_Capacity(capacity) {}
+
+    LruCache(const LruCache&) = delete;
+    void operator=(const LruCache&) = delete;
+
+    // Replaces any entry with the same key. The new entry is the most recent.
+    void Put(const Key& key, Value value)
+    {
+        if (m_Capacity == 0)
+            return;
+
+        if (auto it = m_Index.find(key); it != m_Index.end())
+        {
+            it->second->second = std::move(value);
+            m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+            return;
+        }
+
+        m_Entries.emplace_front(key, std::move(value));
+        m_Index.emplace(key, m_Entries.begin());
+
+        if (m_Entries.size() > m_Capacity)
+        {
+            m_Index.erase(m_Entries.back().first);
+            m_Entries.pop_back();
+        }
+    }
+
+    // The entry's value, or nullptr if there is none. The entry becomes the
+    // most recent; the pointer is valid until the entry is removed.
+    Value* Find(const Key& key)
+    {
+        auto it = m_Index.find(key);
+        if (it == m_Index.end())
+            return nullptr;
+
+        m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+        return &it->second->second;
+    }
+
+    // Removes the entry and hands it over, or nullopt if there is none.
+    std::optional<Value> Take(const Key& key)
+    {
+        auto it = m_Index.find(key);
+        if (it == m_Index.end())
+            return std::nullopt;
+
+        std::optional<Value> value(std::move(it->second->second));
+        m_Entries.erase(it->second);
+        m_Index.erase(it);
+        return value;
+    }
+
+    bool Erase(const Key& key)
+    {
+        auto it = m_Index.find(key);
+        if (it == m_Index.end())
+            return false;
+
+        m_Entries.erase(it->second);
+        m_Index.erase(it);
+        return true;
+    }
+
+    bool Contains(const Key& key) const { return m_Index.count(key) != 0; }
+
+    void Clear()
+    {
+        m_Index.clear();
+        m_Entries.clear();
+    }
+
+    size_t GetSize()     const { return m_Entries.size(); }
+    size_t GetCapacity() const { return m_Capacity; }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    size_t                                                    m_Capacity;
+    Entries                                                   m_Entries; // most recent first
+    std::unordered_map<Key, typename Entries::iterator, Hash> m_Index;
+};
@@ -0,0 +1,626 @@
+#include "utils_simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <cwctype>
+
+#if defined(__AVX2__)
+#define SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace simd
+{
+    namespace
+    {
+        void NormaliseAxesScalar(const int32_t* raw,
+                                 const float* scale, const float* offset,
+                                 const float* lo, const float* hi,
+                                 float* out, size_t begin, size_t count)
+        {
+            for (size_t i = begin; i < count; ++i)
+            {
+                // Separate multiply and add so that no FMA contraction makes
+                // the tail differ from the vector body.
+                const float scaled = static_cast<float>(raw[i]) * scale[i];
+                out[i] = std::min(std::max(scaled + offset[i], lo[i]), hi[i]);
+            }
+        }
+    }
+
+    void NormaliseAxes(const int32_t* raw,
+                       const float* scale, const float* offset,
+                       const float* lo, const float* hi,
+                       float* out, size_t count)
+    {
+        size_t i = 0;
+
+#if SIMD_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 v = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + i)));
+            const __m256 scaled = _mm256_mul_ps(v, _mm256_loadu_ps(scale + i));
+            const __m256 shifted = _mm256_add_ps(scaled, _mm256_loadu_ps(offset + i));
+            const __m256 r = _mm256_min_ps(_mm256_max_ps(shifted, _mm256_loadu_ps(lo + i)), _mm256_loadu_ps(hi + i));
+            _mm256_storeu_ps(out + i, r);
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i)));
+            const __m128 scaled = _mm_mul_ps(v, _mm_loadu_ps(scale + i));
+            const __m128 shifted = _mm_add_ps(scaled, _mm_loadu_ps(offset + i));
+            const __m128 r = _mm_min_ps(_mm_max_ps(shifted, _mm_loadu_ps(lo + i)), _mm_loadu_ps(hi + i));
+            _mm_storeu_ps(out + i, r);
+        }
+#elif SIMD_NEON
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t v = vcvtq_f32_s32(vld1q_s32(raw + i));
+            const float32x4_t scaled = vmulq_f32(v, vld1q_f32(scale + i));
+            const float32x4_t shifted = vaddq_f32(scaled, vld1q_f32(offset + i));
+            const float32x4_t r = vminq_f32(vmaxq_f32(shifted, vld1q_f32(lo + i)), vld1q_f32(hi + i));
+            vst1q_f32(out + i, r);
+        }
+#endif
+
+        NormaliseAxesScalar(raw, scale, offset, lo, hi, out, i, count);
+    }
+
+    void NormaliseAxisColumn(const int32_t* raw,
+                             float scale, float offset, float lo, float hi,
+                             float* out, size_t count)
+    {
+        size_t i = 0;
+
+#if SIMD_AVX2
+        {
+            const __m256 vs = _mm256_set1_ps(scale), vo = _mm256_set1_ps(offset);
+            const __m256 vl = _mm256_set1_ps(lo), vh = _mm256_set1_ps(hi);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 v = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + i)));
+                const __m256 shifted = _mm256_add_ps(_mm256_mul_ps(v, vs), vo);
+                _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_max_ps(shifted, vl), vh));
+            }
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        {
+            const __m128 vs = _mm_set1_ps(scale), vo = _mm_set1_ps(offset);
+            const __m128 vl = _mm_set1_ps(lo), vh = _mm_set1_ps(hi);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i)));
+                const __m128 shifted = _mm_add_ps(_mm_mul_ps(v, vs), vo);
+                _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(shifted, vl), vh));
+            }
+        }
+#elif SIMD_NEON
+        {
+            const float32x4_t vs = vdupq_n_f32(scale), vo = vdupq_n_f32(offset);
+            const float32x4_t vl = vdupq_n_f32(lo), vh = vdupq_n_f32(hi);
+            for (; i + 4 <= count; i += 4)
+            {
+                const float32x4_t v = vcvtq_f32_s32(vld1q_s32(raw + i));
+                const float32x4_t shifted = vaddq_f32(vmulq_f32(v, vs), vo);
+                vst1q_f32(out + i, vminq_f32(vmaxq_f32(shifted, vl), vh));
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const float scaled = static_cast<float>(raw[i]) * scale;
+            out[i] = std::min(std::max(scaled + offset, lo), hi);
+        }
+    }
+
+    bool DiffBytes(const uint8_t* a, const uint8_t* b, size_t size, uint64_t* diffMask)
+    {
+        const size_t words = (size + 63) / 64;
+        for (size_t w = 0; w < words; ++w)
+            diffMask[w] = 0;
+
+        uint64_t any = 0;
+        size_t i = 0;
+
+#if SIMD_AVX2
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i eq = _mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            const uint64_t ne = ~static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq))) & 0xFFFFFFFFull;
+            diffMask[i >> 6] |= ne << (i & 63);
+            any |= ne;
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i eq = _mm_cmpeq_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            const uint64_t ne = ~static_cast<uint64_t>(_mm_movemask_epi8(eq)) & 0xFFFFull;
+            diffMask[i >> 6] |= ne << (i & 63);
+            any |= ne;
+        }
+#elif SIMD_NEON
+        // No movemask on NEON: weight each lane by its bit and add across halves.
+        static const uint8_t kWeights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        const uint8x16_t weights = vld1q_u8(kWeights);
+        for (; i + 16 <= size; i += 16)
+        {
+            const uint8x16_t ne = vmvnq_u8(vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+            const uint8x16_t bits = vandq_u8(ne, weights);
+            const uint64_t mask = uint64_t(vaddv_u8(vget_low_u8(bits)))
+                                | (uint64_t(vaddv_u8(vget_high_u8(bits))) << 8);
+            diffMask[i >> 6] |= mask << (i & 63);
+            any |= mask;
+        }
+#endif
+
+        for (; i < size; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                diffMask[i >> 6] |= uint64_t(1) << (i & 63);
+                any = 1;
+            }
+        }
+
+        return any != 0;
+    }
+
+    // ---------------------------------------------------------------------------
+    // Case-insensitive strings
+    // ---------------------------------------------------------------------------
+
+    namespace
+    {
+        uint8_t FoldAscii(uint8_t c)
+        {
+            return (c >= 'a' && c <= 'z') ? static_cast<uint8_t>(c - 0x20) : c;
+        }
+
+        uint32_t FoldWide(wchar_t c)
+        {
+            const uint32_t u = static_cast<uint32_t>(c);
+            if (u < 0x80)
+                return FoldAscii(static_cast<uint8_t>(u));
+            return static_cast<uint32_t>(static_cast<wchar_t>(std::towupper(static_cast<std::wint_t>(c))));
+        }
+
+        int CompareNoCaseScalar(const wchar_t* a, const wchar_t* b, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const uint32_t fa = FoldWide(a[i]);
+                const uint32_t fb = FoldWide(b[i]);
+                if (fa != fb)
+                    return fa < fb ? -1 : 1;
+            }
+            return 0;
+        }
+
+        // Up to 8 folded bytes in memory order, zero-padded. The vector path
+        // stores its folded lanes the same way, so both hash alike.
+        uint64_t LoadFoldedWord(const uint8_t* s, size_t size)
+        {
+            uint8_t folded[8] = {};
+            for (size_t i = 0; i < size; ++i)
+                folded[i] = FoldAscii(s[i]);
+            uint64_t word;
+            std::memcpy(&word, folded, sizeof(word));
+            return word;
+        }
+
+        uint64_t MixWord(uint64_t h, uint64_t word)
+        {
+            h ^= word;
+            h *= 0x9E3779B97F4A7C15ull;
+            return h ^ (h >> 32);
+        }
+
+#if SIMD_AVX2
+        __m256i FoldAscii(__m256i v)
+        {
+            const __m256i lower = _mm256_and_si256(
+                _mm256_cmpgt_epi8(v, _mm256_set1_epi8('a' - 1)),
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), v));
+            return _mm256_sub_epi8(v, _mm256_and_si256(lower, _mm256_set1_epi8(0x20)));
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        // Bytes >= 0x80 are negative as epi8 and fall outside 'a'..'z'.
+        __m128i FoldAscii(__m128i v)
+        {
+            const __m128i lower = _mm_and_si128(
+                _mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)),
+                _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+            return _mm_sub_epi8(v, _mm_and_si128(lower, _mm_set1_epi8(0x20)));
+        }
+
+        __m128i FoldAsciiWide(__m128i v)
+        {
+            const __m128i lower = _mm_and_si128(
+                _mm_cmpgt_epi16(v, _mm_set1_epi16('a' - 1)),
+                _mm_cmplt_epi16(v, _mm_set1_epi16('z' + 1)));
+            return _mm_sub_epi16(v, _mm_and_si128(lower, _mm_set1_epi16(0x20)));
+        }
+#elif SIMD_NEON
+        uint8x16_t FoldAscii(uint8x16_t v)
+        {
+            const uint8x16_t lower = vcltq_u8(vsubq_u8(v, vdupq_n_u8('a')), vdupq_n_u8(26));
+            return vsubq_u8(v, vandq_u8(lower, vdupq_n_u8(0x20)));
+        }
+
+        uint16x8_t FoldAsciiWide(uint16x8_t v)
+        {
+            const uint16x8_t lower = vcltq_u16(vsubq_u16(v, vdupq_n_u16('a')), vdupq_n_u16(26));
+            return vsubq_u16(v, vandq_u16(lower, vdupq_n_u16(0x20)));
+        }
+#endif
+    }
+
+    int CompareNoCase(const char* a, const char* b, size_t size)
+    {
+        const uint8_t* pa = reinterpret_cast<const uint8_t*>(a);
+        const uint8_t* pb = reinterpret_cast<const uint8_t*>(b);
+        size_t i = 0;
+
+#if SIMD_AVX2
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i eq = _mm256_cmpeq_epi8(
+                FoldAscii(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pa + i))),
+                FoldAscii(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pb + i))));
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+            if (mask != 0xFFFFFFFFu)
+            {
+                const size_t j = i + std::countr_zero(~mask);
+                return int(FoldAscii(pa[j])) - int(FoldAscii(pb[j]));
+            }
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i eq = _mm_cmpeq_epi8(
+                FoldAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i))),
+                FoldAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i))));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+            if (mask != 0xFFFFu)
+            {
+                const size_t j = i + std::countr_zero(~mask);
+                return int(FoldAscii(pa[j])) - int(FoldAscii(pb[j]));
+            }
+        }
+#elif SIMD_NEON
+        for (; i + 16 <= size; i += 16)
+        {
+            const uint8x16_t eq = vceqq_u8(FoldAscii(vld1q_u8(pa + i)), FoldAscii(vld1q_u8(pb + i)));
+            if (vminvq_u8(eq) != 0xFF)
+                break; // the scalar loop finds the first difference
+        }
+#endif
+
+        for (; i < size; ++i)
+        {
+            const uint8_t fa = FoldAscii(pa[i]);
+            const uint8_t fb = FoldAscii(pb[i]);
+            if (fa != fb)
+                return int(fa) - int(fb);
+        }
+        return 0;
+    }
+
+    int CompareNoCase(const wchar_t* a, const wchar_t* b, size_t size)
+    {
+        size_t i = 0;
+
+        // Lanes that differ after ASCII folding may still match through
+        // towupper, so a mismatching block is re-checked in scalar code.
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+#if SIMD_AVX2 || SIMD_SSE2
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m128i eq = _mm_cmpeq_epi16(
+                    FoldAsciiWide(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i))),
+                    FoldAsciiWide(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+                if (_mm_movemask_epi8(eq) != 0xFFFF)
+                {
+                    if (const int r = CompareNoCaseScalar(a, b, i, i + 8))
+                        return r;
+                }
+            }
+#elif SIMD_NEON
+            for (; i + 8 <= size; i += 8)
+            {
+                const uint16x8_t eq = vceqq_u16(
+                    FoldAsciiWide(vld1q_u16(reinterpret_cast<const uint16_t*>(a + i))),
+                    FoldAsciiWide(vld1q_u16(reinterpret_cast<const uint16_t*>(b + i))));
+                if (vminvq_u16(eq) != 0xFFFF)
+                {
+                    if (const int r = CompareNoCaseScalar(a, b, i, i + 8))
+                        return r;
+                }
+            }
+#endif
+        }
+
+        return CompareNoCaseScalar(a, b, i, size);
+    }
+
+    const char* FindCharNoCase(const char* s, size_t size, char c)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(s);
+        const uint8_t target = FoldAscii(static_cast<uint8_t>(c));
+        size_t i = 0;
+
+#if SIMD_AVX2
+        {
+            const __m256i t = _mm256_set1_epi8(static_cast<char>(target));
+            for (; i + 32 <= size; i += 32)
+            {
+                const __m256i eq = _mm256_cmpeq_epi8(FoldAscii(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))), t);
+                if (const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq)))
+                    return s + i + std::countr_zero(mask);
+            }
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        {
+            const __m128i t = _mm_set1_epi8(static_cast<char>(target));
+            for (; i + 16 <= size; i += 16)
+            {
+                const __m128i eq = _mm_cmpeq_epi8(FoldAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))), t);
+                if (const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq)))
+                    return s + i + std::countr_zero(mask);
+            }
+        }
+#elif SIMD_NEON
+        {
+            const uint8x16_t t = vdupq_n_u8(target);
+            for (; i + 16 <= size; i += 16)
+            {
+                if (vmaxvq_u8(vceqq_u8(FoldAscii(vld1q_u8(p + i)), t)))
+                    break;
+            }
+        }
+#endif
+
+        for (; i < size; ++i)
+        {
+            if (FoldAscii(p[i]) == target)
+                return s + i;
+        }
+        return nullptr;
+    }
+
+    size_t FindNoCase(const char* haystack, size_t haystackSize, const char* needle, size_t needleSize)
+    {
+        if (needleSize == 0)
+            return 0;
+        if (needleSize > haystackSize)
+            return SIZE_MAX;
+        if (needleSize == 1)
+        {
+            const char* found = FindCharNoCase(haystack, haystackSize, needle[0]);
+            return found ? static_cast<size_t>(found - haystack) : SIZE_MAX;
+        }
+
+        // Candidates are filtered on the first and last needle characters,
+        // a whole block of positions at a time; the middle is then compared.
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(haystack);
+        const size_t last = needleSize - 1;
+        const size_t positions = haystackSize - last;
+        const uint8_t first = FoldAscii(static_cast<uint8_t>(needle[0]));
+        const uint8_t final = FoldAscii(static_cast<uint8_t>(needle[last]));
+        size_t i = 0;
+
+        auto matchesMiddle = [&](size_t pos)
+        {
+            return CompareNoCase(haystack + pos + 1, needle + 1, needleSize - 2) == 0;
+        };
+
+#if SIMD_AVX2
+        {
+            const __m256i vf = _mm256_set1_epi8(static_cast<char>(first));
+            const __m256i vl = _mm256_set1_epi8(static_cast<char>(final));
+            for (; i + 32 <= positions; i += 32)
+            {
+                const __m256i ef = _mm256_cmpeq_epi8(FoldAscii(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i))), vf);
+                const __m256i el = _mm256_cmpeq_epi8(FoldAscii(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + last))), vl);
+                for (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(ef, el))); mask; mask &= mask - 1)
+                {
+                    const size_t pos = i + std::countr_zero(mask);
+                    if (matchesMiddle(pos))
+                        return pos;
+                }
+            }
+        }
+#endif
+
+#if SIMD_AVX2 || SIMD_SSE2
+        {
+            const __m128i vf = _mm_set1_epi8(static_cast<char>(first));
+            const __m128i vl = _mm_set1_epi8(static_cast<char>(final));
+            for (; i + 16 <= positions; i += 16)
+            {
+                const __m128i ef = _mm_cmpeq_epi8(FoldAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i))), vf);
+                const __m128i el = _mm_cmpeq_epi8(FoldAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + last))), vl);
+                for (uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(ef, el))); mask; mask &= mask - 1)
+                {
+                    const size_t pos = i + std::countr_zero(mask);
+                    if (matchesMiddle(pos))
+                        return pos;
+                }
+            }
+        }
+#elif SIMD_NEON
+        {
+            const uint8x16_t vf = vdupq_n_u8(first);
+            const uint8x16_t vl = vdupq_n_u8(final);
+            for (; i + 16 <= positions; i += 16)
+            {
+                const uint8x16_t ef = vceqq_u8(FoldAscii(vld1q_u8(h + i)), vf);
+                const uint8x16_t el = vceqq_u8(FoldAscii(vld1q_u8(h + i + last)), vl);
+                if (!vmaxvq_u8(vandq_u8(ef, el)))
+                    continue;
+                for (size_t pos = i; pos < i + 16; ++pos)
+                {
+                    if (FoldAscii(h[pos]) == first && FoldAscii(h[pos + last]) == final && matchesMiddle(pos))
+                        return pos;
+                }
+            }
+        }
+#endif
+
+        for (; i < positions; ++i)
+        {
+            if (FoldAscii(h[i]) == first && FoldAscii(h[i + last]) == final && matchesMiddle(i))
+                return i;
+        }
+        return SIZE_MAX;
+    }
+
+    uint64_t HashNoCase(const char* s, size_t size)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(s);
+        uint64_t h = 0xCBF29CE484222325ull ^ size;
+        size_t i = 0;
+
+#if SIMD_AVX2 || SIMD_SSE2
+        for (; i + 16 <= size; i += 16)
+        {
+            uint64_t words[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(words), FoldAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))));
+            h = MixWord(MixWord(h, words[0]), words[1]);
+        }
+#elif SIMD_NEON
+        for (; i + 16 <= size; i += 16)
+        {
+            uint64_t words[2];
+            vst1q_u8(reinterpret_cast<uint8_t*>(words), FoldAscii(vld1q_u8(p + i)));
+            h = MixWord(MixWord(h, words[0]), words[1]);
+        }
+#endif
+
+        for (; i + 8 <= size; i += 8)
+            h = MixWord(h, LoadFoldedWord(p + i, 8));
+        if (i < size)
+            h = MixWord(h, LoadFoldedWord(p + i, size - i));
+
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return h ^ (h >> 32);
+    }
+
+    ByteHasher::ByteHasher()
+        : m_Lanes{ 0xCBF29CE484222325ull, 0x84222325CBF29CE4ull, 0x9E3779B97F4A7C15ull, 0xBF58476D1CE4E5B9ull }
+    {
+    }
+
+    void ByteHasher::UpdateBlocks(const void* data, size_t size)
+    {
+        if (size == 0)
+            return;
+
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+
+        if (m_Fill)
+        {
+            const size_t take = std::min(size, kBlockSize - m_Fill);
+            std::memcpy(m_Block + m_Fill, p, take);
+            m_Fill += take;
+            p += take;
+            size -= take;
+            if (m_Fill < kBlockSize)
+                return;
+            MixBlock(m_Block);
+            m_Fill = 0;
+        }
+
+        for (; size >= kBlockSize; p += kBlockSize, size -= kBlockSize)
+            MixBlock(p);
+
+        std::memcpy(m_Block, p, size);
+        m_Fill = size;
+    }
+
+    void ByteHasher::MixBlock(const uint8_t* block)
+    {
+        // Four independent lanes over 32-byte blocks keep the multipliers
+        // busy; a single chain is bound by multiply latency.
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            uint64_t word;
+            std::memcpy(&word, block + lane * 8, sizeof(word));
+            m_Lanes[lane] = MixWord(m_Lanes[lane], word);
+        }
+        m_Size += kBlockSize;
+    }
+
+    uint64_t ByteHasher::Finish() const
+    {
+        uint64_t h = m_Lanes[0];
+        for (size_t lane = 1; lane < 4; ++lane)
+            h = MixWord(h, m_Lanes[lane]);
+
+        size_t i = 0;
+        for (; i + 8 <= m_Fill; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, m_Block + i, sizeof(word));
+            h = MixWord(h, word);
+        }
+        if (i < m_Fill)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, m_Block + i, m_Fill - i);
+            h = MixWord(h, word);
+        }
+
+        h = MixWord(h, m_Size + m_Fill);
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return h ^ (h >> 32);
+    }
+
+    uint64_t HashBytes(const void* data, size_t size)
+    {
+        ByteHasher hasher;
+        hasher.Update(data, size);
+        return hasher.Finish();
+    }
+
+    const char* GetInstructionSet()
+    {
+#if SIMD_AVX2
+        return "AVX2";
+#elif SIMD_SSE2
+        return "SSE2";
+#elif SIMD_NEON
+        return "NEON";
+#else
+        return "scalar";
+#endif
+    }
+}
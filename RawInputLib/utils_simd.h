@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Vectorised kernels for the input hot path.
+//
+// The instruction set is chosen at compile time: AVX2 when the translation
+// unit is built with /arch:AVX2 (or -mavx2), SSE2 on any other x86/x64 build,
+// NEON on ARM64, plain scalar code elsewhere. Results are bit-identical
+// between paths.
+
+namespace simd
+{
+    // out[i] = clamp(float(raw[i]) * scale[i] + offset[i], lo[i], hi[i])
+    //
+    // All arrays hold `count` elements. No alignment is required.
+    void NormaliseAxes(const int32_t* raw,
+                       const float* scale, const float* offset,
+                       const float* lo, const float* hi,
+                       float* out, size_t count);
+
+    // Same transform for `count` samples of one axis:
+    // out[i] = clamp(float(raw[i]) * scale + offset, lo, hi)
+    void NormaliseAxisColumn(const int32_t* raw,
+                             float scale, float offset, float lo, float hi,
+                             float* out, size_t count);
+
+    // Compares two byte buffers of `size` bytes. Sets bit i of `diffMask`
+    // (BitWordCount(size) words, see utils_bitset.h) when a[i] != b[i] and
+    // clears it otherwise. Returns true if any byte differs.
+    bool DiffBytes(const uint8_t* a, const uint8_t* b, size_t size, uint64_t* diffMask);
+
+    // Case-insensitive string kernels.
+    //
+    // Narrow strings are UTF-8: only ASCII letters are folded and every other
+    // byte compares exactly. Wide strings fold ASCII the same way and pass
+    // other code units through towupper. Characters compare as unsigned
+    // values after folding to upper case.
+
+    // <0, 0 or >0 like memcmp, over `size` characters of each string.
+    int CompareNoCase(const char* a, const char* b, size_t size);
+    int CompareNoCase(const wchar_t* a, const wchar_t* b, size_t size);
+
+    // First occurrence of `c` in s[0, size), or nullptr.
+    const char* FindCharNoCase(const char* s, size_t size, char c);
+
+    // Offset of the first occurrence of `needle` in `haystack`, or SIZE_MAX.
+    size_t FindNoCase(const char* haystack, size_t haystackSize, const char* needle, size_t needleSize);
+
+    // Hash of the folded bytes: strings equal under CompareNoCase hash equal.
+    uint64_t HashNoCase(const char* s, size_t size);
+
+    // Hash of the bytes themselves. Stable across builds and little-endian
+    // platforms, so it can be stored in files.
+    uint64_t HashBytes(const void* data, size_t size);
+
+    // HashBytes over bytes fed in pieces: any split of the same bytes gives
+    // the same value as one HashBytes call. Keeps one 32-byte block.
+    class ByteHasher
+    {
+    public:
+        ByteHasher();
+
+        void Update(const void* data, size_t size)
+        {
+            // Small writes that stay inside the current block are the common
+            // case when feeding descriptor items.
+            if (size && m_Fill + size < kBlockSize)
+            {
+                std::memcpy(m_Block + m_Fill, data, size);
+                m_Fill += size;
+                return;
+            }
+            UpdateBlocks(data, size);
+        }
+
+        void Update(uint8_t byte)
+        {
+            // Through a local: a byte store may alias m_Fill, which would
+            // otherwise be reloaded after every byte.
+            size_t fill = m_Fill;
+            m_Block[fill++] = byte;
+            if (fill == kBlockSize)
+            {
+                MixBlock(m_Block);
+                fill = 0;
+            }
+            m_Fill = fill;
+        }
+
+        uint64_t Finish() const;
+
+    private:
+        static constexpr size_t kBlockSize = 32;
+
+        void UpdateBlocks(const void* data, size_t size);
+        void MixBlock(const uint8_t* block);
+
+        uint64_t m_Lanes[4];
+        uint64_t m_Size = 0; // bytes mixed into the lanes
+        uint8_t  m_Block[kBlockSize];
+        size_t   m_Fill = 0;
+    };
+
+    // Name of the compiled-in instruction set, for diagnostics.
+    const char* GetInstructionSet();
+}
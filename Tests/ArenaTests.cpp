@@ -0,0 +1,77 @@
+#include "utils_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+TEST(ChunkedArena, CopiesStringsNulTerminated)
+{
+    ChunkedArena arena(64);
+
+    const std::string source = "HID\\VID_046D&PID_C52B&MI_00";
+    const std::string_view copy = arena.CopyString(source);
+    EXPECT_EQ(copy, source);
+    EXPECT_NE(copy.data(), source.data());
+    EXPECT_EQ(copy.data()[copy.size()], '\0');
+
+    const std::string_view empty = arena.CopyString("");
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.data()[0], '\0');
+    EXPECT_EQ(arena.GetUsedBytes(), source.size() + 1);
+}
+
+TEST(ChunkedArena, GrowsByBlocksNeverSmaller)
+{
+    ChunkedArena arena(64);
+    EXPECT_EQ(arena.GetBlockCount(), 0u);
+
+    arena.CopyString(std::string(40, 'a'));
+    EXPECT_EQ(arena.GetBlockCount(), 1u);
+    EXPECT_EQ(arena.GetReservedBytes(), 64u);
+
+    // Does not fit the rest of the first block: a second one of at least
+    // the first one's size, or the request's if larger.
+    arena.CopyString(std::string(100, 'b'));
+    EXPECT_EQ(arena.GetBlockCount(), 2u);
+    EXPECT_EQ(arena.GetReservedBytes(), 64u + 101u);
+
+    arena.CopyString(std::string(10, 'c'));
+    EXPECT_EQ(arena.GetBlockCount(), 3u);
+    EXPECT_EQ(arena.GetReservedBytes(), 64u + 101u + 101u);
+}
+
+TEST(ChunkedArena, AlignsAllocations)
+{
+    ChunkedArena arena(256);
+    arena.CopyString("x");
+
+    const std::span<uint64_t> values = arena.Allocate<uint64_t>(3);
+    ASSERT_EQ(values.size(), 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % alignof(uint64_t), 0u);
+    EXPECT_EQ(values[0], 0u);
+
+    const std::span<std::string_view> views = arena.Allocate<std::string_view>(2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(views.data()) % alignof(std::string_view), 0u);
+    EXPECT_TRUE(arena.Allocate<uint32_t>(0).empty());
+}
+
+TEST(MonotonicArena, InlineOrOneHeapBlock)
+{
+    MonotonicArena<64> arena;
+
+    const size_t small = ArenaLayout().Add<uint8_t>(3).Add<uint32_t>(4).GetBytes();
+    EXPECT_EQ(small, 4u + 16u);
+    arena.Reserve(small);
+    EXPECT_TRUE(arena.IsInline());
+    arena.Allocate<uint8_t>(3);
+    const std::span<uint32_t> words = arena.Allocate<uint32_t>(4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(words.data()) % alignof(uint32_t), 0u);
+    EXPECT_EQ(arena.GetUsed(), small);
+
+    const size_t large = ArenaLayout().Add<uint64_t>(100).GetBytes();
+    arena.Reserve(large);
+    EXPECT_FALSE(arena.IsInline());
+    EXPECT_EQ(arena.GetCapacity(), large);
+    EXPECT_EQ(arena.GetUsed(), 0u);
+}
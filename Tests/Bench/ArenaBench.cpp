@@ -0,0 +1,138 @@
+#include "Bench/Bench.h"
+
+#include "utils_arena.h"
+
+#include <cstdio>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Counts the allocations made through it.
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocations = 0;
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override
+        {
+            ++allocations;
+            bytes += size;
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        }
+
+        void do_deallocate(void* p, size_t size, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    // The metadata of a USB HID gamepad interface as RawInputDevice and its
+    // facets collect it: paths, IDs, identity and devnode strings, the driver
+    // stack and hardware ID lists, and the USB descriptors.
+    struct MetadataSample
+    {
+        std::vector<std::string> strings = {
+            "\\\\?\\HID#VID_045E&PID_02EA&MI_00&COL01#8&2b3d6a1f&0&0000#{4d1e55b2-f16f-11cf-88cb-001111000030}",
+            "HID\\VID_045E&PID_02EA&MI_00&COL01\\8&2B3D6A1F&0&0000",
+            "\\\\?\\USB#VID_045E&PID_02EA#3039373030333433313933353235#{a5dcbf10-6530-11d2-901f-00c04fb951ed}",
+            "USB\\VID_045E&PID_02EA\\3039373030333433313933353235",
+            "Microsoft", "Controller", "3039373030333433313933353235",
+            "HID-compliant game controller", "Microsoft", "HIDClass", "{745a17a0-74d3-11d0-b6fe-00a0c90f57da}",
+            "hidusb", "input.inf", "10.0.22621.1", "Port_#0003.Hub_#0001",
+        };
+        std::vector<std::string> stack = { "\\Driver\\xboxgip", "\\Driver\\HidUsb", "\\Driver\\ACPI" };
+        std::vector<std::string> hardwareIds = {
+            "HID\\VID_045E&PID_02EA&REV_0408&MI_00&Col01", "HID\\VID_045E&PID_02EA&MI_00&Col01",
+            "HID\\VID_045E&UP:0001_U:0005", "HID_DEVICE_SYSTEM_GAME", "HID_DEVICE_UP:0001_U:0005", "HID_DEVICE",
+        };
+        std::vector<uint8_t> configuration = std::vector<uint8_t>(96, 0x09);
+        std::vector<uint8_t> reportDescriptor = std::vector<uint8_t>(334, 0x05);
+    };
+
+    // The std::string / std::vector layout the devices used before the arena.
+    struct StringMetadata
+    {
+        explicit StringMetadata(std::pmr::memory_resource* resource)
+            : strings(resource), stack(resource), hardwareIds(resource), configuration(resource), reportDescriptor(resource)
+        {}
+
+        std::pmr::vector<std::pmr::string> strings;
+        std::pmr::vector<std::pmr::string> stack;
+        std::pmr::vector<std::pmr::string> hardwareIds;
+        std::pmr::vector<uint8_t>          configuration;
+        std::pmr::vector<uint8_t>          reportDescriptor;
+    };
+
+    void Fill(StringMetadata& metadata, const MetadataSample& sample)
+    {
+        // One member per string, so no reserve() on the outer vector.
+        for (const std::string& s : sample.strings)
+            metadata.strings.emplace_back(s);
+        for (const std::string& s : sample.stack)
+            metadata.stack.emplace_back(s);
+        for (const std::string& s : sample.hardwareIds)
+            metadata.hardwareIds.emplace_back(s);
+        metadata.configuration.assign(sample.configuration.begin(), sample.configuration.end());
+        metadata.reportDescriptor.assign(sample.reportDescriptor.begin(), sample.reportDescriptor.end());
+    }
+
+    // RawInputDevice::kMetadataBlockBytes.
+    constexpr size_t kMetadataBlockBytes = 2048;
+
+    size_t Fill(ChunkedArena& arena, const MetadataSample& sample)
+    {
+        size_t views = 0;
+        for (const std::string& s : sample.strings)
+            views += arena.CopyString(s).size();
+        for (const std::vector<std::string>* list : { &sample.stack, &sample.hardwareIds })
+        {
+            const std::span<std::string_view> copies = arena.Allocate<std::string_view>(list->size());
+            for (size_t i = 0; i < list->size(); ++i)
+                copies[i] = arena.CopyString((*list)[i]);
+            views += copies.size();
+        }
+        views += arena.CopyBytes(sample.configuration).size();
+        views += arena.CopyBytes(sample.reportDescriptor).size();
+        return views;
+    }
+}
+
+// Per-device metadata footprint: heap allocations and bytes of the old
+// std::string / std::vector members against the ChunkedArena the devices
+// use now, and the time to fill each.
+RAWINPUT_BENCH(DeviceMetadata)
+{
+    const MetadataSample sample;
+
+    {
+        CountingResource resource;
+        StringMetadata metadata(&resource);
+        Fill(metadata, sample);
+        std::printf("  %-48s %12zu allocations %8zu bytes\n", "std::string members", resource.allocations, resource.bytes);
+    }
+    {
+        ChunkedArena arena(kMetadataBlockBytes);
+        Fill(arena, sample);
+        std::printf("  %-48s %12zu allocations %8zu bytes (%zu used)\n", "ChunkedArena",
+            arena.GetBlockCount(), arena.GetReservedBytes(), arena.GetUsedBytes());
+    }
+
+    Measure("fill std::string members", context.Iterations(200000), 0, [&]
+    {
+        StringMetadata metadata(std::pmr::new_delete_resource());
+        Fill(metadata, sample);
+        Consume(metadata.strings.size());
+    });
+
+    Measure("fill ChunkedArena", context.Iterations(200000), 0, [&]
+    {
+        ChunkedArena arena(kMetadataBlockBytes);
+        Consume(Fill(arena, sample));
+    });
+}
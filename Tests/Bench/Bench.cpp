@@ -0,0 +1,83 @@
+#include "Bench/Bench.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Benchmark
+    {
+        const char* name;
+        BenchFn     fn;
+    };
+
+    std::vector<Benchmark>& GetBenchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    volatile uint64_t g_Sink = 0;
+}
+
+BenchRegistration::BenchRegistration(const char* name, BenchFn fn)
+{
+    GetBenchmarks().push_back({ name, fn });
+}
+
+void Measure(std::string_view label, size_t iterations, size_t bytes, const std::function<void()>& body)
+{
+    if (!iterations)
+        return;
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        body();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const double nsPerIteration = seconds * 1e9 / static_cast<double>(iterations);
+    std::printf("  %-48.*s %12.1f ns/iter", static_cast<int>(label.size()), label.data(), nsPerIteration);
+    if (bytes && seconds > 0)
+        std::printf("  %10.1f MB/s", static_cast<double>(bytes) * static_cast<double>(iterations) / seconds / 1e6);
+    std::printf("\n");
+}
+
+void Consume(uint64_t value)
+{
+    g_Sink = g_Sink + value;
+}
+
+int main(int argc, char** argv)
+{
+    BenchContext context;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--quick"))
+            context.quick = true;
+        else
+            selected.emplace_back(argv[i]);
+    }
+
+    size_t run = 0;
+    for (const Benchmark& benchmark : GetBenchmarks())
+    {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), benchmark.name) == selected.end())
+            continue;
+
+        std::printf("%s\n", benchmark.name);
+        benchmark.fn(context);
+        ++run;
+    }
+
+    if (!run)
+    {
+        std::fprintf(stderr, "no benchmark matches\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// A minimal benchmark harness. Each benchmark registers itself with
+// RAWINPUT_BENCH and reports one or more timed loops through Measure().
+//
+//   RawInputBench [--quick] [name...]
+//
+// --quick runs every loop a handful of times; ctest uses it to check the
+// benchmarks still run. The numbers only mean something in a release build
+// without --quick, on an otherwise idle machine.
+
+struct BenchContext
+{
+    bool quick = false;
+
+    // `full` iterations normally, a few with --quick.
+    size_t Iterations(size_t full) const { return quick ? (full < 8 ? full : 8) : full; }
+};
+
+using BenchFn = void (*)(const BenchContext& context);
+
+struct BenchRegistration
+{
+    BenchRegistration(const char* name, BenchFn fn);
+};
+
+#define RAWINPUT_BENCH(name)                                                       \
+    static void Bench_##name(const BenchContext& context);                         \
+    static const BenchRegistration g_Bench_##name(#name, Bench_##name);            \
+    static void Bench_##name(const BenchContext& context)
+
+// Runs `body` `iterations` times and prints the time per iteration and, if
+// `bytes` is non-zero, the throughput over `bytes` per iteration.
+void Measure(std::string_view label, size_t iterations, size_t bytes, const std::function<void()>& body);
+
+// Keeps a result alive so the compiler cannot drop the work producing it.
+void Consume(uint64_t value);
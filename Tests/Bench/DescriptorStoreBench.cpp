@@ -0,0 +1,69 @@
+#include "Bench/Bench.h"
+#include "Samples.h"
+#include "TempDirectory.h"
+
+#include "DescriptorStore.h"
+#include "utils_simd.h"
+
+#include <fstream>
+
+// Ingesting a directory of dumps, and walking and looking up the resulting
+// store, which is how corpora are fed to the decoders and to
+// ReconstructDescriptor checks.
+RAWINPUT_BENCH(DescriptorStore)
+{
+    TempDirectory dir;
+    const std::vector<std::vector<uint8_t>> corpus = MakeDescriptorCorpus(context.quick ? 200 : 20000, 1);
+
+    // Four dumps of every descriptor, as from four machines.
+    const size_t dumps = context.quick ? 100 : 4000;
+    for (size_t i = 0; i < dumps; ++i)
+    {
+        const std::filesystem::path machine = dir.GetPath() / "dumps" / std::to_string(i % 4);
+        std::filesystem::create_directories(machine);
+        const std::vector<uint8_t>& descriptor = corpus[i / 4];
+        std::ofstream(machine / ("VID_045E&PID_" + std::to_string(1000 + i / 4) + ".bin"), std::ios::binary)
+            .write(reinterpret_cast<const char*>(descriptor.data()), static_cast<std::streamsize>(descriptor.size()));
+    }
+
+    Measure("ingest dumps", context.Iterations(10), 0, [&]
+    {
+        DescriptorStoreBuilder builder;
+        Consume(IngestDescriptorDumps(builder, dir.GetPath() / "dumps").added);
+    });
+
+    DescriptorStoreBuilder builder;
+    size_t bytes = 0;
+    for (const std::vector<uint8_t>& descriptor : corpus)
+    {
+        builder.Add(descriptor);
+        bytes += descriptor.size();
+    }
+    builder.Write(dir / "store");
+    const std::optional<DescriptorStore> store = DescriptorStore::Open(dir / "store");
+    if (!store)
+        return;
+
+    Measure("open", context.Iterations(100), 0, [&]
+    {
+        Consume(DescriptorStore::Open(dir / "store")->GetEntries().size());
+    });
+
+    Measure("walk and hash every descriptor", context.Iterations(50), bytes, [&]
+    {
+        uint64_t hash = 0;
+        for (const DescriptorStore::Entry& entry : store->GetEntries())
+        {
+            const std::span<const uint8_t> descriptor = store->GetDescriptor(entry);
+            hash ^= simd::HashBytes(descriptor.data(), descriptor.size());
+        }
+        Consume(hash);
+    });
+
+    size_t next = 0;
+    Measure("find by content", context.Iterations(200000), 0, [&]
+    {
+        Consume(store->Find(corpus[next]) != nullptr);
+        next = (next + 1) % corpus.size();
+    });
+}
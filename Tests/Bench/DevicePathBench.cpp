@@ -0,0 +1,88 @@
+#include "Bench/Bench.h"
+
+#include "DevicePath.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // Interface paths and instance IDs in the spellings a machine reports:
+    // HID collections, USB devices with serial numbers, Bluetooth classic
+    // and LE HID, mixed case as Windows hands them out.
+    std::vector<std::string> MakePathCorpus(size_t count)
+    {
+        static const char* const kFormats[] = {
+            "\\\\?\\HID#VID_%04X&PID_%04X&MI_%02u&Col%02u#7&%08x&0&0000#{4d1e55b2-f16f-11cf-88cb-001111000030}",
+            "\\\\?\\HID#VID_%04X&PID_%04X&MI_%02u&Col%02u#8&%08x&0&0000#{378de44c-56ef-11d1-bc8c-00a0c91405dd}\\KBD",
+            "\\\\?\\USB#vid_%04x&pid_%04x&mi_%02u#%u&%08x&0&0000#{a5dcbf10-6530-11d2-901f-00c04fb951ed}",
+            "\\\\?\\HID#{00001124-0000-1000-8000-00805f9b34fb}_VID&0002%04x_PID&%04x&MI_%02u&Col%02u#9&%08x&0&0000#{4d1e55b2-f16f-11cf-88cb-001111000030}",
+            "HID\\VID_%04X&PID_%04X&MI_%02u&COL%02u\\8&%08X&0&0000",
+        };
+
+        std::mt19937 random(38);
+        std::vector<std::string> corpus;
+        char path[256];
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::snprintf(path, sizeof(path), kFormats[i % std::size(kFormats)],
+                static_cast<unsigned>(random() & 0xFFFF), static_cast<unsigned>(random() & 0xFFFF),
+                static_cast<unsigned>(random() % 4), static_cast<unsigned>(1 + random() % 4),
+                static_cast<unsigned>(random()));
+            corpus.push_back(path);
+        }
+        return corpus;
+    }
+
+    std::string ToLower(std::string s)
+    {
+        for (char& c : s)
+            c = static_cast<char>((c >= 'A' && c <= 'Z') ? c + 0x20 : c);
+        return s;
+    }
+}
+
+// Parsing and interning a corpus of device paths. Interning is measured on
+// paths already in the pool, the case for every device after the first
+// enumeration, against keying a std::string map by the lower-cased copy.
+RAWINPUT_BENCH(DevicePath)
+{
+    const std::vector<std::string> corpus = MakePathCorpus(1000);
+    size_t bytes = 0;
+    for (const std::string& path : corpus)
+        bytes += path.size();
+
+    Measure("ParseDevicePath, 1000 paths", context.Iterations(2000), bytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : corpus)
+            sum += ParseDevicePath(path).vendorId.value_or(0);
+        Consume(sum);
+    });
+
+    for (const std::string& path : corpus)
+        DevicePath::Intern(path);
+
+    Measure("DevicePath::Intern, 1000 interned paths", context.Iterations(2000), bytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : corpus)
+            sum += DevicePath::Intern(path).GetId();
+        Consume(sum);
+    });
+
+    std::unordered_map<std::string, uint32_t> lowered;
+    for (const std::string& path : corpus)
+        lowered.emplace(ToLower(path), static_cast<uint32_t>(lowered.size() + 1));
+
+    Measure("lower-case + std::unordered_map, 1000 paths", context.Iterations(2000), bytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : corpus)
+            sum += lowered.find(ToLower(path))->second;
+        Consume(sum);
+    });
+}
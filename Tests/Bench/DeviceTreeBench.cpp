@@ -0,0 +1,120 @@
+#include "Bench/Bench.h"
+
+#include "DeviceTree.h"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr DeviceGuid kUsbDeviceInterface = { 0xA5DCBF10, 0x6530, 0x11D2, { 0x90, 0x1F, 0x00, 0xC0, 0x4F, 0xB9, 0x51, 0xED } };
+
+    struct GeneratedTree
+    {
+        std::shared_ptr<FakeDeviceTreeSource> source = std::make_shared<FakeDeviceTreeSource>();
+        std::vector<std::string>              instanceIds;
+        std::vector<std::string>              hidLeaves;
+    };
+
+    // A tree of about `count` nodes shaped like a busy machine: controllers
+    // with root hubs, hubs up to three deep, USB devices with one or two HID
+    // collections each, and a USB device interface on every USB node.
+    GeneratedTree MakeTree(size_t count)
+    {
+        GeneratedTree tree;
+        std::mt19937 random(40);
+        char id[128];
+
+        auto add = [&](const std::string& instanceId, const std::string& parent)
+        {
+            tree.source->AddNode(instanceId, parent);
+            tree.instanceIds.push_back(instanceId);
+        };
+
+        add("HTREE\\ROOT\\0", "");
+        std::vector<std::string> hubs;
+        for (unsigned c = 0; c < 8; ++c)
+        {
+            std::snprintf(id, sizeof(id), "PCI\\VEN_8086&DEV_A36D&SUBSYS_86941043&REV_10\\3&11583659&0&%02X", c);
+            const std::string controller = id;
+            add(controller, "HTREE\\ROOT\\0");
+            std::snprintf(id, sizeof(id), "USB\\ROOT_HUB30\\4&%08X&0&0", c);
+            add(id, controller);
+            hubs.push_back(id);
+        }
+
+        for (unsigned n = 0; tree.instanceIds.size() < count; ++n)
+        {
+            const std::string parent = hubs[random() % hubs.size()];
+            const bool isHub = (random() % 16 == 0) && hubs.size() < 64;
+            std::snprintf(id, sizeof(id), "USB\\VID_%04X&PID_%04X\\%u&%08X&0&%u",
+                static_cast<unsigned>(random() & 0xFFFF), static_cast<unsigned>(random() & 0xFFFF), 5 + n % 3,
+                static_cast<unsigned>(random()), n % 16);
+            const std::string device = id;
+            add(device, parent);
+
+            std::snprintf(id, sizeof(id), "\\\\?\\%s#{a5dcbf10-6530-11d2-901f-00c04fb951ed}", device.c_str());
+            tree.source->AddInterface(kUsbDeviceInterface, id, device);
+
+            if (isHub)
+            {
+                hubs.push_back(device);
+                continue;
+            }
+            for (unsigned col = 1, cols = 1 + random() % 2; col <= cols; ++col)
+            {
+                std::snprintf(id, sizeof(id), "HID\\VID_045E&PID_02EA&MI_00&COL%02u\\8&%08X&0&%04u",
+                    col, static_cast<unsigned>(random()), n);
+                add(id, device);
+                tree.hidLeaves.push_back(id);
+            }
+        }
+        return tree;
+    }
+}
+
+// Snapshot cost and the queries a device arrival makes against it, on a
+// tree of about 5000 nodes.
+RAWINPUT_BENCH(DeviceTree)
+{
+    const GeneratedTree generated = MakeTree(5000);
+    std::printf("  %zu nodes, %zu HID leaves\n", generated.instanceIds.size(), generated.hidLeaves.size());
+
+    Measure("snapshot", context.Iterations(200), 0, [&]
+    {
+        Consume(DeviceTree::Snapshot(generated.source)->GetNodeCount());
+    });
+
+    const std::shared_ptr<const DeviceTree> tree = DeviceTree::Snapshot(generated.source);
+
+    Measure("FindNode, every node", context.Iterations(500), 0, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& instanceId : generated.instanceIds)
+            sum += tree->FindNode(instanceId);
+        Consume(sum);
+    });
+
+    Measure("walk to root, every HID leaf", context.Iterations(500), 0, [&]
+    {
+        uint64_t depth = 0;
+        for (const std::string& instanceId : generated.hidLeaves)
+        {
+            for (DeviceTree::NodeId node = tree->FindNode(instanceId); node != DeviceTree::kNoNode; node = tree->GetParent(node))
+                ++depth;
+        }
+        Consume(depth);
+    });
+
+    // The first call enumerates the interface class, the rest hit the cache.
+    Measure("SearchParentInterface, every HID leaf", context.Iterations(500), 0, [&]
+    {
+        uint64_t length = 0;
+        for (const std::string& instanceId : generated.hidLeaves)
+            length += tree->SearchParentInterface(tree->FindNode(instanceId), kUsbDeviceInterface).size();
+        Consume(length);
+    });
+}
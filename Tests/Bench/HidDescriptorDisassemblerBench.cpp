@@ -0,0 +1,28 @@
+#include "Bench/Bench.h"
+#include "Samples.h"
+
+#include "HidDescriptorDisassembler.h"
+
+// Disassembling descriptors of a typical and of a very large (12 KB) device,
+// with a disassembler kept across calls as RawInputInfo does.
+RAWINPUT_BENCH(HidDescriptorDisassembler)
+{
+    HidDescriptorDisassembler disassembler;
+
+    const std::vector<uint8_t> gamepad = MakeHidGamepadDescriptor();
+    Measure("gamepad, items and layout", context.Iterations(100000), gamepad.size(), [&]
+    {
+        Consume(disassembler.Disassemble(gamepad).size());
+    });
+
+    const std::vector<uint8_t> large = MakeLargeHidDescriptor(12 * 1024);
+    Measure("12 KB, items", context.Iterations(2000), large.size(), [&]
+    {
+        Consume(disassembler.Disassemble(large, HidDescriptorDisassembler::Items).size());
+    });
+    Measure("12 KB, items, bytes and layout", context.Iterations(2000), large.size(), [&]
+    {
+        Consume(disassembler.Disassemble(large, HidDescriptorDisassembler::Items | HidDescriptorDisassembler::Bytes
+            | HidDescriptorDisassembler::Layout).size());
+    });
+}
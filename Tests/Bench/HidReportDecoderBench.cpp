@@ -0,0 +1,615 @@
+#include "Bench/Bench.h"
+
+#include "HidReportDecoder.h"
+#include "Samples.h"
+#include "utils_bitset.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    // Report ID 1, 512 buttons and 64 16-bit Ordinal values: 576 controls
+    // in one 193-byte report.
+    std::vector<uint8_t> MakeWideDescriptor()
+    {
+        return {
+            0x05, 0x01,        // Usage Page (Generic Desktop)
+            0x09, 0x04,        // Usage (Joystick)
+            0xA1, 0x01,        // Collection (Application)
+            0x85, 0x01,        //   Report ID (1)
+            0x05, 0x09,        //   Usage Page (Button)
+            0x19, 0x01,        //   Usage Minimum (1)
+            0x2A, 0x00, 0x02,  //   Usage Maximum (512)
+            0x15, 0x00,        //   Logical Minimum (0)
+            0x25, 0x01,        //   Logical Maximum (1)
+            0x75, 0x01,        //   Report Size (1)
+            0x96, 0x00, 0x02,  //   Report Count (512)
+            0x81, 0x02,        //   Input (Data,Var,Abs)
+            0x05, 0x0A,        //   Usage Page (Ordinal)
+            0x19, 0x01,        //   Usage Minimum (1)
+            0x29, 0x40,        //   Usage Maximum (64)
+            0x16, 0x00, 0x80,  //   Logical Minimum (-32768)
+            0x26, 0xFF, 0x7F,  //   Logical Maximum (32767)
+            0x75, 0x10,        //   Report Size (16)
+            0x95, 0x40,        //   Report Count (64)
+            0x81, 0x02,        //   Input (Data,Var,Abs)
+            0xC0,              // End Collection
+        };
+    }
+
+    // Report IDs 1..10, each with 48 vendor-page bits and 8 16-bit Ordinal
+    // values of its own: 560 controls in 23-byte reports.
+    std::vector<uint8_t> MakeMultiReportDescriptor()
+    {
+        std::vector<uint8_t> descriptor = {
+            0x06, 0x00, 0xFF,  // Usage Page (Vendor 0xFF00)
+            0x09, 0x01,        // Usage (1)
+            0xA1, 0x01,        // Collection (Application)
+        };
+        for (uint8_t id = 1; id <= 10; ++id)
+        {
+            const uint16_t bits = static_cast<uint16_t>((id - 1) * 48);
+            const uint16_t values = static_cast<uint16_t>((id - 1) * 8);
+            const uint8_t report[] = {
+                0x85, id,                                             //   Report ID
+                0x06, 0x00, 0xFF,                                     //   Usage Page (Vendor 0xFF00)
+                0x1A, uint8_t(bits + 1), uint8_t((bits + 1) >> 8),    //   Usage Minimum
+                0x2A, uint8_t(bits + 48), uint8_t((bits + 48) >> 8),  //   Usage Maximum
+                0x15, 0x00,                                           //   Logical Minimum (0)
+                0x25, 0x01,                                           //   Logical Maximum (1)
+                0x75, 0x01,                                           //   Report Size (1)
+                0x95, 0x30,                                           //   Report Count (48)
+                0x81, 0x02,                                           //   Input (Data,Var,Abs)
+                0x05, 0x0A,                                           //   Usage Page (Ordinal)
+                0x19, uint8_t(values + 1),                            //   Usage Minimum
+                0x29, uint8_t(values + 8),                            //   Usage Maximum
+                0x16, 0x00, 0x80,                                     //   Logical Minimum (-32768)
+                0x26, 0xFF, 0x7F,                                     //   Logical Maximum (32767)
+                0x75, 0x10,                                           //   Report Size (16)
+                0x95, 0x08,                                           //   Report Count (8)
+                0x81, 0x02,                                           //   Input (Data,Var,Abs)
+            };
+            descriptor.insert(descriptor.end(), std::begin(report), std::end(report));
+        }
+        descriptor.push_back(0xC0); // End Collection
+        return descriptor;
+    }
+
+    std::string DescribeControls(const HidReportDecoder& decoder)
+    {
+        return std::to_string(decoder.GetButtonCount() + decoder.GetAxisCount() + decoder.GetSwitchCount()) + " controls";
+    }
+}
+
+// Decode throughput on descriptors with 500+ controls: many small reports
+// under different Report IDs, and one wide report with everything or only
+// two axes changing. Then usage lookups through the control registry.
+RAWINPUT_BENCH(HidReportDecoder)
+{
+    const size_t reports = context.quick ? 64 : 50000;
+
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(MakeMultiReportDescriptor()));
+        const size_t reportSize = decoder.GetModel()->GetInputReportSize();
+
+        std::vector<uint8_t> stream(reports * reportSize);
+        for (size_t i = 0; i < reports; ++i)
+        {
+            uint8_t* report = &stream[i * reportSize];
+            report[0] = static_cast<uint8_t>(1 + i % 10);
+            for (size_t b = 1; b < reportSize; ++b)
+                report[b] = static_cast<uint8_t>(i * 7 + b * 13);
+        }
+
+        Measure("10 Report IDs, " + DescribeControls(decoder), context.Iterations(10), stream.size(), [&]
+        {
+            decoder.Decode(stream.data(), reportSize, reports, 0);
+            Consume(decoder.GetDecodeStats().reports);
+        });
+    }
+
+    HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(MakeWideDescriptor()));
+    const size_t reportSize = decoder.GetModel()->GetInputReportSize();
+
+    std::vector<uint8_t> changing(reports * reportSize);
+    std::vector<uint8_t> twoAxes(reports * reportSize, 0);
+    for (size_t i = 0; i < reports; ++i)
+    {
+        uint8_t* report = &changing[i * reportSize];
+        report[0] = 1;
+        for (size_t b = 1; b < reportSize; ++b)
+            report[b] = static_cast<uint8_t>(i * 7 + b * 13);
+
+        // A stick moving, everything else still: the first two values.
+        uint8_t* still = &twoAxes[i * reportSize];
+        still[0] = 1;
+        still[65] = static_cast<uint8_t>(i);
+        still[67] = static_cast<uint8_t>(i * 3);
+    }
+
+    Measure("one report, " + DescribeControls(decoder) + ", all changing", context.Iterations(5), changing.size(), [&]
+    {
+        decoder.Decode(changing.data(), reportSize, reports, 0);
+        Consume(decoder.GetDecodeStats().reports);
+    });
+
+    Measure("one report, " + DescribeControls(decoder) + ", two axes changing", context.Iterations(10), twoAxes.size(), [&]
+    {
+        decoder.Decode(twoAxes.data(), reportSize, reports, 0);
+        Consume(decoder.GetDecodeStats().partial);
+    });
+
+    const HidControlRegistry& controls = decoder.GetControls();
+    Measure("find every control by usage", context.Iterations(1000), 0, [&]
+    {
+        uint64_t found = 0;
+        for (const HidControlRegistry::Entry& entry : controls.GetEntries())
+            found += controls.Find(entry.usagePage, entry.usage)->index;
+        Consume(found);
+    });
+}
+
+namespace
+{
+    // Report ID 1 and eight absolute axes (X .. 0x37) of `bits` bits each.
+    std::vector<uint8_t> MakeAxesDescriptor(uint8_t bits)
+    {
+        const uint32_t max = (1u << bits) - 1;
+        return {
+            0x05, 0x01,        // Usage Page (Generic Desktop)
+            0x09, 0x04,        // Usage (Joystick)
+            0xA1, 0x01,        // Collection (Application)
+            0x85, 0x01,        //   Report ID (1)
+            0x19, 0x30,        //   Usage Minimum (X)
+            0x29, 0x37,        //   Usage Maximum (0x37)
+            0x15, 0x00,        //   Logical Minimum (0)
+            0x27, uint8_t(max), uint8_t(max >> 8), uint8_t(max >> 16), uint8_t(max >> 24), // Logical Maximum
+            0x75, bits,        //   Report Size
+            0x95, 0x08,        //   Report Count (8)
+            0x81, 0x02,        //   Input (Data,Var,Abs)
+            0xC0,              // End Collection
+        };
+    }
+}
+
+// Calibrated axes: 12-bit axes read their value from a table, 16-bit ones
+// are too wide for one and run the curve arithmetic after normalising.
+// Each is measured against the same axes uncalibrated.
+RAWINPUT_BENCH(AxisCalibration)
+{
+    const size_t reports = context.quick ? 64 : 200000;
+    const AxisCalibration calibration = { .deadzone = 0.1f, .saturation = 0.95f, .exponent = 2.f };
+
+    for (uint8_t bits : { uint8_t(12), uint8_t(16) })
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(MakeAxesDescriptor(bits)));
+        const size_t reportSize = decoder.GetModel()->GetInputReportSize();
+
+        // Every axis moves in every report.
+        std::vector<uint8_t> stream(reports * reportSize);
+        for (size_t i = 0; i < reports; ++i)
+        {
+            uint8_t* report = &stream[i * reportSize];
+            report[0] = 1;
+            for (size_t b = 1; b < reportSize; ++b)
+                report[b] = static_cast<uint8_t>(i * 7 + b * 13);
+        }
+
+        const std::string axes = std::to_string(bits) + "-bit axes, ";
+        Measure(axes + "uncalibrated", context.Iterations(10), stream.size(), [&]
+        {
+            decoder.Decode(stream.data(), reportSize, reports, 0);
+            Consume(decoder.GetDecodeStats().reports);
+        });
+
+        for (size_t a = 0; a < decoder.GetAxisCount(); ++a)
+            decoder.SetAxisCalibration(a, calibration);
+
+        Measure(axes + (bits <= 12 ? "LUT" : "arithmetic curve"), context.Iterations(10), stream.size(), [&]
+        {
+            decoder.Decode(stream.data(), reportSize, reports, 0);
+            Consume(decoder.GetDecodeStats().reports);
+        });
+    }
+}
+
+namespace
+{
+    // Gamepad report of Samples' gamepad descriptor.
+    void WriteGamepadReport(uint8_t* report, uint16_t buttons, uint8_t hat, uint8_t x, uint8_t y)
+    {
+        const uint8_t bytes[] = { 0x01, uint8_t(buttons), uint8_t(buttons >> 8), hat, x, y, 0x80, 0x80 };
+        std::copy(std::begin(bytes), std::end(bytes), report);
+    }
+}
+
+// A gamepad streaming at its polling rate: an idle capture (every report
+// repeats the previous one and is skipped), a stick moving (only the axis
+// fields are re-decoded) and an active capture where buttons, hat and sticks
+// change in every report.
+RAWINPUT_BENCH(ReportDedup)
+{
+    const size_t reports = context.quick ? 64 : 200000;
+    const std::vector<uint8_t> descriptor = MakeHidGamepadDescriptor();
+    const size_t reportSize = HidDeviceModel::AcquireFromDescriptor(descriptor)->GetInputReportSize();
+
+    std::vector<uint8_t> idle(reports * reportSize), stick(reports * reportSize), active(reports * reportSize);
+    for (size_t i = 0; i < reports; ++i)
+    {
+        WriteGamepadReport(&idle[i * reportSize], 0, 0x08, 0x80, 0x80);
+        WriteGamepadReport(&stick[i * reportSize], 0, 0x08, static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3));
+        WriteGamepadReport(&active[i * reportSize], static_cast<uint16_t>(i * 0x9E5), static_cast<uint8_t>(i % 9),
+            static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3));
+    }
+
+    const std::pair<const char*, const std::vector<uint8_t>*> captures[] = {
+        { "idle capture", &idle }, { "stick moving", &stick }, { "active capture", &active },
+    };
+    for (const auto& [name, stream] : captures)
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(descriptor));
+        Measure(name, context.Iterations(10), stream->size(), [&]
+        {
+            decoder.Decode(stream->data(), reportSize, reports, 0);
+            Consume(decoder.GetDecodeStats().reports);
+        });
+
+        const HidDecodeStats stats = decoder.GetDecodeStats();
+        std::printf("    %llu reports: %llu skipped, %llu partially decoded\n", static_cast<unsigned long long>(stats.reports),
+            static_cast<unsigned long long>(stats.skipped), static_cast<unsigned long long>(stats.partial));
+    }
+}
+
+// One second of input from 32 gamepads polled at 1 kHz, each report handed
+// to Decode() on its own as OnInput does, with the first device read after
+// every report. Eagerly decoded against deferred decode on the 31 devices
+// nobody reads: the time per iteration is the input thread's CPU per second.
+RAWINPUT_BENCH(DeferredDecode)
+{
+    constexpr size_t kDevices = 32;
+    constexpr size_t kReportsPerSecond = 1000;
+    const std::vector<uint8_t> descriptor = MakeHidGamepadDescriptor();
+    const size_t reportSize = HidDeviceModel::AcquireFromDescriptor(descriptor)->GetInputReportSize();
+
+    // Sticks and buttons moving, so no report is skipped as a repeat.
+    std::vector<uint8_t> stream(kReportsPerSecond * reportSize);
+    for (size_t i = 0; i < kReportsPerSecond; ++i)
+    {
+        WriteGamepadReport(&stream[i * reportSize], static_cast<uint16_t>(i / 50), 0x08,
+            static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3));
+    }
+
+    for (bool deferred : { false, true })
+    {
+        std::vector<std::unique_ptr<HidReportDecoder>> decoders;
+        for (size_t d = 0; d < kDevices; ++d)
+        {
+            decoders.push_back(std::make_unique<HidReportDecoder>(HidDeviceModel::AcquireFromDescriptor(descriptor)));
+            decoders.back()->SetDeferredDecode(deferred && d != 0);
+        }
+
+        Measure(deferred ? "32 devices, 31 deferred, 1 read" : "32 devices, all decoded, 1 read",
+            context.Iterations(20), kDevices * stream.size(), [&]
+        {
+            HidReportDecoder::Snapshot state;
+            float sum = 0.f;
+            for (size_t i = 0; i < kReportsPerSecond; ++i)
+            {
+                for (const std::unique_ptr<HidReportDecoder>& decoder : decoders)
+                    decoder->Decode(&stream[i * reportSize], reportSize, 1, i);
+                decoders.front()->ReadSnapshot(state);
+                sum += state.GetAxis(0);
+            }
+            Consume(static_cast<uint64_t>(sum));
+        });
+    }
+}
+
+// RAWHID bursts of 8 gamepad reports (dwCount = 8), every report changing:
+// decoded one Decode() call per report, as one batch in each HidBatchMode,
+// and with the history copied out after every batch.
+RAWINPUT_BENCH(BatchDecode)
+{
+    constexpr size_t kBurst = 8;
+    const size_t bursts = context.quick ? 8 : 25000;
+    const std::vector<uint8_t> descriptor = MakeHidGamepadDescriptor();
+    const size_t reportSize = HidDeviceModel::AcquireFromDescriptor(descriptor)->GetInputReportSize();
+
+    std::vector<uint8_t> stream(bursts * kBurst * reportSize);
+    for (size_t i = 0; i < bursts * kBurst; ++i)
+    {
+        WriteGamepadReport(&stream[i * reportSize], static_cast<uint16_t>(i * 0x9E5), static_cast<uint8_t>(i % 9),
+            static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3));
+    }
+    const size_t burstBytes = kBurst * reportSize;
+
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(descriptor));
+        Measure("8 Decode() calls of one report", context.Iterations(20), stream.size(), [&]
+        {
+            for (size_t i = 0; i < bursts * kBurst; ++i)
+                decoder.Decode(&stream[i * reportSize], reportSize, 1, 0);
+            Consume(decoder.GetDecodeStats().reports);
+        });
+    }
+
+    const std::pair<const char*, HidBatchMode> modes[] = {
+        { "burst of 8, Sequential", HidBatchMode::Sequential },
+        { "burst of 8, LatestOnly", HidBatchMode::LatestOnly },
+        { "burst of 8, History", HidBatchMode::History },
+    };
+    for (const auto& [name, mode] : modes)
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(descriptor));
+        decoder.SetBatchMode(mode);
+        Measure(name, context.Iterations(20), stream.size(), [&]
+        {
+            for (size_t b = 0; b < bursts; ++b)
+                decoder.Decode(&stream[b * burstBytes], reportSize, kBurst, 0);
+            Consume(decoder.GetDecodeStats().reports);
+        });
+    }
+
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(descriptor));
+        decoder.SetBatchMode(HidBatchMode::History);
+        HidReportHistory history;
+        Measure("burst of 8, History + CopyHistory()", context.Iterations(20), stream.size(), [&]
+        {
+            for (size_t b = 0; b < bursts; ++b)
+            {
+                decoder.Decode(&stream[b * burstBytes], reportSize, kBurst, 0);
+                decoder.CopyHistory(history);
+            }
+            Consume(decoder.GetDecodeStats().reports);
+        });
+    }
+}
+
+namespace
+{
+    // Report ID 1 and 128 buttons: a HOTAS or button box, 17-byte reports.
+    std::vector<uint8_t> Make128ButtonDescriptor()
+    {
+        return {
+            0x05, 0x01,        // Usage Page (Generic Desktop)
+            0x09, 0x04,        // Usage (Joystick)
+            0xA1, 0x01,        // Collection (Application)
+            0x85, 0x01,        //   Report ID (1)
+            0x05, 0x09,        //   Usage Page (Button)
+            0x19, 0x01,        //   Usage Minimum (1)
+            0x29, 0x80,        //   Usage Maximum (128)
+            0x15, 0x00,        //   Logical Minimum (0)
+            0x25, 0x01,        //   Logical Maximum (1)
+            0x75, 0x01,        //   Report Size (1)
+            0x96, 0x80, 0x00,  //   Report Count (128)
+            0x81, 0x02,        //   Input (Data,Var,Abs)
+            0xC0,              // End Collection
+        };
+    }
+
+    // Button state as it was kept before the packed words: a padded struct
+    // per button and a std::vector<bool> mask per Report ID.
+    struct ButtonStateAoS
+    {
+        bool     value = false;
+        uint16_t usagePage = 0;
+        uint16_t usage = 0;
+        uint16_t linkCollection = 0;
+        uint8_t  reportId = 0;
+        uint16_t reportCount = 1;
+    };
+}
+
+// 128-button reports with a few buttons changing each time: the per-bit
+// reset through the Report ID mask map, per-button stores and edges found
+// by comparing bools, against whole-word clear, store and XOR edges, and
+// the decoder's full path with the edges read back through a snapshot.
+RAWINPUT_BENCH(Buttons128)
+{
+    constexpr size_t kButtons = 128;
+    constexpr size_t kReportSize = 1 + kButtons / 8;
+    const size_t reports = context.quick ? 64 : 200000;
+
+    std::mt19937 random(28);
+    std::vector<uint8_t> stream(reports * kReportSize);
+    uint8_t held[kButtons / 8] = {};
+    for (size_t i = 0; i < reports; ++i)
+    {
+        held[random() % sizeof(held)] ^= static_cast<uint8_t>(1u << (random() % 8));
+        stream[i * kReportSize] = 1;
+        std::copy(std::begin(held), std::end(held), &stream[i * kReportSize + 1]);
+    }
+
+    {
+        std::vector<ButtonStateAoS> buttons(kButtons);
+        std::vector<bool> previous(kButtons), pressed(kButtons), released(kButtons);
+        std::unordered_map<uint8_t, std::vector<bool>> reportMasks;
+        reportMasks[1] = std::vector<bool>(kButtons, true);
+
+        Measure("bool per button, per-bit mask map", context.Iterations(20), stream.size(), [&]
+        {
+            for (size_t r = 0; r < reports; ++r)
+            {
+                const uint8_t* report = &stream[r * kReportSize];
+                for (size_t i = 0; i < kButtons; ++i)
+                    previous[i] = buttons[i].value;
+                if (auto it = reportMasks.find(report[0]); it != reportMasks.end())
+                {
+                    for (size_t i = 0; i < kButtons; ++i)
+                        if (it->second[i])
+                            buttons[i].value = false;
+                }
+                for (size_t i = 0; i < kButtons; ++i)
+                    if ((report[1 + i / 8] >> (i % 8)) & 1)
+                        buttons[i].value = true;
+                for (size_t i = 0; i < kButtons; ++i)
+                {
+                    pressed[i] = buttons[i].value && !previous[i];
+                    released[i] = !buttons[i].value && previous[i];
+                }
+            }
+            Consume(pressed[0] + released[0]);
+        });
+    }
+
+    {
+        constexpr size_t kWords = BitWordCount(kButtons);
+        std::array<std::array<uint64_t, kWords>, 256> reportMasks{};
+        reportMasks[1].fill(~uint64_t(0));
+        uint64_t words[kWords] = {}, before[kWords], pressed[kWords], released[kWords];
+
+        Measure("packed words, XOR edges", context.Iterations(20), stream.size(), [&]
+        {
+            for (size_t r = 0; r < reports; ++r)
+            {
+                const uint8_t* report = &stream[r * kReportSize];
+                std::copy(std::begin(words), std::end(words), before);
+                ClearBits(words, reportMasks[report[0]]);
+                uint64_t bits[kWords];
+                std::memcpy(bits, report + 1, sizeof(bits));
+                for (size_t w = 0; w < kWords; ++w)
+                    words[w] |= bits[w];
+                std::fill(std::begin(pressed), std::end(pressed), 0);
+                std::fill(std::begin(released), std::end(released), 0);
+                AccumulateEdges(before, words, pressed, released);
+            }
+            Consume(pressed[0] ^ released[1]);
+        });
+    }
+
+    {
+        HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(Make128ButtonDescriptor()));
+        HidReportDecoder::Snapshot snapshot;
+        Measure("HidReportDecoder, " + DescribeControls(decoder) + ", snapshot per report", context.Iterations(20), stream.size(), [&]
+        {
+            for (size_t r = 0; r < reports; ++r)
+            {
+                decoder.Decode(&stream[r * kReportSize], kReportSize, 1, 0);
+                decoder.ReadSnapshot(snapshot);
+            }
+            Consume(snapshot.pressed[0] ^ snapshot.released[1]);
+        });
+    }
+}
+
+namespace
+{
+    struct AxisStateAoS
+    {
+        float    value = 0.f;
+        int32_t  logicalMin = 0;
+        int32_t  logicalMax = 0;
+        uint16_t bitSize = 0;
+        bool     isSigned = false;
+        bool     isAbsolute = true;
+        uint16_t usagePage = 0;
+        uint16_t usage = 0;
+        uint16_t linkCollection = 0;
+        uint8_t  reportId = 0;
+        int32_t  physicalMin = 0;
+        int32_t  physicalMax = 0;
+        uint32_t units = 0;
+        int16_t  unitsExp = 0;
+        uint16_t reportCount = 1;
+    };
+
+    struct SwitchStateAoS
+    {
+        SwitchPosition value = SwitchPosition::Center;
+        int32_t        logicalMin = 0;
+        int32_t        logicalMax = 0;
+        uint16_t       usagePage = 0;
+        uint16_t       usage = 0;
+    };
+
+    // Control state as RawInputDeviceHid held it inline before it was sized
+    // from the descriptor: 16 axes, 32 buttons and 4 switches at most.
+    struct FixedControlState
+    {
+        AxisStateAoS   axes[16]{};
+        ButtonStateAoS buttons[32]{};
+        SwitchStateAoS switches[4]{};
+    };
+}
+
+// Control storage sized from the descriptor against the old fixed arrays:
+// what each keeps of a gamepad and of a 128-button device, the cost of
+// setting up a device's state, and decoding from inline storage (gamepad)
+// and from the one heap block of a large device.
+RAWINPUT_BENCH(ControlStorage)
+{
+    const size_t reports = context.quick ? 64 : 200000;
+    const std::vector<uint8_t> gamepad = MakeHidGamepadDescriptor();
+    const std::vector<uint8_t> buttons = Make128ButtonDescriptor();
+
+    std::printf("  %-48s %zu bytes per device\n", "fixed arrays (16 axes, 32 buttons, 4 switches)", sizeof(FixedControlState));
+    std::printf("  %-48s %zu bytes inline, larger devices one heap block\n", "HidReportDecoder control storage",
+        HidReportDecoder::kInlineStorageBytes);
+    for (const auto& [name, descriptor] : { std::pair{ "gamepad", &gamepad }, std::pair{ "128 buttons", &buttons } })
+    {
+        const HidReportDecoder decoder(HidDeviceModel::AcquireFromDescriptor(*descriptor));
+        const size_t kept = std::min<size_t>(decoder.GetAxisCount(), 16) + std::min<size_t>(decoder.GetButtonCount(), 32)
+            + std::min<size_t>(decoder.GetSwitchCount(), 4);
+        std::printf("  %-48s %zu controls, %zu kept by the fixed arrays\n", name, decoder.GetAxisCount() + decoder.GetButtonCount()
+            + decoder.GetSwitchCount(), kept);
+    }
+
+    Measure("set up fixed arrays", context.Iterations(1000000), 0, [&]
+    {
+        auto state = std::make_unique<FixedControlState>();
+        Consume(state->buttons[0].value);
+    });
+
+    const std::shared_ptr<const HidDeviceModel> gamepadModel = HidDeviceModel::AcquireFromDescriptor(gamepad);
+    const std::shared_ptr<const HidDeviceModel> buttonsModel = HidDeviceModel::AcquireFromDescriptor(buttons);
+    Measure("set up decoder, gamepad (inline storage)", context.Iterations(1000000), 0, [&]
+    {
+        HidReportDecoder decoder(gamepadModel);
+        Consume(decoder.GetAxisCount());
+    });
+    Measure("set up decoder, 128 buttons (one heap block)", context.Iterations(1000000), 0, [&]
+    {
+        HidReportDecoder decoder(buttonsModel);
+        Consume(decoder.GetButtonCount());
+    });
+
+    // Every report changes, so each one is decoded.
+    const size_t gamepadSize = gamepadModel->GetInputReportSize();
+    std::vector<uint8_t> gamepadStream(reports * gamepadSize);
+    for (size_t i = 0; i < reports; ++i)
+    {
+        WriteGamepadReport(&gamepadStream[i * gamepadSize], static_cast<uint16_t>(i * 0x9E5), static_cast<uint8_t>(i % 9),
+            static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3));
+    }
+
+    const size_t buttonsSize = buttonsModel->GetInputReportSize();
+    std::vector<uint8_t> buttonsStream(reports * buttonsSize);
+    for (size_t i = 0; i < reports; ++i)
+    {
+        buttonsStream[i * buttonsSize] = 1;
+        buttonsStream[i * buttonsSize + 1 + i % 16] = static_cast<uint8_t>(i);
+    }
+
+    HidReportDecoder gamepadDecoder(gamepadModel);
+    Measure("decode, gamepad (inline storage)", context.Iterations(10), gamepadStream.size(), [&]
+    {
+        gamepadDecoder.Decode(gamepadStream.data(), gamepadSize, reports, 0);
+        Consume(gamepadDecoder.GetDecodeStats().reports);
+    });
+
+    HidReportDecoder buttonsDecoder(buttonsModel);
+    Measure("decode, 128 buttons (one heap block)", context.Iterations(10), buttonsStream.size(), [&]
+    {
+        buttonsDecoder.Decode(buttonsStream.data(), buttonsSize, reports, 0);
+        Consume(buttonsDecoder.GetDecodeStats().reports);
+    });
+}
@@ -0,0 +1,36 @@
+#include "Bench/Bench.h"
+#include "HotplugGenerator.h"
+
+// Feeding and draining the coalescer during a storm, the per-notification
+// cost the manager adds on top of creating and destroying devices.
+RAWINPUT_BENCH(Hotplug)
+{
+    using namespace std::chrono_literals;
+
+    HotplugGenerator generator(1);
+    const std::vector<HotplugGenerator::Notification> storm = generator.MakeStorm(4096, 64, 10);
+
+    Measure("coalesce 4096 notifications", context.Iterations(500), 0, [&]
+    {
+        HotplugCoalescer coalescer(30ms, 250ms);
+        HotplugCoalescer::Clock::time_point now{};
+        uint64_t changes = 0;
+
+        for (const HotplugGenerator::Notification& notification : storm)
+        {
+            now += notification.delay;
+            if (coalescer.IsDue(now))
+            {
+                const HotplugCoalescer::Batch batch = coalescer.Take();
+                changes += batch.removed.size() + batch.arrived.size();
+            }
+
+            if (notification.arrival)
+                coalescer.OnArrival(notification.key, now);
+            else
+                coalescer.OnRemoval(notification.key, now);
+        }
+        changes += coalescer.Take().arrived.size();
+        Consume(changes);
+    });
+}
@@ -0,0 +1,89 @@
+#include "Bench/Bench.h"
+
+#include "InputPipeline.h"
+#include "SyntheticInputBackend.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // Report ID 1, 64 buttons and 32 16-bit axes: 73-byte reports, about a
+    // hundred ops per decode.
+    std::vector<uint8_t> MakeWideDescriptor()
+    {
+        return {
+            0x05, 0x01,        // Usage Page (Generic Desktop)
+            0x09, 0x04,        // Usage (Joystick)
+            0xA1, 0x01,        // Collection (Application)
+            0x85, 0x01,        //   Report ID (1)
+            0x05, 0x09,        //   Usage Page (Button)
+            0x19, 0x01,        //   Usage Minimum (1)
+            0x29, 0x40,        //   Usage Maximum (64)
+            0x15, 0x00,        //   Logical Minimum (0)
+            0x25, 0x01,        //   Logical Maximum (1)
+            0x75, 0x01,        //   Report Size (1)
+            0x95, 0x40,        //   Report Count (64)
+            0x81, 0x02,        //   Input (Data,Var,Abs)
+            0x05, 0x01,        //   Usage Page (Generic Desktop)
+            0x19, 0x30,        //   Usage Minimum (X)
+            0x29, 0x4F,        //   Usage Maximum (0x4F)
+            0x16, 0x00, 0x80,  //   Logical Minimum (-32768)
+            0x26, 0xFF, 0x7F,  //   Logical Maximum (32767)
+            0x75, 0x10,        //   Report Size (16)
+            0x95, 0x20,        //   Report Count (32)
+            0x81, 0x02,        //   Input (Data,Var,Abs)
+            0xC0,              // End Collection
+        };
+    }
+
+    constexpr size_t kReportSize = 73;
+    constexpr size_t kDevices = 32;
+}
+
+// The whole pipeline off Windows: 32 synthetic devices sending generated
+// reports in virtual time, copied by the backend thread and decoded by 1, 2,
+// 4, ... workers up to one per hardware thread. Scaling stops where the
+// backend thread's copying, or the core count, becomes the limit.
+RAWINPUT_BENCH(ParallelDecode)
+{
+    const uint64_t packets = context.quick ? 256 : 200000;
+    const size_t maxWorkers = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    SyntheticInputBackend::DeviceSpec spec;
+    spec.reportRate = 1000;
+    spec.reportSize = kReportSize;
+    spec.reportDescriptor = MakeWideDescriptor();
+
+    SyntheticInputBackend::Config config;
+    config.realTime = false;
+    config.packetLimit = packets;
+    config.devices.assign(kDevices, spec);
+
+    for (size_t workers = 1; ; workers = std::min(workers * 2, maxWorkers))
+    {
+        const std::string label = "decode " + std::to_string(packets) + " reports, " + std::to_string(workers) + " workers";
+        Measure(label, context.Iterations(5), packets * kReportSize, [&]
+        {
+            auto backend = std::make_unique<SyntheticInputBackend>(config);
+            SyntheticInputBackend& synthetic = *backend;
+
+            InputPipeline pipeline(std::move(backend), workers);
+            pipeline.Start();
+            while (synthetic.GetPacketCount() < packets)
+                std::this_thread::yield();
+            pipeline.Flush();
+
+            uint64_t decoded = 0;
+            for (InputPipeline::DeviceHandle handle : pipeline.GetDevices())
+                decoded += pipeline.GetDecoder(handle)->GetDecodeStats().reports;
+            Consume(decoded);
+
+            pipeline.Stop();
+        });
+
+        if (workers == maxWorkers)
+            break;
+    }
+}
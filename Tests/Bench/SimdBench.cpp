@@ -0,0 +1,267 @@
+#include "Bench/Bench.h"
+
+#include "utils_simd.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // The byte loops the kernels replaced.
+
+    uint8_t Fold(uint8_t c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<uint8_t>(c - 0x20) : c;
+    }
+
+    int CompareNoCaseScalar(const char* a, const char* b, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const uint8_t fa = Fold(static_cast<uint8_t>(a[i]));
+            const uint8_t fb = Fold(static_cast<uint8_t>(b[i]));
+            if (fa != fb)
+                return int(fa) - int(fb);
+        }
+        return 0;
+    }
+
+    size_t FindNoCaseScalar(const char* haystack, size_t haystackSize, const char* needle, size_t needleSize)
+    {
+        for (size_t i = 0; i + needleSize <= haystackSize; ++i)
+        {
+            if (CompareNoCaseScalar(haystack + i, needle, needleSize) == 0)
+                return i;
+        }
+        return SIZE_MAX;
+    }
+
+    uint64_t HashNoCaseScalar(const char* s, size_t size)
+    {
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= Fold(static_cast<uint8_t>(s[i]));
+            h *= 0x100000001B3ull;
+        }
+        return h;
+    }
+
+    bool DiffBytesScalar(const uint8_t* a, const uint8_t* b, size_t size, uint64_t* diffMask)
+    {
+        bool any = false;
+        for (size_t w = 0; w < (size + 63) / 64; ++w)
+            diffMask[w] = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                diffMask[i / 64] |= uint64_t(1) << (i % 64);
+                any = true;
+            }
+        }
+        return any;
+    }
+
+    // Device interface paths as the device manager compares and hashes them.
+    std::vector<std::string> MakePaths(size_t count)
+    {
+        std::mt19937 random(39);
+        std::vector<std::string> paths;
+        for (size_t i = 0; i < count; ++i)
+        {
+            char path[160];
+            std::snprintf(path, sizeof(path),
+                "\\\\?\\HID#VID_%04X&PID_%04X&MI_00&Col01#8&%08x&0&0000#{4d1e55b2-f16f-11cf-88cb-001111000030}",
+                static_cast<unsigned>(random() & 0xFFFF), static_cast<unsigned>(random() & 0xFFFF),
+                static_cast<unsigned>(random()));
+            paths.push_back(path);
+        }
+        return paths;
+    }
+}
+
+// Case-insensitive path kernels and the report diff, each against the
+// byte loop it replaced. The instruction set is the one this binary was
+// built for.
+RAWINPUT_BENCH(Simd)
+{
+    std::printf("  instruction set: %s\n", simd::GetInstructionSet());
+
+    const std::vector<std::string> paths = MakePaths(256);
+    std::vector<std::string> lowered = paths;
+    for (std::string& path : lowered)
+    {
+        for (char& c : path)
+            c = static_cast<char>((c >= 'A' && c <= 'Z') ? c + 0x20 : c);
+    }
+    size_t pathBytes = 0;
+    for (const std::string& path : paths)
+        pathBytes += path.size();
+
+    Measure("CompareNoCase, paths, scalar", context.Iterations(20000), pathBytes, [&]
+    {
+        int sum = 0;
+        for (size_t i = 0; i < paths.size(); ++i)
+            sum += CompareNoCaseScalar(paths[i].data(), lowered[i].data(), paths[i].size());
+        Consume(static_cast<uint64_t>(sum));
+    });
+    Measure("CompareNoCase, paths, simd", context.Iterations(20000), pathBytes, [&]
+    {
+        int sum = 0;
+        for (size_t i = 0; i < paths.size(); ++i)
+            sum += simd::CompareNoCase(paths[i].data(), lowered[i].data(), paths[i].size());
+        Consume(static_cast<uint64_t>(sum));
+    });
+
+    // The interface class GUID sits at the end of every path.
+    const std::string guid = "{4D1E55B2-F16F-11CF-88CB-001111000030}";
+    Measure("FindNoCase, class GUID, scalar", context.Iterations(5000), pathBytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : lowered)
+            sum += FindNoCaseScalar(path.data(), path.size(), guid.data(), guid.size());
+        Consume(sum);
+    });
+    Measure("FindNoCase, class GUID, simd", context.Iterations(5000), pathBytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : lowered)
+            sum += simd::FindNoCase(path.data(), path.size(), guid.data(), guid.size());
+        Consume(sum);
+    });
+
+    Measure("HashNoCase, paths, scalar FNV-1a", context.Iterations(20000), pathBytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : paths)
+            sum += HashNoCaseScalar(path.data(), path.size());
+        Consume(sum);
+    });
+    Measure("HashNoCase, paths, simd", context.Iterations(20000), pathBytes, [&]
+    {
+        uint64_t sum = 0;
+        for (const std::string& path : paths)
+            sum += simd::HashNoCase(path.data(), path.size());
+        Consume(sum);
+    });
+
+    // A 64-byte report against the previous one, two bytes changed.
+    std::vector<uint8_t> previous(64), report(64);
+    for (size_t i = 0; i < previous.size(); ++i)
+        previous[i] = report[i] = static_cast<uint8_t>(i * 37);
+    report[5] ^= 0x10;
+    report[40] ^= 0x01;
+    uint64_t mask[1];
+
+    Measure("DiffBytes, 64-byte report, scalar", context.Iterations(5000000), report.size(), [&]
+    {
+        Consume(DiffBytesScalar(previous.data(), report.data(), report.size(), mask) + mask[0]);
+    });
+    Measure("DiffBytes, 64-byte report, simd", context.Iterations(5000000), report.size(), [&]
+    {
+        Consume(simd::DiffBytes(previous.data(), report.data(), report.size(), mask) + mask[0]);
+    });
+}
+
+namespace
+{
+    // Axis state as one array of structs, hot and cold fields mixed, the
+    // layout the decoder normalised from before the split.
+    struct AxisStateAoS
+    {
+        float    value = 0.f;
+        int32_t  logicalMin = 0;
+        int32_t  logicalMax = 0;
+        uint16_t bitSize = 0;
+        bool     isSigned = false;
+        bool     isAbsolute = true;
+
+        uint16_t usagePage = 0;
+        uint16_t usage = 0;
+        uint16_t linkCollection = 0;
+        uint8_t  reportId = 0;
+        int32_t  physicalMin = 0;
+        int32_t  physicalMax = 0;
+        uint32_t units = 0;
+        int16_t  unitsExp = 0;
+        uint16_t reportCount = 1;
+    };
+
+    // The per-axis normalisation the SIMD pass replaced: sign extension and
+    // a float divide per axis per report.
+    float NormaliseAxisScalar(int32_t lv, const AxisStateAoS& ax)
+    {
+        if (ax.isSigned && ax.bitSize < 32)
+        {
+            const int32_t shift = 32 - ax.bitSize;
+            lv = static_cast<int32_t>(static_cast<uint32_t>(lv) << shift) >> shift;
+        }
+
+        if (!ax.isAbsolute)
+            return ax.value + static_cast<float>(lv);
+
+        const float min = static_cast<float>(ax.logicalMin);
+        const float max = static_cast<float>(ax.logicalMax);
+        const float range = max - min;
+        if (range == 0.f)
+            return 0.f;
+
+        const float t = (static_cast<float>(lv) - min) / range;
+        return std::clamp(2.f * t - 1.f, -1.f, 1.f);
+    }
+}
+
+// Normalising every axis of a report: the old per-axis NormaliseAxis over
+// the array of structs against simd::NormaliseAxes over the hot arrays, for
+// a gamepad's 8 axes and a 64-axis panel, 16-bit signed.
+RAWINPUT_BENCH(NormaliseAxes)
+{
+    const size_t reports = context.quick ? 64 : 100000;
+
+    for (size_t axes : { size_t(8), size_t(64) })
+    {
+        std::mt19937 random(29);
+        std::vector<int32_t> raw(reports * axes);
+        for (int32_t& value : raw)
+            value = static_cast<int32_t>(static_cast<int16_t>(random()));
+
+        std::vector<AxisStateAoS> state(axes);
+        for (AxisStateAoS& ax : state)
+        {
+            ax.logicalMin = -32768;
+            ax.logicalMax = 32767;
+            ax.bitSize = 16;
+            ax.isSigned = true;
+        }
+
+        // value = clamp(raw * scale + offset, -1, 1), the same map.
+        const float range = 65535.f;
+        const std::vector<float> scale(axes, 2.f / range);
+        const std::vector<float> offset(axes, 2.f * 32768.f / range - 1.f);
+        const std::vector<float> lo(axes, -1.f), hi(axes, 1.f);
+        std::vector<float> values(axes);
+
+        const std::string label = std::to_string(axes) + " axes, ";
+        Measure(label + "NormaliseAxis per axis", context.Iterations(50), reports * axes * sizeof(int32_t), [&]
+        {
+            for (size_t r = 0; r < reports; ++r)
+            {
+                const int32_t* report = &raw[r * axes];
+                for (size_t a = 0; a < axes; ++a)
+                    state[a].value = NormaliseAxisScalar(report[a], state[a]);
+            }
+            Consume(static_cast<uint64_t>(static_cast<int64_t>(state[0].value * 1000.f)));
+        });
+
+        Measure(label + "simd::NormaliseAxes", context.Iterations(50), reports * axes * sizeof(int32_t), [&]
+        {
+            for (size_t r = 0; r < reports; ++r)
+                simd::NormaliseAxes(&raw[r * axes], scale.data(), offset.data(), lo.data(), hi.data(), values.data(), axes);
+            Consume(static_cast<uint64_t>(static_cast<int64_t>(values[0] * 1000.f)));
+        });
+    }
+}
@@ -0,0 +1,53 @@
+#include "Bench/Bench.h"
+#include "Samples.h"
+
+#include "UsbDescriptor.h"
+
+#include <vector>
+
+// Walking and parsing a configuration descriptor set, as done for every USB
+// device on arrival.
+RAWINPUT_BENCH(UsbDescriptor)
+{
+    // A large composite device: the sample's interfaces repeated until the
+    // set is near its 64 KB wTotalLength limit.
+    const std::vector<uint8_t> sample = MakeUsbConfigurationSample();
+    std::vector<uint8_t> config(sample.begin(), sample.begin() + 9);
+    for (uint8_t copy = 0; config.size() + sample.size() < 0xFFFF && copy < 0xFF; ++copy)
+    {
+        const size_t first = config.size();
+        config.insert(config.end(), sample.begin() + 9, sample.end());
+        config[first + 2] = copy; // interface 0's bInterfaceNumber
+    }
+    config[2] = static_cast<uint8_t>(config.size());
+    config[3] = static_cast<uint8_t>(config.size() >> 8);
+
+    Measure("walk", context.Iterations(20000), config.size(), [&]
+    {
+        uint64_t types = 0;
+        for (const UsbDescriptorView& desc : UsbDescriptorList(config))
+            types += desc.type;
+        Consume(types);
+    });
+
+    Measure("parse every descriptor", context.Iterations(20000), config.size(), [&]
+    {
+        uint64_t fields = 0;
+        for (const UsbDescriptorView& desc : UsbDescriptorList(config))
+        {
+            if (const auto itf = ParseUsbInterfaceDescriptor(desc.data))
+                fields += itf->bInterfaceClass;
+            else if (const auto endpoint = ParseUsbEndpointDescriptor(desc.data))
+                fields += endpoint->wMaxPacketSize;
+            else if (const auto hid = ParseUsbHidDescriptor(desc.data))
+                fields += hid->GetReportDescriptorLength();
+        }
+        Consume(fields);
+    });
+
+    Measure("find last interface", context.Iterations(20000), config.size(), [&]
+    {
+        const auto itf = FindUsbInterface(config, 0xFE);
+        Consume(itf ? itf->data.size() : 0);
+    });
+}
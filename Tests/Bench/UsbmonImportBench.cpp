@@ -0,0 +1,45 @@
+#include "Bench/Bench.h"
+#include "Samples.h"
+#include "TempDirectory.h"
+
+#include "UsbmonCapture.h"
+
+#include <fstream>
+
+// Importing a usbmon capture of one gamepad: walking the packets in memory,
+// then the whole import from a mapped file, once keeping only the
+// descriptor and once copying every report.
+RAWINPUT_BENCH(UsbmonImport)
+{
+    const size_t reportCount = context.quick ? 1000 : 500000;
+    std::vector<std::vector<uint8_t>> reports(reportCount);
+    for (size_t i = 0; i < reportCount; ++i)
+        reports[i] = { 0x01, uint8_t(i), uint8_t(i >> 8), 0x08, uint8_t(i * 3), uint8_t(i * 5), 0x80, 0x80 };
+
+    const std::vector<uint8_t> capture = MakeUsbmonCaptureSample(MakeHidGamepadDescriptor(), reports);
+    reports = {};
+
+    TempDirectory dir;
+    const std::string path = dir / "capture.pcap";
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(capture.data()), static_cast<std::streamsize>(capture.size()));
+
+    Measure("walk packets", context.Iterations(20), capture.size(), [&]
+    {
+        UsbmonCaptureReader reader(capture);
+        uint64_t bytes = 0;
+        while (std::optional<UsbmonPacket> packet = reader.Next())
+            bytes += packet->data.size();
+        Consume(bytes);
+    });
+
+    Measure("import mapped file, descriptor only", context.Iterations(20), capture.size(), [&]
+    {
+        Consume(ImportUsbmonHidDevices(path, 1)->size());
+    });
+
+    Measure("import mapped file, all reports", context.Iterations(10), capture.size(), [&]
+    {
+        Consume(ImportUsbmonHidDevices(path)->front().reports.size());
+    });
+}
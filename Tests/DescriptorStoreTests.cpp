@@ -0,0 +1,198 @@
+#include "Samples.h"
+#include "TempDirectory.h"
+
+#include "DescriptorStore.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    std::vector<uint8_t> ReadFile(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    }
+
+    void WriteFile(const std::string& path, std::span<const uint8_t> bytes)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    // Header fields used to damage a store in place.
+    constexpr size_t kEntryCountOffset = 12;
+    constexpr size_t kEntriesOffset = 64;
+    constexpr size_t kEntrySize = sizeof(DescriptorStore::Entry);
+
+    uint32_t ReadU32(const std::vector<uint8_t>& file, size_t offset)
+    {
+        uint32_t value;
+        std::memcpy(&value, file.data() + offset, sizeof(value));
+        return value;
+    }
+}
+
+TEST(DescriptorStore, FindsEveryDescriptor)
+{
+    TempDirectory dir;
+    const std::vector<std::vector<uint8_t>> corpus = MakeDescriptorCorpus(500, 1);
+
+    DescriptorStoreBuilder builder;
+    for (size_t i = 0; i < corpus.size(); ++i)
+        builder.Add(corpus[i], 0x045E, static_cast<uint16_t>(i % 7));
+    builder.Add(corpus[0]);
+    EXPECT_EQ(builder.GetCount(), corpus.size());
+    ASSERT_TRUE(builder.Write(dir / "store"));
+
+    const std::optional<DescriptorStore> store = DescriptorStore::Open(dir / "store");
+    ASSERT_TRUE(store);
+    ASSERT_EQ(store->GetEntries().size(), corpus.size());
+
+    for (const std::vector<uint8_t>& descriptor : corpus)
+    {
+        const DescriptorStore::Entry* entry = store->Find(descriptor);
+        ASSERT_NE(entry, nullptr);
+        const std::span<const uint8_t> stored = store->GetDescriptor(*entry);
+        EXPECT_TRUE(std::equal(stored.begin(), stored.end(), descriptor.begin(), descriptor.end()));
+        EXPECT_EQ(entry->copies, &descriptor == &corpus[0] ? 2u : 1u);
+        EXPECT_EQ(store->Find(DescriptorStore::Hash(descriptor)).size(), 1u);
+    }
+
+    const std::span<const DescriptorStore::VidPid> product3 = store->FindByVidPid(0x045E, 3);
+    EXPECT_EQ(product3.size(), (corpus.size() - 3 + 6) / 7);
+    for (const DescriptorStore::VidPid& vidPid : product3)
+        EXPECT_EQ(vidPid.vidPid, 0x045E0003u);
+    EXPECT_TRUE(store->FindByVidPid(0x046D, 3).empty());
+
+    const std::vector<uint8_t> missing(64, 0xAA);
+    EXPECT_EQ(store->Find(missing), nullptr);
+}
+
+TEST(DescriptorStore, RewriteIsIndependentOfOrder)
+{
+    TempDirectory dir;
+    const std::vector<std::vector<uint8_t>> corpus = MakeDescriptorCorpus(200, 2);
+
+    DescriptorStoreBuilder forward, backward;
+    for (size_t i = 0; i < corpus.size(); ++i)
+    {
+        forward.Add(corpus[i], 1, 2);
+        backward.Add(corpus[corpus.size() - 1 - i], 1, 2);
+    }
+    ASSERT_TRUE(forward.Write(dir / "forward"));
+    ASSERT_TRUE(backward.Write(dir / "backward"));
+    EXPECT_EQ(ReadFile(dir / "forward"), ReadFile(dir / "backward"));
+
+    // Merging a store into an empty builder reproduces it.
+    const std::optional<DescriptorStore> store = DescriptorStore::Open(dir / "forward");
+    ASSERT_TRUE(store);
+    DescriptorStoreBuilder merged;
+    merged.Merge(*store);
+    ASSERT_TRUE(merged.Write(dir / "merged"));
+    EXPECT_EQ(ReadFile(dir / "merged"), ReadFile(dir / "forward"));
+}
+
+TEST(DescriptorStore, RejectsDamagedFiles)
+{
+    TempDirectory dir;
+    DescriptorStoreBuilder builder;
+    for (const std::vector<uint8_t>& descriptor : MakeDescriptorCorpus(64, 3))
+        builder.Add(descriptor, 1, 2);
+    ASSERT_TRUE(builder.Write(dir / "store"));
+
+    const std::vector<uint8_t> good = ReadFile(dir / "store");
+    ASSERT_EQ(ReadU32(good, kEntryCountOffset), 64u);
+
+    auto opens = [&](const std::vector<uint8_t>& file)
+    {
+        WriteFile(dir / "damaged", file);
+        return DescriptorStore::Open(dir / "damaged").has_value();
+    };
+    EXPECT_TRUE(opens(good));
+
+    std::vector<uint8_t> file = good;
+    file.resize(file.size() - 8);
+    EXPECT_FALSE(opens(file)) << "truncated";
+
+    // Two entries swapped: each still points at valid bytes, but the hash
+    // order that Find() searches by is broken.
+    file = good;
+    std::swap_ranges(file.begin() + kEntriesOffset, file.begin() + kEntriesOffset + kEntrySize,
+        file.begin() + kEntriesOffset + 10 * kEntrySize);
+    EXPECT_FALSE(opens(file)) << "unsorted";
+
+    // A bucket boundary moved up by one: still monotonic, but the entry it
+    // skips now sits in the previous bucket, where Find() never looks for it.
+    file = good;
+    const size_t bucketsOffset = kEntriesOffset + 64 * kEntrySize;
+    size_t bucket = 1;
+    while (ReadU32(file, bucketsOffset + 4 * bucket) == ReadU32(file, bucketsOffset + 4 * (bucket + 1)))
+        ++bucket;
+    const uint32_t moved = ReadU32(file, bucketsOffset + 4 * bucket) + 1;
+    std::memcpy(file.data() + bucketsOffset + 4 * bucket, &moved, sizeof(moved));
+    EXPECT_FALSE(opens(file)) << "wrong bucket";
+
+    file = good;
+    file[kEntriesOffset + 8] = 0xFF; // first entry's offset
+    file[kEntriesOffset + 13] = 0xFF;
+    EXPECT_FALSE(opens(file)) << "offset out of bounds";
+}
+
+TEST(DescriptorStore, IngestsDumps)
+{
+    TempDirectory dir;
+    const std::vector<std::vector<uint8_t>> corpus = MakeDescriptorCorpus(3, 4);
+
+    // A copy of a sysfs hidraw device directory, and Windows-style dumps.
+    std::filesystem::create_directories(dir.GetPath() / "machine1/hidraw0/device");
+    WriteFile(dir / "machine1/hidraw0/device/report_descriptor", corpus[0]);
+    std::ofstream(dir / "machine1/hidraw0/device/uevent") << "DRIVER=hid-generic\nHID_ID=0003:0000045E:000002EA\nHID_NAME=pad\n";
+
+    std::filesystem::create_directories(dir.GetPath() / "machine2");
+    WriteFile(dir / "machine2/VID_046D&PID_C52B&MI_00.bin", corpus[1]);
+    WriteFile(dir / "machine2/vid_046d&pid_c52b&mi_01.bin", corpus[0]);
+    WriteFile(dir / "machine2/VID_046D&PID_C52B&MI_02.bin", {});
+    WriteFile(dir / "machine2/notes.txt", corpus[2]);
+
+    DescriptorStoreBuilder builder;
+    const DescriptorIngestStats stats = IngestDescriptorDumps(builder, dir.GetPath());
+    EXPECT_EQ(stats.files, 4u);
+    EXPECT_EQ(stats.added, 2u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.skipped, 1u);
+
+    ASSERT_TRUE(builder.Write(dir / "store"));
+    const std::optional<DescriptorStore> store = DescriptorStore::Open(dir / "store");
+    ASSERT_TRUE(store);
+    EXPECT_EQ(store->FindByVidPid(0x045E, 0x02EA).size(), 1u);
+    EXPECT_EQ(store->FindByVidPid(0x046D, 0xC52B).size(), 2u);
+    EXPECT_EQ(store->Find(corpus[2]), nullptr);
+}
+
+#ifdef __linux__
+// Files in sysfs and procfs report a size that has nothing to do with their
+// contents, so dumps are read to EOF. /proc/version reports 0 bytes.
+TEST(DescriptorStore, IngestsPseudoFiles)
+{
+    const std::vector<uint8_t> expected = ReadFile("/proc/version");
+    if (expected.empty())
+        GTEST_SKIP() << "no /proc/version";
+
+    TempDirectory dir;
+    std::filesystem::create_directories(dir.GetPath() / "hidraw0/device");
+    std::filesystem::create_symlink("/proc/version", dir.GetPath() / "hidraw0/device/report_descriptor");
+
+    DescriptorStoreBuilder builder;
+    const DescriptorIngestStats stats = IngestDescriptorDumps(builder, dir.GetPath());
+    EXPECT_EQ(stats.added, 1u);
+
+    ASSERT_TRUE(builder.Write(dir / "store"));
+    const std::optional<DescriptorStore> store = DescriptorStore::Open(dir / "store");
+    ASSERT_TRUE(store);
+    EXPECT_NE(store->Find(expected), nullptr);
+}
+#endif
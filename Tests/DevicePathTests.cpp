@@ -0,0 +1,156 @@
+#include "DevicePath.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(DevicePath, ParsesHidInterfacePath)
+{
+    const DevicePathInfo info = ParseDevicePath(
+        "\\\\?\\HID#VID_203A&PID_FFFC&MI_01&Col02#7&2de99099&0&0000#{378de44c-56ef-11d1-bc8c-00a0c91405dd}\\KBD");
+
+    EXPECT_TRUE(info.IsInterfacePath());
+    EXPECT_EQ(info.bus, "HID");
+    EXPECT_EQ(info.deviceId, "VID_203A&PID_FFFC&MI_01&Col02");
+    EXPECT_EQ(info.instance, "7&2de99099&0&0000");
+    EXPECT_EQ(info.interfaceGuid, "{378de44c-56ef-11d1-bc8c-00a0c91405dd}");
+    EXPECT_EQ(info.reference, "KBD");
+    EXPECT_EQ(info.vendorId, 0x203A);
+    EXPECT_EQ(info.productId, 0xFFFC);
+    EXPECT_EQ(info.interfaceNumber, 1);
+    EXPECT_EQ(info.collection, 2);
+    EXPECT_FALSE(info.revision);
+}
+
+TEST(DevicePath, ParsesUsbInterfacePath)
+{
+    // Serial number as instance, lower-case hex, no reference string.
+    const DevicePathInfo info = ParseDevicePath(
+        "\\\\?\\USB#vid_045e&pid_02ea#3039373030333433313933353235#{a5dcbf10-6530-11d2-901f-00c04fb951ed}");
+
+    EXPECT_EQ(info.bus, "USB");
+    EXPECT_EQ(info.instance, "3039373030333433313933353235");
+    EXPECT_EQ(info.interfaceGuid, "{a5dcbf10-6530-11d2-901f-00c04fb951ed}");
+    EXPECT_TRUE(info.reference.empty());
+    EXPECT_EQ(info.vendorId, 0x045E);
+    EXPECT_EQ(info.productId, 0x02EA);
+    EXPECT_FALSE(info.interfaceNumber);
+    EXPECT_FALSE(info.collection);
+}
+
+TEST(DevicePath, ParsesInstanceAndHardwareIds)
+{
+    const DevicePathInfo instance = ParseDevicePath("HID\\VID_046D&PID_C52B&MI_02&COL01\\8&1B2F3A4C&0&0000");
+    EXPECT_FALSE(instance.IsInterfacePath());
+    EXPECT_EQ(instance.bus, "HID");
+    EXPECT_EQ(instance.instance, "8&1B2F3A4C&0&0000");
+    EXPECT_EQ(instance.vendorId, 0x046D);
+    EXPECT_EQ(instance.interfaceNumber, 2);
+    EXPECT_EQ(instance.collection, 1);
+
+    const DevicePathInfo hardwareId = ParseDevicePath("USB\\VID_05E3&PID_0610&REV_9226");
+    EXPECT_EQ(hardwareId.deviceId, "VID_05E3&PID_0610&REV_9226");
+    EXPECT_TRUE(hardwareId.instance.empty());
+    EXPECT_EQ(hardwareId.revision, 0x9226);
+}
+
+TEST(DevicePath, ParsesBluetoothSpellings)
+{
+    // Classic: vendor ID source 0002 (USB-IF) in front of the vendor ID.
+    const DevicePathInfo classic = ParseDevicePath(
+        "\\\\?\\HID#{00001124-0000-1000-8000-00805f9b34fb}_VID&0002054c_PID&09cc&Col01#9&2a5b3c4d&0&0000#{4d1e55b2-f16f-11cf-88cb-001111000030}");
+    EXPECT_EQ(classic.vendorId, 0x054C);
+    EXPECT_EQ(classic.productId, 0x09CC);
+    EXPECT_EQ(classic.collection, 1);
+
+    // Low energy.
+    const DevicePathInfo le = ParseDevicePath(
+        "\\\\?\\HID#{00001812-0000-1000-8000-00805f9b34fb}_Dev_VID&02045e_PID&0b13_REV&0509_c8d3e5a7b1f9&Col03#a&1f2e3d4c&0&0002#{4d1e55b2-f16f-11cf-88cb-001111000030}");
+    EXPECT_EQ(le.vendorId, 0x045E);
+    EXPECT_EQ(le.productId, 0x0B13);
+    EXPECT_EQ(le.revision, 0x0509);
+    EXPECT_EQ(le.collection, 3);
+}
+
+TEST(DevicePath, LeavesMalformedFieldsEmpty)
+{
+    EXPECT_TRUE(ParseDevicePath("").bus.empty());
+    EXPECT_EQ(ParseDevicePath("Default Keyboard").bus, "Default Keyboard");
+    EXPECT_FALSE(ParseDevicePath("Default Keyboard").vendorId);
+
+    // Prefix only.
+    const DevicePathInfo prefix = ParseDevicePath("\\\\?\\");
+    EXPECT_TRUE(prefix.bus.empty());
+    EXPECT_FALSE(prefix.IsInterfacePath());
+
+    // Non-hex digits, too many digits, no digits, and a field glued to the next.
+    const DevicePathInfo bad = ParseDevicePath("HID\\VID_12G4&PID_123456&MI_&COL1X\\1");
+    EXPECT_FALSE(bad.vendorId);
+    EXPECT_FALSE(bad.productId);
+    EXPECT_FALSE(bad.interfaceNumber);
+    EXPECT_FALSE(bad.collection);
+    EXPECT_EQ(bad.instance, "1");
+
+    // Unterminated interface GUID, and a class segment without one.
+    EXPECT_FALSE(ParseDevicePath("\\\\?\\HID#VID_1234&PID_5678#1#{4d1e55b2-f16f").IsInterfacePath());
+    EXPECT_FALSE(ParseDevicePath("\\\\?\\HID#VID_1234&PID_5678#1#KBD").IsInterfacePath());
+
+    // Truncated after the device ID.
+    const DevicePathInfo truncated = ParseDevicePath("\\\\?\\HID#VID_1234&PID_5678");
+    EXPECT_EQ(truncated.vendorId, 0x1234);
+    EXPECT_EQ(truncated.productId, 0x5678);
+    EXPECT_TRUE(truncated.instance.empty());
+}
+
+TEST(DevicePath, InternsIgnoringCase)
+{
+    const std::string path = "\\\\?\\HID#VID_203A&PID_FFFC&MI_01&Col02#7&2de99099&0&0000#{378de44c-56ef-11d1-bc8c-00a0c91405dd}\\KBD";
+    std::string upper = path;
+    for (char& c : upper)
+        c = static_cast<char>((c >= 'a' && c <= 'z') ? c - 0x20 : c);
+
+    const size_t before = DevicePath::GetInternedCount();
+    const DevicePath a = DevicePath::Intern(path);
+    const DevicePath b = DevicePath::Intern(upper);
+    const DevicePath other = DevicePath::Intern("\\\\?\\HID#VID_203A&PID_FFFC&MI_01&Col01#7&2de99099&0&0000#{378de44c-56ef-11d1-bc8c-00a0c91405dd}\\KBD");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, other);
+    EXPECT_EQ(DevicePath::GetInternedCount(), before + 2);
+
+    // The first spelling is kept, NUL-terminated, and parsed once.
+    EXPECT_EQ(b.GetString(), path);
+    EXPECT_EQ(b.GetString().data()[path.size()], '\0');
+    EXPECT_EQ(b.GetInfo().collection, 2);
+    EXPECT_EQ(a.GetId() + 1, other.GetId());
+
+    const DevicePath empty = DevicePath::Intern("");
+    EXPECT_TRUE(empty.IsEmpty());
+    EXPECT_EQ(empty.GetId(), 0u);
+    EXPECT_EQ(empty, DevicePath());
+}
+
+TEST(DevicePath, InternsConcurrently)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < 64; ++i)
+        paths.push_back("\\\\?\\HID#VID_1209&PID_" + std::to_string(1000 + i) + "#1&0&0#{4d1e55b2-f16f-11cf-88cb-001111000030}");
+
+    std::vector<std::vector<DevicePath>> interned(4);
+    std::vector<std::thread> threads;
+    for (std::vector<DevicePath>& out : interned)
+    {
+        threads.emplace_back([&paths, &out]
+            {
+                for (const std::string& path : paths)
+                    out.push_back(DevicePath::Intern(path));
+            });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (const std::vector<DevicePath>& out : interned)
+        EXPECT_EQ(out, interned.front());
+}
@@ -0,0 +1,184 @@
+#include "DeviceTree.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace
+{
+    // GUID_DEVINTERFACE_USB_DEVICE and GUID_DEVINTERFACE_HID.
+    constexpr DeviceGuid kUsbDeviceInterface = { 0xA5DCBF10, 0x6530, 0x11D2, { 0x90, 0x1F, 0x00, 0xC0, 0x4F, 0xB9, 0x51, 0xED } };
+    constexpr DeviceGuid kHidInterface = { 0x4D1E55B2, 0xF16F, 0x11CF, { 0x88, 0xCB, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30 } };
+
+    // DEVPKEY_Device_FriendlyName; DEVPROP_TYPE_STRING.
+    constexpr DevicePropertyKey kFriendlyName = { { 0xA45C254E, 0xDF1C, 0x4EFD, { 0x80, 0x20, 0x67, 0xD1, 0x46, 0xA8, 0x50, 0xE0 } }, 14 };
+    constexpr uint32_t kPropertyTypeString = 0x12;
+
+    constexpr const char* kRoot = "HTREE\\ROOT\\0";
+    constexpr const char* kController = "PCI\\VEN_8086&DEV_A36D&SUBSYS_86941043&REV_10\\3&11583659&0&A0";
+    constexpr const char* kRootHub = "USB\\ROOT_HUB30\\4&2A7E3B1F&0&0";
+    constexpr const char* kHub = "USB\\VID_05E3&PID_0610\\5&1C9B2A4&0&3";
+    constexpr const char* kGamepad = "USB\\VID_045E&PID_02EA\\3039373030333433313933353235";
+    constexpr const char* kGamepadHid = "HID\\VID_045E&PID_02EA&MI_00&COL01\\8&2B3D6A1F&0&0000";
+
+    // A gamepad behind an external hub on the first root hub, with the USB
+    // and HID interfaces a real one exposes.
+    std::shared_ptr<FakeDeviceTreeSource> MakeSource()
+    {
+        auto source = std::make_shared<FakeDeviceTreeSource>();
+        source->AddNode(kRoot, "");
+        source->AddNode(kController, kRoot);
+        source->AddNode(kRootHub, kController);
+        source->AddNode(kHub, kRootHub);
+        source->AddNode(kGamepad, kHub);
+        source->AddNode(kGamepadHid, kGamepad);
+
+        source->AddInterface(kUsbDeviceInterface,
+            "\\\\?\\USB#VID_05E3&PID_0610#5&1c9b2a4&0&3#{a5dcbf10-6530-11d2-901f-00c04fb951ed}", kHub);
+        source->AddInterface(kUsbDeviceInterface,
+            "\\\\?\\USB#VID_045E&PID_02EA#3039373030333433313933353235#{a5dcbf10-6530-11d2-901f-00c04fb951ed}", kGamepad);
+        source->AddInterface(kHidInterface,
+            "\\\\?\\HID#VID_045E&PID_02EA&MI_00&COL01#8&2b3d6a1f&0&0000#{4d1e55b2-f16f-11cf-88cb-001111000030}", kGamepadHid);
+        return source;
+    }
+}
+
+TEST(DeviceTree, LooksUpNodesIgnoringCase)
+{
+    const std::shared_ptr<const DeviceTree> tree = DeviceTree::Snapshot(MakeSource());
+    ASSERT_EQ(tree->GetNodeCount(), 6u);
+
+    const DeviceTree::NodeId gamepad = tree->FindNode(kGamepad);
+    ASSERT_NE(gamepad, DeviceTree::kNoNode);
+    EXPECT_EQ(tree->FindNode("usb\\vid_045e&pid_02ea\\3039373030333433313933353235"), gamepad);
+    EXPECT_EQ(tree->GetInstanceId(gamepad), kGamepad);
+    EXPECT_EQ(tree->FindNode("USB\\VID_045E&PID_02EA\\0"), DeviceTree::kNoNode);
+
+    EXPECT_EQ(tree->GetParent(tree->FindNode(kRoot)), DeviceTree::kNoNode);
+    EXPECT_EQ(tree->GetParent(gamepad), tree->FindNode(kHub));
+    ASSERT_EQ(tree->GetChildren(tree->FindNode(kHub)).size(), 1u);
+    EXPECT_EQ(tree->GetChildren(tree->FindNode(kHub))[0], gamepad);
+    EXPECT_TRUE(tree->GetChildren(tree->FindNode(kGamepadHid)).empty());
+}
+
+TEST(DeviceTree, FindsNearestAncestorInterface)
+{
+    auto source = MakeSource();
+    const std::shared_ptr<const DeviceTree> tree = DeviceTree::Snapshot(source);
+
+    // The HID collection's USB device is its parent, not the hub above it.
+    DeviceTree::NodeId owner = DeviceTree::kNoNode;
+    const std::string_view usb = tree->SearchParentInterface(tree->FindNode(kGamepadHid), kUsbDeviceInterface, &owner);
+    EXPECT_EQ(owner, tree->FindNode(kGamepad));
+    EXPECT_NE(usb.find("PID_02EA"), std::string_view::npos);
+
+    EXPECT_TRUE(tree->GetInterface(tree->FindNode(kGamepadHid), kUsbDeviceInterface).empty());
+    EXPECT_EQ(tree->SearchParentInterface(tree->FindNode(kRootHub), kUsbDeviceInterface, &owner), "");
+    EXPECT_EQ(owner, DeviceTree::kNoNode);
+
+    // Each class is enumerated once per snapshot.
+    EXPECT_FALSE(tree->GetInterface(tree->FindNode(kGamepadHid), kHidInterface).empty());
+    EXPECT_FALSE(tree->GetInterface(tree->FindNode(kHub), kUsbDeviceInterface).empty());
+    EXPECT_EQ(source->GetInterfaceQueryCount(), 2u);
+}
+
+TEST(DeviceTree, CachesProperties)
+{
+    auto source = MakeSource();
+    const std::string name = "Xbox Controller";
+    source->SetProperty(kGamepad, kFriendlyName, { reinterpret_cast<const uint8_t*>(name.data()), name.size() });
+
+    const std::shared_ptr<const DeviceTree> tree = DeviceTree::Snapshot(source);
+    const DeviceTree::NodeId gamepad = tree->FindNode(kGamepad);
+    for (int i = 0; i < 3; ++i)
+    {
+        const std::span<const uint8_t> value = tree->GetProperty(gamepad, kFriendlyName, kPropertyTypeString);
+        EXPECT_EQ(std::string(value.begin(), value.end()), name);
+    }
+    EXPECT_TRUE(tree->GetProperty(tree->FindNode(kHub), kFriendlyName, kPropertyTypeString).empty());
+    EXPECT_TRUE(tree->GetProperty(DeviceTree::kNoNode, kFriendlyName, kPropertyTypeString).empty());
+    EXPECT_EQ(source->GetPropertyQueryCount(), 2u);
+}
+
+TEST(DeviceTree, SnapshotsSeeInsertedNodes)
+{
+    auto source = MakeSource();
+    const std::shared_ptr<const DeviceTree> before = DeviceTree::Snapshot(source);
+
+    const char* mouse = "USB\\VID_046D&PID_C52B\\6&3A1B0C2D&0&2";
+    source->AddNode(mouse, kHub);
+    const std::shared_ptr<const DeviceTree> after = DeviceTree::Snapshot(source);
+
+    EXPECT_EQ(before->FindNode(mouse), DeviceTree::kNoNode);
+    ASSERT_NE(after->FindNode(mouse), DeviceTree::kNoNode);
+    EXPECT_EQ(after->GetParent(after->FindNode(mouse)), after->FindNode(kHub));
+    EXPECT_EQ(after->GetChildren(after->FindNode(kHub)).size(), 2u);
+
+    // A node listed twice keeps its first parent.
+    source->AddNode(mouse, kRootHub);
+    const std::shared_ptr<const DeviceTree> duplicate = DeviceTree::Snapshot(source);
+    EXPECT_EQ(duplicate->GetNodeCount(), after->GetNodeCount());
+    EXPECT_EQ(duplicate->GetParent(duplicate->FindNode(mouse)), duplicate->FindNode(kHub));
+}
+
+TEST(DeviceTree, SnapshotsSeeRemovedNodes)
+{
+    auto source = MakeSource();
+    const std::shared_ptr<const DeviceTree> before = DeviceTree::Snapshot(source);
+
+    // Unplugging the hub takes the gamepad and its HID collection with it.
+    source->RemoveNode(kHub);
+    const std::shared_ptr<const DeviceTree> after = DeviceTree::Snapshot(source);
+
+    EXPECT_EQ(after->GetNodeCount(), 3u);
+    EXPECT_EQ(after->FindNode(kHub), DeviceTree::kNoNode);
+    EXPECT_EQ(after->FindNode(kGamepadHid), DeviceTree::kNoNode);
+    EXPECT_TRUE(after->GetChildren(after->FindNode(kRootHub)).empty());
+
+    // Interfaces of removed nodes are dropped; the old snapshot keeps them.
+    EXPECT_EQ(after->SearchParentInterface(after->FindNode(kRootHub), kUsbDeviceInterface), "");
+    EXPECT_NE(before->SearchParentInterface(before->FindNode(kGamepadHid), kUsbDeviceInterface), "");
+}
+
+TEST(DeviceTree, SnapshotsSeeReparentedNodes)
+{
+    auto source = MakeSource();
+    const char* otherController = "PCI\\VEN_8086&DEV_A36D&SUBSYS_86941043&REV_10\\3&11583659&0&A8";
+    const char* otherRootHub = "USB\\ROOT_HUB30\\4&3B8F4C2A&0&0";
+    source->AddNode(otherController, kRoot);
+    source->AddNode(otherRootHub, otherController);
+
+    const std::shared_ptr<const DeviceTree> before = DeviceTree::Snapshot(source);
+
+    // The hub moved to a port of the other controller, devices and all.
+    source->MoveNode(kHub, otherRootHub);
+    const std::shared_ptr<const DeviceTree> after = DeviceTree::Snapshot(source);
+
+    ASSERT_EQ(after->GetNodeCount(), before->GetNodeCount());
+    EXPECT_EQ(after->GetParent(after->FindNode(kHub)), after->FindNode(otherRootHub));
+    EXPECT_EQ(after->GetParent(after->FindNode(kGamepad)), after->FindNode(kHub));
+    EXPECT_EQ(after->GetParent(after->FindNode(kGamepadHid)), after->FindNode(kGamepad));
+    EXPECT_TRUE(after->GetChildren(after->FindNode(kRootHub)).empty());
+    EXPECT_EQ(before->GetParent(before->FindNode(kHub)), before->FindNode(kRootHub));
+
+    // Ancestry follows the new parent.
+    DeviceTree::NodeId node = after->FindNode(kGamepadHid);
+    while (after->GetParent(node) != after->FindNode(kRoot))
+        node = after->GetParent(node);
+    EXPECT_EQ(node, after->FindNode(otherController));
+}
+
+TEST(LazyDeviceTree, SnapshotsOnFirstUse)
+{
+    auto source = MakeSource();
+    const LazyDeviceTree lazy(source);
+
+    // Changes made before the first Get() are seen, later ones are not.
+    source->RemoveNode(kGamepad);
+    const std::shared_ptr<const DeviceTree>& tree = lazy.Get();
+    source->AddNode(kGamepad, kHub);
+
+    EXPECT_EQ(tree->FindNode(kGamepad), DeviceTree::kNoNode);
+    EXPECT_EQ(lazy.Get(), tree);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+// Fuzz targets. Each one feeds arbitrary bytes to one parser and checks what
+// must hold for any input; a violation aborts, which both libFuzzer and the
+// test runner report as a crash. Out-of-bounds reads are left to the
+// sanitizers.
+//
+// Every target file also defines LLVMFuzzerTestOneInput when built as a
+// libFuzzer binary (RAWINPUT_LIBFUZZER). FuzzTests.cpp replays the targets on
+// mutations of their seeds, so they run in every test pass as well.
+
+#define FUZZ_CHECK(condition)                                                       \
+    do                                                                              \
+    {                                                                               \
+        if (!(condition))                                                           \
+        {                                                                           \
+            std::fprintf(stderr, "%s:%d: FUZZ_CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                           \
+        }                                                                           \
+    } while (false)
+
+#ifdef RAWINPUT_LIBFUZZER
+#define RAWINPUT_FUZZ_ENTRY(target)                                                 \
+    extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)         \
+    {                                                                               \
+        target({ data, size });                                                     \
+        return 0;                                                                   \
+    }
+#else
+#define RAWINPUT_FUZZ_ENTRY(target)
+#endif
+
+// Whether `inner` lies within `outer`.
+inline bool IsWithin(std::span<const uint8_t> inner, std::span<const uint8_t> outer)
+{
+    return inner.empty()
+        || (inner.data() >= outer.data() && inner.data() + inner.size() <= outer.data() + outer.size());
+}
+
+// UsbDescriptor.h: the descriptor walk and every descriptor parser.
+void FuzzUsbDescriptors(std::span<const uint8_t> data);
+std::vector<std::vector<uint8_t>> GetUsbDescriptorSeeds();
+
+// HidDescriptorDisassembler.h: every flag combination on arbitrary input.
+void FuzzHidDescriptorDisassembler(std::span<const uint8_t> data);
+std::vector<std::vector<uint8_t>> GetHidDescriptorDisassemblerSeeds();
+
+// HidDeviceModel.h: models built from arbitrary report descriptors.
+void FuzzHidDeviceModel(std::span<const uint8_t> data);
+std::vector<std::vector<uint8_t>> GetHidDeviceModelSeeds();
@@ -0,0 +1,27 @@
+#include "Fuzz/FuzzTargets.h"
+#include "Samples.h"
+
+#include "HidDescriptorDisassembler.h"
+
+void FuzzHidDescriptorDisassembler(std::span<const uint8_t> data)
+{
+    using Disassembler = HidDescriptorDisassembler;
+
+    // Small, so that growing the buffer is exercised too.
+    static Disassembler disassembler(512);
+
+    for (uint32_t flags : { Disassembler::Items | Disassembler::Bytes | Disassembler::Layout, uint32_t(Disassembler::Layout) })
+    {
+        const std::string_view text = disassembler.Disassemble(data, flags);
+
+        // Every line is complete.
+        FUZZ_CHECK(text.empty() || text.back() == '\n');
+    }
+}
+
+std::vector<std::vector<uint8_t>> GetHidDescriptorDisassemblerSeeds()
+{
+    return { MakeHidGamepadDescriptor(), MakeLargeHidDescriptor(512) };
+}
+
+RAWINPUT_FUZZ_ENTRY(FuzzHidDescriptorDisassembler)
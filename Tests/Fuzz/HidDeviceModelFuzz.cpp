@@ -0,0 +1,41 @@
+#include "Fuzz/FuzzTargets.h"
+#include "Samples.h"
+
+#include "HidDeviceModel.h"
+
+void FuzzHidDeviceModel(std::span<const uint8_t> data)
+{
+    const std::shared_ptr<const HidDeviceModel> model = HidDeviceModel::AcquireFromDescriptor(data);
+    if (!model)
+        return;
+
+    // Every op stays inside the report and lands on a slot of its kind.
+    const HidDecodePlan& plan = model->GetDecodePlan();
+    for (unsigned reportId = 0; reportId <= 0xFF; ++reportId)
+    {
+        for (const HidDecodePlan::Op& op : plan.GetOps(static_cast<uint8_t>(reportId)))
+        {
+            FUZZ_CHECK(op.reportId == reportId);
+            FUZZ_CHECK(op.bitSize >= 1 && op.bitSize <= 32);
+            FUZZ_CHECK(op.GetEndByte() <= model->GetInputReportSize());
+
+            switch (op.kind)
+            {
+            case HidDecodePlan::OpKind::Button: FUZZ_CHECK(op.slot < model->GetButtons().size()); break;
+            case HidDecodePlan::OpKind::Axis:   FUZZ_CHECK(op.slot < model->GetAxes().size()); break;
+            case HidDecodePlan::OpKind::Switch: FUZZ_CHECK(op.slot < model->GetSwitches().size()); break;
+            case HidDecodePlan::OpKind::Selector:
+                for (uint16_t slot : plan.GetSelectorSlots(op))
+                    FUZZ_CHECK(slot == HidDecodePlan::kNoSlot || slot < model->GetButtons().size());
+                break;
+            }
+        }
+    }
+}
+
+std::vector<std::vector<uint8_t>> GetHidDeviceModelSeeds()
+{
+    return { MakeHidGamepadDescriptor(), MakeLargeHidDescriptor(512) };
+}
+
+RAWINPUT_FUZZ_ENTRY(FuzzHidDeviceModel)
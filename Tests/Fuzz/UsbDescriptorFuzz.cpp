@@ -0,0 +1,72 @@
+#include "Fuzz/FuzzTargets.h"
+#include "Samples.h"
+
+#include "UsbDescriptor.h"
+
+namespace
+{
+    // Every parser on one descriptor; whatever they accept must stay inside it.
+    void ParseAll(std::span<const uint8_t> data)
+    {
+        ParseUsbDeviceDescriptor(data);
+        ParseUsbConfigurationDescriptor(data);
+        ParseUsbInterfaceDescriptor(data);
+        ParseUsbEndpointDescriptor(data);
+        ParseUsbInterfaceAssociationDescriptor(data);
+        ParseUsbBosDescriptor(data);
+
+        if (const auto hid = ParseUsbHidDescriptor(data))
+        {
+            FUZZ_CHECK(IsWithin(hid->classDescriptors, data));
+            hid->GetReportDescriptorLength();
+        }
+
+        if (const auto capability = ParseUsbDeviceCapabilityDescriptor(data))
+            FUZZ_CHECK(IsWithin(capability->capability, data));
+
+        const std::span<const uint8_t> units = ParseUsbStringDescriptor(data);
+        FUZZ_CHECK(IsWithin(units, data) && units.size() % 2 == 0);
+    }
+}
+
+void FuzzUsbDescriptors(std::span<const uint8_t> data)
+{
+    const UsbDescriptorList list(data);
+
+    size_t walked = 0;
+    for (const UsbDescriptorView& desc : list)
+    {
+        FUZZ_CHECK(desc.data.size() >= 2 && desc.type == desc.data[1]);
+        FUZZ_CHECK(desc.data.data() == data.data() + walked);
+        walked += desc.data.size();
+        ParseAll(desc.data);
+    }
+
+    // The walk covers the buffer exactly unless it stopped at a bad descriptor.
+    FUZZ_CHECK(walked <= data.size());
+    FUZZ_CHECK(list.IsTruncated() == (walked != data.size()));
+
+    ParseAll(data);
+
+    for (uint8_t number = 0; number < 4; ++number)
+    {
+        const auto itf = FindUsbInterface(data, number);
+        if (!itf)
+            continue;
+
+        FUZZ_CHECK(itf->descriptor.bInterfaceNumber == number);
+        FUZZ_CHECK(IsWithin(itf->data, data));
+        for (const UsbDescriptorView& desc : itf->GetDescriptors())
+            FUZZ_CHECK(IsWithin(desc.data, itf->data));
+
+        if (const auto hid = itf->GetHidDescriptor())
+            FUZZ_CHECK(IsWithin(hid->classDescriptors, itf->data));
+    }
+}
+
+std::vector<std::vector<uint8_t>> GetUsbDescriptorSeeds()
+{
+    return { MakeUsbConfigurationSample(), MakeUsbDeviceSample(), MakeUsbBosSample() };
+}
+
+RAWINPUT_FUZZ_ENTRY(FuzzUsbDescriptors)
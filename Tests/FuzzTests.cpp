@@ -0,0 +1,87 @@
+#include "Fuzz/FuzzTargets.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace
+{
+    // Seeded mutations: bit flips, byte overwrites, truncation, insertion
+    // and duplication of a slice. Enough to walk every length check of a
+    // parser; the libFuzzer builds go further.
+    class Mutator
+    {
+    public:
+        explicit Mutator(uint32_t seed) : m_Random(seed) {}
+
+        std::vector<uint8_t> Mutate(const std::vector<uint8_t>& seed)
+        {
+            std::vector<uint8_t> data = seed;
+            const size_t edits = 1 + Next(4);
+            for (size_t i = 0; i < edits; ++i)
+            {
+                const size_t at = data.empty() ? 0 : Next(data.size());
+                switch (Next(5))
+                {
+                case 0:
+                    if (!data.empty())
+                        data[at] ^= static_cast<uint8_t>(1u << Next(8));
+                    break;
+                case 1:
+                    if (!data.empty())
+                        data[at] = static_cast<uint8_t>(Next(256));
+                    break;
+                case 2:
+                    data.resize(at);
+                    break;
+                case 3:
+                    data.insert(data.begin() + at, static_cast<uint8_t>(Next(256)));
+                    break;
+                case 4:
+                {
+                    const size_t size = Next(data.size() - at + 1);
+                    data.insert(data.begin() + at, data.begin() + at, data.begin() + at + size);
+                    break;
+                }
+                }
+            }
+            return data;
+        }
+
+    private:
+        size_t Next(size_t bound) { return bound ? m_Random() % bound : 0; }
+
+        std::mt19937 m_Random;
+    };
+
+    constexpr size_t kMutations = 20000;
+
+    template<typename Target>
+    void Replay(Target target, const std::vector<std::vector<uint8_t>>& seeds)
+    {
+        Mutator mutator(1);
+        for (const std::vector<uint8_t>& seed : seeds)
+            target(seed);
+
+        for (size_t i = 0; i < kMutations; ++i)
+        {
+            const std::vector<uint8_t> data = mutator.Mutate(seeds[i % seeds.size()]);
+            target(data);
+        }
+    }
+}
+
+TEST(Fuzz, UsbDescriptors)
+{
+    Replay(FuzzUsbDescriptors, GetUsbDescriptorSeeds());
+}
+
+TEST(Fuzz, HidDescriptorDisassembler)
+{
+    Replay(FuzzHidDescriptorDisassembler, GetHidDescriptorDisassemblerSeeds());
+}
+
+TEST(Fuzz, HidDeviceModel)
+{
+    Replay(FuzzHidDeviceModel, GetHidDeviceModelSeeds());
+}
@@ -0,0 +1,85 @@
+#include "Samples.h"
+
+#include "HidDescriptorDisassembler.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+    size_t CountOf(std::string_view text, std::string_view needle)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(needle); at != std::string_view::npos; at = text.find(needle, at + 1))
+            ++count;
+        return count;
+    }
+}
+
+TEST(HidDescriptorDisassembler, RendersItems)
+{
+    HidDescriptorDisassembler disassembler;
+    const std::string text(disassembler.Disassemble(MakeHidGamepadDescriptor(), HidDescriptorDisassembler::Items));
+
+    EXPECT_NE(text.find("Usage Page (Generic Desktop)\n"), std::string::npos);
+    EXPECT_NE(text.find("Collection (Application)\n"), std::string::npos);
+    EXPECT_NE(text.find("  Usage Minimum (Button 1)\n"), std::string::npos);
+    EXPECT_NE(text.find("  Physical Maximum (315)\n"), std::string::npos);
+    EXPECT_NE(text.find("  Input (Data,Var,Abs,Null)\n"), std::string::npos);
+    EXPECT_NE(text.find("\nEnd Collection\n"), std::string::npos);
+    EXPECT_EQ(text.find("Input report"), std::string::npos);
+}
+
+TEST(HidDescriptorDisassembler, RendersBytes)
+{
+    HidDescriptorDisassembler disassembler;
+    const std::string text(disassembler.Disassemble(MakeHidGamepadDescriptor(),
+        HidDescriptorDisassembler::Items | HidDescriptorDisassembler::Bytes));
+
+    EXPECT_EQ(text.rfind("0000: 05 01", 0), 0u);
+    EXPECT_NE(text.find("0028: 46 3B 01"), std::string::npos);
+}
+
+TEST(HidDescriptorDisassembler, RendersLayout)
+{
+    HidDescriptorDisassembler disassembler;
+    const std::string text(disassembler.Disassemble(MakeHidGamepadDescriptor(), HidDescriptorDisassembler::Layout));
+
+    EXPECT_NE(text.find("Input report 1: 8 bytes with Report ID\n"), std::string::npos);
+    EXPECT_NE(text.find("bit     0   1 x 12"), std::string::npos);
+    EXPECT_NE(text.find("bit    12   4 x 1     Const,Var,Abs   padding"), std::string::npos);
+    EXPECT_NE(text.find("bit    24   8 x 4"), std::string::npos);
+    EXPECT_NE(text.find("Generic Desktop: X, Y, Z, Rz"), std::string::npos);
+}
+
+TEST(HidDescriptorDisassembler, NotesMalformedInput)
+{
+    std::vector<uint8_t> descriptor = MakeHidGamepadDescriptor();
+    descriptor.resize(63); // inside Logical Maximum (255)
+
+    HidDescriptorDisassembler disassembler;
+    const std::string text(disassembler.Disassemble(descriptor));
+
+    EXPECT_NE(text.find("Usage (Rz)\n"), std::string::npos);
+    EXPECT_NE(text.find("*** descriptor ends inside an item"), std::string::npos);
+    EXPECT_NE(text.find("*** 1 collection not closed"), std::string::npos);
+}
+
+// Descriptors over 10 KB render completely, and a disassembler reused for a
+// smaller one afterwards gives the same text as a fresh one.
+TEST(HidDescriptorDisassembler, RendersLargeDescriptorsAndReuses)
+{
+    const std::vector<uint8_t> large = MakeLargeHidDescriptor(12 * 1024);
+    ASSERT_GE(large.size(), 12u * 1024);
+
+    // Start small so the buffer has to grow.
+    HidDescriptorDisassembler disassembler(1024);
+    const std::string text(disassembler.Disassemble(large));
+    EXPECT_EQ(CountOf(text, "Collection (Application)\n"), large.size() / MakeHidGamepadDescriptor().size());
+    EXPECT_EQ(CountOf(text, ": 8 bytes with Report ID\n"), large.size() / MakeHidGamepadDescriptor().size());
+    EXPECT_EQ(text.find("***"), std::string::npos);
+
+    HidDescriptorDisassembler fresh;
+    EXPECT_EQ(disassembler.Disassemble(MakeHidGamepadDescriptor()), fresh.Disassemble(MakeHidGamepadDescriptor()));
+}
@@ -0,0 +1,224 @@
+#include "Samples.h"
+
+#include "HidDescriptorCanonical.h"
+#include "HidDeviceModel.h"
+#include "HidInputLayout.h"
+#include "utils_simd.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace
+{
+    const HidDecodePlan::Op* FindOp(const HidDeviceModel& model, uint8_t reportId, HidDecodePlan::OpKind kind, uint16_t slot)
+    {
+        for (const HidDecodePlan::Op& op : model.GetDecodePlan().GetOps(reportId))
+            if (op.kind == kind && op.slot == slot)
+                return &op;
+        return nullptr;
+    }
+}
+
+TEST(HidInputLayout, ParsesGamepad)
+{
+    HidInputLayout layout;
+    ASSERT_TRUE(ParseInputLayout(MakeHidGamepadDescriptor(), layout));
+
+    EXPECT_EQ(layout.usagePage, 0x01);
+    EXPECT_EQ(layout.usageId, 0x05);
+    EXPECT_TRUE(layout.hasReportIds);
+    EXPECT_EQ(layout.inputReportSize, 8u);
+
+    // Buttons 1-12, the hat switch, then X, Y, Z, Rz one channel each; the
+    // padding has no channel.
+    ASSERT_EQ(layout.channels.size(), 6u);
+    EXPECT_EQ(layout.dataIndexCount, 12u + 1 + 4);
+
+    const HidInputChannel& buttons = layout.channels[0];
+    EXPECT_TRUE(buttons.isButton);
+    EXPECT_TRUE(buttons.isRange);
+    EXPECT_EQ(buttons.bitOffset, 8u);
+    EXPECT_EQ(buttons.usageMin, 1);
+    EXPECT_EQ(buttons.usageMax, 12);
+    EXPECT_EQ(buttons.dataIndexMax, 11);
+
+    const HidInputChannel& hat = layout.channels[1];
+    EXPECT_FALSE(hat.isButton);
+    EXPECT_EQ(hat.bitOffset, 24u);
+    EXPECT_EQ(hat.usageMin, 0x39);
+    EXPECT_EQ(hat.physicalMax, 315);
+    EXPECT_EQ(hat.units, 0x14u);
+
+    const HidInputChannel& rz = layout.channels[5];
+    EXPECT_EQ(rz.bitOffset, 56u);
+    EXPECT_EQ(rz.usageMin, 0x35);
+    EXPECT_EQ(rz.reportCount, 1);
+    EXPECT_EQ(rz.logicalMax, 255);
+}
+
+TEST(HidInputLayout, CountsReportIdByteWithoutReportIds)
+{
+    HidInputLayout layout;
+    ASSERT_TRUE(ParseInputLayout(MakeHidMouseDescriptor(), layout));
+
+    EXPECT_FALSE(layout.hasReportIds);
+    EXPECT_EQ(layout.inputReportSize, 1u + 4);
+    ASSERT_EQ(layout.channels.size(), 4u);
+    EXPECT_EQ(layout.channels[0].bitOffset, 8u);
+    EXPECT_EQ(layout.channels[1].bitOffset, 16u);
+    EXPECT_FALSE(layout.channels[1].isAbsolute);
+
+    // Pointer is nested in the Mouse collection.
+    EXPECT_EQ(layout.channels[0].linkCollection, 1);
+}
+
+TEST(HidInputLayout, RejectsMalformedDescriptors)
+{
+    HidInputLayout layout;
+
+    std::vector<uint8_t> truncated = MakeHidGamepadDescriptor();
+    truncated.resize(63); // inside Logical Maximum (255)
+    EXPECT_FALSE(ParseInputLayout(truncated, layout));
+
+    std::vector<uint8_t> unbalanced = MakeHidGamepadDescriptor();
+    unbalanced.pop_back();
+    EXPECT_FALSE(ParseInputLayout(unbalanced, layout));
+
+    std::vector<uint8_t> reportIdZero = MakeHidGamepadDescriptor();
+    reportIdZero[7] = 0;
+    EXPECT_FALSE(ParseInputLayout(reportIdZero, layout));
+
+    // 0xFFFF fields of 32 bits do not fit a report.
+    const std::vector<uint8_t> oversized = {
+        0x05, 0x01, 0x09, 0x04, 0xA1, 0x01,
+        0x09, 0x30, 0x75, 0x20, 0x96, 0xFF, 0xFF, 0x81, 0x02,
+        0xC0,
+    };
+    EXPECT_FALSE(ParseInputLayout(oversized, layout));
+}
+
+TEST(HidDeviceModel, BuildsGamepadFromDescriptor)
+{
+    const std::shared_ptr<const HidDeviceModel> model = HidDeviceModel::AcquireFromDescriptor(MakeHidGamepadDescriptor());
+    ASSERT_NE(model, nullptr);
+
+    EXPECT_EQ(model->GetUsagePage(), 0x01);
+    EXPECT_EQ(model->GetUsageId(), 0x05);
+    EXPECT_TRUE(model->HasReportIds());
+    EXPECT_EQ(model->GetInputReportSize(), 8u);
+
+    // Button slots follow the button numbers.
+    ASSERT_EQ(model->GetButtons().size(), 12u);
+    for (size_t i = 0; i < 12; ++i)
+        EXPECT_EQ(model->GetButtons()[i].usage, i + 1);
+
+    // X, Y, Z take their usage slots; Rz has no slot 5 among four axes and
+    // takes the free one.
+    ASSERT_EQ(model->GetAxes().size(), 4u);
+    EXPECT_EQ(model->GetAxes()[0].usage, 0x30);
+    EXPECT_EQ(model->GetAxes()[2].usage, 0x32);
+    EXPECT_EQ(model->GetAxes()[3].usage, 0x35);
+    EXPECT_EQ(model->GetAxes()[3].logicalMax, 255);
+
+    ASSERT_EQ(model->GetSwitches().size(), 1u);
+    EXPECT_EQ(model->GetSwitches()[0].granularity, 36000 / 8);
+
+    EXPECT_EQ(model->GetDecodePlan().GetOpCount(), 12u + 1 + 4);
+    const HidDecodePlan::Op* rz = FindOp(*model, 1, HidDecodePlan::OpKind::Axis, 3);
+    ASSERT_NE(rz, nullptr);
+    EXPECT_EQ(rz->bitOffset, 56u);
+    const HidDecodePlan::Op* button12 = FindOp(*model, 1, HidDecodePlan::OpKind::Button, 11);
+    ASSERT_NE(button12, nullptr);
+    EXPECT_EQ(button12->bitOffset, 19u);
+
+    EXPECT_EQ(model->GetControls().Find(0x01, 0x39)->kind, HidControlRegistry::Kind::Switch);
+}
+
+TEST(HidDeviceModel, SharesModelsOfEquivalentDescriptors)
+{
+    const std::vector<uint8_t> gamepad = MakeHidGamepadDescriptor();
+
+    // The same descriptor with Report Size (8) as a 4-byte item.
+    std::vector<uint8_t> reencoded = gamepad;
+    const std::vector<uint8_t> reportSize = { 0x75, 0x08 };
+    const auto at = std::search(reencoded.begin(), reencoded.end(), reportSize.begin(), reportSize.end());
+    ASSERT_NE(at, reencoded.end());
+    *at = 0x77;
+    reencoded.insert(at + 2, { 0x00, 0x00, 0x00 });
+
+    std::vector<uint8_t> otherId = gamepad;
+    otherId[7] = 2;
+
+    const size_t before = HidDeviceModel::GetLiveModelCount();
+    const std::shared_ptr<const HidDeviceModel> a = HidDeviceModel::AcquireFromDescriptor(gamepad);
+    const std::shared_ptr<const HidDeviceModel> b = HidDeviceModel::AcquireFromDescriptor(reencoded);
+    const std::shared_ptr<const HidDeviceModel> c = HidDeviceModel::AcquireFromDescriptor(otherId);
+
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(HidDeviceModel::GetLiveModelCount(), before + 2);
+
+    EXPECT_EQ(HidDeviceModel::AcquireFromDescriptor({}), nullptr);
+}
+
+TEST(HidDeviceModel, FingerprintHashesCanonicalForm)
+{
+    // The model cache is keyed by the fingerprint and confirms with the
+    // canonical bytes, so both must agree.
+    std::vector<std::vector<uint8_t>> corpus = MakeDescriptorCorpus(64, 49);
+    corpus.push_back(MakeHidGamepadDescriptor());
+    corpus.push_back(MakeLargeHidDescriptor(16));
+
+    for (const std::vector<uint8_t>& descriptor : corpus)
+    {
+        std::vector<uint8_t> canonical;
+        uint64_t fingerprint = 0;
+        const bool valid = CanonicalizeDescriptor(descriptor, canonical);
+        ASSERT_EQ(FingerprintDescriptor(descriptor, fingerprint), valid);
+        if (valid)
+        {
+            EXPECT_EQ(fingerprint, simd::HashBytes(canonical.data(), canonical.size()));
+        }
+    }
+
+    uint64_t fingerprint = 0;
+    const std::vector<uint8_t> truncated = { 0x05, 0x01, 0x09, 0x05, 0xA1 };
+    EXPECT_FALSE(FingerprintDescriptor(truncated, fingerprint));
+}
+
+TEST(HidDeviceModel, MarksRelativeReports)
+{
+    const std::shared_ptr<const HidDeviceModel> model = HidDeviceModel::AcquireFromDescriptor(MakeHidMouseDescriptor());
+    ASSERT_NE(model, nullptr);
+
+    EXPECT_FALSE(model->HasReportIds());
+    EXPECT_TRUE(model->GetDecodePlan().HasRelative(0));
+    ASSERT_EQ(model->GetAxes().size(), 3u);
+    EXPECT_FALSE(model->GetAxes()[0].isAbsolute);
+    EXPECT_EQ(model->GetAxes()[0].logicalMin, -127);
+    EXPECT_EQ(model->GetAxisTransform().scale[0], 1.f);
+}
+
+TEST(HidDeviceModel, MapsArraysThroughSelectorTables)
+{
+    const std::shared_ptr<const HidDeviceModel> model = HidDeviceModel::AcquireFromDescriptor(MakeHidKeyboardDescriptor());
+    ASSERT_NE(model, nullptr);
+
+    // Modifiers and keys 0..101 are all appended: none is on the Button page.
+    ASSERT_EQ(model->GetButtons().size(), 8u + 102);
+    EXPECT_EQ(model->GetButtons()[0].usage, 0xE0);
+    EXPECT_EQ(model->GetButtons()[8 + 4].usage, 0x04); // A
+
+    std::span<const HidDecodePlan::Op> ops = model->GetDecodePlan().GetOps(0);
+    const auto selector = std::find_if(ops.begin(), ops.end(),
+        [](const HidDecodePlan::Op& op) { return op.kind == HidDecodePlan::OpKind::Selector; });
+    ASSERT_NE(selector, ops.end());
+    EXPECT_EQ(selector->bitOffset, 24u);
+    EXPECT_EQ(selector->fieldCount, 6);
+
+    const std::span<const uint16_t> slots = model->GetDecodePlan().GetSelectorSlots(*selector);
+    ASSERT_EQ(slots.size(), 102u);
+    EXPECT_EQ(slots[0x04], 8 + 4);
+}
@@ -0,0 +1,360 @@
+#include "Samples.h"
+
+#include "HidReportDecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    std::shared_ptr<const HidDeviceModel> AcquireSample(const std::vector<uint8_t>& descriptor)
+    {
+        std::shared_ptr<const HidDeviceModel> model = HidDeviceModel::AcquireFromDescriptor(descriptor);
+        EXPECT_NE(model, nullptr);
+        return model;
+    }
+
+    // Gamepad report: Report ID 1, buttons 1..12, hat, X, Y, Z, Rz.
+    std::array<uint8_t, 8> MakeGamepadReport(uint16_t buttons, uint8_t hat, uint8_t x, uint8_t y = 0x80, uint8_t z = 0x80, uint8_t rz = 0x80)
+    {
+        return { 0x01, static_cast<uint8_t>(buttons), static_cast<uint8_t>(buttons >> 8), hat, x, y, z, rz };
+    }
+
+    void Decode(HidReportDecoder& decoder, std::span<const uint8_t> report, uint64_t timestamp = 0)
+    {
+        decoder.Decode(report.data(), report.size(), 1, timestamp);
+    }
+}
+
+TEST(HidReportDecoder, DecodesGamepadReport)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    ASSERT_EQ(decoder.GetButtonCount(), 12u);
+    ASSERT_EQ(decoder.GetAxisCount(), 4u);
+    ASSERT_EQ(decoder.GetSwitchCount(), 1u);
+
+    Decode(decoder, MakeGamepadReport(0x0801, 2, 0xFF, 0x00));
+
+    HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    EXPECT_TRUE(state.GetButton(0));
+    EXPECT_FALSE(state.GetButton(1));
+    EXPECT_TRUE(state.GetButton(11));
+    EXPECT_FALSE(state.GetButton(64));
+    EXPECT_EQ(state.GetSwitch(0), SwitchPosition::Right);
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(1), -1.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(4), 0.f);
+    EXPECT_TRUE(state.WasButtonPressed(0));
+    EXPECT_TRUE(state.WasButtonPressed(11));
+
+    // Hat outside its logical range is its null state.
+    Decode(decoder, MakeGamepadReport(0x0800, 8, 0xFF, 0x00));
+    decoder.ReadSnapshot(state);
+    EXPECT_EQ(state.GetSwitch(0), SwitchPosition::Center);
+    EXPECT_TRUE(state.WasButtonReleased(0));
+    EXPECT_FALSE(state.WasButtonPressed(11));
+}
+
+TEST(HidReportDecoder, ReadsSnapshot)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    Decode(decoder, MakeGamepadReport(0x0005, 4, 0x00, 0xFF));
+
+    HidReportDecoder::Snapshot snapshot;
+    decoder.ReadSnapshot(snapshot);
+    ASSERT_EQ(snapshot.axes.size(), 4u);
+    ASSERT_EQ(snapshot.buttons.size(), 1u);
+    EXPECT_FLOAT_EQ(snapshot.axes[0], -1.f);
+    EXPECT_FLOAT_EQ(snapshot.axes[1], 1.f);
+    EXPECT_EQ(snapshot.buttons[0], 0x0005u);
+    EXPECT_EQ(snapshot.pressed[0], 0x0005u);
+    EXPECT_EQ(snapshot.released[0], 0u);
+    EXPECT_EQ(snapshot.switches[0], SwitchPosition::Down);
+    EXPECT_EQ(snapshot.stats.reports, 1u);
+}
+
+TEST(HidReportDecoder, SkipsRepeatedReports)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+
+    const std::array<uint8_t, 8> report = MakeGamepadReport(0x0001, 0, 0x10);
+    Decode(decoder, report);
+    Decode(decoder, report);
+    Decode(decoder, MakeGamepadReport(0x0001, 0, 0x20));
+
+    const HidDecodeStats stats = decoder.GetDecodeStats();
+    EXPECT_EQ(stats.reports, 3u);
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.partial, 1u);
+    EXPECT_TRUE(decoder.ReadSnapshot().GetButton(0));
+}
+
+TEST(HidReportDecoder, AccumulatesRelativeAxesWithoutReportIds)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidMouseDescriptor()));
+    ASSERT_EQ(decoder.GetAxisCount(), 3u);
+
+    // Report ID byte 0, buttons, X, Y, wheel.
+    const uint8_t reports[] = {
+        0x00, 0x01, 0x05, 0x00, 0x00,
+        0x00, 0x01, 0xFD, 0x02, 0x00,
+    };
+    decoder.SetBatchMode(HidBatchMode::LatestOnly);
+    decoder.Decode(reports, 5, 2, 0);
+
+    const HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 2.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(1), 2.f);
+    EXPECT_TRUE(state.GetButton(0));
+    EXPECT_EQ(state.stats.coalesced, 0u);
+}
+
+TEST(HidReportDecoder, BatchModes)
+{
+    std::array<uint8_t, 3 * 8> burst;
+    const uint8_t xs[] = { 0x00, 0x80, 0xFF };
+    for (size_t i = 0; i < std::size(xs); ++i)
+    {
+        const std::array<uint8_t, 8> report = MakeGamepadReport(xs[i] == 0x80 ? 0x0002 : 0, 0, xs[i]);
+        std::copy(report.begin(), report.end(), burst.begin() + i * report.size());
+    }
+
+    HidReportDecoder sequential(AcquireSample(MakeHidGamepadDescriptor()));
+    sequential.Decode(burst.data(), 8, 3, 0);
+    HidReportDecoder::Snapshot state = sequential.ReadSnapshot();
+    EXPECT_TRUE(state.WasButtonPressed(1));
+    EXPECT_TRUE(state.WasButtonReleased(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+
+    HidReportDecoder latest(AcquireSample(MakeHidGamepadDescriptor()));
+    latest.SetBatchMode(HidBatchMode::LatestOnly);
+    latest.Decode(burst.data(), 8, 3, 0);
+    latest.ReadSnapshot(state);
+    EXPECT_FALSE(state.WasButtonPressed(1));
+    EXPECT_EQ(state.stats.coalesced, 2u);
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+
+    HidReportDecoder history(AcquireSample(MakeHidGamepadDescriptor()));
+    history.SetBatchMode(HidBatchMode::History);
+    history.Decode(burst.data(), 8, 3, 0);
+    HidReportHistory rows;
+    history.CopyHistory(rows);
+    ASSERT_EQ(rows.GetReportCount(), 3u);
+    EXPECT_FLOAT_EQ(rows.GetAxis(0)[0], -1.f);
+    EXPECT_FLOAT_EQ(rows.GetAxis(0)[2], 1.f);
+    EXPECT_TRUE(TestBit(rows.GetButtonWords(1), 1));
+    EXPECT_FALSE(TestBit(rows.GetButtonWords(2), 1));
+    history.ReadSnapshot(state);
+    EXPECT_TRUE(state.WasButtonPressed(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+}
+
+TEST(HidReportDecoder, DeferredDecodeRunsOnRead)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    decoder.SetDeferredDecode(true);
+
+    Decode(decoder, MakeGamepadReport(0x0001, 0, 0x00));
+    Decode(decoder, MakeGamepadReport(0x0004, 0, 0xFF));
+    EXPECT_EQ(decoder.GetDecodeStats().coalesced, 1u);
+
+    HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    EXPECT_FALSE(state.GetButton(0));
+    EXPECT_TRUE(state.GetButton(2));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+    EXPECT_TRUE(state.WasButtonPressed(2));
+
+    // Edges cover everything since the previous read.
+    Decode(decoder, MakeGamepadReport(0x0004, 0, 0xFF));
+    decoder.ReadSnapshot(state);
+    EXPECT_FALSE(state.WasButtonPressed(2));
+}
+
+TEST(HidReportDecoder, DeferredReadsWhileDecoding)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    decoder.SetDeferredDecode(true);
+
+    constexpr int kReports = 20000;
+    std::thread writer([&decoder]()
+        {
+            for (int i = 0; i < kReports; ++i)
+                Decode(decoder, MakeGamepadReport(static_cast<uint16_t>(1u << (i % 12)), 0, static_cast<uint8_t>(i)));
+        });
+
+    // Each read flushes what is pending while the writer keeps decoding.
+    HidReportDecoder::Snapshot state;
+    for (int i = 0; i < kReports / 10; ++i)
+        decoder.ReadSnapshot(state);
+    writer.join();
+
+    const int last = kReports - 1;
+    decoder.ReadSnapshot(state);
+    EXPECT_TRUE(state.GetButton(last % 12));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), (static_cast<uint8_t>(last) - 127.5f) / 127.5f);
+    EXPECT_EQ(state.stats.reports, static_cast<uint64_t>(kReports));
+}
+
+TEST(HidReportDecoder, MapsKeyboardArrayToButtons)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidKeyboardDescriptor()));
+
+    const HidControlRegistry::Entry* keyA = decoder.GetControls().Find(0x07, 0x04);
+    const HidControlRegistry::Entry* keyB = decoder.GetControls().Find(0x07, 0x05);
+    ASSERT_NE(keyA, nullptr);
+    ASSERT_NE(keyB, nullptr);
+    ASSERT_EQ(keyA->kind, HidControlRegistry::Kind::Button);
+
+    // Report ID byte 0, modifiers, reserved, six key slots.
+    const uint8_t down[] = { 0x00, 0x00, 0x00, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00 };
+    Decode(decoder, down);
+    HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    EXPECT_TRUE(state.GetButton(keyA->index));
+    EXPECT_TRUE(state.GetButton(keyB->index));
+
+    const uint8_t up[] = { 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    Decode(decoder, up);
+    decoder.ReadSnapshot(state);
+    EXPECT_FALSE(state.GetButton(keyA->index));
+    EXPECT_TRUE(state.GetButton(keyB->index));
+    EXPECT_TRUE(state.WasButtonReleased(keyA->index));
+}
+
+TEST(HidReportDecoder, CalibrationAndSettings)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    decoder.SetAxisCalibration(0, { .deadzone = 0.5f });
+    decoder.EnableRawReportRing(4);
+
+    Decode(decoder, MakeGamepadReport(0, 0, 0xA0, 0xA0), 42);
+    const HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 0.f);
+    EXPECT_NE(state.GetAxis(1), 0.f);
+
+    RawReportRing::View view;
+    ASSERT_NE(decoder.GetRawReportRing(), nullptr);
+    ASSERT_TRUE(decoder.GetRawReportRing()->Read(0, view));
+    EXPECT_EQ(view.timestamp, 42u);
+    EXPECT_EQ(view.reportId, 1u);
+
+    // A new decoder for the same model takes the settings over.
+    HidReportDecoder restored(decoder.GetModel());
+    restored.RestoreSettings(decoder.SaveSettings());
+    EXPECT_FLOAT_EQ(restored.GetAxisCalibration(0).deadzone, 0.5f);
+    EXPECT_EQ(restored.GetRawReportRing()->GetCapacity(), 4u);
+}
+
+TEST(HidReportDecoder, CalibrationChangesWhileDecoding)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    HidReportDecoder reference(decoder.GetModel());
+
+    std::atomic<bool> done = false;
+    std::thread decodeThread([&]
+    {
+        for (uint8_t x = 0; !done; ++x)
+            Decode(decoder, MakeGamepadReport(0, 0, x, 0xA0, 0xA0));
+    });
+
+    for (int i = 0; i < 200; ++i)
+    {
+        decoder.SetAxisCalibration(1, { .deadzone = (i % 2) ? 0.f : 0.5f });
+        decoder.SetAxisCalibration(2, { .deadzone = 0.5f });
+    }
+    done = true;
+    decodeThread.join();
+
+    // Axis 1 ends uncalibrated, axis 2 (a LUT between two arithmetic runs)
+    // with the deadzone; the others are untouched.
+    decoder.SetBatchMode(HidBatchMode::History);
+    const std::array<uint8_t, 8> reports[2] = { MakeGamepadReport(0, 0, 0x10, 0xA0, 0xA0, 0xF0),
+                                                MakeGamepadReport(0, 0, 0x20, 0xA0, 0xA0, 0xF0) };
+    decoder.Decode(reports[0].data(), reports[0].size(), 2, 0);
+    for (const auto& report : reports)
+        Decode(reference, report);
+
+    EXPECT_EQ(decoder.GetAxisCalibration(1).deadzone, 0.f);
+    HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    HidReportDecoder::Snapshot expected = reference.ReadSnapshot();
+    EXPECT_FLOAT_EQ(state.GetAxis(0), expected.GetAxis(0));
+    EXPECT_FLOAT_EQ(state.GetAxis(1), expected.GetAxis(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(2), 0.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(3), expected.GetAxis(3));
+
+    HidReportHistory history;
+    decoder.CopyHistory(history);
+    ASSERT_EQ(history.GetReportCount(), 2u);
+    EXPECT_FLOAT_EQ(history.GetAxis(2)[0], 0.f);
+    EXPECT_NE(history.GetAxis(1)[0], 0.f);
+
+    // Sequential decode goes through the per-report pass.
+    decoder.SetBatchMode(HidBatchMode::Sequential);
+    Decode(decoder, MakeGamepadReport(0, 0, 0x30, 0xA0, 0xA0, 0x10));
+    Decode(reference, MakeGamepadReport(0, 0, 0x30, 0xA0, 0xA0, 0x10));
+    decoder.ReadSnapshot(state);
+    reference.ReadSnapshot(expected);
+    EXPECT_FLOAT_EQ(state.GetAxis(1), expected.GetAxis(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(2), 0.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(3), expected.GetAxis(3));
+}
+
+TEST(HidReportDecoder, EnablesRawReportRingWhileDecoding)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+
+    std::atomic<uint64_t> decoded = 0;
+    std::atomic<bool> done = false;
+    std::thread decodeThread([&]
+    {
+        for (uint8_t x = 0; !done; ++x)
+        {
+            Decode(decoder, MakeGamepadReport(0, 0, x), x);
+            ++decoded;
+        }
+    });
+
+    while (decoded < 100)
+        std::this_thread::yield();
+    decoder.EnableRawReportRing(8);
+    const RawReportRing* ring = decoder.GetRawReportRing();
+    ASSERT_NE(ring, nullptr);
+
+    // Reports decoded after the ring was published land in it.
+    const uint64_t published = decoded;
+    while (decoded < published + 100)
+        std::this_thread::yield();
+    done = true;
+    decodeThread.join();
+
+    ASSERT_GE(ring->GetNextSequence(), 100u);
+    RawReportRing::View view;
+    EXPECT_TRUE(ring->Read(ring->GetNextSequence() - 1, view));
+    EXPECT_EQ(view.reportId, 1u);
+
+    decoder.EnableRawReportRing(16);
+    EXPECT_EQ(decoder.GetRawReportRing(), ring);
+}
+
+TEST(HidReportDecoder, CalibrationAppliesToStillAxes)
+{
+    HidReportDecoder decoder(AcquireSample(MakeHidGamepadDescriptor()));
+    Decode(decoder, MakeGamepadReport(0, 0, 0xA0));
+    const float uncalibrated = decoder.ReadSnapshot().GetAxis(0);
+    ASSERT_NE(uncalibrated, 0.f);
+
+    // The same report again is skipped, yet the new deadzone shows.
+    decoder.SetAxisCalibration(0, { .deadzone = 0.5f });
+    Decode(decoder, MakeGamepadReport(0, 0, 0xA0));
+    EXPECT_EQ(decoder.GetDecodeStats().skipped, 1u);
+    EXPECT_FLOAT_EQ(decoder.ReadSnapshot().GetAxis(0), 0.f);
+
+    // A report changing only buttons picks up the next change too.
+    decoder.SetAxisCalibration(0, {});
+    Decode(decoder, MakeGamepadReport(0x0001, 0, 0xA0));
+    const HidReportDecoder::Snapshot state = decoder.ReadSnapshot();
+    EXPECT_TRUE(state.GetButton(0));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), uncalibrated);
+}
@@ -0,0 +1,133 @@
+#include "HotplugGenerator.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    using Clock = HotplugCoalescer::Clock;
+
+    // A registry of handles, each with the generation of the device object
+    // created for it, so a re-created device can be told from a kept one.
+    using Registry = std::map<HotplugCoalescer::Key, uint32_t>;
+
+    // What handling each notification on its own does.
+    void ApplyOne(Registry& registry, uint32_t& generation, const HotplugGenerator::Notification& notification)
+    {
+        registry.erase(notification.key);
+        if (notification.arrival)
+            registry[notification.key] = ++generation;
+    }
+
+    // What the manager does with a batch: removals, then arrivals.
+    void ApplyBatch(Registry& registry, uint32_t& generation, const HotplugCoalescer::Batch& batch)
+    {
+        for (HotplugCoalescer::Key key : batch.removed)
+            registry.erase(key);
+        for (HotplugCoalescer::Key key : batch.arrived)
+        {
+            // A repeated arrival of a device already in keeps it.
+            if (!registry.count(key))
+                registry[key] = ++generation;
+        }
+    }
+
+    std::set<HotplugCoalescer::Key> Keys(const Registry& registry)
+    {
+        std::set<HotplugCoalescer::Key> keys;
+        for (const auto& entry : registry)
+            keys.insert(entry.first);
+        return keys;
+    }
+}
+
+TEST(HotplugCoalescer, CollapsesPerHandle)
+{
+    HotplugCoalescer coalescer(30ms, 250ms);
+    const Clock::time_point now{};
+
+    coalescer.OnArrival(1, now);
+    coalescer.OnArrival(1, now);  // repeated
+    coalescer.OnArrival(2, now);
+    coalescer.OnRemoval(2, now);  // arrive then remove
+    coalescer.OnRemoval(3, now);
+    coalescer.OnArrival(3, now);  // handle reused
+
+    const HotplugCoalescer::Batch batch = coalescer.Take();
+    EXPECT_EQ(batch.notifications, 6u);
+    EXPECT_EQ(batch.removed, (std::vector<HotplugCoalescer::Key>{ 2, 3 }));
+    EXPECT_EQ(batch.arrived, (std::vector<HotplugCoalescer::Key>{ 1, 3 }));
+    EXPECT_TRUE(coalescer.IsEmpty());
+}
+
+TEST(HotplugCoalescer, DueAfterQuietPeriodOrMaxDelay)
+{
+    HotplugCoalescer coalescer(30ms, 250ms);
+    const Clock::time_point start{};
+
+    EXPECT_FALSE(coalescer.IsDue(start + 1s));
+
+    coalescer.OnArrival(1, start);
+    EXPECT_FALSE(coalescer.IsDue(start + 29ms));
+    EXPECT_TRUE(coalescer.IsDue(start + 30ms));
+
+    // A steady trickle pushes the quiet deadline on, up to the max delay.
+    for (auto t = 20ms; t < 400ms; t += 20ms)
+        coalescer.OnArrival(t.count(), start + t);
+    EXPECT_EQ(coalescer.GetDeadline(), start + 250ms);
+
+    coalescer.Take();
+    EXPECT_FALSE(coalescer.IsDue(start + 1s));
+}
+
+// Random storms, taken whenever the coalescer says the batch is due, must
+// leave the same handles registered as handling every notification on its
+// own. A handle removed and re-added within a batch must get a new device.
+TEST(HotplugCoalescer, MatchesPerNotificationReference)
+{
+    HotplugGenerator generator(7);
+    Registry reference, batched;
+    uint32_t referenceGeneration = 0, batchedGeneration = 0;
+
+    for (int storm = 0; storm < 200; ++storm)
+    {
+        HotplugCoalescer coalescer(30ms, 250ms);
+        Clock::time_point now{};
+        size_t batches = 0;
+
+        for (const HotplugGenerator::Notification& notification : generator.MakeStorm(100, 40, 40))
+        {
+            now += notification.delay;
+            if (coalescer.IsDue(now))
+            {
+                ApplyBatch(batched, batchedGeneration, coalescer.Take());
+                ++batches;
+            }
+
+            if (notification.arrival)
+                coalescer.OnArrival(notification.key, now);
+            else
+                coalescer.OnRemoval(notification.key, now);
+
+            ApplyOne(reference, referenceGeneration, notification);
+        }
+
+        const Registry beforeLast = batched;
+        const HotplugCoalescer::Batch last = coalescer.Take();
+        ApplyBatch(batched, batchedGeneration, last);
+        ++batches;
+
+        ASSERT_EQ(Keys(batched), Keys(reference)) << "storm " << storm;
+        for (HotplugCoalescer::Key key : last.removed)
+        {
+            if (batched.count(key) && beforeLast.count(key))
+            {
+                EXPECT_NE(batched[key], beforeLast.at(key)) << "storm " << storm << " handle " << key;
+            }
+        }
+        EXPECT_GE(batches, 2u);
+    }
+}
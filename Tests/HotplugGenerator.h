@@ -0,0 +1,47 @@
+#pragma once
+
+#include "HotplugCoalescer.h"
+
+#include <random>
+#include <set>
+#include <vector>
+
+// Synthetic hotplug storms: a dock or hub announcing and dropping interfaces,
+// with repeats and reused handles, spread over a few hundred milliseconds.
+class HotplugGenerator
+{
+public:
+    struct Notification
+    {
+        HotplugCoalescer::Key          key = 0;
+        bool                           arrival = false;
+        HotplugCoalescer::Clock::duration delay{}; // since the previous one
+    };
+
+    explicit HotplugGenerator(uint32_t seed) : m_Random(seed) {}
+
+    // `count` notifications over handles 1..`handles`, mostly arrivals of
+    // absent handles and removals of present ones, with some of each the
+    // other way round. Gaps are 0..`maxGapMs` milliseconds.
+    std::vector<Notification> MakeStorm(size_t count, uint64_t handles, uint32_t maxGapMs)
+    {
+        std::vector<Notification> storm(count);
+        for (Notification& notification : storm)
+        {
+            notification.key = 1 + m_Random() % handles;
+            const bool present = m_Present.count(notification.key) != 0;
+            notification.arrival = (m_Random() % 8 == 0) ? present : !present;
+            notification.delay = std::chrono::milliseconds(m_Random() % (maxGapMs + 1));
+
+            if (notification.arrival)
+                m_Present.insert(notification.key);
+            else
+                m_Present.erase(notification.key);
+        }
+        return storm;
+    }
+
+private:
+    std::mt19937       m_Random;
+    std::set<uint64_t> m_Present;
+};
@@ -0,0 +1,122 @@
+#include "Samples.h"
+
+#include "InputPipeline.h"
+#include "SyntheticInputBackend.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace
+{
+    using DeviceSpec = SyntheticInputBackend::DeviceSpec;
+
+    DeviceSpec MakeGamepadSpec()
+    {
+        DeviceSpec spec;
+        spec.reportRate = 1000;
+        spec.reportDescriptor = MakeHidGamepadDescriptor();
+        // Button 1 down with X at the left, then button 2 with X at the right.
+        spec.packets = {
+            { 0x01, 0x01, 0x00, 0x08, 0x00, 0x80, 0x80, 0x80 },
+            { 0x01, 0x02, 0x00, 0x08, 0xFF, 0x80, 0x80, 0x80 },
+        };
+        return spec;
+    }
+
+    // Reports without the Report ID byte, as a hidraw mouse sends them.
+    DeviceSpec MakeMouseSpec()
+    {
+        DeviceSpec spec;
+        spec.reportRate = 1000;
+        spec.reportDescriptor = MakeHidMouseDescriptor();
+        spec.packets = {
+            { 0x01, 0x05, 0x00, 0x00 },
+            { 0x00, 0xFD, 0x01, 0x00 },
+        };
+        return spec;
+    }
+
+    // Runs the backend in virtual time until `packets` were sent, then
+    // waits for them to be decoded.
+    void RunPackets(InputPipeline& pipeline, SyntheticInputBackend& backend, uint64_t packets)
+    {
+        while (backend.GetPacketCount() < packets)
+            std::this_thread::yield();
+        pipeline.Flush();
+    }
+}
+
+TEST(InputPipeline, DecodesSyntheticDevices)
+{
+    SyntheticInputBackend::Config config;
+    config.realTime = false;
+    config.packetLimit = 4;
+    config.devices = { MakeGamepadSpec(), MakeMouseSpec() };
+
+    auto backend = std::make_unique<SyntheticInputBackend>(config);
+    SyntheticInputBackend& synthetic = *backend;
+
+    InputPipeline pipeline(std::move(backend), 2);
+    pipeline.Start();
+    RunPackets(pipeline, synthetic, config.packetLimit);
+
+    const std::vector<InputPipeline::DeviceHandle> handles = synthetic.EnumerateDevices();
+    ASSERT_EQ(handles.size(), 2u);
+    ASSERT_EQ(pipeline.GetDevices().size(), 2u);
+
+    const std::shared_ptr<HidReportDecoder> gamepad = pipeline.GetDecoder(handles[0]);
+    ASSERT_NE(gamepad, nullptr);
+    EXPECT_EQ(gamepad->GetDecodeStats().reports, 2u);
+    const HidReportDecoder::Snapshot gamepadState = gamepad->ReadSnapshot();
+    EXPECT_FALSE(gamepadState.GetButton(0));
+    EXPECT_TRUE(gamepadState.GetButton(1));
+    EXPECT_FLOAT_EQ(gamepadState.GetAxis(0), 1.f);
+    EXPECT_EQ(gamepadState.GetSwitch(0), SwitchPosition::Center);
+
+    const std::shared_ptr<HidReportDecoder> mouse = pipeline.GetDecoder(handles[1]);
+    ASSERT_NE(mouse, nullptr);
+    EXPECT_EQ(mouse->GetDecodeStats().reports, 2u);
+    const HidReportDecoder::Snapshot mouseState = mouse->ReadSnapshot();
+    EXPECT_FALSE(mouseState.GetButton(0));
+    EXPECT_FLOAT_EQ(mouseState.GetAxis(0), 2.f);
+    EXPECT_FLOAT_EQ(mouseState.GetAxis(1), 1.f);
+
+    pipeline.Stop();
+    EXPECT_TRUE(pipeline.GetDevices().empty());
+}
+
+TEST(InputPipeline, TracksHotplug)
+{
+    SyntheticInputBackend::Config config;
+    config.realTime = false;
+    config.packetLimit = 1;
+
+    DeviceSpec noDescriptor;
+    noDescriptor.reportRate = 1000;
+    config.devices = { noDescriptor };
+
+    auto backend = std::make_unique<SyntheticInputBackend>(config);
+    SyntheticInputBackend& synthetic = *backend;
+
+    InputPipeline pipeline(std::move(backend), 1);
+    pipeline.Start();
+    RunPackets(pipeline, synthetic, config.packetLimit);
+
+    // Devices without a report descriptor are not decoded.
+    EXPECT_TRUE(pipeline.GetDevices().empty());
+
+    synthetic.Plug(MakeGamepadSpec());
+    pipeline.Flush();
+    ASSERT_EQ(pipeline.GetDevices().size(), 1u);
+
+    const InputPipeline::DeviceHandle handle = pipeline.GetDevices().front();
+    const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(handle);
+    ASSERT_NE(decoder, nullptr);
+    EXPECT_EQ(decoder->GetButtonCount(), 12u);
+
+    synthetic.Unplug(handle);
+    pipeline.Flush();
+    EXPECT_TRUE(pipeline.GetDevices().empty());
+    EXPECT_EQ(pipeline.GetDecoder(handle), nullptr);
+}
@@ -0,0 +1,255 @@
+#include "Samples.h"
+#include "TempDirectory.h"
+
+#include "InputPipeline.h"
+#include "LinuxInputBackend.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    using DeviceType = InputBackend::DeviceType;
+    using StreamFormat = LinuxInputBackend::StreamFormat;
+
+    // A sysfs HID device directory as dumped from a real one.
+    void WriteSysfsDump(const std::filesystem::path& dir, std::span<const uint8_t> descriptor)
+    {
+        std::filesystem::create_directories(dir);
+
+        std::ofstream(dir / "report_descriptor", std::ios::binary)
+            .write(reinterpret_cast<const char*>(descriptor.data()), static_cast<std::streamsize>(descriptor.size()));
+
+        std::ofstream(dir / "uevent")
+            << "DRIVER=hid-generic\n"
+            << "HID_ID=0003:0000046D:0000C21D\n"
+            << "HID_NAME=Logitech Gamepad F310\n"
+            << "HID_PHYS=usb-0000:00:14.0-2/input0\n"
+            << "HID_UNIQ=\n"
+            << "MODALIAS=hid:b0003g0004v0000046Dp0000C21D\n";
+    }
+
+    input_event MakeEvent(uint16_t type, uint16_t code, int32_t value)
+    {
+        input_event event = {};
+        event.type = type;
+        event.code = code;
+        event.value = value;
+        return event;
+    }
+
+    void WriteAll(int fd, const void* data, size_t size)
+    {
+        ASSERT_EQ(::write(fd, data, size), static_cast<ssize_t>(size));
+    }
+
+    // The backend reads on its own thread; poll until it caught up.
+    bool WaitFor(InputPipeline& pipeline, const std::function<bool()>& done)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            pipeline.Flush();
+            if (done())
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    bool WaitForReports(InputPipeline& pipeline, InputPipeline::DeviceHandle handle, uint64_t reports)
+    {
+        return WaitFor(pipeline, [&]
+            {
+                const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(handle);
+                return decoder && decoder->GetDecodeStats().reports >= reports;
+            });
+    }
+
+    // Read end of a non-blocking pipe as a source; the write end is returned.
+    int AddPipeSource(LinuxInputBackend& backend, LinuxInputBackend::Source source)
+    {
+        int fds[2];
+        EXPECT_EQ(::pipe2(fds, O_NONBLOCK | O_CLOEXEC), 0);
+        source.fd = fds[0];
+        backend.AddSource(std::move(source));
+        return fds[1];
+    }
+
+    // Gamepad report: Report ID 1, buttons 1..12, hat, X, Y, Z, Rz.
+    std::array<uint8_t, 8> MakeGamepadReport(uint16_t buttons, uint8_t x)
+    {
+        return { 0x01, static_cast<uint8_t>(buttons), static_cast<uint8_t>(buttons >> 8), 0x08, x, 0x80, 0x80, 0x80 };
+    }
+}
+
+TEST(LinuxInputBackend, ReadsSysfsDump)
+{
+    TempDirectory dir;
+    const std::vector<uint8_t> descriptor = MakeHidGamepadDescriptor();
+    WriteSysfsDump(dir.GetPath() / "hidraw0", descriptor);
+
+    const std::optional<LinuxInputBackend::HidrawSysfsInfo> info = LinuxInputBackend::ReadHidrawSysfs((dir.GetPath() / "hidraw0").string());
+    ASSERT_TRUE(info);
+    EXPECT_EQ(info->bus, 3u);
+    EXPECT_EQ(info->vendorId, 0x046Du);
+    EXPECT_EQ(info->productId, 0xC21Du);
+    EXPECT_EQ(info->name, "Logitech Gamepad F310");
+    EXPECT_TRUE(info->uniq.empty());
+    EXPECT_EQ(info->reportDescriptor, descriptor);
+
+    EXPECT_FALSE(LinuxInputBackend::ReadHidrawSysfs((dir.GetPath() / "missing").string()));
+}
+
+TEST(LinuxInputBackend, DecodesHidrawPacketsFromSocketpair)
+{
+    TempDirectory dir;
+    WriteSysfsDump(dir.GetPath() / "hidraw0", MakeHidGamepadDescriptor());
+
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds), 0);
+
+    LinuxInputBackend::Source source;
+    source.fd = fds[0];
+    source.interfacePath = "/dev/hidraw0";
+    source.reportDescriptor = LinuxInputBackend::ReadHidrawSysfs((dir.GetPath() / "hidraw0").string())->reportDescriptor;
+
+    auto backend = std::make_unique<LinuxInputBackend>();
+    backend->AddSource(std::move(source));
+
+    InputPipeline pipeline(std::move(backend), 1);
+    pipeline.Start();
+    ASSERT_EQ(pipeline.GetDevices().size(), 1u);
+    const InputPipeline::DeviceHandle handle = pipeline.GetDevices().front();
+
+    // One report per datagram, several queued per recvmmsg.
+    for (const auto& report : { MakeGamepadReport(0x0001, 0x00), MakeGamepadReport(0x0003, 0x80), MakeGamepadReport(0x0002, 0xFF) })
+        ASSERT_EQ(::send(fds[1], report.data(), report.size(), 0), static_cast<ssize_t>(report.size()));
+
+    ASSERT_TRUE(WaitForReports(pipeline, handle, 3));
+    const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(handle);
+    const HidReportDecoder::Snapshot state = decoder->ReadSnapshot();
+    EXPECT_FALSE(state.GetButton(0));
+    EXPECT_TRUE(state.GetButton(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+
+    // The peer going away removes the device.
+    ::close(fds[1]);
+    EXPECT_TRUE(WaitFor(pipeline, [&] { return pipeline.GetDevices().empty(); }));
+
+    pipeline.Stop();
+}
+
+TEST(LinuxInputBackend, DecodesFixedReportsFromPipe)
+{
+    auto backend = std::make_unique<LinuxInputBackend>();
+
+    LinuxInputBackend::Source source;
+    source.format = StreamFormat::FixedReports;
+    source.reportSize = 4;
+    source.reportDescriptor = MakeHidMouseDescriptor();
+    const int writer = AddPipeSource(*backend, std::move(source));
+
+    InputPipeline pipeline(std::move(backend), 1);
+    pipeline.Start();
+    const InputPipeline::DeviceHandle handle = pipeline.GetDevices().front();
+
+    // Three mouse reports, split across writes mid-report.
+    const uint8_t reports[] = {
+        0x01, 0x05, 0x00, 0x00,
+        0x01, 0x03, 0xFE, 0x00,
+        0x00, 0xFF, 0x01, 0x01,
+    };
+    WriteAll(writer, reports, 6);
+    ASSERT_TRUE(WaitForReports(pipeline, handle, 1));
+    WriteAll(writer, reports + 6, sizeof(reports) - 6);
+    ASSERT_TRUE(WaitForReports(pipeline, handle, 3));
+
+    const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(handle);
+    const HidReportDecoder::Snapshot state = decoder->ReadSnapshot();
+    EXPECT_FALSE(state.GetButton(0));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 7.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(1), -1.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(2), 1.f);
+
+    ::close(writer);
+    pipeline.Stop();
+}
+
+TEST(LinuxInputBackend, DecodesEvdevKeyboard)
+{
+    auto backend = std::make_unique<LinuxInputBackend>();
+
+    LinuxInputBackend::Source source;
+    source.format = StreamFormat::Evdev;
+    source.type = DeviceType::Keyboard;
+    const int writer = AddPipeSource(*backend, std::move(source));
+
+    InputPipeline pipeline(std::move(backend), 1);
+    pipeline.Start();
+    const InputPipeline::DeviceHandle handle = pipeline.GetDevices().front();
+
+    // A down, Shift down with A repeating, A up; MSC_SCAN as real keyboards send.
+    const input_event events[] = {
+        MakeEvent(EV_MSC, MSC_SCAN, 0x70004), MakeEvent(EV_KEY, KEY_A, 1), MakeEvent(EV_SYN, SYN_REPORT, 0),
+        MakeEvent(EV_KEY, KEY_LEFTSHIFT, 1), MakeEvent(EV_KEY, KEY_A, 2), MakeEvent(EV_SYN, SYN_REPORT, 0),
+        MakeEvent(EV_MSC, MSC_SCAN, 0x70004), MakeEvent(EV_KEY, KEY_A, 0), MakeEvent(EV_SYN, SYN_REPORT, 0),
+    };
+    WriteAll(writer, events, sizeof(events));
+    ASSERT_TRUE(WaitForReports(pipeline, handle, 3));
+
+    // Button slots are Keyboard/Keypad usages.
+    const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(handle);
+    ASSERT_EQ(decoder->GetButtonCount(), EvdevHidTranslator::kKeyboardUsages);
+    const HidReportDecoder::Snapshot state = decoder->ReadSnapshot();
+    EXPECT_FALSE(state.GetButton(0x04));
+    EXPECT_TRUE(state.WasButtonReleased(0x04));
+    EXPECT_TRUE(state.GetButton(0xE1));
+
+    ::close(writer);
+    pipeline.Stop();
+}
+
+TEST(LinuxInputBackend, DecodesEvdevMouseAndDropsOverrunFrames)
+{
+    auto backend = std::make_unique<LinuxInputBackend>();
+
+    LinuxInputBackend::Source source;
+    source.format = StreamFormat::Evdev;
+    source.type = DeviceType::Mouse;
+    const int writer = AddPipeSource(*backend, std::move(source));
+
+    InputPipeline pipeline(std::move(backend), 1);
+    pipeline.Start();
+    const InputPipeline::DeviceHandle handle = pipeline.GetDevices().front();
+
+    const input_event events[] = {
+        MakeEvent(EV_REL, REL_X, 5), MakeEvent(EV_REL, REL_Y, -3), MakeEvent(EV_KEY, BTN_LEFT, 1), MakeEvent(EV_SYN, SYN_REPORT, 0),
+        // The kernel buffer overran: this frame is incomplete and dropped.
+        MakeEvent(EV_SYN, SYN_DROPPED, 0), MakeEvent(EV_REL, REL_X, 100), MakeEvent(EV_SYN, SYN_REPORT, 0),
+        MakeEvent(EV_REL, REL_X, 2), MakeEvent(EV_REL, REL_WHEEL, 1), MakeEvent(EV_KEY, BTN_RIGHT, 1), MakeEvent(EV_SYN, SYN_REPORT, 0),
+    };
+    WriteAll(writer, events, sizeof(events));
+    ASSERT_TRUE(WaitForReports(pipeline, handle, 2));
+
+    const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(handle);
+    EXPECT_EQ(decoder->GetDecodeStats().reports, 2u);
+    const HidReportDecoder::Snapshot state = decoder->ReadSnapshot();
+    EXPECT_TRUE(state.GetButton(0));
+    EXPECT_TRUE(state.GetButton(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 7.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(1), -3.f);
+    EXPECT_FLOAT_EQ(state.GetAxis(2), 1.f);
+
+    ::close(writer);
+    pipeline.Stop();
+}
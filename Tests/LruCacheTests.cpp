@@ -0,0 +1,63 @@
+#include "utils_lru.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(LruCache, EvictsLeastRecentlyUsed)
+{
+    LruCache<int, std::string> cache(2);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+
+    // Using 1 leaves 2 as the least recent.
+    ASSERT_NE(cache.Find(1), nullptr);
+    cache.Put(3, "three");
+
+    EXPECT_TRUE(cache.Contains(1));
+    EXPECT_FALSE(cache.Contains(2));
+    EXPECT_TRUE(cache.Contains(3));
+    EXPECT_EQ(cache.GetSize(), 2u);
+}
+
+TEST(LruCache, PutRefreshesExistingEntry)
+{
+    LruCache<int, std::string> cache(2);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    cache.Put(1, "uno");
+    cache.Put(3, "three");
+
+    ASSERT_NE(cache.Find(1), nullptr);
+    EXPECT_EQ(*cache.Find(1), "uno");
+    EXPECT_FALSE(cache.Contains(2));
+}
+
+TEST(LruCache, ContainsIsNotAUse)
+{
+    LruCache<int, int> cache(2);
+    cache.Put(1, 10);
+    cache.Put(2, 20);
+    EXPECT_TRUE(cache.Contains(1));
+    cache.Put(3, 30);
+
+    EXPECT_FALSE(cache.Contains(1));
+    EXPECT_TRUE(cache.Contains(2));
+}
+
+TEST(LruCache, TakeAndErase)
+{
+    LruCache<int, int> cache(4);
+    cache.Put(1, 10);
+    cache.Put(2, 20);
+
+    EXPECT_EQ(cache.Take(1), 10);
+    EXPECT_EQ(cache.Take(1), std::nullopt);
+    EXPECT_TRUE(cache.Erase(2));
+    EXPECT_FALSE(cache.Erase(2));
+    EXPECT_EQ(cache.GetSize(), 0u);
+
+    LruCache<int, int> disabled(0);
+    disabled.Put(1, 10);
+    EXPECT_FALSE(disabled.Contains(1));
+}
@@ -0,0 +1,241 @@
+#include "Samples.h"
+
+#include <array>
+#include <cstring>
+#include <random>
+
+std::vector<uint8_t> MakeUsbConfigurationSample()
+{
+    return {
+        0x09, 0x02, 0x43, 0x00, 0x02, 0x01, 0x00, 0xA0, 0x32, // configuration, wTotalLength 67
+        0x09, 0x04, 0x00, 0x00, 0x01, 0x03, 0x01, 0x02, 0x00, // interface 0: HID, boot, mouse
+        0x09, 0x21, 0x11, 0x01, 0x00, 0x01, 0x22, 0x34, 0x00, // HID 1.11, report descriptor of 52 bytes
+        0x07, 0x05, 0x81, 0x03, 0x08, 0x00, 0x0A,             // endpoint 1 IN, interrupt
+        0x08, 0x0B, 0x01, 0x01, 0x03, 0x00, 0x00, 0x00,       // IAD for interface 1
+        0x09, 0x04, 0x01, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, // interface 1: HID
+        0x09, 0x21, 0x11, 0x01, 0x00, 0x01, 0x22, 0x20, 0x01, // HID 1.11, report descriptor of 288 bytes
+        0x07, 0x05, 0x82, 0x03, 0x40, 0x00, 0x01,             // endpoint 2 IN, interrupt
+    };
+}
+
+std::vector<uint8_t> MakeUsbDeviceSample()
+{
+    return {
+        0x12, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x08,
+        0x6D, 0x04, 0x2B, 0xC5, 0x01, 0x12, 0x01, 0x02,
+        0x00, 0x01,
+    };
+}
+
+std::vector<uint8_t> MakeUsbBosSample()
+{
+    return {
+        0x05, 0x0F, 0x0C, 0x00, 0x01,                   // BOS, wTotalLength 12, one capability
+        0x07, 0x10, 0x02, 0x06, 0x00, 0x00, 0x00,       // USB 2.0 extension, LPM
+    };
+}
+
+std::vector<std::vector<uint8_t>> MakeDescriptorCorpus(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::vector<uint8_t>> corpus(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::vector<uint8_t>& descriptor = corpus[i];
+        descriptor.resize(16 + random() % 1009);
+        for (uint8_t& byte : descriptor)
+            byte = static_cast<uint8_t>(random());
+
+        // The index makes every string distinct.
+        for (size_t b = 0; b < sizeof(uint32_t); ++b)
+            descriptor[b] = static_cast<uint8_t>(i >> (8 * b));
+    }
+    return corpus;
+}
+
+std::vector<uint8_t> MakeHidGamepadDescriptor()
+{
+    return {
+        0x05, 0x01,        // Usage Page (Generic Desktop)
+        0x09, 0x05,        // Usage (Gamepad)
+        0xA1, 0x01,        // Collection (Application)
+        0x85, 0x01,        //   Report ID (1)
+        0x05, 0x09,        //   Usage Page (Button)
+        0x19, 0x01,        //   Usage Minimum (1)
+        0x29, 0x0C,        //   Usage Maximum (12)
+        0x15, 0x00,        //   Logical Minimum (0)
+        0x25, 0x01,        //   Logical Maximum (1)
+        0x75, 0x01,        //   Report Size (1)
+        0x95, 0x0C,        //   Report Count (12)
+        0x81, 0x02,        //   Input (Data,Var,Abs)
+        0x75, 0x04,        //   Report Size (4)
+        0x95, 0x01,        //   Report Count (1)
+        0x81, 0x03,        //   Input (Const,Var,Abs)
+        0x05, 0x01,        //   Usage Page (Generic Desktop)
+        0x09, 0x39,        //   Usage (Hat Switch)
+        0x15, 0x00,        //   Logical Minimum (0)
+        0x25, 0x07,        //   Logical Maximum (7)
+        0x35, 0x00,        //   Physical Minimum (0)
+        0x46, 0x3B, 0x01,  //   Physical Maximum (315)
+        0x65, 0x14,        //   Unit (degrees)
+        0x75, 0x08,        //   Report Size (8)
+        0x95, 0x01,        //   Report Count (1)
+        0x81, 0x42,        //   Input (Data,Var,Abs,Null)
+        0x09, 0x30,        //   Usage (X)
+        0x09, 0x31,        //   Usage (Y)
+        0x09, 0x32,        //   Usage (Z)
+        0x09, 0x35,        //   Usage (Rz)
+        0x15, 0x00,        //   Logical Minimum (0)
+        0x26, 0xFF, 0x00,  //   Logical Maximum (255)
+        0x75, 0x08,        //   Report Size (8)
+        0x95, 0x04,        //   Report Count (4)
+        0x81, 0x02,        //   Input (Data,Var,Abs)
+        0xC0,              // End Collection
+    };
+}
+
+std::vector<uint8_t> MakeLargeHidDescriptor(size_t minSize)
+{
+    const std::vector<uint8_t> gamepad = MakeHidGamepadDescriptor();
+    constexpr size_t kReportIdOffset = 7;
+
+    std::vector<uint8_t> descriptor;
+    for (unsigned reportId = 1; descriptor.size() < minSize && reportId <= 0xFF; ++reportId)
+    {
+        const size_t first = descriptor.size();
+        descriptor.insert(descriptor.end(), gamepad.begin(), gamepad.end());
+        descriptor[first + kReportIdOffset] = static_cast<uint8_t>(reportId);
+    }
+    return descriptor;
+}
+
+std::vector<uint8_t> MakeHidMouseDescriptor()
+{
+    return {
+        0x05, 0x01,        // Usage Page (Generic Desktop)
+        0x09, 0x02,        // Usage (Mouse)
+        0xA1, 0x01,        // Collection (Application)
+        0x09, 0x01,        //   Usage (Pointer)
+        0xA1, 0x00,        //   Collection (Physical)
+        0x05, 0x09,        //     Usage Page (Button)
+        0x19, 0x01,        //     Usage Minimum (1)
+        0x29, 0x03,        //     Usage Maximum (3)
+        0x15, 0x00,        //     Logical Minimum (0)
+        0x25, 0x01,        //     Logical Maximum (1)
+        0x75, 0x01,        //     Report Size (1)
+        0x95, 0x03,        //     Report Count (3)
+        0x81, 0x02,        //     Input (Data,Var,Abs)
+        0x75, 0x05,        //     Report Size (5)
+        0x95, 0x01,        //     Report Count (1)
+        0x81, 0x03,        //     Input (Const,Var,Abs)
+        0x05, 0x01,        //     Usage Page (Generic Desktop)
+        0x09, 0x30,        //     Usage (X)
+        0x09, 0x31,        //     Usage (Y)
+        0x09, 0x38,        //     Usage (Wheel)
+        0x15, 0x81,        //     Logical Minimum (-127)
+        0x25, 0x7F,        //     Logical Maximum (127)
+        0x75, 0x08,        //     Report Size (8)
+        0x95, 0x03,        //     Report Count (3)
+        0x81, 0x06,        //     Input (Data,Var,Rel)
+        0xC0,              //   End Collection
+        0xC0,              // End Collection
+    };
+}
+
+std::vector<uint8_t> MakeHidKeyboardDescriptor()
+{
+    return {
+        0x05, 0x01,        // Usage Page (Generic Desktop)
+        0x09, 0x06,        // Usage (Keyboard)
+        0xA1, 0x01,        // Collection (Application)
+        0x05, 0x07,        //   Usage Page (Keyboard)
+        0x19, 0xE0,        //   Usage Minimum (Left Control)
+        0x29, 0xE7,        //   Usage Maximum (Right GUI)
+        0x15, 0x00,        //   Logical Minimum (0)
+        0x25, 0x01,        //   Logical Maximum (1)
+        0x75, 0x01,        //   Report Size (1)
+        0x95, 0x08,        //   Report Count (8)
+        0x81, 0x02,        //   Input (Data,Var,Abs)
+        0x75, 0x08,        //   Report Size (8)
+        0x95, 0x01,        //   Report Count (1)
+        0x81, 0x01,        //   Input (Const)
+        0x19, 0x00,        //   Usage Minimum (0)
+        0x29, 0x65,        //   Usage Maximum (101)
+        0x15, 0x00,        //   Logical Minimum (0)
+        0x25, 0x65,        //   Logical Maximum (101)
+        0x75, 0x08,        //   Report Size (8)
+        0x95, 0x06,        //   Report Count (6)
+        0x81, 0x00,        //   Input (Data,Array,Abs)
+        0xC0,              // End Collection
+    };
+}
+
+namespace
+{
+    // One pcap record holding a struct mon_bin_hdr (64 bytes, mmapped
+    // variant) and the captured data.
+    void AppendUsbmonRecord(std::vector<uint8_t>& capture, uint64_t timestampUs, uint64_t urbId, char eventType,
+                            uint8_t transferType, uint8_t endpoint, const std::array<uint8_t, 8>* setup,
+                            std::span<const uint8_t> data)
+    {
+        const auto append = [&capture](const void* value, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(value);
+            capture.insert(capture.end(), bytes, bytes + size);
+        };
+
+        const uint32_t recordHeader[4] = {
+            uint32_t(timestampUs / 1'000'000), uint32_t(timestampUs % 1'000'000),
+            uint32_t(64 + data.size()), uint32_t(64 + data.size()),
+        };
+        append(recordHeader, sizeof(recordHeader));
+
+        uint8_t header[64] = {};
+        std::memcpy(header, &urbId, sizeof(urbId));
+        header[8] = static_cast<uint8_t>(eventType);
+        header[9] = transferType;
+        header[10] = endpoint;
+        header[11] = 5;                      // device
+        header[12] = 1;                      // bus
+        header[14] = setup ? 0 : '-';        // flag_setup: 0 if setup is valid
+        header[15] = data.empty() ? '<' : 0; // flag_data: 0 if data follows
+        const uint32_t length = static_cast<uint32_t>(data.size());
+        std::memcpy(header + 32, &length, sizeof(length)); // len_urb
+        std::memcpy(header + 36, &length, sizeof(length)); // len_cap
+        if (setup)
+            std::memcpy(header + 40, setup->data(), setup->size());
+        append(header, sizeof(header));
+        append(data.data(), data.size());
+    }
+}
+
+std::vector<uint8_t> MakeUsbmonCaptureSample(std::span<const uint8_t> reportDescriptor, std::span<const std::vector<uint8_t>> reports)
+{
+    constexpr uint8_t kControl = 2;
+    constexpr uint8_t kInterrupt = 1;
+
+    // pcap header: microsecond timestamps, link type 220.
+    std::vector<uint8_t> capture = {
+        0xD4, 0xC3, 0xB2, 0xA1, 0x02, 0x00, 0x04, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x04, 0x00, 0xDC, 0x00, 0x00, 0x00,
+    };
+
+    const std::vector<uint8_t> configuration = MakeUsbConfigurationSample();
+    const std::array<uint8_t, 8> getConfiguration = { 0x80, 0x06, 0x00, 0x02, 0x00, 0x00, uint8_t(configuration.size()), 0x00 };
+    const std::array<uint8_t, 8> getReport = { 0x81, 0x06, 0x00, 0x22, 0x01, 0x00, uint8_t(reportDescriptor.size()), uint8_t(reportDescriptor.size() >> 8) };
+
+    uint64_t time = 1'000'000;
+    AppendUsbmonRecord(capture, time, 1, 'S', kControl, 0x80, &getConfiguration, {});
+    AppendUsbmonRecord(capture, time + 100, 1, 'C', kControl, 0x80, nullptr, configuration);
+    AppendUsbmonRecord(capture, time + 200, 2, 'S', kControl, 0x80, &getReport, {});
+    AppendUsbmonRecord(capture, time + 300, 2, 'C', kControl, 0x80, nullptr, reportDescriptor);
+
+    for (const std::vector<uint8_t>& report : reports)
+    {
+        time += 1000;
+        AppendUsbmonRecord(capture, time, 3, 'C', kInterrupt, 0x82, nullptr, report);
+    }
+
+    return capture;
+}
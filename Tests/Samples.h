@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Descriptors shared by the tests, benchmarks and fuzz seeds.
+
+// Configuration descriptor set of a composite device: a boot mouse on
+// interface 0, then an IAD and a HID interface 1. Each interface has a HID
+// descriptor and one interrupt IN endpoint.
+std::vector<uint8_t> MakeUsbConfigurationSample();
+
+// USB 2.0 device descriptor, VID 046D / PID C52B.
+std::vector<uint8_t> MakeUsbDeviceSample();
+
+// BOS descriptor set with a USB 2.0 extension capability.
+std::vector<uint8_t> MakeUsbBosSample();
+
+// `count` distinct byte strings of 16..1024 bytes, standing in for a corpus
+// of report descriptors where only the bytes matter.
+std::vector<std::vector<uint8_t>> MakeDescriptorCorpus(size_t count, uint32_t seed);
+
+// Report descriptor of a gamepad with Report ID 1: 12 buttons, 4 bits of
+// padding, a hat switch and four 8-bit axes (X, Y, Z, Rz); 8-byte reports.
+std::vector<uint8_t> MakeHidGamepadDescriptor();
+
+// The gamepad's collection repeated with Report IDs 1, 2, ... until the
+// descriptor is at least `minSize` bytes (at most 255 copies).
+std::vector<uint8_t> MakeLargeHidDescriptor(size_t minSize);
+
+// Boot mouse without Report IDs: 3 buttons, 5 bits of padding, relative X,
+// Y and wheel.
+std::vector<uint8_t> MakeHidMouseDescriptor();
+
+// Boot keyboard input without Report IDs: 8 modifier bits, a reserved byte
+// and a 6-key array of usages 0..101.
+std::vector<uint8_t> MakeHidKeyboardDescriptor();
+
+// pcap capture (link type LINUX_USB_MMAPPED) of bus 1 device 5: the
+// configuration descriptor of MakeUsbConfigurationSample(), `reportDescriptor`
+// read for interface 1, then `reports` completed on its endpoint 2 IN, one
+// per millisecond.
+std::vector<uint8_t> MakeUsbmonCaptureSample(std::span<const uint8_t> reportDescriptor, std::span<const std::vector<uint8_t>> reports);
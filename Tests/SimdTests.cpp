@@ -0,0 +1,239 @@
+#include "utils_simd.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// The vector kernels against plain loops, over random lengths and start
+// offsets, so that every body / tail split and unaligned load is hit.
+
+namespace
+{
+    constexpr size_t kRounds = 4000;
+    constexpr size_t kMaxLength = 300;
+    constexpr size_t kMaxOffset = 32;
+
+    // ---------------------------------------------------------------------------
+    // Scalar references
+    // ---------------------------------------------------------------------------
+
+    uint8_t Fold(uint8_t c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<uint8_t>(c - 0x20) : c;
+    }
+
+    int CompareNoCaseReference(const char* a, const char* b, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const uint8_t fa = Fold(static_cast<uint8_t>(a[i]));
+            const uint8_t fb = Fold(static_cast<uint8_t>(b[i]));
+            if (fa != fb)
+                return fa < fb ? -1 : 1;
+        }
+        return 0;
+    }
+
+    size_t FindNoCaseReference(const char* haystack, size_t haystackSize, const char* needle, size_t needleSize)
+    {
+        if (needleSize > haystackSize)
+            return SIZE_MAX;
+        for (size_t i = 0; i + needleSize <= haystackSize; ++i)
+        {
+            if (CompareNoCaseReference(haystack + i, needle, needleSize) == 0)
+                return i;
+        }
+        return SIZE_MAX;
+    }
+
+    // Folded 8-byte little-endian words, the last one zero-padded.
+    uint64_t HashNoCaseReference(const char* s, size_t size)
+    {
+        uint64_t h = 0xCBF29CE484222325ull ^ size;
+        for (size_t i = 0; i < size; i += 8)
+        {
+            uint64_t word = 0;
+            for (size_t j = 0; j < 8 && i + j < size; ++j)
+                word |= uint64_t(Fold(static_cast<uint8_t>(s[i + j]))) << (8 * j);
+            h ^= word;
+            h *= 0x9E3779B97F4A7C15ull;
+            h ^= h >> 32;
+        }
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return h ^ (h >> 32);
+    }
+
+    int Sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    // ---------------------------------------------------------------------------
+    // Inputs
+    // ---------------------------------------------------------------------------
+
+    class Inputs
+    {
+    public:
+        explicit Inputs(uint32_t seed) : m_Random(seed) {}
+
+        size_t Next(size_t bound) { return bound ? m_Random() % bound : 0; }
+
+        // Letters of both cases, the neighbours of the folded range and
+        // bytes above 0x7F, which must not fold.
+        char NextChar()
+        {
+            static constexpr char kAlphabet[] = "aAbBzZ@[`{09 \x80\xC1\xE1\xFF";
+            return kAlphabet[Next(sizeof(kAlphabet) - 1)];
+        }
+
+        std::string NextString(size_t size)
+        {
+            std::string s(size, '\0');
+            for (char& c : s)
+                c = NextChar();
+            return s;
+        }
+
+        // Swaps the case of about half the letters.
+        std::string FlipCase(std::string s)
+        {
+            for (char& c : s)
+            {
+                if (Next(2) && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')))
+                    c ^= 0x20;
+            }
+            return s;
+        }
+
+    private:
+        std::mt19937 m_Random;
+    };
+
+    // `s` copied to `offset` bytes into a fresh buffer.
+    struct Placed
+    {
+        Placed(const std::string& s, size_t offset) : buffer(offset + s.size() + 1, '#')
+        {
+            std::memcpy(buffer.data() + offset, s.data(), s.size());
+            data = buffer.data() + offset;
+        }
+
+        std::vector<char> buffer;
+        const char*       data;
+    };
+}
+
+TEST(Simd, CompareNoCaseMatchesScalar)
+{
+    Inputs inputs(39);
+    for (size_t round = 0; round < kRounds; ++round)
+    {
+        const size_t size = inputs.Next(kMaxLength + 1);
+        const std::string a = inputs.NextString(size);
+        std::string b = inputs.FlipCase(a);
+        if (size && inputs.Next(2))
+            b[inputs.Next(size)] = inputs.NextChar();
+
+        const Placed pa(a, inputs.Next(kMaxOffset));
+        const Placed pb(b, inputs.Next(kMaxOffset));
+        ASSERT_EQ(Sign(simd::CompareNoCase(pa.data, pb.data, size)), CompareNoCaseReference(pa.data, pb.data, size))
+            << "size " << size << ", round " << round;
+    }
+}
+
+TEST(Simd, FindNoCaseMatchesScalar)
+{
+    Inputs inputs(40);
+    for (size_t round = 0; round < kRounds; ++round)
+    {
+        const std::string haystack = inputs.NextString(inputs.Next(kMaxLength + 1));
+
+        // Half the needles are taken from the haystack, so there is a match.
+        std::string needle;
+        if (!haystack.empty() && inputs.Next(2))
+        {
+            const size_t at = inputs.Next(haystack.size());
+            needle = inputs.FlipCase(haystack.substr(at, 1 + inputs.Next(std::min<size_t>(haystack.size() - at, 40))));
+        }
+        else
+        {
+            needle = inputs.NextString(inputs.Next(6));
+        }
+
+        const Placed ph(haystack, inputs.Next(kMaxOffset));
+        const Placed pn(needle, inputs.Next(kMaxOffset));
+        ASSERT_EQ(simd::FindNoCase(ph.data, haystack.size(), pn.data, needle.size()),
+                  FindNoCaseReference(ph.data, haystack.size(), pn.data, needle.size()))
+            << "haystack " << haystack.size() << ", needle " << needle.size() << ", round " << round;
+
+        if (!needle.empty())
+        {
+            const char* found = simd::FindCharNoCase(ph.data, haystack.size(), needle[0]);
+            const size_t expected = FindNoCaseReference(ph.data, haystack.size(), needle.data(), 1);
+            ASSERT_EQ(found ? static_cast<size_t>(found - ph.data) : SIZE_MAX, expected) << "round " << round;
+        }
+    }
+}
+
+TEST(Simd, HashNoCaseMatchesScalar)
+{
+    Inputs inputs(41);
+    for (size_t round = 0; round < kRounds; ++round)
+    {
+        const size_t size = inputs.Next(kMaxLength + 1);
+        const std::string s = inputs.NextString(size);
+        const std::string flipped = inputs.FlipCase(s);
+
+        const Placed ps(s, inputs.Next(kMaxOffset));
+        const Placed pf(flipped, inputs.Next(kMaxOffset));
+        const uint64_t hash = simd::HashNoCase(ps.data, size);
+        ASSERT_EQ(hash, HashNoCaseReference(ps.data, size)) << "size " << size << ", round " << round;
+        ASSERT_EQ(hash, simd::HashNoCase(pf.data, size)) << "size " << size << ", round " << round;
+    }
+}
+
+TEST(Simd, DiffBytesMatchesScalar)
+{
+    Inputs inputs(42);
+    for (size_t round = 0; round < kRounds; ++round)
+    {
+        const size_t size = inputs.Next(kMaxLength + 1);
+        const size_t offsetA = inputs.Next(kMaxOffset);
+        const size_t offsetB = inputs.Next(kMaxOffset);
+
+        std::vector<uint8_t> a(offsetA + size);
+        for (uint8_t& byte : a)
+            byte = static_cast<uint8_t>(inputs.Next(256));
+        std::vector<uint8_t> b(offsetB + size);
+        std::memcpy(b.data() + offsetB, a.data() + offsetA, size);
+
+        // From no difference at all to most bytes differing.
+        const size_t changes = inputs.Next(4) ? inputs.Next(4) : inputs.Next(size + 1);
+        for (size_t i = 0; i < changes && size; ++i)
+            b[offsetB + inputs.Next(size)] ^= static_cast<uint8_t>(1 + inputs.Next(255));
+
+        const size_t words = (size + 63) / 64;
+        std::vector<uint64_t> expected(words + 1, 0);
+        bool expectedAny = false;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (a[offsetA + i] != b[offsetB + i])
+            {
+                expected[i / 64] |= uint64_t(1) << (i % 64);
+                expectedAny = true;
+            }
+        }
+
+        // A stale mask and a guard word past its end.
+        std::vector<uint64_t> mask(words + 1, ~uint64_t(0));
+        mask[words] = 0;
+        ASSERT_EQ(simd::DiffBytes(a.data() + offsetA, b.data() + offsetB, size, mask.data()), expectedAny)
+            << "size " << size << ", round " << round;
+        ASSERT_EQ(mask, expected) << "size " << size << ", round " << round;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <random>
+#include <string>
+
+// A fresh directory under the system temporary directory, removed with
+// everything in it when the object goes away.
+class TempDirectory
+{
+public:
+    TempDirectory()
+    {
+        std::random_device random;
+        m_Path = std::filesystem::temp_directory_path() / ("RawInputTests-" + std::to_string(random()));
+        std::filesystem::create_directories(m_Path);
+    }
+
+    ~TempDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_Path, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    void operator=(const TempDirectory&) = delete;
+
+    const std::filesystem::path& GetPath() const { return m_Path; }
+    std::string operator/(const std::string& name) const { return (m_Path / name).string(); }
+
+private:
+    std::filesystem::path m_Path;
+};
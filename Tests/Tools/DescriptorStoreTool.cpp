@@ -0,0 +1,120 @@
+// Builds and inspects descriptor corpora (DescriptorStore.h).
+//
+//   DescriptorStoreTool ingest <store> <dir>...  add the dumps under each
+//                                                 directory; an existing
+//                                                 store is merged, not lost
+//   DescriptorStoreTool stats <store>            entry, copy and VID/PID counts
+//   DescriptorStoreTool extract <store> <dir>    one file per descriptor,
+//                                                 named by hash
+
+#include "DescriptorStore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    int Ingest(const std::string& path, int count, char** dirs)
+    {
+        DescriptorStoreBuilder builder;
+        if (std::filesystem::exists(path))
+        {
+            const std::optional<DescriptorStore> store = DescriptorStore::Open(path);
+            if (!store)
+            {
+                std::fprintf(stderr, "%s: not a descriptor store\n", path.c_str());
+                return 1;
+            }
+            builder.Merge(*store);
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const DescriptorIngestStats stats = IngestDescriptorDumps(builder, dirs[i]);
+            std::printf("%s: %zu files, %zu new, %zu duplicates, %zu skipped\n",
+                dirs[i], stats.files, stats.added, stats.duplicates, stats.skipped);
+        }
+
+        if (!builder.Write(path))
+        {
+            std::fprintf(stderr, "%s: cannot write\n", path.c_str());
+            return 1;
+        }
+
+        std::printf("%s: %zu descriptors\n", path.c_str(), builder.GetCount());
+        return 0;
+    }
+
+    int Stats(const DescriptorStore& store)
+    {
+        size_t copies = 0, bytes = 0, largest = 0;
+        for (const DescriptorStore::Entry& entry : store.GetEntries())
+        {
+            copies += entry.copies;
+            bytes += entry.size;
+            largest = std::max<size_t>(largest, entry.size);
+        }
+
+        std::printf("descriptors: %zu (%zu bytes, largest %zu)\n", store.GetEntries().size(), bytes, largest);
+        std::printf("ingested:    %zu\n", copies);
+        std::printf("VID/PIDs:    %zu\n", store.GetVidPids().size());
+        return 0;
+    }
+
+    int Extract(const DescriptorStore& store, const std::filesystem::path& dir)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+
+        for (const DescriptorStore::Entry& entry : store.GetEntries())
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(entry.hash));
+
+            const std::span<const uint8_t> descriptor = store.GetDescriptor(entry);
+            std::ofstream out(dir / name, std::ios::binary | std::ios::trunc);
+            if (!out.write(reinterpret_cast<const char*>(descriptor.data()), static_cast<std::streamsize>(descriptor.size())))
+            {
+                std::fprintf(stderr, "%s: cannot write\n", (dir / name).string().c_str());
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    int PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: DescriptorStoreTool ingest <store> <dir>...\n"
+            "       DescriptorStoreTool stats <store>\n"
+            "       DescriptorStoreTool extract <store> <dir>\n");
+        return 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return PrintUsage();
+
+    const std::string path = argv[2];
+    if (!std::strcmp(argv[1], "ingest") && argc >= 4)
+        return Ingest(path, argc - 3, argv + 3);
+
+    const bool stats = !std::strcmp(argv[1], "stats") && argc == 3;
+    const bool extract = !std::strcmp(argv[1], "extract") && argc == 4;
+    if (!stats && !extract)
+        return PrintUsage();
+
+    const std::optional<DescriptorStore> store = DescriptorStore::Open(path);
+    if (!store)
+    {
+        std::fprintf(stderr, "%s: not a descriptor store\n", path.c_str());
+        return 1;
+    }
+
+    return stats ? Stats(*store) : Extract(*store, argv[3]);
+}
@@ -0,0 +1,122 @@
+#include "Samples.h"
+
+#include "UsbDescriptor.h"
+
+#include <gtest/gtest.h>
+
+TEST(UsbDescriptor, WalksConfigurationSet)
+{
+    const std::vector<uint8_t> config = MakeUsbConfigurationSample();
+    const UsbDescriptorList list(config);
+
+    std::vector<uint8_t> types;
+    for (const UsbDescriptorView& desc : list)
+        types.push_back(desc.type);
+
+    EXPECT_EQ(types, (std::vector<uint8_t>{ 0x02, 0x04, 0x21, 0x05, 0x0B, 0x04, 0x21, 0x05 }));
+    EXPECT_FALSE(list.IsTruncated());
+
+    const auto header = ParseUsbConfigurationDescriptor(config);
+    ASSERT_TRUE(header);
+    EXPECT_EQ(header->wTotalLength, config.size());
+    EXPECT_EQ(header->bNumInterfaces, 2);
+}
+
+TEST(UsbDescriptor, FindsInterfacesAndHidDescriptors)
+{
+    const std::vector<uint8_t> config = MakeUsbConfigurationSample();
+
+    const auto mouse = FindUsbInterface(config, 0);
+    ASSERT_TRUE(mouse);
+    EXPECT_EQ(mouse->descriptor.bInterfaceClass, 0x03);
+    EXPECT_EQ(mouse->descriptor.bInterfaceProtocol, 0x02);
+    const auto mouseHid = mouse->GetHidDescriptor();
+    ASSERT_TRUE(mouseHid);
+    EXPECT_EQ(mouseHid->bcdHID, 0x0111);
+    EXPECT_EQ(mouseHid->GetReportDescriptorLength(), 0x34);
+
+    // Interface 0 ends at the IAD, so interface 1's endpoint is not in it.
+    size_t endpoints = 0;
+    for (const UsbDescriptorView& desc : mouse->GetDescriptors())
+    {
+        if (const auto endpoint = ParseUsbEndpointDescriptor(desc.data))
+        {
+            ++endpoints;
+            EXPECT_EQ(endpoint->bEndpointAddress, 0x81);
+            EXPECT_TRUE(endpoint->IsIn());
+        }
+    }
+    EXPECT_EQ(endpoints, 1u);
+
+    const auto second = FindUsbInterface(config, 1);
+    ASSERT_TRUE(second);
+    const auto secondHid = second->GetHidDescriptor();
+    ASSERT_TRUE(secondHid);
+    EXPECT_EQ(secondHid->GetReportDescriptorLength(), 0x120);
+
+    EXPECT_FALSE(FindUsbInterface(config, 2));
+    EXPECT_FALSE(FindUsbInterface(config, 0, 1));
+}
+
+TEST(UsbDescriptor, ParsesDeviceAndBos)
+{
+    const auto device = ParseUsbDeviceDescriptor(MakeUsbDeviceSample());
+    ASSERT_TRUE(device);
+    EXPECT_EQ(device->bcdUSB, 0x0200);
+    EXPECT_EQ(device->idVendor, 0x046D);
+    EXPECT_EQ(device->idProduct, 0xC52B);
+    EXPECT_EQ(device->bNumConfigurations, 1);
+
+    const std::vector<uint8_t> bos = MakeUsbBosSample();
+    const auto header = ParseUsbBosDescriptor(bos);
+    ASSERT_TRUE(header);
+    EXPECT_EQ(header->wTotalLength, bos.size());
+
+    size_t capabilities = 0;
+    for (const UsbDescriptorView& desc : UsbDescriptorList(bos))
+    {
+        if (const auto capability = ParseUsbDeviceCapabilityDescriptor(desc.data))
+        {
+            ++capabilities;
+            EXPECT_EQ(capability->bDevCapabilityType, 0x02);
+            EXPECT_EQ(capability->capability.size(), 4u);
+        }
+    }
+    EXPECT_EQ(capabilities, header->bNumDeviceCaps);
+}
+
+TEST(UsbDescriptor, StopsAtMalformedDescriptor)
+{
+    std::vector<uint8_t> config = MakeUsbConfigurationSample();
+
+    // Cut into the last endpoint descriptor.
+    config.resize(config.size() - 3);
+    const UsbDescriptorList truncated(config);
+    EXPECT_TRUE(truncated.IsTruncated());
+    EXPECT_EQ(std::distance(truncated.begin(), truncated.end()), 7);
+
+    // A zero bLength would otherwise never advance.
+    config = MakeUsbConfigurationSample();
+    config[9] = 0;
+    const UsbDescriptorList zero(config);
+    EXPECT_TRUE(zero.IsTruncated());
+    EXPECT_EQ(std::distance(zero.begin(), zero.end()), 1);
+    EXPECT_FALSE(FindUsbInterface(config, 0));
+
+    // Too short for their fields.
+    const std::vector<uint8_t> device = MakeUsbDeviceSample();
+    EXPECT_FALSE(ParseUsbDeviceDescriptor(std::span(device).first(17)));
+    EXPECT_FALSE(ParseUsbEndpointDescriptor(std::vector<uint8_t>{ 0x06, 0x05, 0x81, 0x03, 0x08, 0x00 }));
+}
+
+TEST(UsbDescriptor, ParsesStringDescriptor)
+{
+    const std::vector<uint8_t> langIds = { 0x04, 0x03, 0x09, 0x04 };
+    EXPECT_EQ(ParseUsbStringDescriptor(langIds).size(), 2u);
+
+    // An odd bLength drops the half code unit.
+    const std::vector<uint8_t> odd = { 0x05, 0x03, 'A', 0x00, 'B' };
+    EXPECT_EQ(ParseUsbStringDescriptor(odd).size(), 2u);
+
+    EXPECT_TRUE(ParseUsbStringDescriptor(MakeUsbDeviceSample()).empty());
+}
@@ -0,0 +1,124 @@
+#include "Samples.h"
+#include "TempDirectory.h"
+
+#include "InputPipeline.h"
+#include "UsbmonCapture.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <thread>
+
+namespace
+{
+    // Button 1, then buttons 1 and 2 with X at the right, then button 2 alone.
+    std::vector<std::vector<uint8_t>> MakeGamepadReports()
+    {
+        return {
+            { 0x01, 0x01, 0x00, 0x08, 0x00, 0x80, 0x80, 0x80 },
+            { 0x01, 0x03, 0x00, 0x08, 0xFF, 0x80, 0x80, 0x80 },
+            { 0x01, 0x02, 0x00, 0x02, 0xFF, 0x80, 0x80, 0x80 },
+        };
+    }
+
+    std::string WriteCapture(const TempDirectory& dir, std::span<const uint8_t> capture)
+    {
+        const std::string path = dir / "capture.pcap";
+        std::ofstream(path, std::ios::binary)
+            .write(reinterpret_cast<const char*>(capture.data()), static_cast<std::streamsize>(capture.size()));
+        return path;
+    }
+}
+
+TEST(UsbmonCapture, ReadsPackets)
+{
+    const std::vector<uint8_t> capture = MakeUsbmonCaptureSample(MakeHidGamepadDescriptor(), MakeGamepadReports());
+
+    UsbmonCaptureReader reader(capture);
+    ASSERT_TRUE(reader.IsValid());
+
+    size_t packets = 0;
+    std::optional<UsbmonPacket> last;
+    while (std::optional<UsbmonPacket> packet = reader.Next())
+    {
+        ++packets;
+        last = packet;
+    }
+
+    EXPECT_EQ(packets, 7u);
+    EXPECT_FALSE(reader.IsTruncated());
+    EXPECT_EQ(reader.GetOffset(), capture.size());
+    ASSERT_TRUE(last);
+    EXPECT_EQ(last->eventType, 'C');
+    EXPECT_EQ(last->transferType, UsbmonPacket::Interrupt);
+    EXPECT_EQ(last->endpoint, 0x82u);
+    EXPECT_EQ(last->timestamp, 1'003'000'000u);
+    EXPECT_EQ(last->data.size(), 8u);
+
+    // A cut-off record ends the walk.
+    UsbmonCaptureReader cut(std::span<const uint8_t>(capture).first(capture.size() - 4));
+    size_t cutPackets = 0;
+    while (cut.Next())
+        ++cutPackets;
+    EXPECT_EQ(cutPackets, 6u);
+    EXPECT_TRUE(cut.IsTruncated());
+}
+
+TEST(UsbmonCapture, ImportsHidInterfaces)
+{
+    TempDirectory dir;
+    const std::vector<uint8_t> descriptor = MakeHidGamepadDescriptor();
+    const std::string path = WriteCapture(dir, MakeUsbmonCaptureSample(descriptor, MakeGamepadReports()));
+
+    const std::optional<std::vector<UsbmonHidDevice>> devices = ImportUsbmonHidDevices(path);
+    ASSERT_TRUE(devices);
+    ASSERT_EQ(devices->size(), 1u);
+
+    // Reports on endpoint 2 belong to interface 1 by the configuration descriptor.
+    const UsbmonHidDevice& device = devices->front();
+    EXPECT_EQ(device.key, (UsbmonHidImporter::InterfaceKey{ 1, 5, 1 }));
+    EXPECT_EQ(device.reportDescriptor, descriptor);
+    EXPECT_EQ(device.reports, MakeGamepadReports());
+    EXPECT_EQ(device.lastTimestamp - device.firstTimestamp, 2'000'000u);
+
+    const SyntheticInputBackend::DeviceSpec spec = device.ToDeviceSpec();
+    EXPECT_EQ(spec.interfacePath, "usbmon:1:5:1");
+    EXPECT_DOUBLE_EQ(spec.reportRate, 1000.);
+
+    EXPECT_EQ(ImportUsbmonHidDevices(path, 2)->front().reports.size(), 2u);
+    EXPECT_FALSE(ImportUsbmonHidDevices(dir / "missing.pcap"));
+}
+
+TEST(UsbmonCapture, ReplaysThroughDecoder)
+{
+    TempDirectory dir;
+    const std::string path = WriteCapture(dir, MakeUsbmonCaptureSample(MakeHidGamepadDescriptor(), MakeGamepadReports()));
+    const std::optional<std::vector<UsbmonHidDevice>> devices = ImportUsbmonHidDevices(path);
+    ASSERT_TRUE(devices && devices->size() == 1);
+
+    SyntheticInputBackend::Config config;
+    config.realTime = false;
+    config.packetLimit = devices->front().reports.size();
+    config.devices = { devices->front().ToDeviceSpec() };
+
+    auto backend = std::make_unique<SyntheticInputBackend>(config);
+    SyntheticInputBackend& synthetic = *backend;
+
+    InputPipeline pipeline(std::move(backend), 1);
+    pipeline.Start();
+    while (synthetic.GetPacketCount() < config.packetLimit)
+        std::this_thread::yield();
+    pipeline.Flush();
+
+    ASSERT_EQ(pipeline.GetDevices().size(), 1u);
+    const std::shared_ptr<HidReportDecoder> decoder = pipeline.GetDecoder(pipeline.GetDevices().front());
+    ASSERT_NE(decoder, nullptr);
+    EXPECT_EQ(decoder->GetDecodeStats().reports, 3u);
+    const HidReportDecoder::Snapshot state = decoder->ReadSnapshot();
+    EXPECT_FALSE(state.GetButton(0));
+    EXPECT_TRUE(state.GetButton(1));
+    EXPECT_FLOAT_EQ(state.GetAxis(0), 1.f);
+    EXPECT_EQ(state.GetSwitch(0), SwitchPosition::Right);
+
+    pipeline.Stop();
+}